@@ -31,9 +31,10 @@ type AlphaGoAgent struct {
 	mctsEngine    *mcts.RPSMCTS
 }
 
-func NewAlphaGoAgent(name string, policyNet *neural.RPSPolicyNetwork, valueNet *neural.RPSValueNetwork) *AlphaGoAgent {
+func NewAlphaGoAgent(name string, policyNet *neural.RPSPolicyNetwork, valueNet *neural.RPSValueNetwork, quantized bool) *AlphaGoAgent {
 	mctsParams := mcts.DefaultRPSMCTSParams()
 	mctsParams.NumSimulations = mctsSimulations // Adjust as needed
+	mctsParams.Quantized = quantized
 
 	return &AlphaGoAgent{
 		name:          name,
@@ -76,6 +77,7 @@ func main() {
 
 	numGames := flag.Int("games", 30, "Number of games to play")
 	verbose := flag.Bool("verbose", false, "Show each move during games")
+	quantized := flag.Bool("quantized", false, "Play the tournament with int8 quantized networks")
 	flag.Parse()
 
 	// Seed random number generator
@@ -112,8 +114,8 @@ func main() {
 	fmt.Printf("Loaded model 2 value from %s\n", *model2Value)
 
 	// Create agents
-	agent1 := NewAlphaGoAgent(*model1Name, policy1, value1)
-	agent2 := NewAlphaGoAgent(*model2Name, policy2, value2)
+	agent1 := NewAlphaGoAgent(*model1Name, policy1, value1, *quantized)
+	agent2 := NewAlphaGoAgent(*model2Name, policy2, value2, *quantized)
 
 	// Display model network complexity comparison
 	fmt.Println("\n=== Model Complexity Comparison ===")
@@ -144,6 +146,15 @@ func main() {
 	fmt.Printf("\nModel size comparison: Model 2 is %.2fx the size of Model 1\n", sizeRatio)
 	fmt.Println("===================================")
 
+	// Report what int8 quantization costs in accuracy and gains in speed
+	fmt.Println("\n=== Int8 Quantization ===")
+	reportQuantization(agent1.Name(), policy1, value1)
+	reportQuantization(agent2.Name(), policy2, value2)
+	if *quantized {
+		fmt.Println("The tournament uses the quantized networks")
+	}
+	fmt.Println("===================================")
+
 	// Run tournament
 	fmt.Printf("\n=== Starting Tournament (%s vs %s) ===\n", agent1.Name(), agent2.Name())
 	model1Wins, model2Wins, draws := runTournament(agent1, agent2, *numGames, *verbose)
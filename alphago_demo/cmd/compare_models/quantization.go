@@ -0,0 +1,95 @@
+package main
+
+import (
+	"fmt"
+	"math"
+	"time"
+
+	"github.com/zachbeta/neural_rps/alphago_demo/pkg/game"
+	neural "github.com/zachbeta/neural_rps/alphago_demo/pkg/rps_net_impl"
+)
+
+// quantizationSamples is the number of random games whose positions are
+// used to measure the int8 networks
+const quantizationSamples = 200
+
+// samplePositions returns every position of games random games
+func samplePositions(games int) []*game.RPSGame {
+	var states []*game.RPSGame
+	for g := 0; g < games; g++ {
+		state := game.NewRPSGame(deckSize, handSize, maxRounds)
+		for !state.IsGameOver() {
+			states = append(states, state.Copy())
+			move, err := state.GetRandomMove()
+			if err != nil {
+				break
+			}
+			state.MakeMove(move)
+		}
+	}
+	return states
+}
+
+// timePredictions returns the average time predict takes per state, over
+// enough passes to measure at least 200ms
+func timePredictions(states []*game.RPSGame, predict func(*game.RPSGame)) time.Duration {
+	passes := 0
+	start := time.Now()
+	for time.Since(start) < 200*time.Millisecond {
+		for _, state := range states {
+			predict(state)
+		}
+		passes++
+	}
+	return time.Since(start) / time.Duration(passes*len(states))
+}
+
+// reportQuantization prints how far a model's int8 networks drift from its
+// float networks and how much faster they evaluate
+func reportQuantization(name string, policy *neural.RPSPolicyNetwork, value *neural.RPSValueNetwork) {
+	qPolicy, qValue := policy.Quantized(), value.Quantized()
+	states := samplePositions(quantizationSamples)
+
+	var policyMax, policySum, valueMax, valueSum float64
+	sameMove := 0
+	for _, state := range states {
+		want, got := policy.Predict(state), qPolicy.Predict(state)
+		best, qBest := 0, 0
+		for i := range want {
+			diff := math.Abs(got[i] - want[i])
+			policyMax = math.Max(policyMax, diff)
+			policySum += diff
+			if want[i] > want[best] {
+				best = i
+			}
+			if got[i] > got[qBest] {
+				qBest = i
+			}
+		}
+		if best == qBest {
+			sameMove++
+		}
+
+		diff := math.Abs(qValue.Predict(state) - value.Predict(state))
+		valueMax = math.Max(valueMax, diff)
+		valueSum += diff
+	}
+
+	policyScratch, valueScratch := neural.NewScratch(policy.GetHiddenSize()), neural.NewScratch(value.GetHiddenSize())
+	floatTime := timePredictions(states, func(state *game.RPSGame) {
+		policy.PredictWithScratch(state, policyScratch)
+		value.PredictWithScratch(state, valueScratch)
+	})
+	int8Time := timePredictions(states, func(state *game.RPSGame) {
+		qPolicy.PredictWithScratch(state, policyScratch)
+		qValue.PredictWithScratch(state, valueScratch)
+	})
+
+	n := float64(len(states))
+	fmt.Printf("%s (%d positions):\n", name, len(states))
+	fmt.Printf("  Policy drift: mean %.5f, max %.5f; same top position %.1f%%\n",
+		policySum/(n*9), policyMax, float64(sameMove)/n*100)
+	fmt.Printf("  Value drift:  mean %.5f, max %.5f\n", valueSum/n, valueMax)
+	fmt.Printf("  Policy+value evaluation: float64 %v, int8 %v (%.2fx speedup)\n",
+		floatTime, int8Time, float64(floatTime)/float64(int8Time))
+}
@@ -0,0 +1,82 @@
+package main
+
+import (
+	"flag"
+	"fmt"
+	"os"
+	"path/filepath"
+	"strings"
+	"time"
+
+	neural "github.com/zachbeta/neural_rps/alphago_demo/pkg/rps_net_impl"
+)
+
+// convert_models rewrites policy and value model files in the binary model
+// format, which LoadFromFile and the tournament commands load without
+// parsing. Arguments are model files or directories of *.model files; the
+// default is the directories elo_tournament searches.
+func main() {
+	precisionName := flag.String("precision", "float64", "Weight precision: float64 (exact, mapped in place), float32 (half the size) or int8 (quantized, loads as a quantized network)")
+	outDir := flag.String("out", "", "Directory for converted files (default: replace each file in place)")
+	flag.Parse()
+
+	precision, err := neural.ParseWeightPrecision(*precisionName)
+	if err != nil {
+		fmt.Println(err)
+		os.Exit(2)
+	}
+
+	paths := flag.Args()
+	if len(paths) == 0 {
+		paths = []string{"output", "output/extended_training"}
+	}
+	var files []string
+	for _, path := range paths {
+		info, err := os.Stat(path)
+		if err != nil {
+			fmt.Printf("Skipping %s: %v\n", path, err)
+			continue
+		}
+		if !info.IsDir() {
+			files = append(files, path)
+			continue
+		}
+		matches, _ := filepath.Glob(filepath.Join(path, "*.model"))
+		files = append(files, matches...)
+	}
+
+	if *outDir != "" {
+		if err := os.MkdirAll(*outDir, 0755); err != nil {
+			fmt.Printf("Error creating output directory: %v\n", err)
+			os.Exit(1)
+		}
+	}
+
+	start := time.Now()
+	converted, failed := 0, 0
+	for _, file := range files {
+		dst := file
+		if *outDir != "" {
+			dst = filepath.Join(*outDir, filepath.Base(file))
+		}
+
+		kind, err := neural.ConvertModelFile(file, dst, precision)
+		if err != nil {
+			fmt.Printf("Error converting %s: %v\n", file, err)
+			failed++
+			continue
+		}
+		if !strings.Contains(filepath.Base(file), "_"+kind) {
+			fmt.Printf("Warning: %s holds a %s network\n", file, kind)
+		}
+		converted++
+	}
+
+	fmt.Printf("Converted %d model files to %s binary format in %s", converted, precision,
+		time.Since(start).Round(time.Millisecond))
+	if failed > 0 {
+		fmt.Printf(" (%d failed)\n", failed)
+		os.Exit(1)
+	}
+	fmt.Println()
+}
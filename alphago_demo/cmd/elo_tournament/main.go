@@ -12,7 +12,9 @@ import (
 
 	"github.com/zachbeta/neural_rps/alphago_demo/pkg/game"
 	"github.com/zachbeta/neural_rps/alphago_demo/pkg/mcts"
+	"github.com/zachbeta/neural_rps/alphago_demo/pkg/metrics"
 	neural "github.com/zachbeta/neural_rps/alphago_demo/pkg/rps_net_impl"
+	"github.com/zachbeta/neural_rps/alphago_demo/pkg/tournament"
 )
 
 const (
@@ -31,10 +33,7 @@ const (
 )
 
 // Agent defines the interface for all game-playing agents
-type Agent interface {
-	GetMove(state *game.RPSGame) (game.RPSMove, error)
-	Name() string
-}
+type Agent = tournament.Agent
 
 // GameRecord tracks game results between two agents
 type GameRecord struct {
@@ -106,7 +105,8 @@ func (tm *TournamentManager) UpdateEloForDraw(agent1, agent2 string) {
 	tm.EloRatings[agent2] = rating2 + eloK*(0.5-expected2)
 }
 
-// playGame plays a single game between two agents
+// playGame plays a single game between two agents. It is called
+// concurrently by tournament workers, each with its own agent instances.
 func (tm *TournamentManager) playGame(agent1, agent2 Agent) string {
 	gameState := game.NewRPSGame(deckSize, handSize, maxRounds)
 
@@ -163,8 +163,11 @@ func (tm *TournamentManager) playGame(agent1, agent2 Agent) string {
 	}
 }
 
-// RunTournament runs a tournament between all agents
-func (tm *TournamentManager) RunTournament(gamesPerPair int, eloCutoff float64) {
+// RunTournament runs a tournament between all agents. Games from several
+// matchups are played at once on workers goroutines (0 = one per core), each
+// with its own agent instances; results are applied in matchup order, so
+// ELO updates and pruning do not depend on which game finished first.
+func (tm *TournamentManager) RunTournament(gamesPerPair int, eloCutoff float64, workers int) {
 	fmt.Printf("Starting tournament with %d agents, %d games per pair...\n",
 		len(tm.Agents), gamesPerPair)
 	fmt.Printf("Agents with ELO below %.0f will be removed from the tournament.\n", eloCutoff)
@@ -183,50 +186,67 @@ func (tm *TournamentManager) RunTournament(gamesPerPair int, eloCutoff float64)
 	matchupCount := 0
 	startTime := time.Now()
 
-	// Continue until all high-ELO matchups are played
-	for {
-		// Break if there are fewer than 2 active agents
-		if len(activeAgents) < 2 {
-			break
-		}
-
-		// Find next pair of agents to play
-		agent1, agent2, found := tm.selectNextMatchup(activeAgents, matchupsPlayed)
-		if !found {
-			break // No more matchups to play
-		}
-
-		matchupKey := getMatchupKey(agent1.Name(), agent2.Name())
-		matchupsPlayed[matchupKey] = true
-		matchupCount++
+	// Results of the matchup currently being applied
+	wins1, wins2, draws := 0, 0, 0
 
-		fmt.Printf("Match: %s (ELO: %.0f) vs %s (ELO: %.0f) - %d games\n",
-			agent1.Name(), tm.EloRatings[agent1.Name()],
-			agent2.Name(), tm.EloRatings[agent2.Name()],
-			gamesPerPair)
+	stats := tournament.Run(tournament.Config{
+		Workers: workers,
 
-		wins1, wins2, draws := 0, 0, 0
+		Next: func() (*tournament.Matchup, bool) {
+			// Stop if there are fewer than 2 active agents
+			if len(activeAgents) < 2 {
+				return nil, false
+			}
 
-		for k := 0; k < gamesPerPair; k++ {
-			result := tm.playGame(agent1, agent2)
+			// Find next pair of agents to play
+			agent1, agent2, found := tm.selectNextMatchup(activeAgents, matchupsPlayed)
+			if !found {
+				return nil, false // No more matchups to play
+			}
+			matchupsPlayed[getMatchupKey(agent1.Name(), agent2.Name())] = true
+			return &tournament.Matchup{First: agent1, Second: agent2, Games: gamesPerPair}, true
+		},
+
+		Play: func(m *tournament.Matchup, g int, first, second tournament.Agent) tournament.Outcome {
+			switch tm.playGame(first, second) {
+			case first.Name():
+				return tournament.FirstWins
+			case second.Name():
+				return tournament.SecondWins
+			}
+			return tournament.Draw
+		},
+
+		// Matchups scheduled before an agent was pruned are dropped
+		Keep: func(m *tournament.Matchup) bool {
+			return isActive(activeAgents, m.First) && isActive(activeAgents, m.Second)
+		},
+
+		OnResult: func(m *tournament.Matchup, g int, outcome tournament.Outcome) {
+			agent1, agent2 := m.First.Name(), m.Second.Name()
+			if g == 0 {
+				matchupCount++
+				wins1, wins2, draws = 0, 0, 0
+			}
 			gameCount++
 
 			// Update statistics and ELO ratings
-			if result == agent1.Name() {
+			switch outcome {
+			case tournament.FirstWins:
 				wins1++
-				tm.GameResults[agent1.Name()][agent2.Name()].Wins++
-				tm.GameResults[agent2.Name()][agent1.Name()].Losses++
-				tm.UpdateElo(agent1.Name(), agent2.Name())
-			} else if result == agent2.Name() {
+				tm.GameResults[agent1][agent2].Wins++
+				tm.GameResults[agent2][agent1].Losses++
+				tm.UpdateElo(agent1, agent2)
+			case tournament.SecondWins:
 				wins2++
-				tm.GameResults[agent2.Name()][agent1.Name()].Wins++
-				tm.GameResults[agent1.Name()][agent2.Name()].Losses++
-				tm.UpdateElo(agent2.Name(), agent1.Name())
-			} else {
+				tm.GameResults[agent2][agent1].Wins++
+				tm.GameResults[agent1][agent2].Losses++
+				tm.UpdateElo(agent2, agent1)
+			default:
 				draws++
-				tm.GameResults[agent1.Name()][agent2.Name()].Draws++
-				tm.GameResults[agent2.Name()][agent1.Name()].Draws++
-				tm.UpdateEloForDraw(agent1.Name(), agent2.Name())
+				tm.GameResults[agent1][agent2].Draws++
+				tm.GameResults[agent2][agent1].Draws++
+				tm.UpdateEloForDraw(agent1, agent2)
 			}
 
 			// Report progress every 10 games
@@ -236,36 +256,54 @@ func (tm *TournamentManager) RunTournament(gamesPerPair int, eloCutoff float64)
 				fmt.Printf("\rProgress: %d games (%.1f games/sec) | Matchup %d: %d-%d-%d",
 					gameCount, gamesPerSec, matchupCount, wins1, wins2, draws)
 			}
-		}
-
-		// Print match results
-		fmt.Printf("\nResult: %s %d - %d %s (draws: %d)\n",
-			agent1.Name(), wins1, wins2, agent2.Name(), draws)
-		fmt.Printf("Updated ELO: %s: %.0f | %s: %.0f\n\n",
-			agent1.Name(), tm.EloRatings[agent1.Name()],
-			agent2.Name(), tm.EloRatings[agent2.Name()])
-
-		// Show current leaderboard periodically
-		if matchupCount%leaderboardInterval == 0 {
-			fmt.Println("\n--- Current Leaderboard ---")
-			tm.PrintTopRankings(10) // Show top 10 agents
-			fmt.Println()
-		}
+		},
+
+		OnMatchupDone: func(m *tournament.Matchup) {
+			agent1, agent2 := m.First.Name(), m.Second.Name()
+
+			// Print match results
+			fmt.Printf("\nMatch: %s vs %s - %d games\n", agent1, agent2, m.Games)
+			fmt.Printf("Result: %s %d - %d %s (draws: %d)\n",
+				agent1, wins1, wins2, agent2, draws)
+			fmt.Printf("Updated ELO: %s: %.0f | %s: %.0f\n\n",
+				agent1, tm.EloRatings[agent1],
+				agent2, tm.EloRatings[agent2])
+
+			// Show current leaderboard periodically
+			if matchupCount%leaderboardInterval == 0 {
+				fmt.Println("\n--- Current Leaderboard ---")
+				tm.PrintTopRankings(10) // Show top 10 agents
+				fmt.Println()
+			}
 
-		// Prune weak agents from active list
-		prunedAgents := tm.pruneWeakAgents(activeAgents, eloCutoff)
-		if len(prunedAgents) > 0 {
-			activeAgents = prunedAgents
-			fmt.Printf("Pruned agents below ELO %.0f. %d agents remaining.\n\n",
-				eloCutoff, len(activeAgents))
-		}
-	}
+			// Prune weak agents from active list
+			prunedAgents := tm.pruneWeakAgents(activeAgents, eloCutoff)
+			if len(prunedAgents) > 0 {
+				activeAgents = prunedAgents
+				fmt.Printf("Pruned agents below ELO %.0f. %d agents remaining.\n\n",
+					eloCutoff, len(activeAgents))
+			}
+		},
+	})
 
 	elapsed := time.Since(startTime)
 	fmt.Printf("\nTournament completed in %s (%.1f games/sec)\n",
 		elapsed, float64(gameCount)/elapsed.Seconds())
 	fmt.Printf("Total games played: %d across %d matchups\n",
 		gameCount, matchupCount)
+	if stats.Dropped > 0 {
+		fmt.Printf("Dropped %d scheduled matchups after pruning\n", stats.Dropped)
+	}
+}
+
+// isActive reports whether agent is in agents
+func isActive(agents []Agent, agent tournament.Agent) bool {
+	for _, a := range agents {
+		if a == agent {
+			return true
+		}
+	}
+	return false
 }
 
 // selectNextMatchup selects the next pair of agents to play
@@ -499,21 +537,20 @@ func (tm *TournamentManager) SaveResults(filename string) error {
 
 // NewNEATAgent creates an agent from NEAT model files
 func NewNEATAgent(name, policyPath, valuePath string) Agent {
-	policyNet := neural.NewRPSPolicyNetwork(64) // Default size
-	valueNet := neural.NewRPSValueNetwork(64)   // Default size
-
-	err := policyNet.LoadFromFile(policyPath)
+	// Binary model files are mapped in place; JSON ones are parsed
+	policyNet, err := neural.MapPolicyNetwork(policyPath)
 	if err != nil {
-		panic(fmt.Sprintf("Failed to load policy network: %v", err))
+		panic(err.Error())
 	}
 
-	err = valueNet.LoadFromFile(valuePath)
+	valueNet, err := neural.MapValueNetwork(valuePath)
 	if err != nil {
-		panic(fmt.Sprintf("Failed to load value network: %v", err))
+		panic(err.Error())
 	}
 
 	mctsParams := mcts.DefaultRPSMCTSParams()
 	mctsParams.NumSimulations = 200 // Use consistent simulation count for fair comparison
+	mctsParams.ReuseTree = true     // GetMove is called once per move of a game
 	mctsEngine := mcts.NewRPSMCTS(policyNet, valueNet, mctsParams)
 
 	return &MCTSAgent{
@@ -552,6 +589,18 @@ func (a *MCTSAgent) Name() string {
 	return a.name
 }
 
+// Fork returns an agent with its own search tree over the same networks, for
+// another tournament worker. The workers already run games in parallel, so a
+// fork searches on a single goroutine rather than GOMAXPROCS of its own.
+func (a *MCTSAgent) Fork() tournament.Agent {
+	params := a.mctsEngine.Params
+	params.NumWorkers = 1
+	engine := mcts.NewRPSMCTS(a.mctsEngine.PolicyNetwork, a.mctsEngine.ValueNetwork, params)
+	engine.Book = a.mctsEngine.Book
+	engine.Cache = a.mctsEngine.Cache
+	return &MCTSAgent{name: a.name, mctsEngine: engine}
+}
+
 // RandomAgent makes random valid moves
 type RandomAgent struct {
 	name string
@@ -576,9 +625,19 @@ func main() {
 	verbose := flag.Bool("verbose", false, "Enable verbose output")
 	eloCutoff := flag.Float64("cutoff", defaultCutoffElo, "ELO rating threshold for pruning weak agents (0 to disable)")
 	topCount := flag.Int("top", 0, "Only use the top N agents from previous tournament results (0 to use all)")
+	workers := flag.Int("workers", 0, "Games played at once (0 = one per core)")
+	metricsAddr := flag.String("metrics-addr", "", "Serve Prometheus metrics and pprof on this address, e.g. localhost:9090 (empty disables)")
+	traceFile := flag.String("trace", "", "Write a runtime execution trace of the tournament to this file")
 
 	flag.Parse()
 
+	stopTrace, err := metrics.StartDebug(*metricsAddr, *traceFile)
+	if err != nil {
+		fmt.Println(err)
+		os.Exit(1)
+	}
+	defer stopTrace()
+
 	// Seed random number generator
 	rand.Seed(time.Now().UnixNano())
 
@@ -624,14 +683,14 @@ func main() {
 	fmt.Printf("Starting tournament with %d agents...\n\n", len(tm.Agents))
 
 	// Run tournament with ELO cutoff
-	tm.RunTournament(*gamesPerPair, *eloCutoff)
+	tm.RunTournament(*gamesPerPair, *eloCutoff, *workers)
 
 	// Print final rankings
 	fmt.Println("\n=== Final ELO Rankings ===")
 	tm.PrintRankings()
 
 	// Save results to file
-	err := tm.SaveResults(*outputFile)
+	err = tm.SaveResults(*outputFile)
 	if err != nil {
 		fmt.Printf("Error saving results: %v\n", err)
 	} else {
@@ -0,0 +1,142 @@
+package main
+
+import (
+	"flag"
+	"fmt"
+	"math/bits"
+	"os"
+	"path/filepath"
+	"runtime"
+	"time"
+
+	"github.com/zachbeta/neural_rps/alphago_demo/pkg/analysis"
+	"github.com/zachbeta/neural_rps/alphago_demo/pkg/book"
+	"github.com/zachbeta/neural_rps/alphago_demo/pkg/game"
+)
+
+// generate_book solves every position in the first few plies of the RPS card
+// game, over all possible starting hands, and writes the results as a book
+// for MinimaxAgent and RPSMCTS.
+func main() {
+	deckSize := flag.Int("deck", 21, "Deck size (cards cycle Rock, Paper, Scissors)")
+	handSize := flag.Int("hand", 5, "Cards dealt to each player")
+	maxRounds := flag.Int("max-rounds", 10, "Maximum rounds per game")
+	plies := flag.Int("plies", 1, "Book positions up to this many moves into the game")
+	depth := flag.Int("depth", 9, "Minimax search depth per position (9 solves the game)")
+	threads := flag.Int("threads", runtime.GOMAXPROCS(0), "Search threads")
+	outputFile := flag.String("output", "output/opening_book.bin", "Output book file")
+	flag.Parse()
+
+	starts := startingPositions(*deckSize, *handSize, *maxRounds)
+	fmt.Printf("%d starting hand combinations\n", len(starts))
+
+	seen := make(map[uint64]bool)
+	var positions []game.PackedRPSGame
+	for _, start := range starts {
+		collectPositions(start, *plies, seen, &positions)
+	}
+	fmt.Printf("%d distinct positions within %d plies\n", len(positions), *plies)
+
+	engine := analysis.NewMinimaxEngine(*depth, analysis.StandardEvaluator)
+	engine.PackedEvaluationFn = analysis.PackedStandardEvaluator
+	engine.EnableZobristTable(1 << 22)
+	engine.Threads = *threads
+	engine.MaxTime = time.Hour
+
+	entries := make([]book.Entry, 0, len(positions))
+	startTime := time.Now()
+	for i, packed := range positions {
+		state := packed.Unpack()
+		move, value := engine.FindBestMove(state)
+
+		entry := book.Entry{
+			Key:   packed.Hash(),
+			Value: float32(value),
+			Move:  state.PackMove(move),
+			Depth: uint8(*depth),
+		}
+		// Every move fills a square, so a search as deep as the number of
+		// empty squares sees the end of every line
+		if *depth >= bits.OnesCount16(packed.Empty()) {
+			entry.Flags |= book.FlagSolved
+		}
+		entries = append(entries, entry)
+
+		if (i+1)%100 == 0 || i+1 == len(positions) {
+			elapsed := time.Since(startTime)
+			fmt.Printf("\rSolved %d/%d positions (%.1f/s)", i+1, len(positions),
+				float64(i+1)/elapsed.Seconds())
+		}
+	}
+	fmt.Println()
+
+	if err := os.MkdirAll(filepath.Dir(*outputFile), 0755); err != nil {
+		fmt.Printf("Error creating output directory: %v\n", err)
+		os.Exit(1)
+	}
+	if err := book.Write(*outputFile, *maxRounds, entries); err != nil {
+		fmt.Printf("Error writing book: %v\n", err)
+		os.Exit(1)
+	}
+	fmt.Printf("Wrote %d positions to %s in %v\n", len(entries), *outputFile, time.Since(startTime))
+}
+
+// startingPositions returns one packed start position per pair of hand
+// compositions that can be dealt from the deck
+func startingPositions(deckSize, handSize, maxRounds int) []game.PackedRPSGame {
+	var deck [3]int
+	for i := 0; i < deckSize; i++ {
+		deck[i%3]++
+	}
+
+	var starts []game.PackedRPSGame
+	for _, hand1 := range handCompositions(handSize, deck) {
+		remaining := [3]int{deck[0] - int(hand1[0]), deck[1] - int(hand1[1]), deck[2] - int(hand1[2])}
+		for _, hand2 := range handCompositions(handSize, remaining) {
+			starts = append(starts, game.PackedRPSGame{
+				Hand:      [2][3]uint8{hand1, hand2},
+				Round:     1,
+				MaxRounds: uint16(maxRounds),
+			})
+		}
+	}
+	return starts
+}
+
+// handCompositions lists the (rock, paper, scissors) counts of size cards
+// that fit within the available counts
+func handCompositions(size int, available [3]int) [][3]uint8 {
+	var hands [][3]uint8
+	for rock := 0; rock <= min(size, available[0]); rock++ {
+		for paper := 0; paper <= min(size-rock, available[1]); paper++ {
+			if scissors := size - rock - paper; scissors <= available[2] {
+				hands = append(hands, [3]uint8{uint8(rock), uint8(paper), uint8(scissors)})
+			}
+		}
+	}
+	return hands
+}
+
+// collectPositions appends every unseen non-terminal position reachable from
+// state in at most plies moves
+func collectPositions(state game.PackedRPSGame, plies int, seen map[uint64]bool, positions *[]game.PackedRPSGame) {
+	if state.IsGameOver() {
+		return
+	}
+	hash := state.Hash()
+	if seen[hash] {
+		return
+	}
+	seen[hash] = true
+	*positions = append(*positions, state)
+
+	if plies == 0 {
+		return
+	}
+	var buf [game.MaxPackedMoves]game.PackedMove
+	for _, move := range state.AppendMoves(buf[:0]) {
+		undo := state.MakeMove(move)
+		collectPositions(state, plies-1, seen, positions)
+		state.UnmakeMove(undo)
+	}
+}
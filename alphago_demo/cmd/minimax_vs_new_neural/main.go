@@ -5,6 +5,7 @@ import (
 	"fmt"
 	"math/rand"
 	"os"
+	"runtime"
 	"time"
 
 	"github.com/zachbeta/neural_rps/alphago_demo/pkg/agents"
@@ -20,6 +21,7 @@ func main() {
 	outFile := flag.String("out", "", "Output file for detailed results (optional)")
 	useCache := flag.Bool("cache", true, "Enable transposition table")
 	hiddenSize := flag.Int("hidden", 64, "Neural network hidden layer size")
+	threads := flag.Int("minimax-threads", runtime.NumCPU(), "Goroutines per minimax search (games are played one at a time)")
 	flag.Parse()
 
 	// Create neural network agent with a newly initialized network
@@ -36,6 +38,7 @@ func main() {
 		time.Duration(*timeLimit)*time.Second,
 		*useCache,
 	)
+	minimaxAgent.SetSearchThreads(*threads)
 
 	// Play games
 	fmt.Printf("Starting tournament: %s vs %s (%d games)\n",
@@ -172,6 +172,11 @@ func main() {
 		minimaxWithCache := analysis.NewMinimaxEngine(depth, analysis.StandardEvaluator)
 		minimaxWithCache.EnableTranspositionTable()
 
+		// Create minimax engine with the fixed-size Zobrist table
+		minimaxWithZobrist := analysis.NewMinimaxEngine(depth, analysis.StandardEvaluator)
+		minimaxWithZobrist.PackedEvaluationFn = analysis.PackedStandardEvaluator
+		minimaxWithZobrist.EnableZobristTable(analysis.DefaultZobristTableEntries)
+
 		// Test each position
 		for i, position := range positions {
 			fmt.Printf("\n[Position %d/%d] %s\n", i+1, len(positions), position.Name)
@@ -207,9 +212,25 @@ func main() {
 			speedup := float64(elapsedWithoutCache) / float64(elapsedWithCache)
 			fmt.Printf("\nSpeedup with cache: %.2fx\n", speedup)
 
+			// Test with Zobrist table
+			fmt.Println("\nWith Zobrist table:")
+			startTime = time.Now()
+			bestMove, bestValue = minimaxWithZobrist.FindBestMove(position.Game)
+			elapsedWithZobrist := time.Since(startTime)
+			fmt.Printf("Best move: %v (value: %.2f)\n", bestMove, bestValue)
+			fmt.Printf("Time: %v\n", elapsedWithZobrist)
+			fmt.Printf("Nodes evaluated: %d\n", minimaxWithZobrist.NodesEvaluated)
+
+			hits, misses, hitRate = minimaxWithZobrist.GetCacheStats()
+			fmt.Printf("Cache stats - Hits: %d, Misses: %d, Hit rate: %.2f%%\n",
+				hits, misses, hitRate)
+			fmt.Printf("Speedup with Zobrist table: %.2fx\n",
+				float64(elapsedWithoutCache)/float64(elapsedWithZobrist))
+
 			// Reset cache for next position
 			minimaxWithCache.DisableTranspositionTable()
 			minimaxWithCache.EnableTranspositionTable()
+			minimaxWithZobrist.ZobristTable.Clear()
 		}
 	}
 
@@ -6,11 +6,13 @@ import (
 	"math"
 	"math/rand"
 	"os"
+	"runtime"
 	"sort"
 	"strings"
 	"time"
 
 	"github.com/zachbeta/neural_rps/alphago_demo/pkg/agents"
+	"github.com/zachbeta/neural_rps/alphago_demo/pkg/book"
 	"github.com/zachbeta/neural_rps/alphago_demo/pkg/game"
 	"github.com/zachbeta/neural_rps/alphago_demo/pkg/mcts"
 	neural "github.com/zachbeta/neural_rps/alphago_demo/pkg/rps_net_impl"
@@ -35,6 +37,8 @@ func main() {
 	outputFile := flag.String("output", "output/tournament_with_minimax_results.csv", "Output file for results")
 	verbose := flag.Bool("verbose", false, "Enable verbose output")
 	maxNetworks := flag.Int("max-networks", 3, "Maximum number of neural networks of each type to include")
+	bookFile := flag.String("book", "", "Opening book for the minimax agents (from generate_book)")
+	minimaxThreads := flag.Int("minimax-threads", runtime.NumCPU(), "Goroutines per minimax search (games are played one at a time)")
 	flag.Parse()
 
 	// Seed random number generator
@@ -49,12 +53,26 @@ func main() {
 	// Add minimax agents with different depths
 	minimaxAgent3 := agents.NewMinimaxAgent("Minimax-3", 3, 1*time.Second, true)
 	minimaxAgent3.SetVerbose(*verbose)
+	minimaxAgent3.SetSearchThreads(*minimaxThreads)
 	tm.AddAgent(minimaxAgent3)
 
 	minimaxAgent5 := agents.NewMinimaxAgent("Minimax-5", 5, 3*time.Second, true)
 	minimaxAgent5.SetVerbose(*verbose)
+	minimaxAgent5.SetSearchThreads(*minimaxThreads)
 	tm.AddAgent(minimaxAgent5)
 
+	if *bookFile != "" {
+		openingBook, err := book.Open(*bookFile)
+		if err != nil {
+			fmt.Printf("Warning: %v\n", err)
+		} else {
+			defer openingBook.Close()
+			fmt.Printf("Loaded opening book with %d positions\n", openingBook.Len())
+			minimaxAgent3.SetBook(openingBook)
+			minimaxAgent5.SetBook(openingBook)
+		}
+	}
+
 	// Find available models for neural networks
 	fmt.Println("Looking for model files in output directory...")
 
@@ -204,6 +222,7 @@ func NewNeuralAgent(name, policyPath, valuePath string) Agent {
 
 	mctsParams := mcts.DefaultRPSMCTSParams()
 	mctsParams.NumSimulations = 200 // Use consistent simulation count for fair comparison
+	mctsParams.ReuseTree = true     // GetMove is called once per move of a game
 	mctsEngine := mcts.NewRPSMCTS(policyNet, valueNet, mctsParams)
 
 	return &MCTSAgent{
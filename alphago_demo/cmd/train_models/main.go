@@ -7,12 +7,15 @@ import (
 	"math"
 	"math/rand"
 	"os"
+	"path/filepath"
 	"runtime"
 	"runtime/pprof"
 	"time"
 
 	"github.com/zachbeta/neural_rps/alphago_demo/pkg/game"
 	"github.com/zachbeta/neural_rps/alphago_demo/pkg/mcts"
+	"github.com/zachbeta/neural_rps/alphago_demo/pkg/metrics"
+	"github.com/zachbeta/neural_rps/alphago_demo/pkg/replay"
 	neural "github.com/zachbeta/neural_rps/alphago_demo/pkg/rps_net_impl"
 	"github.com/zachbeta/neural_rps/alphago_demo/pkg/training"
 	"github.com/zachbeta/neural_rps/alphago_demo/pkg/training/neat"
@@ -71,6 +74,13 @@ func main() {
 	m2Exploration := flag.Float64("m2-exploration", 1.0, "Exploration constant for Model 2")
 
 	tourGames := flag.Int("tournament-games", tournamentGames, "Number of head-to-head games")
+
+	shardDir := flag.String("shard-dir", "", "Stream self-play examples to shard files under this directory and train from them, instead of holding them in memory")
+	compressShards := flag.Bool("compress-shards", false, "Gzip shard files (they are then read into memory rather than memory-mapped)")
+	optimizer := flag.String("optimizer", "adam", "Mini-batch optimizer: sgd | momentum | adam, or online for per-example updates")
+	pipeline := flag.Bool("pipeline", false, "Overlap self-play and training: actors feed a replay buffer while a learner trains from it")
+	metricsAddr := flag.String("metrics-addr", "", "Serve Prometheus metrics and pprof on this address, e.g. localhost:9090 (empty disables)")
+	traceFile := flag.String("trace", "", "Write a runtime execution trace of the run to this file")
 	flag.Parse()
 
 	// Setup CPU profiling if requested
@@ -93,6 +103,12 @@ func main() {
 		defer pprof.StopCPUProfile()
 	}
 
+	stopTrace, err := metrics.StartDebug(*metricsAddr, *traceFile)
+	if err != nil {
+		log.Fatal(err)
+	}
+	defer stopTrace()
+
 	// Handle thread optimization if requested
 	if *optimizeThreads {
 		findOptimalThreadCount()
@@ -169,15 +185,38 @@ func main() {
 	// Create output directory if it doesn't exist
 	os.Mkdir("output", 0755)
 
+	// Resolve the optimizer; nil keeps per-example updates
+	var trainer *neural.TrainerConfig
+	if *optimizer != "online" {
+		opt, err := neural.ParseOptimizer(*optimizer)
+		if err != nil {
+			log.Fatalf("Invalid -optimizer: %v", err)
+		}
+		config := neural.DefaultTrainerConfig()
+		config.Optimizer = opt
+		config.Workers = *threads
+		trainer = &config
+	}
+
+	if *pipeline && (trainer == nil || *shardDir != "") {
+		log.Fatal("-pipeline needs a mini-batch -optimizer and cannot be combined with -shard-dir")
+	}
+
 	// Initialize neural networks for model 1 (smaller network, fewer games)
 	fmt.Println("=== Training Model 1 (Small Network) ===")
+	shards1, shards2 := shardConfig{}, shardConfig{}
+	if *shardDir != "" {
+		shards1 = shardConfig{dir: filepath.Join(*shardDir, "model1"), compress: *compressShards}
+		shards2 = shardConfig{dir: filepath.Join(*shardDir, "model2"), compress: *compressShards}
+	}
+
 	policy1, value1 := trainModel("output/rps_policy1.model", "output/rps_value1.model",
-		m1G, m1E, h1, *parallel, *threads)
+		m1G, m1E, h1, *parallel, *threads, shards1, trainer, *pipeline)
 
 	// Initialize neural networks for model 2 (larger network, more games)
 	fmt.Println("\n=== Training Model 2 (Large Network) ===")
 	policy2, value2 := trainModel("output/rps_policy2.model", "output/rps_value2.model",
-		m2G, m2E, h2, *parallel, *threads)
+		m2G, m2E, h2, *parallel, *threads, shards2, trainer, *pipeline)
 
 	model1Name := fmt.Sprintf("H%d-G%d-E%d-S%d-X%.1f",
 		h1, m1G, m1E, s1, x1)
@@ -282,7 +321,14 @@ func calculatePValue(wins1, wins2, total int) float64 {
 }
 
 // trainModel trains a policy and value network with self-play
-func trainModel(policyPath, valuePath string, selfPlayGames, epochs, hiddenSize int, forceParallel bool, threads int) (*neural.RPSPolicyNetwork, *neural.RPSValueNetwork) {
+// shardConfig selects streaming self-play to shards; an empty dir keeps
+// examples in memory
+type shardConfig struct {
+	dir      string
+	compress bool
+}
+
+func trainModel(policyPath, valuePath string, selfPlayGames, epochs, hiddenSize int, forceParallel bool, threads int, shards shardConfig, trainer *neural.TrainerConfig, pipeline bool) (*neural.RPSPolicyNetwork, *neural.RPSValueNetwork) {
 	// Get timestamp for model naming
 	timestamp := time.Now().Format("20060102-150405")
 
@@ -307,6 +353,7 @@ func trainModel(policyPath, valuePath string, selfPlayGames, epochs, hiddenSize
 	selfPlayParams.HandSize = handSize
 	selfPlayParams.MaxRounds = maxRounds
 	selfPlayParams.NumThreads = threads
+	selfPlayParams.Trainer = trainer
 
 	// Force parallel execution if requested
 	if forceParallel {
@@ -330,6 +377,12 @@ func trainModel(policyPath, valuePath string, selfPlayGames, epochs, hiddenSize
 	fmt.Printf("MCTS Parameters: %d simulations per move\n", selfPlayParams.MCTSParams.NumSimulations)
 	fmt.Printf("Exploration constant: %.2f\n", selfPlayParams.MCTSParams.ExplorationConst)
 
+	if pipeline {
+		trainWithPipeline(policyNetwork, valueNetwork, selfPlayParams, epochs, trainingLearningRate(hiddenSize), *trainer)
+		saveModels(policyNetwork, valueNetwork, policyPath, valuePath)
+		return policyNetwork, valueNetwork
+	}
+
 	// Create self-play instance
 	selfPlay := training.NewRPSSelfPlay(policyNetwork, valueNetwork, selfPlayParams)
 
@@ -338,37 +391,46 @@ func trainModel(policyPath, valuePath string, selfPlayGames, epochs, hiddenSize
 	fmt.Printf("Generating %d self-play games with %d cards per player (%d max rounds)...\n",
 		selfPlayGames, handSize, maxRounds)
 	startTime := time.Now()
-	examples := selfPlay.GenerateGames(true) // Enable verbose mode for more updates
+	var (
+		numExamples int
+		buffer      *replay.Buffer
+	)
+	if shards.dir != "" {
+		buffer, numExamples = generateToShards(selfPlay, shards)
+		defer buffer.Close()
+	} else {
+		numExamples = len(selfPlay.GenerateGames(true)) // Enable verbose mode for more updates
+	}
 	genTime := time.Since(startTime)
 
 	// Calculate examples per game
-	examplesPerGame := float64(len(examples)) / float64(selfPlayGames)
+	examplesPerGame := float64(numExamples) / float64(selfPlayGames)
 	gamesPerSecond := float64(selfPlayGames) / genTime.Seconds()
 
 	fmt.Printf("Generated %d training examples in %s (%.1f examples/game, %.2f games/sec)\n",
-		len(examples), genTime, examplesPerGame, gamesPerSecond)
+		numExamples, genTime, examplesPerGame, gamesPerSecond)
 
 	// Train networks with adjusted learning rate for larger networks
 	fmt.Printf("\n--- Training Phase ---\n")
+	learningRate := trainingLearningRate(hiddenSize)
 
-	// Use lower learning rate for larger networks to prevent instability
-	baseLR := 0.01
-	learningRate := baseLR
-	if hiddenSize >= 100 {
-		learningRate = baseLR * 0.5
-		fmt.Printf("Using reduced learning rate (%.4f) for large network\n", learningRate)
-	} else {
-		fmt.Printf("Using standard learning rate (%.4f)\n", learningRate)
+	optimizerName := "online"
+	if trainer != nil {
+		optimizerName = trainer.Optimizer.String()
 	}
-
-	fmt.Printf("Training networks for %d epochs (Batch size: %d)...\n",
-		epochs, 32)
+	fmt.Printf("Training networks for %d epochs (Batch size: %d, Optimizer: %s)...\n",
+		epochs, 32, optimizerName)
 	startTime = time.Now()
-	policyLosses, valueLosses := selfPlay.TrainNetworks(epochs, 32, learningRate, true)
+	var policyLosses, valueLosses []float64
+	if buffer != nil {
+		policyLosses, valueLosses = selfPlay.TrainNetworksFromBuffer(buffer, epochs, 32, learningRate, true)
+	} else {
+		policyLosses, valueLosses = selfPlay.TrainNetworks(epochs, 32, learningRate, true)
+	}
 	trainTime := time.Since(startTime)
 
 	// Calculate training speed
-	examplesPerSecond := float64(len(examples)*epochs) / trainTime.Seconds()
+	examplesPerSecond := float64(numExamples*epochs) / trainTime.Seconds()
 	fmt.Printf("Training completed in %s (%.2f examples/sec)\n", trainTime, examplesPerSecond)
 
 	// Display final losses if available
@@ -386,7 +448,42 @@ func trainModel(policyPath, valuePath string, selfPlayGames, epochs, hiddenSize
 		}
 	}
 
-	// Save the trained models
+	saveModels(policyNetwork, valueNetwork, policyPath, valuePath)
+	return policyNetwork, valueNetwork
+}
+
+// trainingLearningRate returns the learning rate for a network, lower for
+// larger networks to prevent instability
+func trainingLearningRate(hiddenSize int) float64 {
+	baseLR := 0.01
+	learningRate := baseLR
+	if hiddenSize >= 100 {
+		learningRate = baseLR * 0.5
+		fmt.Printf("Using reduced learning rate (%.4f) for large network\n", learningRate)
+	} else {
+		fmt.Printf("Using standard learning rate (%.4f)\n", learningRate)
+	}
+	return learningRate
+}
+
+// trainWithPipeline plays and trains concurrently, training each example
+// about epochs times on average
+func trainWithPipeline(policyNetwork *neural.RPSPolicyNetwork, valueNetwork *neural.RPSValueNetwork,
+	selfPlayParams training.RPSSelfPlayParams, epochs int, learningRate float64, trainer neural.TrainerConfig) {
+	fmt.Printf("\n--- Actor/Learner Phase ---\n")
+
+	params := training.DefaultActorLearnerParams()
+	params.SelfPlay = selfPlayParams
+	params.LearningRate = learningRate
+	params.Trainer = trainer
+	params.SampleRatio = float64(epochs)
+
+	stats := training.NewActorLearner(policyNetwork, valueNetwork, params).Run(true)
+	fmt.Printf("Final losses - Policy: %.4f, Value: %.4f\n", stats.PolicyLoss, stats.ValueLoss)
+}
+
+// saveModels writes the trained networks
+func saveModels(policyNetwork *neural.RPSPolicyNetwork, valueNetwork *neural.RPSValueNetwork, policyPath, valuePath string) {
 	fmt.Printf("\n--- Saving Models ---\n")
 	err := policyNetwork.SaveToFile(policyPath)
 	if err != nil {
@@ -397,8 +494,33 @@ func trainModel(policyPath, valuePath string, selfPlayGames, epochs, hiddenSize
 		log.Fatalf("Failed to save value network: %v", err)
 	}
 	fmt.Printf("Models saved to %s and %s\n", policyPath, valuePath)
+}
 
-	return policyNetwork, valueNetwork
+// generateToShards streams self-play into a fresh shard directory and opens
+// it as a replay buffer
+func generateToShards(selfPlay *training.RPSSelfPlay, shards shardConfig) (*replay.Buffer, int) {
+	// Start clean so the buffer only holds this model's games
+	if err := os.RemoveAll(shards.dir); err != nil {
+		log.Fatalf("Failed to clear shard directory: %v", err)
+	}
+	config := replay.DefaultWriterConfig()
+	config.Compress = shards.compress
+	writer, err := replay.NewWriter(shards.dir, config)
+	if err != nil {
+		log.Fatalf("Failed to create shard writer: %v", err)
+	}
+
+	numExamples, err := selfPlay.GenerateGamesTo(writer, true)
+	if err != nil {
+		log.Fatalf("Failed to write self-play shards: %v", err)
+	}
+	fmt.Printf("Wrote %d shard(s) to %s\n", len(writer.Paths()), shards.dir)
+
+	buffer, err := replay.OpenDir(shards.dir, 0)
+	if err != nil {
+		log.Fatalf("Failed to open replay buffer: %v", err)
+	}
+	return buffer, numExamples
 }
 
 // AlphaGoAgent wraps the AlphaGo-style MCTS + neural network agent
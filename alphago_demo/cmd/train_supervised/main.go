@@ -40,6 +40,8 @@ func main() {
 	patience := flag.Int("patience", 10, "Early stopping patience")
 	outputPrefix := flag.String("output", "supervised", "Output model prefix")
 	dataDir := flag.String("data-dir", "data", "Directory with preprocessed data")
+	optimizer := flag.String("optimizer", "adam", "Mini-batch optimizer: sgd | momentum | adam")
+	workers := flag.Int("workers", 0, "Goroutines computing each batch's gradients (0 = all cores)")
 	flag.Parse()
 
 	// Ensure output directory exists
@@ -59,11 +61,20 @@ func main() {
 	outputSize := 9 // 9 possible move positions
 	network := neural.NewRPSPolicyNetwork(*hiddenSize)
 
+	trainerConfig := neural.DefaultTrainerConfig()
+	opt, err := neural.ParseOptimizer(*optimizer)
+	if err != nil {
+		panic(err)
+	}
+	trainerConfig.Optimizer = opt
+	trainerConfig.Workers = *workers
+	trainer := neural.NewPolicyTrainer(network, trainerConfig)
+
 	// Print network architecture
 	fmt.Printf("Network architecture: Input(%d) -> Hidden(%d) -> Output(%d)\n",
 		inputSize, *hiddenSize, outputSize)
-	fmt.Printf("Training parameters: LR=%.5f, Batch=%d, MaxEpochs=%d\n",
-		*learningRate, *batchSize, *epochs)
+	fmt.Printf("Training parameters: LR=%.5f, Batch=%d, MaxEpochs=%d, Optimizer=%s\n",
+		*learningRate, *batchSize, *epochs, opt)
 
 	// Train the network
 	fmt.Printf("\nTraining network with %d hidden units for up to %d epochs...\n",
@@ -104,8 +115,8 @@ func main() {
 			batchInputs := trainInputs[start:end]
 			batchTargets := trainTargets[start:end]
 
-			// Train on batch - using our custom transformation
-			batchLoss := trainBatch(network, batchInputs, batchTargets, *learningRate)
+			// One optimizer step per batch
+			batchLoss := trainer.Train(batchInputs, batchTargets, *learningRate)
 			trainLoss += batchLoss
 		}
 
@@ -184,16 +195,6 @@ func main() {
 	}
 }
 
-// trainBatch trains the network on a batch of inputs and targets
-func trainBatch(network *neural.RPSPolicyNetwork, inputs, targets [][]float64, learningRate float64) float64 {
-	// Since we can't directly train on raw features, we'll create a custom implementation
-	// that transforms the raw inputs to game states
-
-	// Custom implementation - in a real application we would modify the RPSPolicyNetwork to accept raw inputs
-	// This is a simplified approach for this tutorial
-	return 0.1 // Placeholder - can't actually train on raw features directly in this way
-}
-
 // transformToGame converts raw features to a game state
 func transformToGame(features []float64) *game.RPSGame {
 	g := game.NewRPSGame(21, 5, 10)
@@ -5,6 +5,7 @@ import (
 	"time"
 
 	"github.com/zachbeta/neural_rps/alphago_demo/pkg/analysis"
+	"github.com/zachbeta/neural_rps/alphago_demo/pkg/book"
 	"github.com/zachbeta/neural_rps/alphago_demo/pkg/game"
 )
 
@@ -19,16 +20,19 @@ type MinimaxAgent struct {
 	totalMoveTime      time.Duration
 	moveCount          int
 	verbose            bool
+	book               *book.Book
+	bookHits           int
 }
 
 // NewMinimaxAgent creates a new minimax-based agent
 func NewMinimaxAgent(name string, depth int, timeLimit time.Duration, useCache bool) *MinimaxAgent {
 	// Create minimax engine with StandardEvaluator
 	engine := analysis.NewMinimaxEngine(depth, analysis.StandardEvaluator)
+	engine.PackedEvaluationFn = analysis.PackedStandardEvaluator
 
 	// Enable transposition table if requested
 	if useCache {
-		engine.EnableTranspositionTable()
+		engine.EnableZobristTable(analysis.DefaultZobristTableEntries)
 	}
 
 	// Set time limit for moves (with a default if not specified)
@@ -59,10 +63,38 @@ func (a *MinimaxAgent) SetVerbose(verbose bool) {
 	a.verbose = verbose
 }
 
+// SetSearchThreads sets how many goroutines each search uses. The default is
+// 1, since tournaments and the game server run many agents at once and
+// already occupy every core; raise it for an agent that plays alone.
+func (a *MinimaxAgent) SetSearchThreads(threads int) {
+	a.minimaxEngine.Threads = threads
+}
+
+// SetBook makes the agent play book moves without searching whenever the
+// position is in the book. Pass nil to disable.
+func (a *MinimaxAgent) SetBook(b *book.Book) {
+	a.book = b
+}
+
+// BookHits returns how many moves were played from the book
+func (a *MinimaxAgent) BookHits() int {
+	return a.bookHits
+}
+
 // GetMove returns the best move according to minimax search
 func (a *MinimaxAgent) GetMove(state *game.RPSGame) (game.RPSMove, error) {
 	startTime := time.Now()
 
+	if move, entry, ok := a.book.Probe(state); ok {
+		a.totalMoveTime += time.Since(startTime)
+		a.moveCount++
+		a.bookHits++
+		if a.verbose {
+			fmt.Printf("Book move: %v, value: %.2f, depth: %d\n", move, entry.Value, entry.Depth)
+		}
+		return move, nil
+	}
+
 	// Use iterative deepening with time limit
 	move, value := a.minimaxEngine.FindBestMoveIterative(state.Copy(), a.timeLimit)
 
@@ -103,16 +135,21 @@ func (a *MinimaxAgent) GetStats() (avgTime time.Duration, totalPositions int, av
 	return
 }
 
+// GetDepthStats returns per-depth node counts for the most recent move
+func (a *MinimaxAgent) GetDepthStats() []analysis.DepthStats {
+	return a.minimaxEngine.GetDepthStats()
+}
+
 // ResetStats resets the agent's performance statistics
 func (a *MinimaxAgent) ResetStats() {
 	a.positionsEvaluated = 0
 	a.totalMoveTime = 0
 	a.moveCount = 0
+	a.bookHits = 0
 
 	// Also reset cache stats if using cache
 	if a.useCache {
-		a.minimaxEngine.DisableTranspositionTable()
-		a.minimaxEngine.EnableTranspositionTable()
+		a.minimaxEngine.ZobristTable.Clear()
 	}
 }
 
@@ -116,3 +116,77 @@ func getCardAdvantage(card1, card2 game.RPSCardType) float64 {
 
 	return -1.0
 }
+
+// packedPositionValues are positionalScore's square weights, in board order
+var packedPositionValues = [9]float64{0.7, 0.5, 0.7, 0.5, 1.0, 0.5, 0.7, 0.5, 0.7}
+
+// packedRelationNeighbors[pos] lists the squares relationshipScore compares
+// pos against: right, down, down-right and down-left
+var packedRelationNeighbors = func() [9][]int {
+	var neighbors [9][]int
+	for row := 0; row < 3; row++ {
+		for col := 0; col < 3; col++ {
+			for _, d := range [][2]int{{0, 1}, {1, 0}, {1, 1}, {1, -1}} {
+				r, c := row+d[0], col+d[1]
+				if r >= 0 && r < 3 && c >= 0 && c < 3 {
+					neighbors[row*3+col] = append(neighbors[row*3+col], r*3+c)
+				}
+			}
+		}
+	}
+	return neighbors
+}()
+
+// PackedStandardEvaluator is StandardEvaluator for packed states, for use as
+// MinimaxEngine.PackedEvaluationFn. It returns the same scores.
+func PackedStandardEvaluator(state *game.PackedRPSGame) float64 {
+	if state.IsGameOver() {
+		winner := state.GetWinner()
+		if winner == game.Player1 {
+			return 1000.0
+		} else if winner == game.Player2 {
+			return -1000.0
+		}
+		return 0.0
+	}
+
+	material := float64(state.CountPlayerCards(game.Player1)-state.CountPlayerCards(game.Player2)) * 10.0
+
+	// Owner and card type per square
+	var owner [9]game.RPSPlayer
+	var cardType [9]game.RPSCardType
+	positional := 0.0
+	for pos := 0; pos < 9; pos++ {
+		owner[pos] = state.OwnerAt(pos)
+		for t := range state.Type {
+			if state.Type[t]&(1<<pos) != 0 {
+				cardType[pos] = game.RPSCardType(t)
+			}
+		}
+
+		if owner[pos] == game.Player1 {
+			positional += packedPositionValues[pos]
+		} else if owner[pos] == game.Player2 {
+			positional -= packedPositionValues[pos]
+		}
+	}
+
+	relationship := 0.0
+	for pos := 0; pos < 9; pos++ {
+		if owner[pos] == game.NoPlayer {
+			continue
+		}
+		for _, adj := range packedRelationNeighbors[pos] {
+			if owner[adj] != game.NoPlayer && owner[adj] != owner[pos] {
+				advantage := getCardAdvantage(cardType[pos], cardType[adj])
+				if owner[pos] == game.Player1 {
+					relationship += advantage
+				} else {
+					relationship -= advantage
+				}
+			}
+		}
+	}
+
+	return material*1.0 + positional*5.0*0.5 + relationship*3.0*0.8
+}
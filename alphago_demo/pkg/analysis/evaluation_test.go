@@ -0,0 +1,45 @@
+package analysis
+
+import (
+	"math"
+	"math/rand"
+	"testing"
+
+	"github.com/zachbeta/neural_rps/alphago_demo/pkg/game"
+)
+
+// randomPositions plays n random games and returns every position reached,
+// terminal ones included
+func randomPositions(rng *rand.Rand, games int) []*game.RPSGame {
+	var positions []*game.RPSGame
+	for i := 0; i < games; i++ {
+		g := game.NewRPSGame(21, 5, 10)
+		positions = append(positions, g.Copy())
+		for !g.IsGameOver() {
+			moves := g.GetValidMoves()
+			g.MakeMove(moves[rng.Intn(len(moves))])
+			positions = append(positions, g.Copy())
+		}
+	}
+	return positions
+}
+
+func TestPackedStandardEvaluatorMatchesStandard(t *testing.T) {
+	rng := rand.New(rand.NewSource(1))
+	terminal := 0
+
+	for i, position := range randomPositions(rng, 200) {
+		packed := position.Pack()
+		want := StandardEvaluator(position)
+		if got := PackedStandardEvaluator(&packed); math.Abs(got-want) > 1e-9 {
+			t.Fatalf("Position %d: packed evaluator gives %f, standard %f\n%s", i, got, want, position)
+		}
+		if position.IsGameOver() {
+			terminal++
+		}
+	}
+
+	if terminal == 0 {
+		t.Error("Expected the random games to reach terminal positions")
+	}
+}
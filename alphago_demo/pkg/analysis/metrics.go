@@ -0,0 +1,44 @@
+package analysis
+
+import (
+	"time"
+
+	"github.com/zachbeta/neural_rps/alphago_demo/pkg/metrics"
+)
+
+// Search metrics, shared by every engine in the process. The transposition
+// table hit rate is minimax_tt_hits_total over minimax_tt_probes_total.
+var (
+	nodesTotal = metrics.NewCounter("minimax_nodes_total",
+		"Positions searched by minimax engines")
+	searchSeconds = metrics.NewDurationHistogram("minimax_search_seconds",
+		"Time per minimax search")
+	ttProbesTotal = metrics.NewCounter("minimax_tt_probes_total",
+		"Transposition table lookups made by minimax searches")
+	ttHitsTotal = metrics.NewCounter("minimax_tt_hits_total",
+		"Transposition table lookups that found the position")
+)
+
+// searchRecorder accumulates one search's counts into the shared metrics
+// when it ends, so the search itself touches no shared counters
+type searchRecorder struct {
+	start        time.Time
+	hits, misses int
+}
+
+func (m *MinimaxEngine) startRecording() searchRecorder {
+	hits, misses, _ := m.GetCacheStats()
+	return searchRecorder{start: time.Now(), hits: hits, misses: misses}
+}
+
+func (r searchRecorder) finish(m *MinimaxEngine) {
+	searchSeconds.Since(r.start)
+	nodesTotal.Add(uint64(m.NodesEvaluated))
+
+	// The table may be shared with other engines or cleared, so deltas are
+	// approximate and clamped at zero
+	hits, misses, _ := m.GetCacheStats()
+	hits, misses = max(hits-r.hits, 0), max(misses-r.misses, 0)
+	ttProbesTotal.Add(uint64(hits + misses))
+	ttHitsTotal.Add(uint64(hits))
+}
@@ -15,6 +15,37 @@ type MinimaxEngine struct {
 	StartTime          time.Time
 	EvaluationFn       func(*game.RPSGame) float64
 	TranspositionTable *SimpleTranspositionTable // Added transposition table
+
+	// PackedEvaluationFn, when set, must score positions exactly like
+	// EvaluationFn. It lets the search run in place on a PackedRPSGame with
+	// make/unmake instead of copying an RPSGame at every node.
+	PackedEvaluationFn func(*game.PackedRPSGame) float64
+
+	// ZobristTable caches packed-search results by Zobrist hash. Unlike
+	// TranspositionTable it has a fixed size and stores bound flags, so
+	// entries from pruned subtrees are reused safely.
+	ZobristTable *ZobristTable
+
+	// Threads is the number of goroutines FindBestMove splits the packed
+	// search across. 0 or 1 searches on the calling goroutine. The chosen
+	// move and value do not depend on it.
+	Threads int
+
+	// NoMoveOrdering makes the packed search try moves in generation order,
+	// to measure what move ordering saves. The value found is the same.
+	NoMoveOrdering bool
+
+	timedOut  bool
+	rootDepth int // Depth of the current iteration, to turn depth into ply
+
+	// Move ordering state, see move_ordering.go
+	killers    [maxSearchPly][2]game.PackedMove
+	hasKillers [maxSearchPly][2]bool
+	history    [2][3][9]int32
+	pvMove     game.PackedMove // Best root move of the last completed iteration
+	hasPV      bool
+
+	depthStats []DepthStats
 }
 
 // NewMinimaxEngine creates a new minimax search engine
@@ -29,15 +60,27 @@ func NewMinimaxEngine(maxDepth int, evalFn func(*game.RPSGame) float64) *Minimax
 // EnableTranspositionTable enables caching of positions
 func (m *MinimaxEngine) EnableTranspositionTable() {
 	m.TranspositionTable = NewSimpleTranspositionTable()
+	m.ZobristTable = nil
+}
+
+// EnableZobristTable enables caching of positions in a fixed-size Zobrist
+// table of the given capacity
+func (m *MinimaxEngine) EnableZobristTable(entries int) {
+	m.ZobristTable = NewZobristTable(entries)
+	m.TranspositionTable = nil
 }
 
 // DisableTranspositionTable turns off position caching
 func (m *MinimaxEngine) DisableTranspositionTable() {
 	m.TranspositionTable = nil
+	m.ZobristTable = nil
 }
 
 // GetCacheStats returns statistics about the transposition table if enabled
 func (m *MinimaxEngine) GetCacheStats() (hits int, misses int, hitRate float64) {
+	if m.ZobristTable != nil {
+		return m.ZobristTable.GetStats()
+	}
 	if m.TranspositionTable == nil {
 		return 0, 0, 0.0
 	}
@@ -46,18 +89,48 @@ func (m *MinimaxEngine) GetCacheStats() (hits int, misses int, hitRate float64)
 
 // FindBestMove returns the best move for the current player
 func (m *MinimaxEngine) FindBestMove(state *game.RPSGame) (game.RPSMove, float64) {
+	m.NodesEvaluated = 0
+	m.StartTime = time.Now()
+	m.resetOrdering()
+	defer m.startRecording().finish(m)
+
+	return m.searchToDepth(state, m.MaxDepth)
+}
+
+// searchToDepth runs one fixed-depth search from state. Node counts and move
+// ordering carry over from earlier calls, so iterative deepening can build
+// on previous iterations.
+func (m *MinimaxEngine) searchToDepth(state *game.RPSGame, depth int) (game.RPSMove, float64) {
+	iterationStart := time.Now()
+	nodesBefore := m.NodesEvaluated
+
 	// If we have a transposition table, check it first
 	if m.TranspositionTable != nil {
 		if result, found := m.TranspositionTable.Get(state); found {
 			// Only use cached result if it was searched at sufficient depth
-			if result.Depth >= m.MaxDepth {
+			if result.Depth >= depth {
 				return result.BestMove, result.Value
 			}
 		}
 	}
 
-	m.NodesEvaluated = 0
-	m.StartTime = time.Now()
+	var packed game.PackedRPSGame
+	var hash uint64
+	if m.usePackedSearch() {
+		packed = state.Pack()
+		hash = packed.Hash()
+		if m.ZobristTable != nil {
+			if entry, found := m.ZobristTable.Probe(hash); found && entry.Flag == BoundExact && int(entry.Depth) >= depth {
+				if move, ok := state.UnpackMove(entry.BestMove); ok {
+					m.pvMove, m.hasPV = entry.BestMove, true
+					return move, entry.Value
+				}
+			}
+		}
+	}
+
+	m.timedOut = false
+	m.rootDepth = depth
 
 	// Initialize alpha-beta bounds
 	alpha := math.Inf(-1)
@@ -67,18 +140,37 @@ func (m *MinimaxEngine) FindBestMove(state *game.RPSGame) (game.RPSMove, float64
 	maximizingPlayer := state.CurrentPlayer == game.Player1
 
 	// Call minimax search
-	value, move := m.minimax(state, m.MaxDepth, alpha, beta, maximizingPlayer)
+	var value float64
+	var move game.RPSMove
+	if m.usePackedSearch() {
+		var packedMove game.PackedMove
+		if m.Threads > 1 && depth > 0 && !packed.IsGameOver() {
+			value, packedMove = m.minimaxPackedParallel(&packed, hash, depth, maximizingPlayer)
+		} else {
+			value, packedMove = m.minimaxPacked(&packed, hash, depth, alpha, beta, maximizingPlayer)
+		}
+		if depth > 0 && !packed.IsGameOver() {
+			move, _ = state.UnpackMove(packedMove)
+			if !m.timedOut {
+				m.pvMove, m.hasPV = packedMove, true
+			}
+		}
+	} else {
+		value, move = m.minimax(state, depth, alpha, beta, maximizingPlayer)
+	}
 
 	// Cache the result if transposition table is enabled
 	if m.TranspositionTable != nil {
 		m.TranspositionTable.Put(state, PositionResult{
 			BestMove:      move,
 			Value:         value,
-			Depth:         m.MaxDepth,
-			NodesExplored: m.NodesEvaluated,
+			Depth:         depth,
+			NodesExplored: m.NodesEvaluated - nodesBefore,
 		})
 	}
 
+	m.recordDepthStats(depth, m.NodesEvaluated-nodesBefore, time.Since(iterationStart))
+
 	return move, value
 }
 
@@ -97,6 +189,7 @@ func (m *MinimaxEngine) minimax(state *game.RPSGame, depth int, alpha, beta floa
 
 	// Check for timeout
 	if time.Since(m.StartTime) > m.MaxTime {
+		m.timedOut = true
 		return m.EvaluationFn(state), game.RPSMove{}
 	}
 
@@ -203,11 +296,139 @@ func (m *MinimaxEngine) minimax(state *game.RPSGame, depth int, alpha, beta floa
 	}
 }
 
-// FindBestMoveIterative performs iterative deepening search
+// usePackedSearch reports whether FindBestMove can search on a packed state.
+// The string-keyed transposition table needs full RPSGame positions, so it
+// keeps the copying search.
+func (m *MinimaxEngine) usePackedSearch() bool {
+	return (m.PackedEvaluationFn != nil || m.ZobristTable != nil) && m.TranspositionTable == nil
+}
+
+// zobristMinDepth is the shallowest remaining depth probed in the ZobristTable
+const zobristMinDepth = 2
+
+// evaluatePacked scores a packed state, falling back to EvaluationFn on an
+// unpacked copy when no PackedEvaluationFn is set
+func (m *MinimaxEngine) evaluatePacked(state *game.PackedRPSGame) float64 {
+	if m.PackedEvaluationFn != nil {
+		return m.PackedEvaluationFn(state)
+	}
+	return m.EvaluationFn(state.Unpack())
+}
+
+// minimaxPacked is minimax on a packed state, making and unmaking moves in
+// place. Cards of the same type are interchangeable, so it only tries one
+// move per (square, card type). hash is state's Zobrist hash.
+func (m *MinimaxEngine) minimaxPacked(state *game.PackedRPSGame, hash uint64, depth int, alpha, beta float64, maximizingPlayer bool) (float64, game.PackedMove) {
+	// A stored result is usable if it was searched at least this deep and its
+	// bound is tight enough for the current window. Nodes just above the
+	// leaves are cheaper to search than to look up.
+	useTable := m.ZobristTable != nil && depth >= zobristMinDepth
+	var ttMove game.PackedMove
+	hasTTMove := false
+	if useTable {
+		if entry, found := m.ZobristTable.Probe(hash); found {
+			if int(entry.Depth) >= depth {
+				switch entry.Flag {
+				case BoundExact:
+					return entry.Value, entry.BestMove
+				case BoundLower:
+					alpha = math.Max(alpha, entry.Value)
+				case BoundUpper:
+					beta = math.Min(beta, entry.Value)
+				}
+				if beta <= alpha {
+					return entry.Value, entry.BestMove
+				}
+			}
+			ttMove, hasTTMove = entry.BestMove, true
+		}
+	}
+
+	m.NodesEvaluated++
+
+	// Check for timeout
+	if time.Since(m.StartTime) > m.MaxTime {
+		m.timedOut = true
+		return m.evaluatePacked(state), game.PackedMove{}
+	}
+
+	// Base case: terminal node or max depth reached
+	if depth == 0 || state.IsGameOver() {
+		return m.evaluatePacked(state), game.PackedMove{}
+	}
+
+	var buf [game.MaxPackedMoves]game.PackedMove
+	validMoves := state.AppendMoves(buf[:0])
+	if len(validMoves) == 0 {
+		return m.evaluatePacked(state), game.PackedMove{}
+	}
+
+	ply := m.rootDepth - depth
+	m.orderMoves(state, validMoves, ply, ttMove, hasTTMove)
+
+	origAlpha, origBeta := alpha, beta
+	var bestMove game.PackedMove
+	bestEval := math.Inf(1)
+	if maximizingPlayer {
+		bestEval = math.Inf(-1)
+	}
+
+	for _, move := range validMoves {
+		undo := state.MakeMove(move)
+		eval, _ := m.minimaxPacked(state, state.HashAfter(hash, undo), depth-1, alpha, beta, !maximizingPlayer)
+		state.UnmakeMove(undo)
+
+		if maximizingPlayer {
+			if eval > bestEval {
+				bestEval = eval
+				bestMove = move
+			}
+			alpha = math.Max(alpha, eval)
+		} else {
+			if eval < bestEval {
+				bestEval = eval
+				bestMove = move
+			}
+			beta = math.Min(beta, eval)
+		}
+
+		// Alpha-beta pruning
+		if beta <= alpha {
+			m.recordCutoff(state, move, ply, depth)
+			break
+		}
+	}
+
+	// Results from a timed-out search are unreliable, so they are not stored
+	if useTable && !m.timedOut {
+		flag := BoundExact
+		if bestEval <= origAlpha {
+			flag = BoundUpper
+		} else if bestEval >= origBeta {
+			flag = BoundLower
+		}
+		m.ZobristTable.Store(ZobristEntry{
+			Key:      hash,
+			Value:    bestEval,
+			BestMove: bestMove,
+			Depth:    int16(depth),
+			Flag:     flag,
+		})
+	}
+
+	return bestEval, bestMove
+}
+
+// FindBestMoveIterative performs iterative deepening search. Each iteration
+// orders moves using the previous one's principal variation, killer moves,
+// history scores and (if enabled) the ZobristTable, so the deeper searches
+// prune far more than a cold search would.
 func (m *MinimaxEngine) FindBestMoveIterative(state *game.RPSGame, maxTime time.Duration) (game.RPSMove, float64) {
 	m.NodesEvaluated = 0
 	m.StartTime = time.Now()
 	m.MaxTime = maxTime
+	m.resetOrdering()
+	defer m.startRecording().finish(m)
 
 	var bestMove game.RPSMove
 	var bestValue float64
@@ -219,17 +440,18 @@ func (m *MinimaxEngine) FindBestMoveIterative(state *game.RPSGame, maxTime time.
 			break
 		}
 
-		move, value := m.FindBestMove(state)
+		move, value := m.searchToDepth(state, depth)
 
-		// Keep track of the best move found so far
-		if time.Since(m.StartTime) <= maxTime {
-			bestMove = move
-			bestValue = value
-		} else {
-			// If we timed out during this iteration, the results might be unreliable
+		// If we timed out during this iteration, the results might be
+		// unreliable. The first iteration is kept anyway so there is a move.
+		if m.timedOut && depth > 1 {
 			break
 		}
 
+		// Keep track of the best move found so far
+		bestMove = move
+		bestValue = value
+
 		// If we found a forced win/loss, no need to search deeper
 		if value > 900 || value < -900 {
 			break
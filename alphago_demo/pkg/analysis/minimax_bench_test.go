@@ -0,0 +1,54 @@
+package analysis
+
+import (
+	"fmt"
+	"testing"
+	"time"
+
+	"github.com/zachbeta/neural_rps/alphago_demo/pkg/game"
+)
+
+// benchOpenings returns a fixed set of opening positions, each one move in,
+// so every depth searches the same trees
+func benchOpenings(n int) []*game.RPSGame {
+	positions := make([]*game.RPSGame, n)
+	for i := range positions {
+		g := game.NewRPSGame(21, 5, 10)
+		g.MakeMove(g.GetValidMoves()[i%9])
+		positions[i] = g
+	}
+	return positions
+}
+
+func BenchmarkMinimaxFindBestMove(b *testing.B) {
+	positions := benchOpenings(8)
+	for _, depth := range []int{2, 3, 4} {
+		for _, cache := range []string{"none", "zobrist"} {
+			b.Run(fmt.Sprintf("depth=%d/tt=%s", depth, cache), func(b *testing.B) {
+				engine := NewMinimaxEngine(depth, StandardEvaluator)
+				engine.MaxTime = time.Hour // Fixed depth: never cut short
+				if cache == "zobrist" {
+					engine.EnableZobristTable(1 << 16)
+				}
+				nodes := 0
+				b.ReportAllocs()
+				b.ResetTimer()
+				for i := 0; i < b.N; i++ {
+					if engine.ZobristTable != nil {
+						// Start each search cold, so iterations don't hit
+						// positions cached by earlier ones
+						b.StopTimer()
+						engine.ZobristTable.Clear()
+						b.StartTimer()
+					}
+					engine.FindBestMove(positions[i%len(positions)])
+					nodes += engine.NodesEvaluated
+				}
+				if s := b.Elapsed().Seconds(); s > 0 {
+					b.ReportMetric(float64(nodes)/s, "nodes/sec")
+				}
+				b.ReportMetric(float64(nodes)/float64(b.N), "nodes/op")
+			})
+		}
+	}
+}
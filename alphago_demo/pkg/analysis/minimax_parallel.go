@@ -0,0 +1,141 @@
+package analysis
+
+import (
+	"math"
+	"sync"
+	"sync/atomic"
+
+	"github.com/zachbeta/neural_rps/alphago_demo/pkg/game"
+)
+
+// rootBest is the best root move found so far by a parallel search
+type rootBest struct {
+	mu    sync.Mutex
+	value float64
+	index int // Index into the root move list, -1 until a move is scored
+	move  game.PackedMove
+}
+
+// minimaxPackedParallel splits a packed search across m.Threads workers at
+// the root. The first move is searched alone to establish a bound, then the
+// workers take the remaining moves in order, each narrowing its window with
+// the best value found so far. They share the ZobristTable, if any.
+//
+// The result is the same as minimaxPacked's: a move only replaces the current
+// best if it scores strictly better, or equal with a lower index, and moves
+// ahead of the current best are searched with a window just below its value
+// so a tie with them is resolved exactly rather than as a bound.
+func (m *MinimaxEngine) minimaxPackedParallel(state *game.PackedRPSGame, hash uint64, depth int, maximizingPlayer bool) (float64, game.PackedMove) {
+	var ttMove game.PackedMove
+	hasTTMove := false
+	if m.ZobristTable != nil && depth >= zobristMinDepth {
+		if entry, found := m.ZobristTable.Probe(hash); found {
+			if entry.Flag == BoundExact && int(entry.Depth) >= depth {
+				return entry.Value, entry.BestMove
+			}
+			ttMove, hasTTMove = entry.BestMove, true
+		}
+	}
+
+	m.NodesEvaluated++
+
+	var buf [game.MaxPackedMoves]game.PackedMove
+	moves := state.AppendMoves(buf[:0])
+	m.orderMoves(state, moves, 0, ttMove, hasTTMove)
+
+	best := &rootBest{value: math.Inf(1), index: -1}
+	if maximizingPlayer {
+		best.value = math.Inf(-1)
+	}
+
+	workers := make([]*MinimaxEngine, min(m.Threads, len(moves)))
+	for i := range workers {
+		worker := *m
+		worker.NodesEvaluated = 0
+		workers[i] = &worker
+	}
+
+	workers[0].searchRootMove(*state, hash, depth, moves, 0, maximizingPlayer, best)
+
+	var next atomic.Int64
+	next.Store(1)
+	var wg sync.WaitGroup
+	for _, worker := range workers {
+		wg.Add(1)
+		go func(worker *MinimaxEngine) {
+			defer wg.Done()
+			for {
+				i := int(next.Add(1) - 1)
+				if i >= len(moves) {
+					return
+				}
+				worker.searchRootMove(*state, hash, depth, moves, i, maximizingPlayer, best)
+			}
+		}(worker)
+	}
+	wg.Wait()
+
+	for _, worker := range workers {
+		m.NodesEvaluated += worker.NodesEvaluated
+		m.timedOut = m.timedOut || worker.timedOut
+	}
+
+	if best.index < 0 {
+		return best.value, game.PackedMove{}
+	}
+
+	if m.ZobristTable != nil && !m.timedOut {
+		m.ZobristTable.Store(ZobristEntry{
+			Key:      hash,
+			Value:    best.value,
+			BestMove: best.move,
+			Depth:    int16(depth),
+			Flag:     BoundExact,
+		})
+	}
+
+	return best.value, best.move
+}
+
+// searchRootMove scores moves[i] on the worker's own copy of the root state
+// and records it in best if it is exactly better than the current best
+func (m *MinimaxEngine) searchRootMove(state game.PackedRPSGame, hash uint64, depth int, moves []game.PackedMove, i int, maximizingPlayer bool, best *rootBest) {
+	best.mu.Lock()
+	bestValue, bestIndex := best.value, best.index
+	best.mu.Unlock()
+
+	alpha, beta := math.Inf(-1), math.Inf(1)
+	if bestIndex >= 0 {
+		bound := bestValue
+		if maximizingPlayer {
+			if i < bestIndex {
+				bound = math.Nextafter(bestValue, math.Inf(-1))
+			}
+			alpha = bound
+		} else {
+			if i < bestIndex {
+				bound = math.Nextafter(bestValue, math.Inf(1))
+			}
+			beta = bound
+		}
+	}
+
+	undo := state.MakeMove(moves[i])
+	eval, _ := m.minimaxPacked(&state, state.HashAfter(hash, undo), depth-1, alpha, beta, !maximizingPlayer)
+
+	// A value outside the window is only a bound, and no better than the
+	// current best
+	if (maximizingPlayer && eval <= alpha) || (!maximizingPlayer && eval >= beta) {
+		return
+	}
+
+	best.mu.Lock()
+	defer best.mu.Unlock()
+	better := eval > best.value
+	if !maximizingPlayer {
+		better = eval < best.value
+	}
+	if best.index < 0 || better || (eval == best.value && i < best.index) {
+		best.value, best.index, best.move = eval, i, moves[i]
+	}
+}
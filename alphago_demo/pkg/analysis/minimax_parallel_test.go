@@ -0,0 +1,37 @@
+package analysis
+
+import (
+	"math"
+	"math/rand"
+	"testing"
+)
+
+func TestParallelSearchMatchesSerial(t *testing.T) {
+	rng := rand.New(rand.NewSource(3))
+
+	for i, position := range searchPositions(rng, 6) {
+		for depth := 2; depth <= 4; depth++ {
+			for _, table := range []bool{false, true} {
+				serial := newPackedEngine(depth)
+				if table {
+					serial.EnableZobristTable(1 << 14)
+				}
+				wantMove, wantValue := serial.FindBestMove(position)
+
+				for _, threads := range []int{2, 4, 7} {
+					parallel := newPackedEngine(depth)
+					parallel.Threads = threads
+					if table {
+						parallel.EnableZobristTable(1 << 14)
+					}
+
+					move, value := parallel.FindBestMove(position)
+					if move != wantMove || math.Abs(value-wantValue) > 1e-9 {
+						t.Errorf("Position %d depth %d table=%v threads=%d: got %+v (%f), serial search %+v (%f)",
+							i, depth, table, threads, move, value, wantMove, wantValue)
+					}
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,138 @@
+package analysis
+
+import (
+	"math/bits"
+	"time"
+
+	"github.com/zachbeta/neural_rps/alphago_demo/pkg/game"
+)
+
+// maxSearchPly bounds the plies tracked by the killer table. A game fills
+// the 9 squares long before this.
+const maxSearchPly = 32
+
+// Move ordering priorities, highest first. Moves in the same class keep
+// generation order, so ordering is deterministic.
+const (
+	orderHashMove   = 1 << 30 // Table or principal-variation move
+	orderCapture    = 1 << 24 // Per card captured
+	orderKiller     = 1 << 22 // First killer; the second gets half
+	maxHistoryScore = 1 << 20
+)
+
+// DepthStats describes one completed iteration of a search
+type DepthStats struct {
+	Depth   int
+	Nodes   int
+	Elapsed time.Duration
+
+	// BranchingFactor is Nodes divided by the previous iteration's Nodes,
+	// the effective branching factor. It is 0 for the first iteration.
+	BranchingFactor float64
+}
+
+// GetDepthStats returns per-iteration node counts for the last
+// FindBestMove or FindBestMoveIterative call
+func (m *MinimaxEngine) GetDepthStats() []DepthStats {
+	return append([]DepthStats(nil), m.depthStats...)
+}
+
+func (m *MinimaxEngine) recordDepthStats(depth, nodes int, elapsed time.Duration) {
+	stats := DepthStats{Depth: depth, Nodes: nodes, Elapsed: elapsed}
+	if n := len(m.depthStats); n > 0 && m.depthStats[n-1].Nodes > 0 {
+		stats.BranchingFactor = float64(nodes) / float64(m.depthStats[n-1].Nodes)
+	}
+	m.depthStats = append(m.depthStats, stats)
+}
+
+// resetOrdering forgets killers, history and the principal variation before
+// searching a new position
+func (m *MinimaxEngine) resetOrdering() {
+	m.killers = [maxSearchPly][2]game.PackedMove{}
+	m.hasKillers = [maxSearchPly][2]bool{}
+	m.history = [2][3][9]int32{}
+	m.hasPV = false
+	m.depthStats = m.depthStats[:0]
+}
+
+// orderMoves sorts moves best-first: the table move (or, at the root, the
+// previous iteration's best move), then captures by number of cards taken,
+// then killer moves, then by history score. The root only uses the first two
+// so the root order, and thus tie-breaking, does not depend on what earlier
+// searches happened to visit.
+func (m *MinimaxEngine) orderMoves(state *game.PackedRPSGame, moves []game.PackedMove, ply int, hashMove game.PackedMove, hasHashMove bool) {
+	if m.NoMoveOrdering {
+		return
+	}
+	if ply == 0 && !hasHashMove && m.hasPV {
+		hashMove, hasHashMove = m.pvMove, true
+	}
+
+	var scores [game.MaxPackedMoves]int32
+	for i, move := range moves {
+		score := int32(0)
+		if hasHashMove && move == hashMove {
+			score = orderHashMove
+		} else if captures := captureCount(state, move); captures > 0 {
+			score = int32(captures) * orderCapture
+		} else if ply > 0 {
+			score = m.quietScore(state, move, ply)
+		}
+		scores[i] = score
+	}
+
+	// Insertion sort: stable, and move lists are short
+	for i := 1; i < len(moves); i++ {
+		move, score := moves[i], scores[i]
+		j := i
+		for ; j > 0 && scores[j-1] < score; j-- {
+			moves[j], scores[j] = moves[j-1], scores[j-1]
+		}
+		moves[j], scores[j] = move, score
+	}
+}
+
+// quietScore ranks a non-capturing move by the killer and history tables
+func (m *MinimaxEngine) quietScore(state *game.PackedRPSGame, move game.PackedMove, ply int) int32 {
+	if ply < maxSearchPly {
+		if m.hasKillers[ply][0] && m.killers[ply][0] == move {
+			return orderKiller
+		}
+		if m.hasKillers[ply][1] && m.killers[ply][1] == move {
+			return orderKiller / 2
+		}
+	}
+	return m.history[state.ToMove][move.Card][move.Position]
+}
+
+// recordCutoff updates the killer and history tables after move caused a
+// beta cutoff. Captures are already ordered first, so only quiet moves are
+// recorded.
+func (m *MinimaxEngine) recordCutoff(state *game.PackedRPSGame, move game.PackedMove, ply, depth int) {
+	if captureCount(state, move) > 0 {
+		return
+	}
+
+	if ply < maxSearchPly && !(m.hasKillers[ply][0] && m.killers[ply][0] == move) {
+		m.killers[ply][1], m.hasKillers[ply][1] = m.killers[ply][0], m.hasKillers[ply][0]
+		m.killers[ply][0], m.hasKillers[ply][0] = move, true
+	}
+
+	h := &m.history[state.ToMove][move.Card][move.Position]
+	*h += int32(depth * depth)
+	if *h >= maxHistoryScore {
+		// Age every entry so scores stay below the killer range
+		for p := range m.history {
+			for t := range m.history[p] {
+				for sq := range m.history[p][t] {
+					m.history[p][t][sq] /= 2
+				}
+			}
+		}
+	}
+}
+
+// captureCount returns how many cards move would capture
+func captureCount(state *game.PackedRPSGame, move game.PackedMove) int {
+	return bits.OnesCount16(state.CaptureMask(move))
+}
@@ -0,0 +1,201 @@
+package analysis
+
+import (
+	"math"
+	"math/rand"
+	"testing"
+	"time"
+
+	"github.com/zachbeta/neural_rps/alphago_demo/pkg/game"
+)
+
+// capturePosition returns a position where some moves capture and some
+// don't, with its moves in generation order
+func capturePosition(t *testing.T) (game.PackedRPSGame, []game.PackedMove) {
+	rng := rand.New(rand.NewSource(4))
+	for attempt := 0; attempt < 1000; attempt++ {
+		g := game.NewRPSGame(21, 5, 10)
+		for moves := 1 + rng.Intn(4); moves > 0 && !g.IsGameOver(); moves-- {
+			valid := g.GetValidMoves()
+			g.MakeMove(valid[rng.Intn(len(valid))])
+		}
+		p := g.Pack()
+
+		var buf [game.MaxPackedMoves]game.PackedMove
+		moves := p.AppendMoves(buf[:0])
+		captures := 0
+		for _, move := range moves {
+			if captureCount(&p, move) > 0 {
+				captures++
+			}
+		}
+		if captures > 0 && captures < len(moves)-2 {
+			return p, append([]game.PackedMove(nil), moves...)
+		}
+	}
+	t.Fatal("No position with both captures and quiet moves found")
+	return game.PackedRPSGame{}, nil
+}
+
+func TestOrderMovesPriorities(t *testing.T) {
+	state, generated := capturePosition(t)
+	var quiet []game.PackedMove
+	for _, move := range generated {
+		if captureCount(&state, move) == 0 {
+			quiet = append(quiet, move)
+		}
+	}
+	hashMove := quiet[len(quiet)-1]
+	killer, historyMove := quiet[len(quiet)-2], quiet[len(quiet)-3]
+
+	m := newPackedEngine(4)
+	const ply = 2
+	m.killers[ply][0], m.hasKillers[ply][0] = killer, true
+	m.history[state.ToMove][historyMove.Card][historyMove.Position] = 7
+
+	moves := append([]game.PackedMove(nil), generated...)
+	m.orderMoves(&state, moves, ply, hashMove, true)
+
+	if moves[0] != hashMove {
+		t.Fatalf("Expected the hash move first, got %+v", moves[0])
+	}
+	i := 1
+	for ; i < len(moves) && captureCount(&state, moves[i]) > 0; i++ {
+		if i > 1 && captureCount(&state, moves[i]) > captureCount(&state, moves[i-1]) {
+			t.Errorf("Expected captures ordered by cards taken, %+v before %+v", moves[i-1], moves[i])
+		}
+	}
+	if i == 1 {
+		t.Fatal("Expected captures right after the hash move")
+	}
+	if moves[i] != killer || moves[i+1] != historyMove {
+		t.Fatalf("Expected the killer then the history move after the captures, got %+v and %+v", moves[i], moves[i+1])
+	}
+
+	// The remaining quiet moves keep generation order
+	var rest []game.PackedMove
+	for _, move := range generated {
+		if captureCount(&state, move) == 0 && move != hashMove && move != killer && move != historyMove {
+			rest = append(rest, move)
+		}
+	}
+	for j, move := range moves[i+2:] {
+		if move != rest[j] {
+			t.Fatalf("Expected unscored moves to keep generation order, got %+v at %d, expected %+v", move, j, rest[j])
+		}
+	}
+
+	// The root ignores killers and history, so its order does not depend on
+	// earlier searches
+	root := append([]game.PackedMove(nil), generated...)
+	m.orderMoves(&state, root, 0, game.PackedMove{}, false)
+	for j := range root {
+		if captureCount(&state, root[j]) == 0 {
+			if root[j] != quiet[0] {
+				t.Errorf("Expected the first quiet root move to be %+v, got %+v", quiet[0], root[j])
+			}
+			break
+		}
+	}
+}
+
+func TestRecordCutoff(t *testing.T) {
+	state, generated := capturePosition(t)
+	var quiet []game.PackedMove
+	var capture game.PackedMove
+	for _, move := range generated {
+		if captureCount(&state, move) == 0 {
+			quiet = append(quiet, move)
+		} else {
+			capture = move
+		}
+	}
+
+	m := newPackedEngine(4)
+	const ply = 1
+	a, b := quiet[0], quiet[1]
+
+	// Killers shift down, and repeating the first killer doesn't evict the second
+	m.recordCutoff(&state, a, ply, 3)
+	m.recordCutoff(&state, b, ply, 3)
+	m.recordCutoff(&state, b, ply, 3)
+	if m.killers[ply][0] != b || m.killers[ply][1] != a || !m.hasKillers[ply][1] {
+		t.Errorf("Expected killers [b a], got %+v", m.killers[ply])
+	}
+	if got := m.history[state.ToMove][b.Card][b.Position]; got != 2*3*3 {
+		t.Errorf("Expected history to grow by depth squared, got %d", got)
+	}
+
+	// Captures are ordered first anyway, so they aren't recorded
+	m.recordCutoff(&state, capture, ply, 3)
+	if m.killers[ply][0] == capture || m.history[state.ToMove][capture.Card][capture.Position] != 0 {
+		t.Errorf("Expected a capture cutoff not to be recorded")
+	}
+
+	// History ages before it can reach the killer range
+	m.history[state.ToMove][a.Card][a.Position] = maxHistoryScore - 1
+	m.recordCutoff(&state, a, ply, 2)
+	if got := m.history[state.ToMove][a.Card][a.Position]; got >= maxHistoryScore || got < maxHistoryScore/2-1 {
+		t.Errorf("Expected history to be halved once it reaches %d, got %d", maxHistoryScore, got)
+	}
+	if got := m.history[state.ToMove][b.Card][b.Position]; got != 2*3*3/2 {
+		t.Errorf("Expected aging to halve every entry, got %d", got)
+	}
+}
+
+func TestPVMoveReuse(t *testing.T) {
+	position := searchPositions(rand.New(rand.NewSource(5)), 1)[0]
+	m := newPackedEngine(4)
+
+	move, _ := m.FindBestMoveIterative(position, time.Hour)
+	if !m.hasPV || m.pvMove != position.PackMove(move) {
+		t.Fatalf("Expected the last iteration's best move %+v to be kept as the PV move, got %+v", move, m.pvMove)
+	}
+
+	// The next iteration searches it first at the root
+	state := position.Pack()
+	var buf [game.MaxPackedMoves]game.PackedMove
+	moves := state.AppendMoves(buf[:0])
+	m.orderMoves(&state, moves, 0, game.PackedMove{}, false)
+	if moves[0] != m.pvMove {
+		t.Errorf("Expected the PV move first at the root, got %+v", moves[0])
+	}
+
+	if stats := m.GetDepthStats(); len(stats) != 4 || stats[3].Depth != 4 {
+		t.Errorf("Expected stats for depths 1 to 4, got %+v", stats)
+	}
+}
+
+func TestSearchResultIndependentOfOrdering(t *testing.T) {
+	rng := rand.New(rand.NewSource(6))
+
+	for i, position := range searchPositions(rng, 6) {
+		for depth := 1; depth <= 4; depth++ {
+			unordered := newPackedEngine(depth)
+			unordered.NoMoveOrdering = true
+			_, want := unordered.FindBestMove(position)
+
+			ordered := newPackedEngine(depth)
+			move, value := ordered.FindBestMove(position)
+			if math.Abs(value-want) > 1e-9 {
+				t.Errorf("Position %d depth %d: ordered search value %f, unordered %f", i, depth, value, want)
+			}
+
+			// The move may differ between equally good ones, but it must be
+			// worth the value found
+			child := position.Copy()
+			if err := child.MakeMove(move); err != nil {
+				t.Fatalf("Position %d depth %d: invalid move %+v: %v", i, depth, move, err)
+			}
+			_, childValue := newPackedEngine(depth - 1).FindBestMove(child)
+			if math.Abs(childValue-want) > 1e-9 {
+				t.Errorf("Position %d depth %d: ordered move is worth %f, expected %f", i, depth, childValue, want)
+			}
+
+			iterative := newPackedEngine(depth)
+			if _, value := iterative.FindBestMoveIterative(position, time.Hour); math.Abs(value-want) > 1e-9 {
+				t.Errorf("Position %d depth %d: iterative deepening value %f, unordered %f", i, depth, value, want)
+			}
+		}
+	}
+}
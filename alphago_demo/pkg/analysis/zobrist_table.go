@@ -0,0 +1,169 @@
+package analysis
+
+import (
+	"sync"
+	"sync/atomic"
+
+	"github.com/zachbeta/neural_rps/alphago_demo/pkg/game"
+)
+
+// DefaultZobristTableEntries is the capacity used by MinimaxAgent (~3 MB)
+const DefaultZobristTableEntries = 1 << 17
+
+// zobristStripes is the number of locks guarding the table. Each bucket maps
+// to one stripe, so concurrent searches rarely contend.
+const zobristStripes = 1024
+
+// BoundFlag records how a stored value relates to the true minimax value
+type BoundFlag uint8
+
+const (
+	boundNone  BoundFlag = iota // Empty entry
+	BoundExact                  // Value is exact
+	BoundLower                  // Search failed high: true value >= Value
+	BoundUpper                  // Search failed low: true value <= Value
+)
+
+// ZobristEntry is one transposition table record
+type ZobristEntry struct {
+	Key      uint64
+	Value    float64
+	BestMove game.PackedMove
+	Depth    int16
+	Flag     BoundFlag
+}
+
+// zobristBucket pairs a depth-preferred slot, which is only replaced by an
+// equal or deeper search of any position, with an always-replace slot that
+// takes everything else, including the entry a deeper search displaces
+type zobristBucket struct {
+	deep   ZobristEntry
+	recent ZobristEntry
+}
+
+// ZobristTable is a fixed-capacity transposition table keyed by
+// PackedRPSGame.Hash. It is safe for concurrent use.
+type ZobristTable struct {
+	buckets []zobristBucket
+	mask    uint64
+	locks   [zobristStripes]sync.Mutex
+
+	hits   atomic.Int64
+	misses atomic.Int64
+	stores atomic.Int64
+	filled atomic.Int64
+}
+
+// NewZobristTable creates a table holding at least entries records, rounded
+// up to a power of two
+func NewZobristTable(entries int) *ZobristTable {
+	buckets := 1
+	for buckets*2 < entries {
+		buckets <<= 1
+	}
+	return &ZobristTable{
+		buckets: make([]zobristBucket, buckets),
+		mask:    uint64(buckets - 1),
+	}
+}
+
+// Probe looks up a position by hash
+func (t *ZobristTable) Probe(key uint64) (ZobristEntry, bool) {
+	idx := key & t.mask
+	lock := &t.locks[idx%zobristStripes]
+
+	lock.Lock()
+	b := &t.buckets[idx]
+	var entry ZobristEntry
+	found := false
+	if b.deep.Flag != boundNone && b.deep.Key == key {
+		entry, found = b.deep, true
+	} else if b.recent.Flag != boundNone && b.recent.Key == key {
+		entry, found = b.recent, true
+	}
+	lock.Unlock()
+
+	if found {
+		t.hits.Add(1)
+	} else {
+		t.misses.Add(1)
+	}
+	return entry, found
+}
+
+// Store records a search result. Entry.Flag must not be zero.
+func (t *ZobristTable) Store(entry ZobristEntry) {
+	idx := entry.Key & t.mask
+	lock := &t.locks[idx%zobristStripes]
+
+	lock.Lock()
+	b := &t.buckets[idx]
+	filled := false
+	switch {
+	case b.deep.Flag == boundNone || b.deep.Key == entry.Key:
+		filled = b.deep.Flag == boundNone
+		b.deep = entry
+	case entry.Depth >= b.deep.Depth:
+		// Demote the displaced entry rather than dropping it: it is still
+		// the deepest result for its position
+		filled = b.recent.Flag == boundNone
+		b.recent, b.deep = b.deep, entry
+	default:
+		filled = b.recent.Flag == boundNone
+		b.recent = entry
+	}
+	lock.Unlock()
+
+	t.stores.Add(1)
+	if filled {
+		t.filled.Add(1)
+	}
+}
+
+// GetStats returns hits, misses and hit rate (percent), like
+// SimpleTranspositionTable.GetStats
+func (t *ZobristTable) GetStats() (int, int, float64) {
+	hits := int(t.hits.Load())
+	misses := int(t.misses.Load())
+
+	total := hits + misses
+	hitRate := 0.0
+	if total > 0 {
+		hitRate = float64(hits) / float64(total) * 100.0
+	}
+
+	return hits, misses, hitRate
+}
+
+// Stores returns the number of Store calls since the last Clear
+func (t *ZobristTable) Stores() int {
+	return int(t.stores.Load())
+}
+
+// Size returns the number of occupied entries
+func (t *ZobristTable) Size() int {
+	return int(t.filled.Load())
+}
+
+// Capacity returns the maximum number of entries
+func (t *ZobristTable) Capacity() int {
+	return len(t.buckets) * 2
+}
+
+// Clear empties the table and resets its statistics
+func (t *ZobristTable) Clear() {
+	for i := range t.locks {
+		t.locks[i].Lock()
+	}
+	for i := range t.buckets {
+		t.buckets[i] = zobristBucket{}
+	}
+	for i := range t.locks {
+		t.locks[i].Unlock()
+	}
+
+	t.hits.Store(0)
+	t.misses.Store(0)
+	t.stores.Store(0)
+	t.filled.Store(0)
+}
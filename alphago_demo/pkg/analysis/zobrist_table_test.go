@@ -0,0 +1,214 @@
+package analysis
+
+import (
+	"math"
+	"math/rand"
+	"testing"
+	"time"
+
+	"github.com/zachbeta/neural_rps/alphago_demo/pkg/game"
+)
+
+func TestZobristTableProbeStore(t *testing.T) {
+	table := NewZobristTable(64)
+	if table.Capacity() != 64 {
+		t.Fatalf("Expected capacity 64, got %d", table.Capacity())
+	}
+
+	if _, found := table.Probe(42); found {
+		t.Fatal("Expected an empty table to miss")
+	}
+
+	want := ZobristEntry{Key: 42, Value: 1.5, BestMove: game.PackedMove{Position: 4, Card: game.Paper}, Depth: 3, Flag: BoundLower}
+	table.Store(want)
+	if got, found := table.Probe(42); !found || got != want {
+		t.Fatalf("Expected to probe back %+v, got %+v (found %v)", want, got, found)
+	}
+
+	// A newer result for the same position replaces the old one, even if
+	// it is shallower
+	want.Depth, want.Flag = 1, BoundExact
+	table.Store(want)
+	if got, _ := table.Probe(42); got != want {
+		t.Errorf("Expected the same position to be overwritten, got %+v", got)
+	}
+	if table.Size() != 1 {
+		t.Errorf("Expected one occupied entry, got %d", table.Size())
+	}
+
+	hits, misses, _ := table.GetStats()
+	if hits != 2 || misses != 1 {
+		t.Errorf("Expected 2 hits and 1 miss, got %d and %d", hits, misses)
+	}
+
+	table.Clear()
+	if _, found := table.Probe(42); found || table.Size() != 0 || table.Stores() != 0 {
+		t.Errorf("Expected Clear to empty the table and reset its stats")
+	}
+}
+
+func TestZobristTableReplacement(t *testing.T) {
+	table := NewZobristTable(64)
+	buckets := uint64(len(table.buckets))
+
+	// Keys that map to the same bucket
+	a, b, c := uint64(7), 7+buckets, 7+2*buckets
+	entry := func(key uint64, depth int16) ZobristEntry {
+		return ZobristEntry{Key: key, Value: float64(depth), Depth: depth, Flag: BoundExact}
+	}
+	probeDepth := func(key uint64) int16 {
+		e, found := table.Probe(key)
+		if !found {
+			return -1
+		}
+		return e.Depth
+	}
+
+	// A shallower search of another position takes the always-replace slot
+	table.Store(entry(a, 5))
+	table.Store(entry(b, 3))
+	if probeDepth(a) != 5 || probeDepth(b) != 3 {
+		t.Fatalf("Expected both entries to be kept, got depths %d and %d", probeDepth(a), probeDepth(b))
+	}
+
+	// Another shallow one evicts the always-replace slot only
+	table.Store(entry(c, 2))
+	if probeDepth(a) != 5 || probeDepth(b) != -1 || probeDepth(c) != 2 {
+		t.Fatalf("Expected c to replace b, got depths a=%d b=%d c=%d", probeDepth(a), probeDepth(b), probeDepth(c))
+	}
+
+	// A deeper search takes the depth-preferred slot and demotes its
+	// previous occupant instead of dropping it
+	table.Store(entry(b, 6))
+	if probeDepth(b) != 6 || probeDepth(a) != 5 || probeDepth(c) != -1 {
+		t.Fatalf("Expected b to displace a into the always-replace slot, got depths a=%d b=%d c=%d",
+			probeDepth(a), probeDepth(b), probeDepth(c))
+	}
+	if table.buckets[7].deep.Key != b || table.buckets[7].recent.Key != a {
+		t.Errorf("Expected deep=b and recent=a, got deep=%d recent=%d", table.buckets[7].deep.Key, table.buckets[7].recent.Key)
+	}
+	if table.Size() != 2 {
+		t.Errorf("Expected 2 occupied entries, got %d", table.Size())
+	}
+}
+
+// newPackedEngine returns a fixed-depth engine that searches packed states
+func newPackedEngine(depth int) *MinimaxEngine {
+	engine := NewMinimaxEngine(depth, StandardEvaluator)
+	engine.PackedEvaluationFn = PackedStandardEvaluator
+	engine.MaxTime = time.Hour
+	return engine
+}
+
+// searchPositions returns a few positions a handful of moves into random
+// games, where the search trees are small enough to search exhaustively
+func searchPositions(rng *rand.Rand, n int) []*game.RPSGame {
+	var positions []*game.RPSGame
+	for len(positions) < n {
+		g := game.NewRPSGame(21, 5, 10)
+		for moves := 2 + rng.Intn(3); moves > 0 && !g.IsGameOver(); moves-- {
+			valid := g.GetValidMoves()
+			g.MakeMove(valid[rng.Intn(len(valid))])
+		}
+		if !g.IsGameOver() {
+			positions = append(positions, g)
+		}
+	}
+	return positions
+}
+
+func TestPackedSearchMatchesCopySearch(t *testing.T) {
+	rng := rand.New(rand.NewSource(1))
+
+	for i, position := range searchPositions(rng, 6) {
+		for depth := 1; depth <= 3; depth++ {
+			copying := NewMinimaxEngine(depth, StandardEvaluator)
+			copying.MaxTime = time.Hour
+			_, want := copying.FindBestMove(position)
+
+			packed := newPackedEngine(depth)
+			withTable := newPackedEngine(depth)
+			withTable.EnableZobristTable(1 << 12)
+
+			for name, engine := range map[string]*MinimaxEngine{"packed": packed, "zobrist": withTable} {
+				move, value := engine.FindBestMove(position)
+				if math.Abs(value-want) > 1e-9 {
+					t.Errorf("Position %d depth %d: %s search value %f, copying search %f", i, depth, name, value, want)
+				}
+				if err := position.Copy().MakeMove(move); err != nil {
+					t.Errorf("Position %d depth %d: %s search chose an invalid move %+v: %v", i, depth, name, move, err)
+				}
+			}
+		}
+	}
+}
+
+// TestZobristBoundFlags checks every entry a search leaves in the table
+// against an exhaustive search of its position: exact entries must hold the
+// true value, lower bounds must not exceed it and upper bounds must not be
+// below it
+func TestZobristBoundFlags(t *testing.T) {
+	rng := rand.New(rand.NewSource(2))
+	const depth = 4
+	checked := map[BoundFlag]int{}
+
+	for _, position := range searchPositions(rng, 4) {
+		engine := newPackedEngine(depth)
+		engine.EnableZobristTable(1 << 16)
+		engine.FindBestMove(position)
+
+		// Every position the search could have stored, by hash
+		reachable := map[uint64]game.PackedRPSGame{}
+		var walk func(p *game.PackedRPSGame, hash uint64, remaining int)
+		walk = func(p *game.PackedRPSGame, hash uint64, remaining int) {
+			reachable[hash] = *p
+			if remaining < zobristMinDepth || p.IsGameOver() {
+				return
+			}
+			var buf [game.MaxPackedMoves]game.PackedMove
+			for _, move := range p.AppendMoves(buf[:0]) {
+				undo := p.MakeMove(move)
+				walk(p, p.HashAfter(hash, undo), remaining-1)
+				p.UnmakeMove(undo)
+			}
+		}
+		root := position.Pack()
+		walk(&root, root.Hash(), depth)
+
+		exact := newPackedEngine(depth)
+		exact.StartTime = time.Now()
+		for _, bucket := range engine.ZobristTable.buckets {
+			for _, entry := range []ZobristEntry{bucket.deep, bucket.recent} {
+				state, ok := reachable[entry.Key]
+				if entry.Flag == boundNone || !ok {
+					continue
+				}
+
+				exact.rootDepth = int(entry.Depth)
+				truth, _ := exact.minimaxPacked(&state, entry.Key, int(entry.Depth), math.Inf(-1), math.Inf(1), state.CurrentPlayer() == game.Player1)
+
+				switch entry.Flag {
+				case BoundExact:
+					if math.Abs(entry.Value-truth) > 1e-9 {
+						t.Fatalf("Exact entry holds %f, true value at depth %d is %f", entry.Value, entry.Depth, truth)
+					}
+				case BoundLower:
+					if truth < entry.Value-1e-9 {
+						t.Fatalf("Lower bound %f exceeds the true value %f", entry.Value, truth)
+					}
+				case BoundUpper:
+					if truth > entry.Value+1e-9 {
+						t.Fatalf("Upper bound %f is below the true value %f", entry.Value, truth)
+					}
+				}
+				checked[entry.Flag]++
+			}
+		}
+	}
+
+	for _, flag := range []BoundFlag{BoundExact, BoundLower, BoundUpper} {
+		if checked[flag] == 0 {
+			t.Errorf("Expected the searches to store entries with flag %d", flag)
+		}
+	}
+}
@@ -0,0 +1,214 @@
+// Package book stores precomputed minimax results for RPS card game
+// positions in a compact binary file that is memory-mapped at startup, so
+// agents can skip searching positions that were solved ahead of time.
+package book
+
+import (
+	"bufio"
+	"encoding/binary"
+	"errors"
+	"fmt"
+	"math"
+	"os"
+	"sort"
+
+	"github.com/zachbeta/neural_rps/alphago_demo/pkg/game"
+	"github.com/zachbeta/neural_rps/alphago_demo/pkg/internal/mmapfile"
+)
+
+// File layout, little-endian:
+//
+//	header (32 bytes): magic "RPSBOOK\x00", version u32, entry size u32,
+//	                   entry count u64, max rounds u32, reserved u32
+//	entries (16 bytes each, sorted by key):
+//	                   key u64, value f32, position u8, card u8, depth u8, flags u8
+const (
+	magic      = "RPSBOOK\x00"
+	version    = 1
+	headerSize = 32
+	entrySize  = 16
+)
+
+// FlagSolved marks an entry whose search reached the end of every line, so
+// its value is exact rather than a depth-limited estimate
+const FlagSolved uint8 = 1
+
+// Entry is one book position
+type Entry struct {
+	Key   uint64 // game.PackedRPSGame.Hash of the position
+	Value float32
+	Move  game.PackedMove
+	Depth uint8
+	Flags uint8
+}
+
+// Book is a read-only, memory-mapped position book. It is safe for
+// concurrent use.
+type Book struct {
+	data      []byte
+	entries   []byte
+	count     int
+	maxRounds int
+	unmap     func() error
+}
+
+// Open memory-maps a book file
+func Open(path string) (*Book, error) {
+	data, unmap, err := mmapfile.Map(path, false)
+	if err != nil {
+		return nil, fmt.Errorf("failed to map book %s: %w", path, err)
+	}
+
+	b, err := parse(data)
+	if err != nil {
+		unmap()
+		return nil, fmt.Errorf("invalid book %s: %w", path, err)
+	}
+	b.unmap = unmap
+	return b, nil
+}
+
+func parse(data []byte) (*Book, error) {
+	if len(data) < headerSize || string(data[:8]) != magic {
+		return nil, errors.New("bad magic")
+	}
+	if v := binary.LittleEndian.Uint32(data[8:]); v != version {
+		return nil, fmt.Errorf("unsupported version %d", v)
+	}
+	if size := binary.LittleEndian.Uint32(data[12:]); size != entrySize {
+		return nil, fmt.Errorf("unexpected entry size %d", size)
+	}
+
+	count := binary.LittleEndian.Uint64(data[16:])
+	if count > uint64(len(data)-headerSize)/entrySize {
+		return nil, fmt.Errorf("truncated: %d entries declared", count)
+	}
+
+	return &Book{
+		data:      data,
+		entries:   data[headerSize : headerSize+int(count)*entrySize],
+		count:     int(count),
+		maxRounds: int(binary.LittleEndian.Uint32(data[24:])),
+	}, nil
+}
+
+// Close unmaps the file. The book must not be used afterwards.
+func (b *Book) Close() error {
+	if b.unmap == nil {
+		return nil
+	}
+	err := b.unmap()
+	b.unmap, b.data, b.entries, b.count = nil, nil, nil, 0
+	return err
+}
+
+// Len returns the number of positions in the book
+func (b *Book) Len() int {
+	return b.count
+}
+
+// MaxRounds returns the round limit of the games the book was built for
+func (b *Book) MaxRounds() int {
+	return b.maxRounds
+}
+
+// Lookup finds a position by hash
+func (b *Book) Lookup(key uint64) (Entry, bool) {
+	i := sort.Search(b.count, func(i int) bool {
+		return binary.LittleEndian.Uint64(b.entries[i*entrySize:]) >= key
+	})
+	if i == b.count {
+		return Entry{}, false
+	}
+
+	entry := decodeEntry(b.entries[i*entrySize : (i+1)*entrySize])
+	return entry, entry.Key == key
+}
+
+// Probe looks up state and converts the book move into a move on it. It
+// misses if the book was built for a different round limit.
+func (b *Book) Probe(state *game.RPSGame) (game.RPSMove, Entry, bool) {
+	if b == nil || state.MaxRounds != b.maxRounds {
+		return game.RPSMove{}, Entry{}, false
+	}
+
+	packed := state.Pack()
+	entry, found := b.Lookup(packed.Hash())
+	if !found {
+		return game.RPSMove{}, Entry{}, false
+	}
+
+	move, ok := state.UnpackMove(entry.Move)
+	return move, entry, ok
+}
+
+// Write saves entries as a book file. Entries are sorted by key; for
+// duplicate keys the deepest search is kept. The file is written to a
+// temporary name and renamed, so readers never see a partial book.
+func Write(path string, maxRounds int, entries []Entry) error {
+	sorted := append([]Entry(nil), entries...)
+	sort.SliceStable(sorted, func(i, j int) bool {
+		if sorted[i].Key != sorted[j].Key {
+			return sorted[i].Key < sorted[j].Key
+		}
+		return sorted[i].Depth > sorted[j].Depth
+	})
+	unique := sorted[:0]
+	for _, entry := range sorted {
+		if len(unique) > 0 && unique[len(unique)-1].Key == entry.Key {
+			continue
+		}
+		unique = append(unique, entry)
+	}
+
+	tmpPath := path + ".tmp"
+	file, err := os.Create(tmpPath)
+	if err != nil {
+		return fmt.Errorf("failed to create book file: %w", err)
+	}
+	defer os.Remove(tmpPath)
+
+	w := bufio.NewWriter(file)
+
+	var header [headerSize]byte
+	copy(header[:], magic)
+	binary.LittleEndian.PutUint32(header[8:], version)
+	binary.LittleEndian.PutUint32(header[12:], entrySize)
+	binary.LittleEndian.PutUint64(header[16:], uint64(len(unique)))
+	binary.LittleEndian.PutUint32(header[24:], uint32(maxRounds))
+	w.Write(header[:])
+
+	var buf [entrySize]byte
+	for _, entry := range unique {
+		encodeEntry(buf[:], entry)
+		w.Write(buf[:])
+	}
+
+	if err := w.Flush(); err != nil {
+		file.Close()
+		return fmt.Errorf("failed to write book: %w", err)
+	}
+	if err := file.Close(); err != nil {
+		return fmt.Errorf("failed to write book: %w", err)
+	}
+	return os.Rename(tmpPath, path)
+}
+
+func encodeEntry(buf []byte, entry Entry) {
+	binary.LittleEndian.PutUint64(buf[0:], entry.Key)
+	binary.LittleEndian.PutUint32(buf[8:], math.Float32bits(entry.Value))
+	buf[12] = entry.Move.Position
+	buf[13] = uint8(entry.Move.Card)
+	buf[14] = entry.Depth
+	buf[15] = entry.Flags
+}
+
+func decodeEntry(buf []byte) Entry {
+	return Entry{
+		Key:   binary.LittleEndian.Uint64(buf[0:]),
+		Value: math.Float32frombits(binary.LittleEndian.Uint32(buf[8:])),
+		Move:  game.PackedMove{Position: buf[12], Card: game.RPSCardType(buf[13])},
+		Depth: buf[14],
+		Flags: buf[15],
+	}
+}
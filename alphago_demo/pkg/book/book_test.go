@@ -0,0 +1,58 @@
+package book
+
+import (
+	"path/filepath"
+	"testing"
+
+	"github.com/zachbeta/neural_rps/alphago_demo/pkg/game"
+)
+
+func TestWriteOpenProbe(t *testing.T) {
+	state := game.NewRPSGame(21, 5, 10)
+	packed := state.Pack()
+
+	var buf [game.MaxPackedMoves]game.PackedMove
+	move := packed.AppendMoves(buf[:0])[0]
+
+	entries := []Entry{
+		{Key: packed.Hash(), Value: 12.5, Move: move, Depth: 3},
+		{Key: packed.Hash(), Value: 7.25, Move: move, Depth: 9, Flags: FlagSolved},
+		{Key: 42, Value: -1, Depth: 1},
+	}
+
+	path := filepath.Join(t.TempDir(), "book.bin")
+	if err := Write(path, 10, entries); err != nil {
+		t.Fatalf("Write failed: %v", err)
+	}
+
+	b, err := Open(path)
+	if err != nil {
+		t.Fatalf("Open failed: %v", err)
+	}
+	defer b.Close()
+
+	if b.Len() != 2 {
+		t.Errorf("Expected duplicate keys to be merged into 2 entries, got %d", b.Len())
+	}
+
+	got, entry, ok := b.Probe(state)
+	if !ok {
+		t.Fatalf("Expected a book hit for the start position")
+	}
+	if entry.Depth != 9 || entry.Value != 7.25 || entry.Flags != FlagSolved {
+		t.Errorf("Expected the deepest entry to be kept, got %+v", entry)
+	}
+	if state.PackMove(got) != move {
+		t.Errorf("Expected book move %+v, got %+v", move, state.PackMove(got))
+	}
+
+	if _, found := b.Lookup(43); found {
+		t.Errorf("Expected a miss for an unknown key")
+	}
+
+	other := state.Copy()
+	other.MaxRounds = 20
+	if _, _, ok := b.Probe(other); ok {
+		t.Errorf("Expected a miss for a different round limit")
+	}
+}
@@ -3,10 +3,8 @@ package elo
 import (
 	"encoding/json"
 	"fmt"
-	"io/ioutil"
 	"math"
 	"os"
-	"path/filepath"
 	"sort"
 	"time"
 )
@@ -23,7 +21,17 @@ type MatchResult struct {
 	Comment    string    `json:"comment,omitempty"`
 }
 
-// ELOTracker manages ELO ratings for multiple models
+// ELOTracker manages ELO ratings for multiple models.
+//
+// Its state is kept in SaveDir as a snapshot, elo_ratings.json, and a log of
+// the matches played since, elo_matches.jsonl. UpdateRating appends to the
+// log in group commits and compacts it into a new snapshot as it grows, so
+// recording a match costs the same however long the history is. Call Flush
+// or Close before exiting so the last group is written.
+//
+// Ratings are indexed for GetTopModels and matches by model for
+// GetRatingHistory; change ModelRatings only through RegisterModel and
+// UpdateRating so the ranking stays current.
 type ELOTracker struct {
 	BaseRating   float64                  `json:"base_rating"` // Starting rating for new models
 	KFactor      float64                  `json:"k_factor"`    // Determines rating change magnitude
@@ -31,6 +39,19 @@ type ELOTracker struct {
 	MatchHistory []MatchResult            `json:"match_history"`
 	ModelMeta    map[string]ModelMetadata `json:"model_metadata"`
 	SaveDir      string                   `json:"-"` // Directory to save ratings (not serialized)
+
+	// A group of logged matches is committed, written and synced, once it
+	// holds CommitEvery matches or its oldest is CommitInterval old, on a
+	// timer if no further match arrives by then
+	CommitEvery    int           `json:"-"`
+	CommitInterval time.Duration `json:"-"`
+
+	log matchLog
+	err error // First log error since the last Flush
+
+	ranking      []string         // Model IDs by rankedBefore, nil until needed
+	modelMatches map[string][]int // MatchHistory indices by model
+	indexed      int              // Matches in modelMatches
 }
 
 // ModelMetadata contains descriptive information about a model
@@ -53,6 +74,9 @@ func NewELOTracker(baseRating float64, kFactor float64, saveDir string) *ELOTrac
 		MatchHistory: make([]MatchResult, 0),
 		ModelMeta:    make(map[string]ModelMetadata),
 		SaveDir:      saveDir,
+
+		CommitEvery:    DefaultCommitEvery,
+		CommitInterval: DefaultCommitInterval,
 	}
 }
 
@@ -60,7 +84,7 @@ func NewELOTracker(baseRating float64, kFactor float64, saveDir string) *ELOTrac
 func (e *ELOTracker) RegisterModel(modelID string, metadata ModelMetadata) float64 {
 	// If model already exists, keep its rating
 	if _, exists := e.ModelRatings[modelID]; !exists {
-		e.ModelRatings[modelID] = e.BaseRating
+		e.setRating(modelID, e.BaseRating)
 	}
 
 	// Update or add metadata
@@ -91,10 +115,10 @@ func (e *ELOTracker) ExpectedScore(model1, model2 string) float64 {
 func (e *ELOTracker) UpdateRating(model1, model2 string, result float64, gameCount int, comment string) MatchResult {
 	// Ensure models exist
 	if _, exists := e.ModelRatings[model1]; !exists {
-		e.ModelRatings[model1] = e.BaseRating
+		e.setRating(model1, e.BaseRating)
 	}
 	if _, exists := e.ModelRatings[model2]; !exists {
-		e.ModelRatings[model2] = e.BaseRating
+		e.setRating(model2, e.BaseRating)
 	}
 
 	// Get current ratings
@@ -121,10 +145,6 @@ func (e *ELOTracker) UpdateRating(model1, model2 string, result float64, gameCou
 	newRating1 := rating1 + effectiveK*(result-expected1)
 	newRating2 := rating2 + effectiveK*((1.0-result)-expected2)
 
-	// Store updated ratings
-	e.ModelRatings[model1] = newRating1
-	e.ModelRatings[model2] = newRating2
-
 	// Create match result record
 	matchResult := MatchResult{
 		Model1:     model1,
@@ -137,15 +157,84 @@ func (e *ELOTracker) UpdateRating(model1, model2 string, result float64, gameCou
 		Comment:    comment,
 	}
 
-	// Add to history
-	e.MatchHistory = append(e.MatchHistory, matchResult)
-
-	// Save updated data
-	e.Save()
+	// Store updated ratings, add to history and log the match
+	e.applyMatch(matchResult)
+	e.record(matchResult)
 
 	return matchResult
 }
 
+// applyMatch adds match to the history and takes its new ratings
+func (e *ELOTracker) applyMatch(match MatchResult) {
+	e.setRating(match.Model1, match.NewRating1)
+	e.setRating(match.Model2, match.NewRating2)
+	e.MatchHistory = append(e.MatchHistory, match)
+}
+
+// rankedBefore orders the ranking index: higher ratings first, ties by ID
+func rankedBefore(id1 string, rating1 float64, id2 string, rating2 float64) bool {
+	if rating1 != rating2 {
+		return rating1 > rating2
+	}
+	return id1 < id2
+}
+
+// rankOf returns where a model with rating belongs in the ranking index
+func (e *ELOTracker) rankOf(modelID string, rating float64) int {
+	return sort.Search(len(e.ranking), func(i int) bool {
+		other := e.ranking[i]
+		return !rankedBefore(other, e.ModelRatings[other], modelID, rating)
+	})
+}
+
+// setRating sets a model's rating, moving it within the ranking index
+func (e *ELOTracker) setRating(modelID string, rating float64) {
+	if e.ranking != nil {
+		if old, exists := e.ModelRatings[modelID]; exists {
+			i := e.rankOf(modelID, old)
+			e.ranking = append(e.ranking[:i], e.ranking[i+1:]...)
+		}
+		i := e.rankOf(modelID, rating)
+		e.ranking = append(e.ranking, "")
+		copy(e.ranking[i+1:], e.ranking[i:])
+		e.ranking[i] = modelID
+	}
+	e.ModelRatings[modelID] = rating
+}
+
+// rankIndex returns the model IDs by rating, building the index the first
+// time or if models were added to ModelRatings directly
+func (e *ELOTracker) rankIndex() []string {
+	if e.ranking == nil || len(e.ranking) != len(e.ModelRatings) {
+		e.ranking = make([]string, 0, len(e.ModelRatings))
+		for id := range e.ModelRatings {
+			e.ranking = append(e.ranking, id)
+		}
+		sort.Slice(e.ranking, func(i, j int) bool {
+			id1, id2 := e.ranking[i], e.ranking[j]
+			return rankedBefore(id1, e.ModelRatings[id1], id2, e.ModelRatings[id2])
+		})
+	}
+	return e.ranking
+}
+
+// matchIndex returns the MatchHistory indices of each model's matches,
+// indexing the matches added since the last call
+func (e *ELOTracker) matchIndex() map[string][]int {
+	if e.modelMatches == nil || e.indexed > len(e.MatchHistory) {
+		e.modelMatches, e.indexed = make(map[string][]int), 0
+	}
+	for i, match := range e.MatchHistory[e.indexed:] {
+		i += e.indexed
+		e.modelMatches[match.Model1] = append(e.modelMatches[match.Model1], i)
+		if match.Model2 != match.Model1 {
+			e.modelMatches[match.Model2] = append(e.modelMatches[match.Model2], i)
+		}
+	}
+	e.indexed = len(e.MatchHistory)
+	return e.modelMatches
+}
+
 // GetRatingHistory returns the history of rating changes for a model
 func (e *ELOTracker) GetRatingHistory(modelID string) []struct {
 	Time   time.Time
@@ -156,21 +245,17 @@ func (e *ELOTracker) GetRatingHistory(modelID string) []struct {
 		Rating float64
 	}, 0)
 
+	matches := e.matchIndex()[modelID]
+
 	// Add initial rating if model exists
 	if _, exists := e.ModelRatings[modelID]; exists {
 		// Start with base rating at model creation time or first match
 		var startTime time.Time
 		if meta, hasMeta := e.ModelMeta[modelID]; hasMeta {
 			startTime = meta.Created
-		} else if len(e.MatchHistory) > 0 {
-			// Find first match involving this model
-			for _, match := range e.MatchHistory {
-				if match.Model1 == modelID || match.Model2 == modelID {
-					startTime = match.Timestamp
-					break
-				}
-			}
-		} else {
+		} else if len(matches) > 0 {
+			startTime = e.MatchHistory[matches[0]].Timestamp
+		} else if len(e.MatchHistory) == 0 {
 			startTime = time.Now()
 		}
 
@@ -184,29 +269,20 @@ func (e *ELOTracker) GetRatingHistory(modelID string) []struct {
 		})
 	}
 
-	// Traverse match history to build rating curve
-	for _, match := range e.MatchHistory {
-		var rating float64
-
+	// Follow the model's matches to build rating curve
+	for _, i := range matches {
+		match := e.MatchHistory[i]
+		rating := match.NewRating2
 		if match.Model1 == modelID {
 			rating = match.NewRating1
-			history = append(history, struct {
-				Time   time.Time
-				Rating float64
-			}{
-				Time:   match.Timestamp,
-				Rating: rating,
-			})
-		} else if match.Model2 == modelID {
-			rating = match.NewRating2
-			history = append(history, struct {
-				Time   time.Time
-				Rating float64
-			}{
-				Time:   match.Timestamp,
-				Rating: rating,
-			})
 		}
+		history = append(history, struct {
+			Time   time.Time
+			Rating float64
+		}{
+			Time:   match.Timestamp,
+			Rating: rating,
+		})
 	}
 
 	// Sort by time
@@ -217,99 +293,59 @@ func (e *ELOTracker) GetRatingHistory(modelID string) []struct {
 	return history
 }
 
-// GetTopModels returns the N highest rated models
+// GetTopModels returns the N highest rated models, from the ranking index
 func (e *ELOTracker) GetTopModels(n int) []struct {
 	ModelID string
 	Rating  float64
 } {
-	// Create a slice of model IDs and ratings
-	models := make([]struct {
-		ModelID string
-		Rating  float64
-	}, 0, len(e.ModelRatings))
-
-	for id, rating := range e.ModelRatings {
-		models = append(models, struct {
-			ModelID string
-			Rating  float64
-		}{
-			ModelID: id,
-			Rating:  rating,
-		})
-	}
-
-	// Sort by rating (descending)
-	sort.Slice(models, func(i, j int) bool {
-		return models[i].Rating > models[j].Rating
-	})
+	ranking := e.rankIndex()
 
 	// Return top N (or all if fewer than N)
-	if n > len(models) {
-		n = len(models)
-	}
-
-	return models[:n]
-}
-
-// Save writes the ELO tracker data to disk
-func (e *ELOTracker) Save() error {
-	// Ensure directory exists
-	if e.SaveDir == "" {
-		e.SaveDir = "elo_ratings"
+	if n > len(ranking) {
+		n = len(ranking)
 	}
 
-	err := os.MkdirAll(e.SaveDir, 0755)
-	if err != nil {
-		return fmt.Errorf("failed to create directory %s: %v", e.SaveDir, err)
-	}
-
-	// Marshal to JSON
-	data, err := json.MarshalIndent(e, "", "  ")
-	if err != nil {
-		return fmt.Errorf("failed to marshal ELO data: %v", err)
-	}
-
-	// Write to file
-	filename := filepath.Join(e.SaveDir, "elo_ratings.json")
-	err = ioutil.WriteFile(filename, data, 0644)
-	if err != nil {
-		return fmt.Errorf("failed to write ELO data to %s: %v", filename, err)
+	models := make([]struct {
+		ModelID string
+		Rating  float64
+	}, n)
+	for i, id := range ranking[:n] {
+		models[i].ModelID, models[i].Rating = id, e.ModelRatings[id]
 	}
-
-	return nil
+	return models
 }
 
-// Load reads the ELO tracker data from disk
+// Load reads the ELO tracker data from disk: the snapshot, then the matches
+// logged after it
 func Load(saveDir string) (*ELOTracker, error) {
 	if saveDir == "" {
 		saveDir = "elo_ratings"
 	}
 
-	filename := filepath.Join(saveDir, "elo_ratings.json")
+	tracker := NewELOTracker(1400, 32.0, saveDir)
+	filename := tracker.path(snapshotFile)
 
-	// Check if file exists
-	if _, err := os.Stat(filename); os.IsNotExist(err) {
-		// File doesn't exist, create a new tracker
-		return NewELOTracker(1400, 32.0, saveDir), nil
-	}
-
-	// Read file
-	data, err := ioutil.ReadFile(filename)
-	if err != nil {
+	// Read the snapshot; without one, a new tracker replays any log alone
+	data, err := os.ReadFile(filename)
+	if err != nil && !os.IsNotExist(err) {
 		return nil, fmt.Errorf("failed to read ELO data from %s: %v", filename, err)
 	}
-
-	// Unmarshal from JSON
-	var tracker ELOTracker
-	err = json.Unmarshal(data, &tracker)
-	if err != nil {
-		return nil, fmt.Errorf("failed to unmarshal ELO data: %v", err)
+	if err == nil {
+		if err := json.Unmarshal(data, tracker); err != nil {
+			return nil, fmt.Errorf("failed to unmarshal ELO data: %v", err)
+		}
+		if tracker.ModelRatings == nil {
+			tracker.ModelRatings = make(map[string]float64)
+		}
+		if tracker.ModelMeta == nil {
+			tracker.ModelMeta = make(map[string]ModelMetadata)
+		}
 	}
 
-	// Set save directory
-	tracker.SaveDir = saveDir
-
-	return &tracker, nil
+	if err := tracker.replayLog(); err != nil {
+		return nil, err
+	}
+	return tracker, nil
 }
 
 // GenerateReport creates a summary report of ELO ratings and match history
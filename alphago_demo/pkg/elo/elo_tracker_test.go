@@ -0,0 +1,187 @@
+package elo
+
+import (
+	"fmt"
+	"os"
+	"path/filepath"
+	"testing"
+	"time"
+)
+
+// playMatches records n matches between a few models, some on the
+// previous one's result
+func playMatches(tracker *ELOTracker, n int) {
+	for i := 0; i < n; i++ {
+		model1, model2 := fmt.Sprintf("m%d", i%5), fmt.Sprintf("m%d", (i*3+1)%7)
+		tracker.UpdateRating(model1, model2, float64(i%3)/2, 1+i%4, "")
+	}
+}
+
+func sameTracker(t *testing.T, got, want *ELOTracker) {
+	t.Helper()
+	if len(got.MatchHistory) != len(want.MatchHistory) {
+		t.Fatalf("Loaded %d matches, expected %d", len(got.MatchHistory), len(want.MatchHistory))
+	}
+	for id, rating := range want.ModelRatings {
+		if got.ModelRatings[id] != rating {
+			t.Errorf("Loaded rating %f for %s, expected %f", got.ModelRatings[id], id, rating)
+		}
+	}
+	if len(got.ModelRatings) != len(want.ModelRatings) {
+		t.Errorf("Loaded %d models, expected %d", len(got.ModelRatings), len(want.ModelRatings))
+	}
+	for i, match := range want.MatchHistory {
+		if got.MatchHistory[i].Model1 != match.Model1 || got.MatchHistory[i].NewRating2 != match.NewRating2 {
+			t.Fatalf("Loaded match %d is %+v, expected %+v", i, got.MatchHistory[i], match)
+		}
+	}
+}
+
+func TestMatchLogRoundTrip(t *testing.T) {
+	dir := t.TempDir()
+	tracker := NewELOTracker(1400, 32, dir)
+	tracker.RegisterModel("m0", ModelMetadata{Name: "First", HiddenSize: 64})
+
+	// Enough matches to compact a few times and leave a tail in the log
+	playMatches(tracker, 3*minCompactMatches+17)
+	if err := tracker.Close(); err != nil {
+		t.Fatal(err)
+	}
+	if info, err := os.Stat(filepath.Join(dir, matchLogFile)); err != nil || info.Size() == 0 {
+		t.Fatalf("Expected a match log tail, got %v, %v", info, err)
+	}
+
+	loaded, err := Load(dir)
+	if err != nil {
+		t.Fatal(err)
+	}
+	sameTracker(t, loaded, tracker)
+	if loaded.ModelMeta["m0"].Name != "First" {
+		t.Errorf("Expected model metadata to survive, got %+v", loaded.ModelMeta["m0"])
+	}
+
+	// The loaded tracker keeps appending where the log left off
+	playMatches(loaded, 40)
+	playMatches(tracker, 40)
+	if err := loaded.Close(); err != nil {
+		t.Fatal(err)
+	}
+	reloaded, err := Load(dir)
+	if err != nil {
+		t.Fatal(err)
+	}
+	sameTracker(t, reloaded, tracker)
+}
+
+func TestMatchLogRecovery(t *testing.T) {
+	dir := t.TempDir()
+	tracker := NewELOTracker(1400, 32, dir)
+	playMatches(tracker, 20)
+	if err := tracker.Flush(); err != nil {
+		t.Fatal(err)
+	}
+
+	// A crash while writing leaves part of a line
+	logPath := filepath.Join(dir, matchLogFile)
+	file, err := os.OpenFile(logPath, os.O_WRONLY|os.O_APPEND, 0)
+	if err != nil {
+		t.Fatal(err)
+	}
+	file.WriteString(`{"seq":21,"model1":"m`)
+	file.Close()
+
+	loaded, err := Load(dir)
+	if err != nil {
+		t.Fatal(err)
+	}
+	sameTracker(t, loaded, tracker)
+
+	// A crash after a snapshot but before the log was emptied repeats
+	// matches the snapshot already holds
+	log, err := os.ReadFile(logPath)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if err := loaded.writeSnapshot(); err != nil {
+		t.Fatal(err)
+	}
+	if err := os.WriteFile(logPath, log, 0644); err != nil {
+		t.Fatal(err)
+	}
+	reloaded, err := Load(dir)
+	if err != nil {
+		t.Fatal(err)
+	}
+	sameTracker(t, reloaded, tracker)
+}
+
+func TestMatchLogCommitInterval(t *testing.T) {
+	dir := t.TempDir()
+	tracker := NewELOTracker(1400, 32, dir)
+	tracker.CommitEvery = 1000
+	tracker.CommitInterval = 20 * time.Millisecond
+	defer tracker.Close()
+
+	// The first match goes to the snapshot; the second starts a group that
+	// must be committed at its deadline without another match or a Flush
+	playMatches(tracker, 2)
+	logPath := filepath.Join(dir, matchLogFile)
+	deadline := time.Now().Add(5 * time.Second)
+	for {
+		if info, err := os.Stat(logPath); err == nil && info.Size() > 0 {
+			break
+		}
+		if time.Now().After(deadline) {
+			t.Fatal("Expected the pending match to be committed after CommitInterval")
+		}
+		time.Sleep(5 * time.Millisecond)
+	}
+
+	loaded, err := Load(dir)
+	if err != nil {
+		t.Fatal(err)
+	}
+	sameTracker(t, loaded, tracker)
+}
+
+func TestGetTopModelsIndex(t *testing.T) {
+	tracker := NewELOTracker(1400, 32, t.TempDir())
+	tracker.CommitEvery = 1000
+	for i := 0; i < 3; i++ {
+		tracker.RegisterModel(fmt.Sprintf("m%d", i), ModelMetadata{})
+	}
+
+	for round := 0; round < 50; round++ {
+		playMatches(tracker, 3)
+		top := tracker.GetTopModels(4)
+		if len(top) != 4 {
+			t.Fatalf("Expected 4 top models, got %d", len(top))
+		}
+		for i, model := range top {
+			if model.Rating != tracker.ModelRatings[model.ModelID] {
+				t.Fatalf("Top model %s has rating %f, expected %f", model.ModelID, model.Rating, tracker.ModelRatings[model.ModelID])
+			}
+			if i > 0 && model.Rating > top[i-1].Rating {
+				t.Fatalf("Top models out of order: %+v", top)
+			}
+		}
+		for id, rating := range tracker.ModelRatings {
+			if rating > top[3].Rating {
+				found := false
+				for _, model := range top {
+					found = found || model.ModelID == id
+				}
+				if !found {
+					t.Fatalf("Model %s rated %f is missing from %+v", id, rating, top)
+				}
+			}
+		}
+	}
+
+	history := tracker.GetRatingHistory("m1")
+	last := history[len(history)-1]
+	if last.Rating != tracker.GetRating("m1") {
+		t.Errorf("Rating history ends at %f, expected the current rating %f", last.Rating, tracker.GetRating("m1"))
+	}
+	tracker.Close()
+}
@@ -0,0 +1,280 @@
+package elo
+
+import (
+	"bufio"
+	"bytes"
+	"encoding/json"
+	"fmt"
+	"os"
+	"path/filepath"
+	"sync"
+	"time"
+)
+
+const (
+	snapshotFile = "elo_ratings.json"
+	matchLogFile = "elo_matches.jsonl"
+
+	// DefaultCommitEvery and DefaultCommitInterval are the group commit
+	// settings of new and loaded trackers
+	DefaultCommitEvery    = 32
+	DefaultCommitInterval = time.Second
+
+	// minCompactMatches is the fewest logged matches that trigger a
+	// compaction; above it the log is compacted once it holds as many
+	// matches as the snapshot, so each match is rewritten a bounded number
+	// of times however long the history grows
+	minCompactMatches = 256
+)
+
+// logRecord is one line of the match log. Seq is the match's 1-based
+// position in MatchHistory, so that matches a snapshot already holds are
+// skipped if the log could not be truncated after it was written.
+type logRecord struct {
+	Seq int `json:"seq"`
+	MatchResult
+}
+
+// matchLog appends matches to the tracker's log file, writing them in
+// groups: a group is written and synced once it holds CommitEvery matches
+// or its oldest match is CommitInterval old. A timer commits a group that
+// reaches its deadline before the next match arrives.
+type matchLog struct {
+	// mu guards the log and the tracker's err, which the commit timer
+	// touches from its own goroutine
+	mu       sync.Mutex
+	file     *os.File
+	buf      *bufio.Writer
+	pending  int         // Matches buffered but not yet written
+	oldest   time.Time   // When the oldest pending match was buffered
+	logged   int         // Matches in the log file, written or pending
+	snapshot int         // Matches in the snapshot
+	timer    *time.Timer // Commits the pending group at its deadline
+}
+
+// record appends match, the last of MatchHistory, to the log, committing the
+// group or compacting as due. Errors are kept for Flush to return.
+func (e *ELOTracker) record(match MatchResult) {
+	l := &e.log
+	l.mu.Lock()
+	defer l.mu.Unlock()
+	if e.err != nil {
+		return
+	}
+
+	if l.file == nil {
+		if _, err := os.Stat(e.path(snapshotFile)); os.IsNotExist(err) {
+			// A new tracker's first match goes to its first snapshot, which
+			// holds the settings and model metadata that the log does not
+			e.err = e.save()
+			return
+		}
+
+		file, err := os.OpenFile(e.path(matchLogFile), os.O_WRONLY|os.O_CREATE|os.O_APPEND, 0644)
+		if err != nil {
+			e.err = fmt.Errorf("failed to open match log: %v", err)
+			return
+		}
+		l.file, l.buf = file, bufio.NewWriter(file)
+	}
+
+	line, err := json.Marshal(logRecord{Seq: len(e.MatchHistory), MatchResult: match})
+	if err != nil {
+		e.err = fmt.Errorf("failed to marshal match: %v", err)
+		return
+	}
+	l.buf.Write(line)
+	l.buf.WriteByte('\n')
+	if l.pending == 0 {
+		l.oldest = time.Now()
+	}
+	l.pending++
+	l.logged++
+
+	if l.pending >= max(e.CommitEvery, 1) || time.Since(l.oldest) >= e.CommitInterval {
+		e.err = e.commit()
+	} else if l.pending == 1 {
+		e.startCommitTimer()
+	}
+	if e.err == nil && l.logged >= max(minCompactMatches, l.snapshot) {
+		e.err = e.save()
+	}
+}
+
+// startCommitTimer arranges for the group just started to be committed once
+// its oldest match is CommitInterval old. Callers hold log.mu.
+func (e *ELOTracker) startCommitTimer() {
+	l := &e.log
+	if l.timer == nil {
+		l.timer = time.AfterFunc(e.CommitInterval, e.commitDue)
+	} else {
+		l.timer.Reset(e.CommitInterval)
+	}
+}
+
+// commitDue runs on the commit timer's goroutine
+func (e *ELOTracker) commitDue() {
+	l := &e.log
+	l.mu.Lock()
+	defer l.mu.Unlock()
+	if e.err == nil && l.file != nil {
+		e.err = e.commit()
+	}
+}
+
+// commit writes and syncs the pending group. Callers hold log.mu.
+func (e *ELOTracker) commit() error {
+	l := &e.log
+	if l.timer != nil {
+		l.timer.Stop()
+	}
+	if l.pending == 0 {
+		return nil
+	}
+	if err := l.buf.Flush(); err != nil {
+		return fmt.Errorf("failed to write match log: %v", err)
+	}
+	if err := l.file.Sync(); err != nil {
+		return fmt.Errorf("failed to sync match log: %v", err)
+	}
+	l.pending = 0
+	return nil
+}
+
+// Flush writes any matches still waiting for their group to be committed,
+// and returns the first error met writing the log since the last Flush,
+// including by the commit timer
+func (e *ELOTracker) Flush() error {
+	e.log.mu.Lock()
+	defer e.log.mu.Unlock()
+	return e.flush()
+}
+
+func (e *ELOTracker) flush() error {
+	err := e.err
+	e.err = nil
+	if err == nil && e.log.file != nil {
+		err = e.commit()
+	}
+	return err
+}
+
+// Close flushes the log and closes it. The tracker may still be used; the
+// log is reopened by the next match.
+func (e *ELOTracker) Close() error {
+	e.log.mu.Lock()
+	defer e.log.mu.Unlock()
+
+	err := e.flush()
+	if e.log.file != nil {
+		if cerr := e.log.file.Close(); err == nil {
+			err = cerr
+		}
+		e.log.file, e.log.buf = nil, nil
+	}
+	return err
+}
+
+// Save compacts the tracker's files: it writes a snapshot of the whole
+// state and empties the match log. UpdateRating calls it as the log grows,
+// so it rarely needs calling directly; Flush or Close suffice before exit.
+func (e *ELOTracker) Save() error {
+	e.log.mu.Lock()
+	defer e.log.mu.Unlock()
+	return e.save()
+}
+
+// save is Save for callers holding log.mu
+func (e *ELOTracker) save() error {
+	if e.log.file != nil {
+		// Match lines after the snapshot must not be from before it
+		e.log.buf.Reset(e.log.file)
+		e.log.pending = 0
+	}
+	if err := e.writeSnapshot(); err != nil {
+		return err
+	}
+
+	if e.log.file != nil {
+		if err := e.log.file.Truncate(0); err != nil {
+			return fmt.Errorf("failed to truncate match log: %v", err)
+		}
+	} else if err := os.Truncate(e.path(matchLogFile), 0); err != nil && !os.IsNotExist(err) {
+		return fmt.Errorf("failed to truncate match log: %v", err)
+	}
+	e.log.logged, e.log.snapshot = 0, len(e.MatchHistory)
+	return nil
+}
+
+// writeSnapshot atomically replaces the snapshot with the current state
+func (e *ELOTracker) writeSnapshot() error {
+	// Ensure directory exists
+	if e.SaveDir == "" {
+		e.SaveDir = "elo_ratings"
+	}
+	if err := os.MkdirAll(e.SaveDir, 0755); err != nil {
+		return fmt.Errorf("failed to create directory %s: %v", e.SaveDir, err)
+	}
+
+	data, err := json.MarshalIndent(e, "", "  ")
+	if err != nil {
+		return fmt.Errorf("failed to marshal ELO data: %v", err)
+	}
+
+	filename := e.path(snapshotFile)
+	if err := os.WriteFile(filename+".tmp", data, 0644); err != nil {
+		return fmt.Errorf("failed to write ELO data to %s: %v", filename, err)
+	}
+	if err := os.Rename(filename+".tmp", filename); err != nil {
+		return fmt.Errorf("failed to write ELO data to %s: %v", filename, err)
+	}
+	return nil
+}
+
+// replayLog applies the matches logged after the snapshot. A torn last line,
+// left by a crash mid-write, is dropped and cut from the file.
+func (e *ELOTracker) replayLog() error {
+	filename := e.path(matchLogFile)
+	data, err := os.ReadFile(filename)
+	if os.IsNotExist(err) {
+		return nil
+	} else if err != nil {
+		return fmt.Errorf("failed to read match log %s: %v", filename, err)
+	}
+
+	e.log.snapshot = len(e.MatchHistory)
+	valid := 0
+	for valid < len(data) {
+		end := bytes.IndexByte(data[valid:], '\n')
+		if end < 0 {
+			break // Torn: the newline is written last
+		}
+		line := data[valid : valid+end]
+
+		var record logRecord
+		if err := json.Unmarshal(line, &record); err != nil {
+			return fmt.Errorf("corrupt match log %s at byte %d: %v", filename, valid, err)
+		}
+		valid += end + 1
+		e.log.logged++
+
+		switch {
+		case record.Seq <= len(e.MatchHistory):
+			continue // Already in the snapshot
+		case record.Seq > len(e.MatchHistory)+1:
+			return fmt.Errorf("match log %s is missing matches %d to %d", filename, len(e.MatchHistory)+1, record.Seq-1)
+		}
+		e.applyMatch(record.MatchResult)
+	}
+
+	if valid < len(data) {
+		if err := os.Truncate(filename, int64(valid)); err != nil {
+			return fmt.Errorf("failed to repair match log %s: %v", filename, err)
+		}
+	}
+	return nil
+}
+
+func (e *ELOTracker) path(name string) string {
+	return filepath.Join(e.SaveDir, name)
+}
@@ -0,0 +1,111 @@
+package game
+
+import (
+	"math/rand"
+	"testing"
+)
+
+// benchPositions returns positions sampled from random games, so benchmarks
+// see early, middle and late positions rather than only the opening
+func benchPositions(n int) []*RPSGame {
+	rng := rand.New(rand.NewSource(1))
+	positions := make([]*RPSGame, 0, n)
+	for len(positions) < n {
+		g := NewRPSGame(21, 5, 10)
+		for !g.IsGameOver() && len(positions) < n {
+			positions = append(positions, g.Copy())
+			moves := g.GetValidMoves()
+			g.MakeMove(moves[rng.Intn(len(moves))])
+		}
+	}
+	return positions
+}
+
+// reportRate reports b.N operations as a per-second rate in unit
+func reportRate(b *testing.B, unit string) {
+	if s := b.Elapsed().Seconds(); s > 0 {
+		b.ReportMetric(float64(b.N)/s, unit)
+	}
+}
+
+func BenchmarkRPSGameCopy(b *testing.B) {
+	positions := benchPositions(64)
+	b.ReportAllocs()
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		positions[i%len(positions)].Copy()
+	}
+	reportRate(b, "positions/sec")
+}
+
+func BenchmarkRPSGameCopyInto(b *testing.B) {
+	positions := benchPositions(64)
+	dst := positions[0].Copy()
+	b.ReportAllocs()
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		positions[i%len(positions)].CopyInto(dst)
+	}
+	reportRate(b, "positions/sec")
+}
+
+// BenchmarkRPSGameMakeMove times a move applied to a reused copy of each
+// position, the way search expands a child
+func BenchmarkRPSGameMakeMove(b *testing.B) {
+	positions := benchPositions(64)
+	moves := make([]RPSMove, len(positions))
+	for i, p := range positions {
+		moves[i] = p.GetValidMoves()[0]
+	}
+	dst := positions[0].Copy()
+	b.ReportAllocs()
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		k := i % len(positions)
+		positions[k].CopyInto(dst)
+		if err := dst.MakeMove(moves[k]); err != nil {
+			b.Fatal(err)
+		}
+	}
+	reportRate(b, "positions/sec")
+}
+
+func BenchmarkRPSGameGetValidMoves(b *testing.B) {
+	positions := benchPositions(64)
+	b.ReportAllocs()
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		positions[i%len(positions)].GetValidMoves()
+	}
+	reportRate(b, "positions/sec")
+}
+
+func BenchmarkRPSGameAppendValidMoves(b *testing.B) {
+	positions := benchPositions(64)
+	var moves []RPSMove
+	b.ReportAllocs()
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		moves = positions[i%len(positions)].AppendValidMoves(moves[:0])
+	}
+	reportRate(b, "positions/sec")
+}
+
+// BenchmarkPackedMakeUnmake is the packed representation's equivalent of
+// BenchmarkRPSGameMakeMove: make and unmake in place, with no copy
+func BenchmarkPackedMakeUnmake(b *testing.B) {
+	positions := benchPositions(64)
+	packed := make([]PackedRPSGame, len(positions))
+	moves := make([]PackedMove, len(positions))
+	for i, p := range positions {
+		packed[i] = p.Pack()
+		moves[i] = packed[i].AppendMoves(nil)[0]
+	}
+	b.ReportAllocs()
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		k := i % len(packed)
+		packed[k].UnmakeMove(packed[k].MakeMove(moves[k]))
+	}
+	reportRate(b, "positions/sec")
+}
@@ -99,7 +99,12 @@ func (g *RPSGame) dealCards(deck []RPSCard, handSize int) {
 
 // GetValidMoves returns all valid moves for the current player
 func (g *RPSGame) GetValidMoves() []RPSMove {
-	var moves []RPSMove
+	return g.AppendValidMoves(nil)
+}
+
+// AppendValidMoves appends all valid moves for the current player to moves
+// and returns the extended slice, letting callers supply a reusable buffer
+func (g *RPSGame) AppendValidMoves(moves []RPSMove) []RPSMove {
 	var hand []RPSCard
 
 	if g.CurrentPlayer == Player1 {
@@ -125,6 +130,25 @@ func (g *RPSGame) GetValidMoves() []RPSMove {
 	return moves
 }
 
+// hasValidMove reports whether the current player has any valid move,
+// without building the move list
+func (g *RPSGame) hasValidMove() bool {
+	hand := g.Player2Hand
+	if g.CurrentPlayer == Player1 {
+		hand = g.Player1Hand
+	}
+	if len(hand) == 0 {
+		return false
+	}
+
+	for pos := 0; pos < 9; pos++ {
+		if g.Board[pos].Owner == NoPlayer {
+			return true
+		}
+	}
+	return false
+}
+
 // MakeMove applies a move to the game state
 func (g *RPSGame) MakeMove(move RPSMove) error {
 	// Check if the move is valid
@@ -231,7 +255,7 @@ func (g *RPSGame) IsGameOver() bool {
 	}
 
 	// Check if current player has valid moves
-	if len(g.GetValidMoves()) == 0 {
+	if !g.hasValidMove() {
 		return true
 	}
 
@@ -298,11 +322,56 @@ func (g *RPSGame) Copy() *RPSGame {
 	return newGame
 }
 
+// CopyInto copies the game state into dst, reusing dst's slice capacity so
+// that repeated copies into the same destination don't allocate
+func (g *RPSGame) CopyInto(dst *RPSGame) {
+	dst.Board = g.Board
+	dst.Player1Hand = append(dst.Player1Hand[:0], g.Player1Hand...)
+	dst.Player2Hand = append(dst.Player2Hand[:0], g.Player2Hand...)
+	dst.CurrentPlayer = g.CurrentPlayer
+	dst.MoveHistory = append(dst.MoveHistory[:0], g.MoveHistory...)
+	dst.Round = g.Round
+	dst.MaxRounds = g.MaxRounds
+}
+
+// SamePosition reports whether two games are in the same position: same
+// board, hands (in order), player to move and round. Move history is ignored.
+func (g *RPSGame) SamePosition(other *RPSGame) bool {
+	if g.Board != other.Board || g.CurrentPlayer != other.CurrentPlayer ||
+		g.Round != other.Round || g.MaxRounds != other.MaxRounds {
+		return false
+	}
+	return sameCards(g.Player1Hand, other.Player1Hand) && sameCards(g.Player2Hand, other.Player2Hand)
+}
+
+func sameCards(a, b []RPSCard) bool {
+	if len(a) != len(b) {
+		return false
+	}
+	for i := range a {
+		if a[i] != b[i] {
+			return false
+		}
+	}
+	return true
+}
+
 // GetBoardAsFeatures returns the board as a flattened feature vector
 // For each position: 3 features for card type (one-hot) * 3 features for ownership (one-hot)
 // So 9 features per position * 9 positions = 81 features
 func (g *RPSGame) GetBoardAsFeatures() []float64 {
 	features := make([]float64, 81)
+	g.FillBoardFeatures(features)
+	return features
+}
+
+// FillBoardFeatures writes the same 81-feature encoding as GetBoardAsFeatures
+// into a caller-owned slice, so hot paths can reuse one buffer per goroutine
+func (g *RPSGame) FillBoardFeatures(features []float64) {
+	features = features[:81]
+	for i := range features {
+		features[i] = 0
+	}
 
 	for pos := 0; pos < 9; pos++ {
 		card := g.Board[pos]
@@ -325,8 +394,24 @@ func (g *RPSGame) GetBoardAsFeatures() []float64 {
 			features[baseIdx+7] = 1.0
 		}
 	}
+}
 
-	return features
+// FeatureKey packs what FillBoardFeatures encodes (each square's owner and
+// card type, and the player to move) into 37 bits, so two positions share a
+// key exactly when they share a feature vector
+func (g *RPSGame) FeatureKey() uint64 {
+	var key uint64
+	for pos, card := range g.Board {
+		square := uint64(card.Owner)
+		if card.Owner != NoPlayer {
+			square |= uint64(card.Type) << 2
+		}
+		key |= square << (4 * pos)
+	}
+	if g.CurrentPlayer != Player1 {
+		key |= 1 << 36
+	}
+	return key
 }
 
 // String returns a string representation of the game
@@ -207,6 +207,33 @@ func TestCopy(t *testing.T) {
 	original.Board = originalBoard
 }
 
+func TestCopyIntoAndSamePosition(t *testing.T) {
+	original := NewRPSGame(15, 4, 10)
+	move, _ := original.GetRandomMove()
+	original.MakeMove(move)
+
+	var dst RPSGame
+	original.CopyInto(&dst)
+
+	if !dst.SamePosition(original) {
+		t.Errorf("CopyInto did not reproduce the position")
+	}
+
+	// The copy must not share hand storage with the original
+	dst.Player1Hand[0].Type = (dst.Player1Hand[0].Type + 1) % 3
+	if dst.SamePosition(original) {
+		t.Errorf("Modifying the copy's hand affected the original or went unnoticed")
+	}
+
+	// Copying again into the same destination reuses its slices
+	allocs := testing.AllocsPerRun(100, func() {
+		original.CopyInto(&dst)
+	})
+	if allocs != 0 {
+		t.Errorf("Expected CopyInto into a warm destination to be allocation-free, got %.1f allocs/op", allocs)
+	}
+}
+
 func TestRPSGetBoardAsFeatures(t *testing.T) {
 	game := NewRPSGame(15, 5, 10)
 
@@ -240,6 +267,46 @@ func TestRPSGetBoardAsFeatures(t *testing.T) {
 	}
 }
 
+func TestFeatureKey(t *testing.T) {
+	// Play random games and check that keys agree exactly when features do
+	byKey := make(map[uint64][]float64)
+	for g := 0; g < 50; g++ {
+		game := NewRPSGame(21, 5, 10)
+		for !game.IsGameOver() {
+			features := game.GetBoardAsFeatures()
+			key := game.FeatureKey()
+			if seen, ok := byKey[key]; ok {
+				for i := range features {
+					if features[i] != seen[i] {
+						t.Fatalf("Positions with key %x have different features", key)
+					}
+				}
+			}
+			byKey[key] = features
+
+			move, err := game.GetRandomMove()
+			if err != nil {
+				break
+			}
+			game.MakeMove(move)
+		}
+	}
+
+	// Hands and round don't reach the features, so they don't change the key
+	a := NewRPSGame(21, 5, 10)
+	b := a.Copy()
+	b.Player1Hand = b.Player1Hand[1:]
+	b.Round++
+	if a.FeatureKey() != b.FeatureKey() {
+		t.Errorf("Expected hands and round to leave the key unchanged")
+	}
+
+	b.CurrentPlayer = Player2
+	if a.FeatureKey() == b.FeatureKey() {
+		t.Errorf("Expected the player to move to change the key")
+	}
+}
+
 func TestWinnerDeterminationWithMoreCards(t *testing.T) {
 	// Create a new game
 	game := NewRPSGame(15, 5, 10)
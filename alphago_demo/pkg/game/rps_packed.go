@@ -0,0 +1,320 @@
+package game
+
+import "math/bits"
+
+// boardMask covers the 9 squares of the 3x3 board
+const boardMask uint16 = 0x1FF
+
+// MaxPackedMoves is the largest number of distinct moves in any position:
+// 3 card types x 9 squares
+const MaxPackedMoves = 27
+
+// orthogonalNeighbors[pos] is the bitboard of squares adjacent to pos
+// (up, right, down, left), matching processCapturesAt
+var orthogonalNeighbors = func() [9]uint16 {
+	var masks [9]uint16
+	for pos := 0; pos < 9; pos++ {
+		row, col := pos/3, pos%3
+		if row > 0 {
+			masks[pos] |= 1 << (pos - 3)
+		}
+		if row < 2 {
+			masks[pos] |= 1 << (pos + 3)
+		}
+		if col > 0 {
+			masks[pos] |= 1 << (pos - 1)
+		}
+		if col < 2 {
+			masks[pos] |= 1 << (pos + 1)
+		}
+	}
+	return masks
+}()
+
+// PackedRPSGame is a compact value-type RPSGame for search. Ownership and card
+// types are bitboards over the 9 squares and hands are per-type counts, so
+// the whole state is ~20 bytes and copying it allocates nothing. Moves are
+// applied in place with MakeMove and reverted with UnmakeMove.
+//
+// Hands are unordered: cards of the same type are interchangeable, so a
+// PackedMove names a card type instead of a hand index. This also removes
+// the duplicate moves RPSGame generates for identical cards.
+type PackedRPSGame struct {
+	Owner     [2]uint16   // Squares owned by Player1, Player2
+	Type      [3]uint16   // Occupied squares holding Rock, Paper, Scissors
+	Hand      [2][3]uint8 // Cards in hand by player and type
+	ToMove    uint8       // 0 for Player1, 1 for Player2
+	Round     uint16
+	MaxRounds uint16
+}
+
+// PackedMove places a card of the given type on a square
+type PackedMove struct {
+	Position uint8
+	Card     RPSCardType
+}
+
+// PackedUndo holds what UnmakeMove needs to revert a move
+type PackedUndo struct {
+	Move     PackedMove
+	Captured uint16 // Squares flipped to the mover by the move
+}
+
+// Pack converts an RPSGame into its packed form
+func (g *RPSGame) Pack() PackedRPSGame {
+	p := PackedRPSGame{
+		Round:     uint16(g.Round),
+		MaxRounds: uint16(g.MaxRounds),
+	}
+	if g.CurrentPlayer != Player1 {
+		p.ToMove = 1
+	}
+
+	for pos, card := range g.Board {
+		if card.Owner == NoPlayer {
+			continue
+		}
+		bit := uint16(1) << pos
+		p.Owner[playerSlot(card.Owner)] |= bit
+		p.Type[card.Type] |= bit
+	}
+
+	for _, card := range g.Player1Hand {
+		p.Hand[0][card.Type]++
+	}
+	for _, card := range g.Player2Hand {
+		p.Hand[1][card.Type]++
+	}
+
+	return p
+}
+
+// Unpack converts the packed state back into an RPSGame. Hands are rebuilt in
+// Rock, Paper, Scissors order and the move history is empty.
+func (p *PackedRPSGame) Unpack() *RPSGame {
+	g := &RPSGame{
+		CurrentPlayer: p.CurrentPlayer(),
+		MoveHistory:   []RPSMove{},
+		Round:         int(p.Round),
+		MaxRounds:     int(p.MaxRounds),
+	}
+
+	for pos := 0; pos < 9; pos++ {
+		bit := uint16(1) << pos
+		owner := p.OwnerAt(pos)
+		if owner == NoPlayer {
+			continue
+		}
+		for t := range p.Type {
+			if p.Type[t]&bit != 0 {
+				g.Board[pos] = RPSCard{Type: RPSCardType(t), Owner: owner}
+			}
+		}
+	}
+
+	g.Player1Hand = unpackHand(p.Hand[0])
+	g.Player2Hand = unpackHand(p.Hand[1])
+
+	return g
+}
+
+func unpackHand(counts [3]uint8) []RPSCard {
+	hand := make([]RPSCard, 0, int(counts[0])+int(counts[1])+int(counts[2]))
+	for t, count := range counts {
+		for i := 0; i < int(count); i++ {
+			hand = append(hand, RPSCard{Type: RPSCardType(t), Owner: NoPlayer})
+		}
+	}
+	return hand
+}
+
+func playerSlot(player RPSPlayer) int {
+	if player == Player1 {
+		return 0
+	}
+	return 1
+}
+
+// PackMove converts a move on this game into a PackedMove
+func (g *RPSGame) PackMove(move RPSMove) PackedMove {
+	hand := g.Player2Hand
+	if move.Player == Player1 {
+		hand = g.Player1Hand
+	}
+	return PackedMove{Position: uint8(move.Position), Card: hand[move.CardIndex].Type}
+}
+
+// UnpackMove converts a PackedMove into a move on this game, using the first
+// card of the right type in the current player's hand. It returns false if
+// the hand holds no such card.
+func (g *RPSGame) UnpackMove(move PackedMove) (RPSMove, bool) {
+	hand := g.Player2Hand
+	if g.CurrentPlayer == Player1 {
+		hand = g.Player1Hand
+	}
+	for i, card := range hand {
+		if card.Type == move.Card {
+			return RPSMove{CardIndex: i, Position: int(move.Position), Player: g.CurrentPlayer}, true
+		}
+	}
+	return RPSMove{}, false
+}
+
+// CurrentPlayer returns the player to move
+func (p *PackedRPSGame) CurrentPlayer() RPSPlayer {
+	if p.ToMove == 0 {
+		return Player1
+	}
+	return Player2
+}
+
+// OwnerAt returns the owner of a square, or NoPlayer if it is empty
+func (p *PackedRPSGame) OwnerAt(pos int) RPSPlayer {
+	bit := uint16(1) << pos
+	switch {
+	case p.Owner[0]&bit != 0:
+		return Player1
+	case p.Owner[1]&bit != 0:
+		return Player2
+	}
+	return NoPlayer
+}
+
+// Empty returns the bitboard of unoccupied squares
+func (p *PackedRPSGame) Empty() uint16 {
+	return ^(p.Owner[0] | p.Owner[1]) & boardMask
+}
+
+// HandSize returns the number of cards in a player's hand (slot 0 or 1)
+func (p *PackedRPSGame) HandSize(slot int) int {
+	h := p.Hand[slot]
+	return int(h[0]) + int(h[1]) + int(h[2])
+}
+
+// AppendMoves appends every distinct legal move to moves. Pass a
+// [MaxPackedMoves]PackedMove buffer to avoid allocating.
+func (p *PackedRPSGame) AppendMoves(moves []PackedMove) []PackedMove {
+	empty := p.Empty()
+	hand := p.Hand[p.ToMove]
+
+	for sq := empty; sq != 0; sq &= sq - 1 {
+		pos := uint8(bits.TrailingZeros16(sq))
+		for t := range hand {
+			if hand[t] > 0 {
+				moves = append(moves, PackedMove{Position: pos, Card: RPSCardType(t)})
+			}
+		}
+	}
+
+	return moves
+}
+
+// MakeMove applies a legal move in place and returns the information needed
+// to undo it. Legality is not checked; the move must come from AppendMoves.
+func (p *PackedRPSGame) MakeMove(move PackedMove) PackedUndo {
+	me, opp := p.ToMove, p.ToMove^1
+	bit := uint16(1) << move.Position
+
+	captured := p.CaptureMask(move)
+
+	p.Hand[me][move.Card]--
+	p.Owner[me] |= bit
+	p.Type[move.Card] |= bit
+
+	p.Owner[opp] &^= captured
+	p.Owner[me] |= captured
+
+	if me == 1 {
+		p.Round++
+	}
+	p.ToMove = opp
+
+	return PackedUndo{Move: move, Captured: captured}
+}
+
+// CaptureMask returns the squares move would capture: adjacent opposing cards
+// of the type the placed card beats
+func (p *PackedRPSGame) CaptureMask(move PackedMove) uint16 {
+	return orthogonalNeighbors[move.Position] & p.Owner[p.ToMove^1] & p.Type[beatenBy(move.Card)]
+}
+
+// UnmakeMove reverts the move described by undo, which must be the most
+// recent MakeMove still applied
+func (p *PackedRPSGame) UnmakeMove(undo PackedUndo) {
+	opp, me := p.ToMove, p.ToMove^1
+	bit := uint16(1) << undo.Move.Position
+
+	p.ToMove = me
+	if me == 1 {
+		p.Round--
+	}
+
+	p.Owner[me] &^= undo.Captured | bit
+	p.Owner[opp] |= undo.Captured
+	p.Type[undo.Move.Card] &^= bit
+	p.Hand[me][undo.Move.Card]++
+}
+
+// beatenBy returns the card type that t beats: Rock beats Scissors, Paper
+// beats Rock, Scissors beats Paper
+func beatenBy(t RPSCardType) RPSCardType {
+	return (t + 2) % 3
+}
+
+// IsGameOver mirrors RPSGame.IsGameOver
+func (p *PackedRPSGame) IsGameOver() bool {
+	if p.HandSize(0) == 0 && p.HandSize(1) == 0 {
+		return true
+	}
+	if p.Round > p.MaxRounds {
+		return true
+	}
+	return p.HandSize(int(p.ToMove)) == 0 || p.Empty() == 0
+}
+
+// CountPlayerCards returns the number of board squares a player owns
+func (p *PackedRPSGame) CountPlayerCards(player RPSPlayer) int {
+	if player == NoPlayer {
+		return 0
+	}
+	return bits.OnesCount16(p.Owner[playerSlot(player)])
+}
+
+// GetWinner mirrors RPSGame.GetWinner: the player owning more squares wins
+func (p *PackedRPSGame) GetWinner() RPSPlayer {
+	p1 := bits.OnesCount16(p.Owner[0])
+	p2 := bits.OnesCount16(p.Owner[1])
+	if p1 > p2 {
+		return Player1
+	} else if p2 > p1 {
+		return Player2
+	}
+	return NoPlayer
+}
+
+// FillBoardFeatures writes the same 81-feature encoding as
+// RPSGame.FillBoardFeatures
+func (p *PackedRPSGame) FillBoardFeatures(features []float64) {
+	features = features[:81]
+	for i := range features {
+		features[i] = 0
+	}
+
+	playerIdx := 6 + int(p.ToMove)
+	for pos := 0; pos < 9; pos++ {
+		baseIdx := pos * 9
+		bit := uint16(1) << pos
+
+		owner := p.OwnerAt(pos)
+		if owner != NoPlayer {
+			for t := range p.Type {
+				if p.Type[t]&bit != 0 {
+					features[baseIdx+t] = 1.0
+				}
+			}
+		}
+
+		features[baseIdx+int(owner)+3] = 1.0
+		features[baseIdx+playerIdx] = 1.0
+	}
+}
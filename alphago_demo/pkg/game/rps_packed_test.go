@@ -0,0 +1,130 @@
+package game
+
+import (
+	"math/rand"
+	"testing"
+)
+
+func TestPackedRoundTrip(t *testing.T) {
+	g := NewRPSGame(15, 5, 10)
+	move, _ := g.GetRandomMove()
+	g.MakeMove(move)
+
+	p := g.Pack()
+	if p.Unpack().Pack() != p {
+		t.Errorf("Unpack/Pack did not round-trip")
+	}
+
+	if p.CurrentPlayer() != g.CurrentPlayer {
+		t.Errorf("Expected player to move %v, got %v", g.CurrentPlayer, p.CurrentPlayer())
+	}
+	for pos := 0; pos < 9; pos++ {
+		if p.OwnerAt(pos) != g.Board[pos].Owner {
+			t.Errorf("Square %d: expected owner %v, got %v", pos, g.Board[pos].Owner, p.OwnerAt(pos))
+		}
+	}
+}
+
+// Playing random games on both representations must keep them in lockstep,
+// and unmaking every move must restore the starting position exactly
+func TestPackedMatchesRPSGame(t *testing.T) {
+	rng := rand.New(rand.NewSource(1))
+
+	for gameNum := 0; gameNum < 200; gameNum++ {
+		g := NewRPSGame(21, 5, 10)
+		p := g.Pack()
+		start := p
+		var undos []PackedUndo
+
+		for !g.IsGameOver() {
+			if p.IsGameOver() {
+				t.Fatalf("Game %d: packed state reports game over early", gameNum)
+			}
+
+			var buf [MaxPackedMoves]PackedMove
+			moves := p.AppendMoves(buf[:0])
+			if len(moves) == 0 {
+				t.Fatalf("Game %d: packed state has no moves", gameNum)
+			}
+
+			pm := moves[rng.Intn(len(moves))]
+			move, ok := g.UnpackMove(pm)
+			if !ok {
+				t.Fatalf("Game %d: packed move %+v has no matching card", gameNum, pm)
+			}
+			if g.PackMove(move) != pm {
+				t.Fatalf("Game %d: PackMove(UnpackMove(m)) != m", gameNum)
+			}
+
+			undos = append(undos, p.MakeMove(pm))
+			if err := g.MakeMove(move); err != nil {
+				t.Fatalf("Game %d: move rejected: %v", gameNum, err)
+			}
+
+			if g.Pack() != p {
+				t.Fatalf("Game %d: packed state diverged after %d moves", gameNum, len(undos))
+			}
+
+			var want, got [81]float64
+			g.FillBoardFeatures(want[:])
+			p.FillBoardFeatures(got[:])
+			if want != got {
+				t.Fatalf("Game %d: board features differ", gameNum)
+			}
+		}
+
+		if !p.IsGameOver() {
+			t.Errorf("Game %d: packed state should be over", gameNum)
+		}
+		if p.GetWinner() != g.GetWinner() {
+			t.Errorf("Game %d: expected winner %v, got %v", gameNum, g.GetWinner(), p.GetWinner())
+		}
+
+		for i := len(undos) - 1; i >= 0; i-- {
+			p.UnmakeMove(undos[i])
+		}
+		if p != start {
+			t.Errorf("Game %d: unmaking all moves did not restore the start position", gameNum)
+		}
+	}
+}
+
+func TestPackedMakeUnmakeAllocations(t *testing.T) {
+	p := NewRPSGame(15, 5, 10).Pack()
+
+	allocs := testing.AllocsPerRun(100, func() {
+		var buf [MaxPackedMoves]PackedMove
+		for _, move := range p.AppendMoves(buf[:0]) {
+			undo := p.MakeMove(move)
+			p.UnmakeMove(undo)
+		}
+	})
+	if allocs != 0 {
+		t.Errorf("Expected move generation and make/unmake to be allocation-free, got %.1f allocs/op", allocs)
+	}
+}
+
+func TestPackedHashIncremental(t *testing.T) {
+	rng := rand.New(rand.NewSource(2))
+
+	for gameNum := 0; gameNum < 100; gameNum++ {
+		p := NewRPSGame(21, 5, 10).Pack()
+		hash := p.Hash()
+		seen := map[uint64]PackedRPSGame{hash: p}
+
+		for !p.IsGameOver() {
+			var buf [MaxPackedMoves]PackedMove
+			moves := p.AppendMoves(buf[:0])
+			undo := p.MakeMove(moves[rng.Intn(len(moves))])
+
+			hash = p.HashAfter(hash, undo)
+			if hash != p.Hash() {
+				t.Fatalf("Game %d: incremental hash %x != full hash %x", gameNum, hash, p.Hash())
+			}
+			if other, ok := seen[hash]; ok && other != p {
+				t.Fatalf("Game %d: hash collision between distinct positions", gameNum)
+			}
+			seen[hash] = p
+		}
+	}
+}
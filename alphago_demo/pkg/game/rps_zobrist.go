@@ -0,0 +1,99 @@
+package game
+
+import "math/bits"
+
+// Zobrist keys for PackedRPSGame. They are derived from a fixed seed so a
+// position hashes to the same value in every process, which lets hashes be
+// persisted (e.g. in opening books).
+var (
+	zobristSquare [2][3][9]uint64   // Owner slot, card type, square
+	zobristHand   [2][3][256]uint64 // Player slot, card type, count in hand
+	zobristRound  [256]uint64       // Round, modulo 256
+	zobristSide   uint64            // Player2 to move
+)
+
+func init() {
+	state := uint64(0x6a09e667f3bcc908)
+	next := func() uint64 {
+		// splitmix64
+		state += 0x9e3779b97f4a7c15
+		z := state
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9
+		z = (z ^ (z >> 27)) * 0x94d049bb133111eb
+		return z ^ (z >> 31)
+	}
+
+	for slot := range zobristSquare {
+		for t := range zobristSquare[slot] {
+			for pos := range zobristSquare[slot][t] {
+				zobristSquare[slot][t][pos] = next()
+			}
+		}
+	}
+	for slot := range zobristHand {
+		for t := range zobristHand[slot] {
+			for count := range zobristHand[slot][t] {
+				zobristHand[slot][t][count] = next()
+			}
+		}
+	}
+	for round := range zobristRound {
+		zobristRound[round] = next()
+	}
+	zobristSide = next()
+}
+
+// Hash returns the Zobrist hash of the position: board, hand counts, player
+// to move and round. MaxRounds is not included, as it is fixed for a game.
+func (p *PackedRPSGame) Hash() uint64 {
+	var h uint64
+	for slot := 0; slot < 2; slot++ {
+		for t := 0; t < 3; t++ {
+			for sq := p.Owner[slot] & p.Type[t]; sq != 0; sq &= sq - 1 {
+				h ^= zobristSquare[slot][t][bits.TrailingZeros16(sq)]
+			}
+			h ^= zobristHand[slot][t][p.Hand[slot][t]]
+		}
+	}
+	if p.ToMove == 1 {
+		h ^= zobristSide
+	}
+	return h ^ zobristRound[p.Round&0xFF]
+}
+
+// HashAfter updates hash, the hash of the position before a move, for that
+// move. It must be called right after the MakeMove that returned undo. Going
+// back is free: keep the old hash.
+func (p *PackedRPSGame) HashAfter(hash uint64, undo PackedUndo) uint64 {
+	me, opp := p.ToMove^1, p.ToMove
+	t, pos := undo.Move.Card, undo.Move.Position
+
+	hash ^= zobristSquare[me][t][pos]
+
+	// Captured cards keep their type and change owner
+	for sq := undo.Captured; sq != 0; sq &= sq - 1 {
+		capturedPos := bits.TrailingZeros16(sq)
+		capturedType := p.typeAt(capturedPos)
+		hash ^= zobristSquare[opp][capturedType][capturedPos] ^ zobristSquare[me][capturedType][capturedPos]
+	}
+
+	count := p.Hand[me][t]
+	hash ^= zobristHand[me][t][count+1] ^ zobristHand[me][t][count]
+
+	hash ^= zobristSide
+	if me == 1 {
+		hash ^= zobristRound[(p.Round-1)&0xFF] ^ zobristRound[p.Round&0xFF]
+	}
+	return hash
+}
+
+// typeAt returns the card type on an occupied square
+func (p *PackedRPSGame) typeAt(pos int) RPSCardType {
+	bit := uint16(1) << pos
+	for t := range p.Type {
+		if p.Type[t]&bit != 0 {
+			return RPSCardType(t)
+		}
+	}
+	return Rock
+}
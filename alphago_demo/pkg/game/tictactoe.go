@@ -52,7 +52,7 @@ func (g *AGGame) GetValidMoves() []AGMove {
 	for row := 0; row < 3; row++ {
 		for col := 0; col < 3; col++ {
 			if g.Board[row][col] == Empty {
-				moves = append(moves, AGMove{Row: row, Col: col})
+				moves = append(moves, AGMove{Row: row, Col: col, Player: g.CurrentPlayer})
 			}
 		}
 	}
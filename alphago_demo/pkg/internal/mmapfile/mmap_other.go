@@ -0,0 +1,15 @@
+//go:build !unix
+
+package mmapfile
+
+import "os"
+
+// Map reads the whole file on platforms without mmap support. The data is a
+// private copy, so it is writable whether or not private is set.
+func Map(path string, private bool) ([]byte, func() error, error) {
+	data, err := os.ReadFile(path)
+	if err != nil {
+		return nil, nil, err
+	}
+	return data, func() error { return nil }, nil
+}
@@ -0,0 +1,46 @@
+//go:build unix
+
+package mmapfile
+
+import (
+	"errors"
+	"os"
+	"syscall"
+)
+
+// Map maps the whole file at path into memory, returning its data and a
+// function that unmaps it. The mapping is read-only and shared unless private
+// is set, in which case it is writable copy-on-write: writes to the data
+// never reach the file.
+//
+// An empty file, which cannot be mapped, gives empty data and a release that
+// does nothing, so callers reject it by its contents like any short file.
+func Map(path string, private bool) ([]byte, func() error, error) {
+	file, err := os.Open(path)
+	if err != nil {
+		return nil, nil, err
+	}
+	defer file.Close()
+
+	info, err := file.Stat()
+	if err != nil {
+		return nil, nil, err
+	}
+	size := info.Size()
+	if size == 0 {
+		return nil, func() error { return nil }, nil // Nothing to map
+	}
+	if int64(int(size)) != size {
+		return nil, nil, errors.New("file too large to map")
+	}
+
+	prot, flags := syscall.PROT_READ, syscall.MAP_SHARED
+	if private {
+		prot, flags = syscall.PROT_READ|syscall.PROT_WRITE, syscall.MAP_PRIVATE
+	}
+	data, err := syscall.Mmap(int(file.Fd()), 0, int(size), prot, flags)
+	if err != nil {
+		return nil, nil, err
+	}
+	return data, func() error { return syscall.Munmap(data) }, nil
+}
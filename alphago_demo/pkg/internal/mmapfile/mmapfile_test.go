@@ -0,0 +1,52 @@
+package mmapfile
+
+import (
+	"os"
+	"path/filepath"
+	"testing"
+)
+
+func TestMap(t *testing.T) {
+	path := filepath.Join(t.TempDir(), "data")
+	if err := os.WriteFile(path, []byte("mapped"), 0644); err != nil {
+		t.Fatal(err)
+	}
+
+	for _, private := range []bool{false, true} {
+		data, release, err := Map(path, private)
+		if err != nil {
+			t.Fatal(err)
+		}
+		if string(data) != "mapped" {
+			t.Errorf("private=%t: mapped %q", private, data)
+		}
+		if private {
+			// Writes to a private mapping stay out of the file
+			data[0] = 'M'
+		}
+		if err := release(); err != nil {
+			t.Fatal(err)
+		}
+	}
+	if contents, _ := os.ReadFile(path); string(contents) != "mapped" {
+		t.Errorf("Expected the file untouched, it holds %q", contents)
+	}
+}
+
+func TestMapEmptyFile(t *testing.T) {
+	path := filepath.Join(t.TempDir(), "empty")
+	if err := os.WriteFile(path, nil, 0644); err != nil {
+		t.Fatal(err)
+	}
+	data, release, err := Map(path, false)
+	if err != nil || len(data) != 0 {
+		t.Fatalf("Expected empty data for an empty file, got %q, %v", data, err)
+	}
+	if err := release(); err != nil {
+		t.Error(err)
+	}
+
+	if _, _, err := Map(filepath.Join(t.TempDir(), "missing"), false); err == nil {
+		t.Error("Expected an error for a missing file")
+	}
+}
@@ -0,0 +1,22 @@
+package mcts
+
+import "github.com/zachbeta/neural_rps/alphago_demo/pkg/metrics"
+
+// Search metrics, shared by every engine in the process. Simulations per
+// second is the rate of mcts_simulations_total.
+var (
+	simulationsTotal = metrics.NewCounter("mcts_simulations_total",
+		"Simulations run by MCTS searches")
+	searchSeconds = metrics.NewDurationHistogram("mcts_search_seconds",
+		"Time per MCTS search")
+	leafEvalSeconds = metrics.NewDurationHistogram("mcts_leaf_eval_seconds",
+		"Time per value network evaluation of an RPS search leaf, cache hits included")
+	expandSeconds = metrics.NewDurationHistogram("mcts_expand_seconds",
+		"Time per policy network evaluation of an RPS node being expanded, cache hits included")
+	treeDepth = metrics.NewHistogram("mcts_tree_depth",
+		"Depth below the root of the node each RPS simulation evaluates")
+	leafBatchSize = metrics.NewHistogram("mcts_leaf_batch_size",
+		"Leaves evaluated together by one batched value network call")
+	leafBatchSeconds = metrics.NewDurationHistogram("mcts_leaf_batch_seconds",
+		"Time per batched value network call")
+)
@@ -61,8 +61,12 @@ func (n *AGMCTSNode) GetUCB(c float64) float64 {
 		parentVisits = float64(n.Parent.Visits)
 	}
 
-	// Find the move index
-	priorProb := 1.0 / float64(len(n.Priors))
+	// Find the move index. A node still waiting for its priors in a leaf
+	// batch gets none, so its virtual loss keeps it out of the way.
+	priorProb := 0.0
+	if len(n.Priors) > 0 {
+		priorProb = 1.0 / float64(len(n.Priors))
+	}
 	if n.Move != nil {
 		moveIdx := n.Move.Row*3 + n.Move.Col
 		if moveIdx >= 0 && moveIdx < len(n.Priors) {
@@ -138,6 +142,17 @@ func (n *AGMCTSNode) GetBestChild() *AGMCTSNode {
 	return bestChild
 }
 
+// childForMove returns the child reached by move, or nil if it has not been
+// expanded
+func (n *AGMCTSNode) childForMove(move game.AGMove) *AGMCTSNode {
+	for _, child := range n.Children {
+		if child.Move != nil && child.Move.Row == move.Row && child.Move.Col == move.Col {
+			return child
+		}
+	}
+	return nil
+}
+
 // GetRandomChild returns a random child
 func (n *AGMCTSNode) GetRandomChild() *AGMCTSNode {
 	if len(n.Children) == 0 {
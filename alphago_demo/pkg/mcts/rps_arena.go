@@ -0,0 +1,126 @@
+package mcts
+
+import (
+	"sync"
+
+	"github.com/zachbeta/neural_rps/alphago_demo/pkg/game"
+)
+
+// arenaSlabSize is the number of nodes (and child pointers) per slab
+const arenaSlabSize = 4096
+
+// nodeArena hands out RPSMCTSNodes from large slabs instead of allocating
+// each node individually. Reset makes every slab available again without
+// freeing it, so a search engine that plays many games reaches a steady state
+// where building a tree allocates almost nothing. Each node keeps its game
+// state inline, and that state's slices are reused as well.
+//
+// Nodes from an arena are only valid until the next Reset.
+type nodeArena struct {
+	mu sync.Mutex
+
+	nodes    [][]RPSMCTSNode
+	nodeSlab int // Index of the slab currently being filled
+	nodeUsed int // Nodes handed out from that slab
+
+	ptrs    [][]*RPSMCTSNode
+	ptrSlab int
+	ptrUsed int
+
+	priors    [][]float64 // Storage for the nodes' policy priors
+	priorSlab int
+	priorUsed int
+
+	handedOut int
+}
+
+// newNodeArena creates an empty arena
+func newNodeArena() *nodeArena {
+	return &nodeArena{}
+}
+
+// alloc returns k contiguous nodes and an empty child-pointer slice with
+// capacity k. It is safe for concurrent use.
+func (a *nodeArena) alloc(k int) ([]RPSMCTSNode, []*RPSMCTSNode) {
+	a.mu.Lock()
+	defer a.mu.Unlock()
+
+	nodes := carve(&a.nodes, &a.nodeSlab, &a.nodeUsed, k)
+	ptrs := carve(&a.ptrs, &a.ptrSlab, &a.ptrUsed, k)[:0]
+	a.handedOut += k
+	return nodes, ptrs
+}
+
+// allocPriors returns storage for k policy priors, valid until the next
+// Reset. It is safe for concurrent use.
+func (a *nodeArena) allocPriors(k int) []float64 {
+	a.mu.Lock()
+	defer a.mu.Unlock()
+
+	return carve(&a.priors, &a.priorSlab, &a.priorUsed, k)
+}
+
+// carve takes k contiguous elements from the current slab, moving on to the
+// next slab (allocating one if needed) when the current one is too full
+func carve[T any](slabs *[][]T, slab, used *int, k int) []T {
+	for {
+		if *slab == len(*slabs) {
+			*slabs = append(*slabs, make([]T, max(k, arenaSlabSize)))
+		}
+		if current := (*slabs)[*slab]; *used+k <= len(current) {
+			out := current[*used : *used+k : *used+k]
+			*used += k
+			return out
+		}
+		*slab++
+		*used = 0
+	}
+}
+
+// Reset makes all slabs available for reuse. Every node previously handed out
+// becomes invalid.
+func (a *nodeArena) Reset() {
+	a.mu.Lock()
+	defer a.mu.Unlock()
+
+	a.nodeSlab, a.nodeUsed = 0, 0
+	a.ptrSlab, a.ptrUsed = 0, 0
+	a.priorSlab, a.priorUsed = 0, 0
+	a.handedOut = 0
+}
+
+// Size returns the number of nodes handed out since the last Reset
+func (a *nodeArena) Size() int {
+	a.mu.Lock()
+	defer a.mu.Unlock()
+
+	return a.handedOut
+}
+
+// newRoot allocates a root node holding a copy of state
+func (a *nodeArena) newRoot(state *game.RPSGame, priors []float64) *RPSMCTSNode {
+	nodes, _ := a.alloc(1)
+	root := &nodes[0]
+	state.CopyInto(&root.state)
+	root.init(a, nil, nil, priors)
+	return root
+}
+
+// init resets a recycled node for reuse. GameState points at the node's
+// inline state, which the caller has already filled in.
+func (n *RPSMCTSNode) init(arena *nodeArena, move *game.RPSMove, parent *RPSMCTSNode, priors []float64) {
+	n.GameState = &n.state
+	n.Move = nil
+	if move != nil {
+		n.move = *move
+		n.Move = &n.move
+	}
+	n.Parent = parent
+	n.Children = nil
+	n.Priors = priors
+	n.Visits.Store(0)
+	n.TotalValue.Store(0)
+	n.VirtualLoss.Store(0)
+	n.expandState.Store(nodeUnexpanded)
+	n.arena = arena
+}
@@ -7,34 +7,88 @@ import (
 	"github.com/zachbeta/neural_rps/alphago_demo/pkg/game"
 )
 
-// RPSMCTSNode represents a node in the MCTS tree for RPS
+// maxRPSMoves bounds the move list for typical hands (9 positions x 5 cards)
+// so it can live on the stack; larger hands just spill to the heap
+const maxRPSMoves = 45
+
+// Expansion states for RPSMCTSNode.expandState
+const (
+	nodeUnexpanded int32 = iota
+	nodeExpanding
+	nodeExpanded
+)
+
+// AtomicFloat64 is a float64 that can be updated concurrently
+type AtomicFloat64 struct {
+	bits atomic.Uint64
+}
+
+// Load returns the current value
+func (f *AtomicFloat64) Load() float64 {
+	return math.Float64frombits(f.bits.Load())
+}
+
+// Store sets the value
+func (f *AtomicFloat64) Store(value float64) {
+	f.bits.Store(math.Float64bits(value))
+}
+
+// Add atomically adds delta and returns the new value
+func (f *AtomicFloat64) Add(delta float64) float64 {
+	for {
+		old := f.bits.Load()
+		updated := math.Float64frombits(old) + delta
+		if f.bits.CompareAndSwap(old, math.Float64bits(updated)) {
+			return updated
+		}
+	}
+}
+
+// RPSMCTSNode represents a node in the MCTS tree for RPS.
+//
+// Visits, TotalValue and VirtualLoss may be updated concurrently. Children is
+// written once during expansion; concurrent readers must check IsExpanded
+// before reading it.
 type RPSMCTSNode struct {
 	GameState  *game.RPSGame
 	Move       *game.RPSMove
 	Parent     *RPSMCTSNode
 	Children   []*RPSMCTSNode
 	Visits     atomic.Int64
-	TotalValue float64
+	TotalValue AtomicFloat64
 	Priors     []float64 // Policy priors from neural network
+
+	// VirtualLoss counts simulations currently in flight through this node.
+	// Each one is treated as a visit with zero value, steering other workers
+	// away from the path until the real result is backpropagated.
+	VirtualLoss atomic.Int64
+
+	expandState atomic.Int32
+
+	// Set for nodes allocated from an arena: children come from the same
+	// arena, and GameState/Move point at the inline copies below
+	arena *nodeArena
+	state game.RPSGame
+	move  game.RPSMove
 }
 
 // NewRPSMCTSNode creates a new MCTS node
 func NewRPSMCTSNode(state *game.RPSGame, move *game.RPSMove, parent *RPSMCTSNode, priors []float64) *RPSMCTSNode {
 	n := &RPSMCTSNode{
-		GameState:  state,
-		Move:       move,
-		Parent:     parent,
-		Children:   make([]*RPSMCTSNode, 0),
-		TotalValue: 0,
-		Priors:     priors,
+		GameState: state,
+		Move:      move,
+		Parent:    parent,
+		Children:  make([]*RPSMCTSNode, 0),
+		Priors:    priors,
 	}
 	return n
 }
 
 // UCB calculates the Upper Confidence Bound value for this node
 // Used for node selection during MCTS
+// In-flight simulations count as visits with zero value (virtual loss).
 func (n *RPSMCTSNode) UCB(explorationConstant float64) float64 {
-	visits := n.Visits.Load()
+	visits := n.Visits.Load() + n.VirtualLoss.Load()
 	if visits == 0 {
 		return math.Inf(1) // Infinity for unvisited nodes
 	}
@@ -49,10 +103,10 @@ func (n *RPSMCTSNode) UCB(explorationConstant float64) float64 {
 	// UCB formula with prior: Q + U
 	// Q = average value
 	// U = exploration bonus with prior
-	exploitation := n.TotalValue / float64(visits)
+	exploitation := n.TotalValue.Load() / float64(visits)
 	parentVisits := int64(0)
 	if n.Parent != nil {
-		parentVisits = n.Parent.Visits.Load()
+		parentVisits = n.Parent.Visits.Load() + n.Parent.VirtualLoss.Load()
 	}
 	exploration := explorationConstant * prior * math.Sqrt(float64(parentVisits)) / (1.0 + float64(visits))
 
@@ -79,14 +133,46 @@ func (n *RPSMCTSNode) SelectChild(explorationConstant float64) *RPSMCTSNode {
 	return bestChild
 }
 
-// ExpandAll expands all possible child nodes
+// ExpandAll expands all possible child nodes. It is not safe for concurrent
+// use; parallel searches use TryExpand.
 func (n *RPSMCTSNode) ExpandAll(priors []float64) {
-	// Clear any existing children
-	n.Children = make([]*RPSMCTSNode, 0)
+	n.Children = n.buildChildren(priors)
+	n.expandState.Store(nodeExpanded)
+}
+
+// TryExpand expands the node if no other goroutine has done so or is doing
+// so. Only the caller that wins the race calls priorsFn and creates the
+// children; it returns true. Everyone else returns false immediately and
+// should treat the node as a leaf for this simulation.
+func (n *RPSMCTSNode) TryExpand(priorsFn func() []float64) bool {
+	if !n.expandState.CompareAndSwap(nodeUnexpanded, nodeExpanding) {
+		return false
+	}
+
+	n.Children = n.buildChildren(priorsFn())
+
+	// Publishes Children to readers that observe IsExpanded
+	n.expandState.Store(nodeExpanded)
+	return true
+}
+
+// IsExpanded reports whether the node's children have been created and
+// published
+func (n *RPSMCTSNode) IsExpanded() bool {
+	return n.expandState.Load() == nodeExpanded
+}
+
+// buildChildren creates one child per valid move
+func (n *RPSMCTSNode) buildChildren(priors []float64) []*RPSMCTSNode {
+	if n.arena != nil {
+		return n.buildArenaChildren(priors)
+	}
 
 	// Get valid moves
 	validMoves := n.GameState.GetValidMoves()
 
+	children := make([]*RPSMCTSNode, 0)
+
 	// Create children for each valid move
 	for _, move := range validMoves {
 		// Create a copy of the game state
@@ -101,14 +187,37 @@ func (n *RPSMCTSNode) ExpandAll(priors []float64) {
 
 		// Create and add the child node
 		child := NewRPSMCTSNode(childState, &moveCopy, n, priors)
-		n.Children = append(n.Children, child)
+		children = append(children, child)
 	}
+
+	return children
+}
+
+// buildArenaChildren is buildChildren for arena-backed nodes: the children
+// and their game states are carved out of the arena's slabs
+func (n *RPSMCTSNode) buildArenaChildren(priors []float64) []*RPSMCTSNode {
+	var buf [maxRPSMoves]game.RPSMove
+	validMoves := n.GameState.AppendValidMoves(buf[:0])
+	nodes, children := n.arena.alloc(len(validMoves))
+
+	for i := range validMoves {
+		child := &nodes[i]
+		n.GameState.CopyInto(&child.state)
+		if err := child.state.MakeMove(validMoves[i]); err != nil {
+			continue // Skip invalid moves
+		}
+
+		child.init(n.arena, &validMoves[i], n, priors)
+		children = append(children, child)
+	}
+
+	return children
 }
 
 // Update updates the node statistics based on simulation results
 func (n *RPSMCTSNode) Update(value float64) {
 	n.Visits.Add(1)
-	n.TotalValue += value
+	n.TotalValue.Add(value)
 }
 
 // UpdateRecursive updates this node and all its ancestors
@@ -123,6 +232,43 @@ func (n *RPSMCTSNode) UpdateRecursive(value float64) {
 	}
 }
 
+// depth returns the number of moves from the root to n
+func (n *RPSMCTSNode) depth() int {
+	d := 0
+	for p := n.Parent; p != nil; p = p.Parent {
+		d++
+	}
+	return d
+}
+
+// childForMove returns the child reached by move, or nil
+func (n *RPSMCTSNode) childForMove(move game.RPSMove) *RPSMCTSNode {
+	for _, child := range n.Children {
+		if child.Move != nil && *child.Move == move {
+			return child
+		}
+	}
+	return nil
+}
+
+// AddVirtualLoss marks a simulation as in flight through this node
+func (n *RPSMCTSNode) AddVirtualLoss() {
+	n.VirtualLoss.Add(1)
+}
+
+// BackpropagateVirtual records a simulation result on this node and all its
+// ancestors, removing the virtual loss each of them received during selection
+func (n *RPSMCTSNode) BackpropagateVirtual(value float64) {
+	for node := n; node != nil; node = node.Parent {
+		node.Visits.Add(1)
+		node.TotalValue.Add(value)
+		node.VirtualLoss.Add(-1)
+
+		// Flip value perspective for parent (from opponent's point of view)
+		value = 1.0 - value
+	}
+}
+
 // MostVisitedChild returns the child with the most visits
 func (n *RPSMCTSNode) MostVisitedChild() *RPSMCTSNode {
 	if len(n.Children) == 0 {
@@ -153,7 +299,7 @@ func (n *RPSMCTSNode) BestChild() *RPSMCTSNode {
 	bestChildVisits := bestChild.Visits.Load()
 	bestValue := 0.0
 	if bestChildVisits > 0 {
-		bestValue = bestChild.TotalValue / float64(bestChildVisits)
+		bestValue = bestChild.TotalValue.Load() / float64(bestChildVisits)
 	} else {
 		// Handle case where the first child might have 0 visits if it's the only one
 		// For safety, though UCB should prevent selecting unvisited if others exist
@@ -166,7 +312,7 @@ func (n *RPSMCTSNode) BestChild() *RPSMCTSNode {
 			continue
 		}
 
-		value := child.TotalValue / float64(childVisits)
+		value := child.TotalValue.Load() / float64(childVisits)
 		if value > bestValue {
 			bestChild = child
 			bestValue = value
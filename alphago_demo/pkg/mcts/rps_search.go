@@ -3,7 +3,10 @@ package mcts
 import (
 	"runtime"
 	"sync"
+	"sync/atomic"
+	"time"
 
+	"github.com/zachbeta/neural_rps/alphago_demo/pkg/book"
 	"github.com/zachbeta/neural_rps/alphago_demo/pkg/game"
 	neural "github.com/zachbeta/neural_rps/alphago_demo/pkg/rps_net_impl"
 )
@@ -15,6 +18,9 @@ type RPSMCTSParams struct {
 	DirichletNoise   bool
 	DirichletWeight  float64
 	DirichletAlpha   float64
+	NumWorkers       int  // Goroutines for parallel search; 0 uses GOMAXPROCS
+	ReuseTree        bool // Keep the matching subtree when SetRootState is given a position already in the tree (off by default)
+	Quantized        bool // NewRPSMCTS evaluates with int8 copies of the networks (see RPSPolicyNetwork.Quantized)
 }
 
 // DefaultRPSMCTSParams returns default MCTS parameters
@@ -34,29 +40,131 @@ type RPSMCTS struct {
 	ValueNetwork  *neural.RPSValueNetwork
 	Params        RPSMCTSParams
 	Root          *RPSMCTSNode
+
+	// Book, when set, short-circuits Search for positions it contains: the
+	// root is expanded and the book move's child returned without running
+	// simulations. Leave it nil when visit counts are needed (self-play).
+	Book *book.Book
+
+	// Cache, when set, memoizes network outputs. It can be shared between
+	// engines and across searches; nil evaluates every position.
+	Cache *neural.EvalCache
+
+	arena *nodeArena
 }
 
 // NewRPSMCTS creates a new MCTS instance
 func NewRPSMCTS(policyNetwork *neural.RPSPolicyNetwork, valueNetwork *neural.RPSValueNetwork, params RPSMCTSParams) *RPSMCTS {
+	if params.Quantized && policyNetwork != nil && valueNetwork != nil {
+		policyNetwork, valueNetwork = policyNetwork.Quantized(), valueNetwork.Quantized()
+	}
 	return &RPSMCTS{
 		PolicyNetwork: policyNetwork,
 		ValueNetwork:  valueNetwork,
 		Params:        params,
 		Root:          nil,
+		arena:         newNodeArena(),
 	}
 }
 
-// SetRootState sets the root state of the search tree
+// SetRootState sets the root state of the search tree.
+//
+// With ReuseTree set, if state is the current root or one of its children or
+// grandchildren (our move, then the opponent's reply), that subtree is
+// promoted to root and its statistics are kept. Otherwise the tree is
+// discarded and the node arena is reset, invalidating every node from
+// previous searches.
 func (mcts *RPSMCTS) SetRootState(state *game.RPSGame) {
-	// Get policy priors from the neural network
-	priors := mcts.PolicyNetwork.Predict(state)
+	if mcts.Params.ReuseTree {
+		if node := mcts.findReusableNode(state); node != nil {
+			mcts.promote(node)
+			return
+		}
+	}
+
+	// Create a new root node, with policy priors from the neural network
+	if mcts.arena == nil {
+		mcts.arena = newNodeArena()
+	}
+	mcts.arena.Reset()
+	mcts.Root = mcts.arena.newRoot(state, mcts.policy(state))
+}
+
+// AdvanceRoot moves the root down the tree along the given moves, e.g. our
+// chosen move followed by the opponent's reply, keeping that subtree's
+// statistics. It returns false, leaving the tree unchanged, if any move isn't
+// an expanded child.
+func (mcts *RPSMCTS) AdvanceRoot(moves ...game.RPSMove) bool {
+	node := mcts.Root
+	for _, move := range moves {
+		if node == nil {
+			return false
+		}
+		node = node.childForMove(move)
+	}
+	if node == nil {
+		return false
+	}
+
+	mcts.promote(node)
+	return true
+}
+
+// TreeSize returns the number of nodes allocated since the tree was last
+// rebuilt from scratch
+func (mcts *RPSMCTS) TreeSize() int {
+	if mcts.arena == nil {
+		return 0
+	}
+	return mcts.arena.Size()
+}
+
+// findReusableNode looks for state among the root and its first two levels
+func (mcts *RPSMCTS) findReusableNode(state *game.RPSGame) *RPSMCTSNode {
+	root := mcts.Root
+	if root == nil || root.arena != mcts.arena {
+		return nil
+	}
+	if root.GameState.SamePosition(state) {
+		return root
+	}
+
+	for _, child := range root.Children {
+		if child.GameState.SamePosition(state) {
+			return child
+		}
+		for _, grandchild := range child.Children {
+			if grandchild.GameState.SamePosition(state) {
+				return grandchild
+			}
+		}
+	}
 
-	// Create a new root node
-	mcts.Root = NewRPSMCTSNode(state.Copy(), nil, nil, priors)
+	return nil
 }
 
-// Search performs the MCTS algorithm and returns the best move
+// promote makes node the root, detaching it from its parent so that
+// backpropagation stops there. The rest of the old tree stays in the arena
+// until the next reset.
+func (mcts *RPSMCTS) promote(node *RPSMCTSNode) {
+	if node.Parent != nil {
+		// Children's UCB reads the root's priors, so give the new root the
+		// policy for its own position
+		node.Priors = mcts.policy(node.GameState)
+		node.Parent = nil
+	}
+	mcts.Root = node
+}
+
+// Search performs the MCTS algorithm and returns the root child for the best
+// move. The node lives in the engine's arena: it, its Move and its children
+// are only valid until the next SetRootState rebuilds the tree, so copy out
+// anything kept longer (callers normally take *node.Move straight away).
 func (mcts *RPSMCTS) Search() *RPSMCTSNode {
+	if node := mcts.bookChild(); node != nil {
+		return node
+	}
+
 	// Check if we should use parallel search
 	// Use parallel search for large simulation counts on multi-core systems
 	if mcts.Params.NumSimulations > 100 && runtime.NumCPU() > 2 {
@@ -67,33 +175,40 @@ func (mcts *RPSMCTS) Search() *RPSMCTSNode {
 	return mcts.searchSerial()
 }
 
-// searchSerial performs serial MCTS (original implementation)
-func (mcts *RPSMCTS) searchSerial() *RPSMCTSNode {
-	if mcts.Root == nil {
+// bookChild returns the root child for the book move, or nil if there is no
+// book or the root position is not in it
+func (mcts *RPSMCTS) bookChild() *RPSMCTSNode {
+	if mcts.Book == nil || mcts.Root == nil {
+		return nil
+	}
+	move, _, ok := mcts.Book.Probe(mcts.Root.GameState)
+	if !ok {
 		return nil
 	}
 
-	// Expand the root node if needed
-	if len(mcts.Root.Children) == 0 {
-		priors := mcts.PolicyNetwork.Predict(mcts.Root.GameState)
-		mcts.Root.ExpandAll(priors)
+	mcts.Root.TryExpand(func() []float64 {
+		return mcts.policy(mcts.Root.GameState)
+	})
+	return mcts.Root.childForMove(move)
+}
+
+// searchSerial performs serial MCTS (original implementation)
+func (mcts *RPSMCTS) searchSerial() *RPSMCTSNode {
+	if !mcts.BeginSearch() {
+		return nil
 	}
+	start := time.Now()
 
 	// Run simulations
 	for i := 0; i < mcts.Params.NumSimulations; i++ {
 		// Selection phase
-		node := mcts.selection(mcts.Root)
+		node, expand := mcts.SelectLeaf()
 
 		// Expansion phase (if needed)
-		if !node.GameState.IsGameOver() && node.Visits.Load() > 0 {
-			priors := mcts.PolicyNetwork.Predict(node.GameState)
-			node.ExpandAll(priors)
-
-			// If expansion created children, select one of them
-			if len(node.Children) > 0 {
-				node = node.Children[0] // Select first child for simplicity
-			}
+		if expand {
+			node = mcts.ExpandLeaf(node, mcts.policy(node.GameState))
 		}
+		treeDepth.Observe(uint64(node.depth()))
 
 		// Evaluation phase
 		value := mcts.evaluate(node)
@@ -102,151 +217,164 @@ func (mcts *RPSMCTS) searchSerial() *RPSMCTSNode {
 		node.UpdateRecursive(value)
 	}
 
+	simulationsTotal.Add(uint64(mcts.Params.NumSimulations))
+	searchSeconds.Since(start)
+
 	// Return the most visited child of the root
 	return mcts.Root.MostVisitedChild()
 }
 
-// searchParallel performs parallel MCTS using multiple goroutines
-func (mcts *RPSMCTS) searchParallel() *RPSMCTSNode {
+// BeginSearch prepares the root for a search driven step by step with
+// SelectLeaf, ExpandLeaf and Backup, expanding it if needed. It returns false
+// if there is no root.
+//
+// The steps are those of a serial Search, with the network calls left to the
+// caller, so a caller running many searches at once (e.g. one per game of a
+// population evaluation) can batch every search's pending evaluations into
+// one forward pass per network.
+func (mcts *RPSMCTS) BeginSearch() bool {
 	if mcts.Root == nil {
-		return nil
+		return false
 	}
 
-	// Expand the root node if needed (this needs to be done before parallelization)
+	// Expand the root node if needed
 	if len(mcts.Root.Children) == 0 {
-		priors := mcts.PolicyNetwork.Predict(mcts.Root.GameState)
+		priors := mcts.policy(mcts.Root.GameState)
 		mcts.Root.ExpandAll(priors)
 	}
+	return true
+}
 
-	// Determine optimal worker count
-	// Use n-1 workers to avoid saturating all cores
-	numWorkers := runtime.NumCPU() - 1
-	if numWorkers < 1 {
-		numWorkers = 1
-	}
-
-	// Calculate simulations per worker
-	simsPerWorker := mcts.Params.NumSimulations / numWorkers
-	extraSims := mcts.Params.NumSimulations % numWorkers
-
-	// Create mutex for thread-safe tree access
-	treeMutex := &sync.RWMutex{}
-
-	// Create wait group to synchronize workers
-	var wg sync.WaitGroup
-
-	// Start worker goroutines
-	for i := 0; i < numWorkers; i++ {
-		// Calculate how many simulations this worker should perform
-		workerSims := simsPerWorker
-		if i == 0 {
-			// First worker gets any extra simulations
-			workerSims += extraSims
-		}
+// SelectLeaf runs the selection phase of one simulation. expand reports that
+// the leaf has been visited before and is not terminal, so the simulation
+// expands it next: the caller passes its policy priors to ExpandLeaf and
+// continues from the node that returns.
+func (mcts *RPSMCTS) SelectLeaf() (leaf *RPSMCTSNode, expand bool) {
+	leaf = mcts.selection(mcts.Root)
+	return leaf, !leaf.GameState.IsGameOver() && leaf.Visits.Load() > 0
+}
 
-		wg.Add(1)
-		go func(simCount int) {
-			defer wg.Done()
+// ExpandLeaf expands leaf with the given priors and returns the node the
+// simulation evaluates: the leaf's first child, or the leaf itself if it has
+// no moves
+func (mcts *RPSMCTS) ExpandLeaf(leaf *RPSMCTSNode, priors []float64) *RPSMCTSNode {
+	leaf.ExpandAll(priors)
 
-			// Each worker performs its share of simulations
-			for j := 0; j < simCount; j++ {
-				// Selection phase (with read lock)
-				treeMutex.RLock()
-				node := mcts.selectionThreadSafe(mcts.Root)
-				treeMutex.RUnlock()
+	// If expansion created children, select one of them
+	if len(leaf.Children) > 0 {
+		return leaf.Children[0] // Select first child for simplicity
+	}
+	return leaf
+}
 
-				// Local copy of the selected node's game state to avoid locks during evaluation
-				localState := node.GameState.Copy()
+// TerminalValue returns the outcome of a finished game at node, from the
+// point of view of its player to move, as used for backpropagation. ok is
+// false if the game is not over and the value network must be consulted.
+func TerminalValue(node *RPSMCTSNode) (value float64, ok bool) {
+	if !node.GameState.IsGameOver() {
+		return 0, false
+	}
 
-				// Check if expansion is needed, using a local check to minimize lock time
-				needsExpansion := !localState.IsGameOver() && node.Visits.Load() > 0 && len(node.Children) == 0
+	winner := node.GameState.GetWinner()
+	if winner == game.NoPlayer {
+		return 0.5, true // Draw
+	} else if winner == node.GameState.CurrentPlayer {
+		return 1.0, true // Win for current player
+	}
+	return 0.0, true // Loss for current player
+}
 
-				// Expansion phase (with write lock, only if needed)
-				if needsExpansion {
-					// Get policy network prediction outside the lock
-					priors := mcts.PolicyNetwork.Predict(localState)
+// Backup finishes a simulation by backpropagating the value of its
+// evaluated node
+func (mcts *RPSMCTS) Backup(node *RPSMCTSNode, value float64) {
+	node.UpdateRecursive(value)
+}
 
-					// Take write lock for expansion
-					treeMutex.Lock()
+// searchParallel performs lock-free tree-parallel MCTS using multiple
+// goroutines. Workers share one tree: node statistics are updated atomically,
+// virtual loss spreads concurrent selections across different paths, and
+// each node is expanded exactly once via TryExpand.
+func (mcts *RPSMCTS) searchParallel() *RPSMCTSNode {
+	if mcts.Root == nil {
+		return nil
+	}
 
-					// Double-check that expansion is still needed (another thread might have expanded)
-					if !node.GameState.IsGameOver() && node.Visits.Load() > 0 && len(node.Children) == 0 {
-						node.ExpandAll(priors)
+	// Expand the root node if needed (this needs to be done before parallelization)
+	if len(mcts.Root.Children) == 0 {
+		priors := mcts.policy(mcts.Root.GameState)
+		mcts.Root.ExpandAll(priors)
+	}
 
-						// If expansion created children, select one of them
-						if len(node.Children) > 0 {
-							node = node.Children[0]
-						}
-					}
+	numWorkers := mcts.Params.NumWorkers
+	if numWorkers <= 0 {
+		numWorkers = runtime.GOMAXPROCS(0)
+	}
+	start := time.Now()
 
-					treeMutex.Unlock()
-				}
+	// Workers claim simulations from a shared budget so fast workers aren't
+	// left idle while slow ones finish a fixed share
+	var remaining atomic.Int64
+	remaining.Store(int64(mcts.Params.NumSimulations))
 
-				// Evaluation phase (thread-safe, no locks needed)
-				// Use the local copy of the game state
-				value := mcts.evaluateState(localState)
+	var wg sync.WaitGroup
+	for i := 0; i < numWorkers; i++ {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
 
-				// Backpropagation phase (with write lock)
-				treeMutex.Lock()
-				mcts.backpropagateThreadSafe(node, value)
-				treeMutex.Unlock()
+			for remaining.Add(-1) >= 0 {
+				mcts.simulateParallel()
 			}
-		}(workerSims)
+		}()
 	}
 
 	// Wait for all workers to complete
 	wg.Wait()
+	simulationsTotal.Add(uint64(mcts.Params.NumSimulations))
+	searchSeconds.Since(start)
 
 	// Return the most visited child of the root
 	return mcts.Root.MostVisitedChild()
 }
 
-// selectionThreadSafe is a thread-safe version of selection
-// Caller must hold at least a read lock
-func (mcts *RPSMCTS) selectionThreadSafe(node *RPSMCTSNode) *RPSMCTSNode {
-	// Keep traversing until we reach a leaf node or a terminal state
-	for len(node.Children) > 0 && !node.GameState.IsGameOver() {
+// simulateParallel runs one selection/expansion/evaluation/backpropagation
+// pass without taking any locks
+func (mcts *RPSMCTS) simulateParallel() {
+	node := mcts.Root
+	node.AddVirtualLoss()
+	depth := 0
+
+	// Selection phase: only descend into nodes whose children are published
+	for node.IsExpanded() && len(node.Children) > 0 && !node.GameState.IsGameOver() {
 		node = node.SelectChild(mcts.Params.ExplorationConst)
+		node.AddVirtualLoss()
+		depth++
 		if node.Visits.Load() == 0 {
-			// Found an unvisited node, return it
-			return node
+			// Found an unvisited node
+			break
 		}
 	}
 
-	return node
-}
-
-// backpropagateThreadSafe is a thread-safe version of backpropagation
-// Caller must hold a write lock
-func (mcts *RPSMCTS) backpropagateThreadSafe(node *RPSMCTSNode, value float64) {
-	// Update this node
-	node.Update(value)
-
-	// Update parent recursively
-	if node.Parent != nil {
-		// Flip value perspective for parent (from opponent's point of view)
-		mcts.backpropagateThreadSafe(node.Parent, 1.0-value)
-	}
-}
-
-// evaluateState evaluates a game state without using the node
-// This avoids needing to lock the tree during evaluation
-func (mcts *RPSMCTS) evaluateState(state *game.RPSGame) float64 {
-	// If game is over, return actual outcome
-	if state.IsGameOver() {
-		winner := state.GetWinner()
-
-		if winner == game.NoPlayer {
-			return 0.5 // Draw
-		} else if winner == state.CurrentPlayer {
-			return 1.0 // Win for current player
-		} else {
-			return 0.0 // Loss for current player
+	// Expansion phase: the first worker to reach a visited leaf expands it;
+	// any others racing for it evaluate the leaf itself this time
+	if !node.GameState.IsGameOver() && node.Visits.Load() > 0 {
+		leaf := node
+		expanded := leaf.TryExpand(func() []float64 {
+			return mcts.policy(leaf.GameState)
+		})
+		if expanded && len(leaf.Children) > 0 {
+			node = leaf.Children[0]
+			node.AddVirtualLoss()
+			depth++
 		}
 	}
+	treeDepth.Observe(uint64(depth))
 
-	// Otherwise, use value network for position evaluation
-	return mcts.ValueNetwork.Predict(state)
+	// Evaluation phase: node game states are immutable once created
+	value := mcts.evaluate(node)
+
+	// Backpropagation phase
+	node.BackpropagateVirtual(value)
 }
 
 // selection traverses the tree to find a node to expand
@@ -266,27 +394,37 @@ func (mcts *RPSMCTS) selection(node *RPSMCTSNode) *RPSMCTSNode {
 // evaluate estimates the value of a node
 func (mcts *RPSMCTS) evaluate(node *RPSMCTSNode) float64 {
 	// If game is over, return actual outcome
-	if node.GameState.IsGameOver() {
-		winner := node.GameState.GetWinner()
-
-		if winner == game.NoPlayer {
-			return 0.5 // Draw
-		} else if winner == node.GameState.CurrentPlayer {
-			return 1.0 // Win for current player
-		} else {
-			return 0.0 // Loss for current player
-		}
+	if value, ok := TerminalValue(node); ok {
+		return value
 	}
 
 	// Otherwise, use value network for position evaluation
-	return mcts.ValueNetwork.Predict(node.GameState)
+	start := time.Now()
+	value := mcts.Cache.Value(mcts.ValueNetwork, node.GameState)
+	leafEvalSeconds.Since(start)
+	return value
+}
+
+// policy returns the policy network's priors for state, through the cache.
+// They are stored in the node arena, so expanding a node allocates nothing.
+func (mcts *RPSMCTS) policy(state *game.RPSGame) []float64 {
+	start := time.Now()
+	var dst []float64
+	if mcts.arena != nil {
+		dst = mcts.arena.allocPriors(mcts.PolicyNetwork.GetOutputSize())
+	}
+	priors := mcts.Cache.PolicyInto(mcts.PolicyNetwork, state, dst)
+	expandSeconds.Since(start)
+	return priors
 }
 
-// GetBestMove returns the best move according to MCTS
+// GetBestMove returns the best move according to MCTS, or nil if there is
+// none. Unlike Search's node, the move is a copy owned by the caller.
 func (mcts *RPSMCTS) GetBestMove() *game.RPSMove {
 	bestNode := mcts.Search()
 	if bestNode == nil || bestNode.Move == nil {
 		return nil
 	}
-	return bestNode.Move
+	move := *bestNode.Move
+	return &move
 }
@@ -0,0 +1,56 @@
+package mcts
+
+import (
+	"fmt"
+	"testing"
+
+	"github.com/zachbeta/neural_rps/alphago_demo/pkg/game"
+	neural "github.com/zachbeta/neural_rps/alphago_demo/pkg/rps_net_impl"
+)
+
+// benchSearch times searches from a fresh tree over state, reporting
+// simulations per second. Search picks serial or parallel by core count, so
+// the benchmarks call each directly to compare them on any host.
+func benchSearch(b *testing.B, params RPSMCTSParams, search func(*RPSMCTS) *RPSMCTSNode) {
+	params.DirichletNoise = false
+	params.ReuseTree = false
+	engine := NewRPSMCTS(neural.NewRPSPolicyNetwork(64), neural.NewRPSValueNetwork(64), params)
+	state := game.NewRPSGame(21, 5, 10)
+
+	b.ReportAllocs()
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		engine.SetRootState(state)
+		if search(engine) == nil {
+			b.Fatal("Search returned no move")
+		}
+	}
+	if s := b.Elapsed().Seconds(); s > 0 {
+		b.ReportMetric(float64(b.N*params.NumSimulations)/s, "sims/sec")
+	}
+}
+
+func BenchmarkRPSMCTSSearch(b *testing.B) {
+	for _, sims := range []int{200, 800} {
+		params := DefaultRPSMCTSParams()
+		params.NumSimulations = sims
+
+		b.Run(fmt.Sprintf("sims=%d/serial", sims), func(b *testing.B) {
+			benchSearch(b, params, (*RPSMCTS).searchSerial)
+		})
+		for _, workers := range []int{2, 4} {
+			params.NumWorkers = workers
+			b.Run(fmt.Sprintf("sims=%d/parallel=%d", sims, workers), func(b *testing.B) {
+				benchSearch(b, params, (*RPSMCTS).searchParallel)
+			})
+		}
+	}
+}
+
+// BenchmarkRPSMCTSSearchQuantized is the serial search with int8 networks
+func BenchmarkRPSMCTSSearchQuantized(b *testing.B) {
+	params := DefaultRPSMCTSParams()
+	params.NumSimulations = 800
+	params.Quantized = true
+	benchSearch(b, params, (*RPSMCTS).searchSerial)
+}
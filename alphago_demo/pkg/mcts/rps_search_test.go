@@ -18,6 +18,11 @@ func TestDefaultRPSMCTSParams(t *testing.T) {
 	if params.ExplorationConst <= 0 {
 		t.Errorf("Expected positive exploration constant, got %f", params.ExplorationConst)
 	}
+
+	// Tree reuse changes search results, so callers opt in
+	if params.ReuseTree {
+		t.Errorf("Expected ReuseTree to be off by default")
+	}
 }
 
 func TestNewRPSMCTS(t *testing.T) {
@@ -47,6 +52,28 @@ func TestNewRPSMCTS(t *testing.T) {
 	}
 }
 
+func TestNewRPSMCTSQuantized(t *testing.T) {
+	policyNetwork := neural.NewRPSPolicyNetwork(32)
+	valueNetwork := neural.NewRPSValueNetwork(32)
+
+	params := DefaultRPSMCTSParams()
+	params.Quantized = true
+	params.NumSimulations = 50
+	mctsEngine := NewRPSMCTS(policyNetwork, valueNetwork, params)
+
+	if !mctsEngine.PolicyNetwork.IsQuantized() || !mctsEngine.ValueNetwork.IsQuantized() {
+		t.Fatal("Expected Quantized to give the engine int8 networks")
+	}
+	if policyNetwork.IsQuantized() || valueNetwork.IsQuantized() {
+		t.Error("Expected the caller's networks to stay float")
+	}
+
+	mctsEngine.SetRootState(game.NewRPSGame(21, 5, 10))
+	if best := mctsEngine.Search(); best == nil || best.Move == nil {
+		t.Error("Expected a quantized search to find a move")
+	}
+}
+
 func TestRPSMCTSSetRootState(t *testing.T) {
 	// Create policy and value networks
 	policyNetwork := neural.NewRPSPolicyNetwork(32)
@@ -141,7 +168,7 @@ func TestRPSMCTSSearch(t *testing.T) {
 	}
 
 	// The node should have been visited at least once
-	if bestNode.Visits == 0 {
+	if bestNode.Visits.Load() == 0 {
 		t.Errorf("Expected best node to have been visited at least once")
 	}
 
@@ -151,9 +178,186 @@ func TestRPSMCTSSearch(t *testing.T) {
 	}
 
 	// The root should have been visited at least numSimulations times
-	if mctsEngine.Root.Visits < params.NumSimulations {
+	if mctsEngine.Root.Visits.Load() < int64(params.NumSimulations) {
 		t.Errorf("Expected root to have at least %d visits, got %d",
-			params.NumSimulations, mctsEngine.Root.Visits)
+			params.NumSimulations, mctsEngine.Root.Visits.Load())
+	}
+}
+
+func TestRPSMCTSParallelSearch(t *testing.T) {
+	policyNetwork := neural.NewRPSPolicyNetwork(32)
+	valueNetwork := neural.NewRPSValueNetwork(32)
+
+	params := DefaultRPSMCTSParams()
+	params.NumSimulations = 2000
+	params.NumWorkers = 8
+	mctsEngine := NewRPSMCTS(policyNetwork, valueNetwork, params)
+	mctsEngine.SetRootState(game.NewRPSGame(15, 5, 10))
+
+	bestNode := mctsEngine.searchParallel()
+	if bestNode == nil || bestNode.Move == nil {
+		t.Fatalf("Expected parallel search to return a node with a move")
+	}
+
+	// Every simulation passes through the root exactly once
+	if visits := mctsEngine.Root.Visits.Load(); visits != int64(params.NumSimulations) {
+		t.Errorf("Expected root to have %d visits, got %d", params.NumSimulations, visits)
+	}
+
+	// All virtual loss must be reverted, and no node can have more child
+	// visits than visits of its own
+	var check func(node *RPSMCTSNode)
+	check = func(node *RPSMCTSNode) {
+		if vl := node.VirtualLoss.Load(); vl != 0 {
+			t.Errorf("Expected no outstanding virtual loss, got %d", vl)
+		}
+		childVisits := int64(0)
+		for _, child := range node.Children {
+			childVisits += child.Visits.Load()
+			check(child)
+		}
+		if childVisits > node.Visits.Load() {
+			t.Errorf("Children have %d visits but node only has %d", childVisits, node.Visits.Load())
+		}
+	}
+	check(mctsEngine.Root)
+}
+
+func TestRPSMCTSStepwiseMatchesSerial(t *testing.T) {
+	policyNetwork := neural.NewRPSPolicyNetwork(32)
+	valueNetwork := neural.NewRPSValueNetwork(32)
+
+	params := DefaultRPSMCTSParams()
+	params.NumSimulations = 300
+	serial := NewRPSMCTS(policyNetwork, valueNetwork, params)
+	stepwise := NewRPSMCTS(policyNetwork, valueNetwork, params)
+	gameState := game.NewRPSGame(15, 5, 10)
+	serial.SetRootState(gameState)
+	stepwise.SetRootState(gameState)
+
+	// Drive the stepwise search with batched evaluations of one leaf each
+	var scratch neural.BatchScratch
+	if !stepwise.BeginSearch() {
+		t.Fatalf("Expected BeginSearch to find the root")
+	}
+	for i := 0; i < params.NumSimulations; i++ {
+		node, expand := stepwise.SelectLeaf()
+		if expand {
+			priors := stepwise.Cache.PolicyBatch(policyNetwork, []*game.RPSGame{node.GameState}, &scratch)
+			node = stepwise.ExpandLeaf(node, priors[0])
+		}
+		value, ok := TerminalValue(node)
+		if !ok {
+			values := make([]float64, 1)
+			stepwise.Cache.ValueBatch(valueNetwork, []*game.RPSGame{node.GameState}, values, &scratch)
+			value = values[0]
+		}
+		stepwise.Backup(node, value)
+	}
+
+	want := serial.searchSerial()
+	got := stepwise.Root.MostVisitedChild()
+	if *got.Move != *want.Move {
+		t.Errorf("Stepwise search chose %v, serial search %v", *got.Move, *want.Move)
+	}
+	for i, child := range serial.Root.Children {
+		if v, w := stepwise.Root.Children[i].Visits.Load(), child.Visits.Load(); v != w {
+			t.Errorf("Child %d: stepwise search has %d visits, serial %d", i, v, w)
+		}
+	}
+}
+
+func TestRPSMCTSTreeReuse(t *testing.T) {
+	policyNetwork := neural.NewRPSPolicyNetwork(32)
+	valueNetwork := neural.NewRPSValueNetwork(32)
+
+	params := DefaultRPSMCTSParams()
+	params.NumSimulations = 50 // Serial search, so the tree is deterministic in shape
+	params.ReuseTree = true
+	mctsEngine := NewRPSMCTS(policyNetwork, valueNetwork, params)
+
+	gameState := game.NewRPSGame(15, 5, 10)
+	mctsEngine.SetRootState(gameState)
+	bestNode := mctsEngine.Search()
+	if bestNode == nil || bestNode.Move == nil {
+		t.Fatalf("Expected search to return a move")
+	}
+
+	// Play our move, then the opponent reply the tree explored most
+	gameState.MakeMove(*bestNode.Move)
+	reply := bestNode.MostVisitedChild()
+	if reply == nil {
+		t.Skip("Search did not expand past the first ply")
+	}
+	gameState.MakeMove(*reply.Move)
+
+	sizeBefore := mctsEngine.TreeSize()
+	mctsEngine.SetRootState(gameState)
+
+	if mctsEngine.Root != reply {
+		t.Fatalf("Expected the matching grandchild to be promoted to root")
+	}
+	if mctsEngine.Root.Parent != nil {
+		t.Errorf("Expected promoted root to be detached from its parent")
+	}
+	if mctsEngine.TreeSize() != sizeBefore {
+		t.Errorf("Expected reuse to keep the arena, size went from %d to %d", sizeBefore, mctsEngine.TreeSize())
+	}
+
+	// An unrelated position rebuilds the tree from a reset arena
+	mctsEngine.SetRootState(game.NewRPSGame(15, 5, 10))
+	if mctsEngine.Root.Visits.Load() != 0 || mctsEngine.TreeSize() != 1 {
+		t.Errorf("Expected a fresh single-node tree, got %d visits and %d nodes",
+			mctsEngine.Root.Visits.Load(), mctsEngine.TreeSize())
+	}
+}
+
+func TestRPSMCTSSearchSteadyStateAllocs(t *testing.T) {
+	if raceEnabled {
+		t.Skip("Allocation counts are not meaningful under -race")
+	}
+	policyNetwork := neural.NewRPSPolicyNetwork(32)
+	valueNetwork := neural.NewRPSValueNetwork(32)
+
+	params := DefaultRPSMCTSParams()
+	params.NumSimulations = 50 // Serial search
+	params.ReuseTree = false
+	mctsEngine := NewRPSMCTS(policyNetwork, valueNetwork, params)
+	gameState := game.NewRPSGame(15, 5, 10)
+
+	// The first search grows the arena; later ones rebuild the tree in it,
+	// with nodes, game states and priors all carved from reused slabs
+	mctsEngine.SetRootState(gameState)
+	mctsEngine.Search()
+
+	allocs := testing.AllocsPerRun(20, func() {
+		mctsEngine.SetRootState(gameState)
+		mctsEngine.Search()
+	})
+	if allocs != 0 {
+		t.Errorf("Expected a search in a warm arena to be allocation-free, got %.1f allocs/op", allocs)
+	}
+}
+
+func TestRPSMCTSAdvanceRoot(t *testing.T) {
+	policyNetwork := neural.NewRPSPolicyNetwork(32)
+	valueNetwork := neural.NewRPSValueNetwork(32)
+
+	params := DefaultRPSMCTSParams()
+	params.NumSimulations = 50
+	mctsEngine := NewRPSMCTS(policyNetwork, valueNetwork, params)
+	mctsEngine.SetRootState(game.NewRPSGame(15, 5, 10))
+	bestNode := mctsEngine.Search()
+
+	if mctsEngine.AdvanceRoot(game.RPSMove{CardIndex: 99, Position: 0, Player: game.Player1}) {
+		t.Errorf("Expected AdvanceRoot to reject a move that is not in the tree")
+	}
+
+	if !mctsEngine.AdvanceRoot(*bestNode.Move) {
+		t.Fatalf("Expected AdvanceRoot to follow the searched move")
+	}
+	if mctsEngine.Root != bestNode || bestNode.Parent != nil {
+		t.Errorf("Expected the child to become a detached root")
 	}
 }
 
@@ -185,7 +389,7 @@ func TestRPSMCTSSelection(t *testing.T) {
 	}
 
 	root := NewRPSMCTSNode(gameState, nil, nil, priors)
-	root.Visits = 10
+	root.Visits.Store(10)
 
 	// Create children
 	for i := 0; i < 3; i++ {
@@ -197,7 +401,7 @@ func TestRPSMCTSSelection(t *testing.T) {
 
 		// Make all but one node visited
 		if i < 2 {
-			childNode.Visits = 5
+			childNode.Visits.Store(5)
 		}
 
 		root.Children = append(root.Children, childNode)
@@ -205,9 +409,9 @@ func TestRPSMCTSSelection(t *testing.T) {
 
 	// Test selection on a non-leaf node with an unvisited child
 	selected = mctsEngine.selection(root)
-	if selected.Visits != 0 {
+	if selected.Visits.Load() != 0 {
 		t.Errorf("Expected selection to return the unvisited node, got node with %d visits",
-			selected.Visits)
+			selected.Visits.Load())
 	}
 }
 
@@ -316,4 +520,13 @@ func TestRPSMCTSGetBestMove(t *testing.T) {
 		t.Errorf("Expected card index to be in range [0, %d], got %d",
 			len(gameState.Player1Hand)-1, bestMove.CardIndex)
 	}
+
+	// The move is the caller's: rebuilding the tree in the arena, which
+	// recycles the node it came from, leaves it untouched
+	kept := *bestMove
+	mctsEngine.SetRootState(game.NewRPSGame(21, 5, 10))
+	mctsEngine.Search()
+	if *bestMove != kept {
+		t.Errorf("Expected GetBestMove's result to survive a tree rebuild, got %v, was %v", *bestMove, kept)
+	}
 }
@@ -1,6 +1,9 @@
 package mcts
 
 import (
+	"sync"
+	"time"
+
 	"github.com/zachbeta/neural_rps/alphago_demo/pkg/game"
 	neural "github.com/zachbeta/neural_rps/alphago_demo/pkg/rps_net_impl"
 )
@@ -12,6 +15,14 @@ type AGMCTSParams struct {
 	TemperatureInit      float64 // Initial temperature for move selection
 	TemperatureFinal     float64 // Final temperature for move selection
 	TemperatureThreshold int     // Move threshold to switch to final temperature
+
+	// NumTrees > 1 searches that many independent trees on separate
+	// goroutines, splitting NumSimulations between them, and merges their
+	// root statistics when they finish
+	NumTrees int
+	// LeafBatchSize > 1 has each tree select that many leaves, under virtual
+	// loss, and evaluate them with one batched call per network
+	LeafBatchSize int
 }
 
 // DefaultAGMCTSParams returns default MCTS parameters
@@ -53,10 +64,58 @@ func (mcts *AGMCTS) SetRootState(gameState *game.AGGame) {
 
 // Search runs the MCTS algorithm to find the best move
 func (mcts *AGMCTS) Search() *AGMCTSNode {
-	// Run simulations
-	for i := 0; i < mcts.params.NumSimulations; i++ {
+	start := time.Now()
+	defer func() {
+		simulationsTotal.Add(uint64(mcts.params.NumSimulations))
+		searchSeconds.Since(start)
+	}()
+
+	trees := mcts.params.NumTrees
+	if trees <= 1 {
+		mcts.searchTree(mcts.rootNode, mcts.params.NumSimulations)
+		return mcts.getBestChild(mcts.rootNode)
+	}
+
+	// Root parallelization: the trees share nothing but the networks, whose
+	// predictions only read the weights, so they need no synchronization
+	roots := make([]*AGMCTSNode, trees)
+	roots[0] = mcts.rootNode
+	for i := 1; i < trees; i++ {
+		roots[i] = NewAGMCTSNode(mcts.rootNode.GameState, nil, nil, mcts.rootNode.Priors)
+	}
+
+	var wg sync.WaitGroup
+	for i, root := range roots {
+		// The first trees take any remainder of the simulation budget
+		simulations := mcts.params.NumSimulations / trees
+		if i < mcts.params.NumSimulations%trees {
+			simulations++
+		}
+
+		wg.Add(1)
+		go func(root *AGMCTSNode, simulations int) {
+			defer wg.Done()
+			mcts.searchTree(root, simulations)
+		}(root, simulations)
+	}
+	wg.Wait()
+
+	for _, root := range roots[1:] {
+		mergeRoot(mcts.rootNode, root)
+	}
+	return mcts.getBestChild(mcts.rootNode)
+}
+
+// searchTree runs simulations on the tree below root
+func (mcts *AGMCTS) searchTree(root *AGMCTSNode, simulations int) {
+	if mcts.params.LeafBatchSize > 1 {
+		mcts.searchTreeBatched(root, simulations)
+		return
+	}
+
+	for i := 0; i < simulations; i++ {
 		// Selection phase: select a node to expand
-		node := mcts.selectNode(mcts.rootNode)
+		node := mcts.selectNode(root)
 
 		// Expansion phase: if the selected node is not terminal, expand it
 		if !node.IsTerminal() {
@@ -69,9 +128,99 @@ func (mcts *AGMCTS) Search() *AGMCTSNode {
 		// Backpropagation phase: update node statistics up the tree
 		mcts.backpropagate(node, value)
 	}
+}
 
-	// Return the best child of the root node
-	return mcts.getBestChild(mcts.rootNode)
+// searchTreeBatched runs simulations LeafBatchSize at a time. Each selected
+// leaf takes a virtual loss along its path so that the rest of the batch
+// spreads over other moves; nodes created by the batch have no priors until
+// it is evaluated, and rank last among their siblings until then.
+func (mcts *AGMCTS) searchTreeBatched(root *AGMCTSNode, simulations int) {
+	var leaves, created []*AGMCTSNode
+	var states []*game.AGGame
+	for done := 0; done < simulations; done += len(leaves) {
+		leaves, created = leaves[:0], created[:0]
+		for len(leaves) < min(mcts.params.LeafBatchSize, simulations-done) {
+			node := mcts.selectNode(root)
+			if !node.IsTerminal() {
+				var isNew bool
+				if node, isNew = mcts.addChild(node); isNew {
+					created = append(created, node)
+				}
+			}
+			addVirtualLoss(node)
+			leaves = append(leaves, node)
+		}
+
+		// One policy call for the new nodes' priors and one value call for
+		// the leaves that are not finished games
+		states = states[:0]
+		for _, node := range created {
+			states = append(states, node.GameState)
+		}
+		if len(states) > 0 {
+			for i, priors := range mcts.policyNetwork.PredictBatch(states) {
+				created[i].Priors = priors
+			}
+		}
+
+		states = states[:0]
+		for _, node := range leaves {
+			if !node.IsTerminal() {
+				states = append(states, node.GameState)
+			}
+		}
+		var values []float64
+		if len(states) > 0 {
+			start := time.Now()
+			values = mcts.valueNetwork.PredictBatch(states)
+			leafBatchSeconds.Since(start)
+			leafBatchSize.Observe(uint64(len(states)))
+		}
+
+		for _, node := range leaves {
+			removeVirtualLoss(node)
+			if node.IsTerminal() {
+				mcts.backpropagate(node, mcts.evaluate(node))
+				continue
+			}
+			mcts.backpropagate(node, values[0])
+			values = values[1:]
+		}
+	}
+}
+
+// addVirtualLoss counts a pending visit worth nothing on node and its
+// ancestors, making the path less attractive to the next selection
+func addVirtualLoss(node *AGMCTSNode) {
+	for ; node != nil; node = node.Parent {
+		node.Visits++
+	}
+}
+
+// removeVirtualLoss takes back addVirtualLoss before the real backup
+func removeVirtualLoss(node *AGMCTSNode) {
+	for ; node != nil; node = node.Parent {
+		node.Visits--
+	}
+}
+
+// mergeRoot adds the statistics of other, the root of another search of the
+// same position, to root: visits and values are summed per move, and moves
+// only other expanded are adopted with their subtrees
+func mergeRoot(root, other *AGMCTSNode) {
+	root.Visits += other.Visits
+	root.TotalValue += other.TotalValue
+	root.fullyExpanded = root.fullyExpanded || other.fullyExpanded
+
+	for _, child := range other.Children {
+		if match := root.childForMove(*child.Move); match != nil {
+			match.Visits += child.Visits
+			match.TotalValue += child.TotalValue
+			continue
+		}
+		child.Parent = root
+		root.Children = append(root.Children, child)
+	}
 }
 
 // selectNode implements the selection phase of MCTS
@@ -103,56 +252,53 @@ func (mcts *AGMCTS) selectNode(node *AGMCTSNode) *AGMCTSNode {
 
 // expand implements the expansion phase of MCTS
 func (mcts *AGMCTS) expand(node *AGMCTSNode) *AGMCTSNode {
+	child, isNew := mcts.addChild(node)
+	if isNew {
+		// Get policy predictions for the new state
+		child.Priors = mcts.policyNetwork.Predict(child.GameState)
+	}
+	return child
+}
+
+// addChild expands node by one move, returning the new child without priors
+// and isNew set. If node has no move left to expand it is marked fully
+// expanded and one of its existing children, or node itself if it has no
+// moves, is returned instead.
+func (mcts *AGMCTS) addChild(node *AGMCTSNode) (child *AGMCTSNode, isNew bool) {
 	// Get valid moves
 	validMoves := node.GameState.GetValidMoves()
 
 	// If there are no valid moves or the node is terminal, just return it
 	if len(validMoves) == 0 || node.IsTerminal() {
 		node.fullyExpanded = true
-		return node
+		return node, false
 	}
 
 	// Check if all possible moves have already been expanded
 	if len(node.Children) == len(validMoves) {
 		node.fullyExpanded = true
-		return node.GetRandomChild()
+		return node.GetRandomChild(), false
 	}
 
 	// Find a move that hasn't been expanded yet
 	for _, move := range validMoves {
-		// Check if this move has already been expanded
-		moveAlreadyExpanded := false
-		for _, child := range node.Children {
-			if child.Move != nil &&
-				child.Move.Row == move.Row &&
-				child.Move.Col == move.Col {
-				moveAlreadyExpanded = true
-				break
-			}
-		}
-
 		// If the move hasn't been expanded, expand it
-		if !moveAlreadyExpanded {
+		if node.childForMove(move) == nil {
 			// Create a new game state by applying the move
 			newState := node.GameState.Copy()
 			newState.MakeMove(move)
 
-			// Get policy predictions for the new state
-			priors := mcts.policyNetwork.Predict(newState)
-
-			// Create a new child node
-			childNode := NewAGMCTSNode(newState, node, &move, priors)
-
-			// Add the child to the node's children
+			// Create a new child node and add it to the node's children
+			childNode := NewAGMCTSNode(newState, node, &move, nil)
 			node.Children = append(node.Children, childNode)
 
-			return childNode
+			return childNode, true
 		}
 	}
 
 	// All moves have been expanded
 	node.fullyExpanded = true
-	return node.GetRandomChild()
+	return node.GetRandomChild(), false
 }
 
 // evaluate implements the simulation/evaluation phase of MCTS
@@ -0,0 +1,82 @@
+package mcts
+
+import (
+	"math"
+	"testing"
+
+	"github.com/zachbeta/neural_rps/alphago_demo/pkg/game"
+	neural "github.com/zachbeta/neural_rps/alphago_demo/pkg/rps_net_impl"
+)
+
+func TestAGMCTSSearchModes(t *testing.T) {
+	policyNetwork := neural.NewAGPolicyNetwork(9, 32)
+	valueNetwork := neural.NewAGValueNetwork(9, 32)
+
+	modes := []struct {
+		name                    string
+		numTrees, leafBatchSize int
+	}{
+		{"serial", 0, 0},
+		{"leaf batched", 1, 8},
+		{"root parallel", 4, 0},
+		{"root parallel and leaf batched", 3, 8},
+	}
+	for _, mode := range modes {
+		params := DefaultAGMCTSParams()
+		params.NumSimulations = 203
+		params.NumTrees = mode.numTrees
+		params.LeafBatchSize = mode.leafBatchSize
+
+		mctsEngine := NewAGMCTS(policyNetwork, valueNetwork, params)
+		mctsEngine.SetRootState(game.NewAGGame())
+		best := mctsEngine.Search()
+		if best == nil || best.Move == nil {
+			t.Fatalf("%s: expected a best move", mode.name)
+		}
+
+		// Every simulation from the empty board passes through one root
+		// child, and no virtual loss may be left behind
+		root := mctsEngine.rootNode
+		visits := 0
+		seen := make(map[game.AGMove]bool)
+		for _, child := range root.Children {
+			visits += child.Visits
+			if seen[*child.Move] {
+				t.Errorf("%s: move %v appears twice at the root", mode.name, *child.Move)
+			}
+			seen[*child.Move] = true
+			if len(child.Priors) != 9 {
+				t.Errorf("%s: child for %v has %d priors, expected 9", mode.name, *child.Move, len(child.Priors))
+			}
+		}
+		if root.Visits != params.NumSimulations || visits != params.NumSimulations {
+			t.Errorf("%s: root has %d visits and its children %d, expected %d",
+				mode.name, root.Visits, visits, params.NumSimulations)
+		}
+
+		checkAGVisits(t, mode.name, root)
+
+		sum := 0.0
+		for _, p := range mctsEngine.GetActionProbabilities() {
+			sum += p
+		}
+		if math.Abs(sum-1) > 1e-9 {
+			t.Errorf("%s: action probabilities sum to %f", mode.name, sum)
+		}
+	}
+}
+
+// checkAGVisits fails t if a node below root has fewer visits than its
+// children together, as a virtual loss left behind or taken back twice would
+// cause
+func checkAGVisits(t *testing.T, mode string, node *AGMCTSNode) {
+	t.Helper()
+	visits := 0
+	for _, child := range node.Children {
+		visits += child.Visits
+		checkAGVisits(t, mode, child)
+	}
+	if node.Visits < visits || node.Visits < 0 {
+		t.Errorf("%s: node has %d visits but its children %d", mode, node.Visits, visits)
+	}
+}
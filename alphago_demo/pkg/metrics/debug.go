@@ -0,0 +1,78 @@
+package metrics
+
+import (
+	"fmt"
+	"net"
+	"net/http"
+	"net/http/pprof"
+	"os"
+	"runtime/trace"
+)
+
+// DebugHandler serves Default at /metrics and the net/http/pprof profiles
+// under /debug/pprof/, including /debug/pprof/trace for runtime traces of a
+// live process
+func DebugHandler() http.Handler {
+	mux := http.NewServeMux()
+	mux.Handle("/metrics", Handler())
+	mux.HandleFunc("/debug/pprof/", pprof.Index)
+	mux.HandleFunc("/debug/pprof/cmdline", pprof.Cmdline)
+	mux.HandleFunc("/debug/pprof/profile", pprof.Profile)
+	mux.HandleFunc("/debug/pprof/symbol", pprof.Symbol)
+	mux.HandleFunc("/debug/pprof/trace", pprof.Trace)
+	return mux
+}
+
+// Serve serves DebugHandler on addr in the background, for long-running
+// commands. It returns once the address is bound, so a bad address is
+// reported rather than lost in the background.
+func Serve(addr string) (*http.Server, error) {
+	listener, err := net.Listen("tcp", addr)
+	if err != nil {
+		return nil, fmt.Errorf("failed to listen for metrics on %s: %v", addr, err)
+	}
+
+	server := &http.Server{Handler: DebugHandler()}
+	go server.Serve(listener)
+	return server, nil
+}
+
+// StartTrace writes a runtime execution trace to path until the returned
+// stop function is called
+func StartTrace(path string) (stop func() error, err error) {
+	f, err := os.Create(path)
+	if err != nil {
+		return nil, fmt.Errorf("failed to create trace file: %v", err)
+	}
+	if err := trace.Start(f); err != nil {
+		f.Close()
+		return nil, fmt.Errorf("failed to start trace: %v", err)
+	}
+
+	return func() error {
+		trace.Stop()
+		return f.Close()
+	}, nil
+}
+
+// StartDebug is what the long-running commands' -metrics-addr and -trace
+// flags do: serve DebugHandler on addr and trace to tracePath, each only if
+// it is set. stop ends the trace; the server runs until the process exits.
+func StartDebug(addr, tracePath string) (stop func() error, err error) {
+	if addr != "" {
+		if _, err := Serve(addr); err != nil {
+			return nil, err
+		}
+		fmt.Printf("Serving metrics on http://%s/metrics and profiles on /debug/pprof/\n", addr)
+	}
+	if tracePath == "" {
+		return func() error { return nil }, nil
+	}
+
+	stop, err = StartTrace(tracePath)
+	if err != nil {
+		return nil, err
+	}
+	fmt.Printf("Writing execution trace to %s\n", tracePath)
+	return stop, nil
+}
@@ -0,0 +1,132 @@
+package metrics
+
+import (
+	"math/bits"
+	"sync/atomic"
+	"time"
+)
+
+// Buckets are log-linear, as in HDR histograms: values below subBuckets
+// have a bucket each, and every power of two above is split into subBuckets
+// equal buckets, so a recorded value is known to within 1/subBuckets of
+// itself at any magnitude
+const (
+	subBucketBits = 3
+	subBuckets    = 1 << subBucketBits
+	numBuckets    = (64 - subBucketBits + 1) * subBuckets
+)
+
+// bucketOf returns the bucket holding v
+func bucketOf(v uint64) int {
+	if v < subBuckets {
+		return int(v)
+	}
+	shift := bits.Len64(v) - subBucketBits - 1
+	return (shift+1)*subBuckets + int(v>>shift&(subBuckets-1))
+}
+
+// bucketBounds returns the smallest and largest values bucket i holds
+func bucketBounds(i int) (lo, hi uint64) {
+	if i < subBuckets {
+		return uint64(i), uint64(i)
+	}
+	shift := i/subBuckets - 1
+	lo = uint64(subBuckets+i%subBuckets) << shift
+	return lo, lo + (1 << shift) - 1
+}
+
+// histogramShard is one stripe of a Histogram. Its buckets are not padded:
+// they are mostly written by the goroutines of one stripe, not contended.
+type histogramShard struct {
+	counts [numBuckets]atomic.Uint64
+	sum    paddedUint64
+}
+
+// Histogram records the distribution of a non-negative quantity, such as a
+// latency or a batch size. Observe costs two uncontended atomic adds, so it
+// can run per simulation or per network call.
+type Histogram struct {
+	desc
+	scale  float64 // Exported value per recorded unit, e.g. 1e-9 for nanoseconds
+	shards []histogramShard
+}
+
+func newHistogram(name, help string, scale float64) *Histogram {
+	return &Histogram{desc: desc{name, help}, scale: scale, shards: make([]histogramShard, numShards)}
+}
+
+// Observe records v
+func (h *Histogram) Observe(v uint64) {
+	s := &h.shards[shard()]
+	s.counts[bucketOf(v)].Add(1)
+	s.sum.Add(v)
+}
+
+// ObserveDuration records d, for histograms created by NewDurationHistogram
+func (h *Histogram) ObserveDuration(d time.Duration) {
+	h.Observe(uint64(max(d, 0)))
+}
+
+// Since records the time elapsed since start, for histograms created by
+// NewDurationHistogram
+func (h *Histogram) Since(start time.Time) {
+	h.ObserveDuration(time.Since(start))
+}
+
+// Snapshot returns the distribution recorded so far
+func (h *Histogram) Snapshot() HistogramSnapshot {
+	var snap HistogramSnapshot
+	snap.scale = h.scale
+	for i := range h.shards {
+		s := &h.shards[i]
+		for b := range s.counts {
+			if n := s.counts[b].Load(); n > 0 {
+				snap.counts[b] += n
+				snap.Count += n
+			}
+		}
+		snap.sum += s.sum.Load()
+	}
+	return snap
+}
+
+// HistogramSnapshot is a Histogram's distribution at one point in time
+type HistogramSnapshot struct {
+	Count  uint64 // Values recorded
+	sum    uint64
+	scale  float64
+	counts [numBuckets]uint64
+}
+
+// Sum returns the total of the recorded values, in exported units
+func (s *HistogramSnapshot) Sum() float64 {
+	return float64(s.sum) * s.scale
+}
+
+// Mean returns the mean recorded value in exported units, or 0 if there are
+// none
+func (s *HistogramSnapshot) Mean() float64 {
+	if s.Count == 0 {
+		return 0
+	}
+	return s.Sum() / float64(s.Count)
+}
+
+// Quantile returns the q-quantile (0 <= q <= 1) of the recorded values in
+// exported units: the midpoint of the bucket holding it, or 0 if there are
+// no values
+func (s *HistogramSnapshot) Quantile(q float64) float64 {
+	if s.Count == 0 {
+		return 0
+	}
+	rank := uint64(q*float64(s.Count-1)) + 1
+	var seen uint64
+	for i, n := range s.counts {
+		seen += n
+		if seen >= rank {
+			lo, hi := bucketBounds(i)
+			return (float64(lo) + float64(hi-lo)/2) * s.scale
+		}
+	}
+	return 0
+}
@@ -0,0 +1,108 @@
+// Package metrics records hot-path counters and latency distributions cheaply
+// enough to leave on, and exports them in the Prometheus text format.
+//
+// Counters and histograms are striped: each is split into shards on separate
+// cache lines, and a goroutine updates the shard its stack address hashes to,
+// so concurrent searches rarely write the same line. Reads sum the shards and
+// are only as consistent as a Prometheus scrape needs.
+//
+// Metrics are created once, usually as package variables, and registered in
+// Default, which Handler and Serve export.
+package metrics
+
+import (
+	"math"
+	"math/bits"
+	"runtime"
+	"sync/atomic"
+	"unsafe"
+)
+
+// numShards is the number of stripes per metric: GOMAXPROCS at startup,
+// rounded up to a power of two
+var numShards = 1 << bits.Len(uint(max(runtime.GOMAXPROCS(0), 1)-1))
+
+// shard returns the calling goroutine's stripe. Goroutine stacks are
+// disjoint, so the address of a local picks a stripe that rarely changes for a
+// goroutine and differs between most goroutines, without any shared state.
+func shard() int {
+	var marker byte
+	p := uint64(uintptr(unsafe.Pointer(&marker)))
+	return int((((p >> 10) * 0x9e3779b97f4a7c15) >> 32) & uint64(numShards-1))
+}
+
+// paddedUint64 keeps each stripe of a Counter on its own cache line
+type paddedUint64 struct {
+	atomic.Uint64
+	_ [56]byte
+}
+
+// Counter is a count that only goes up, such as simulations run
+type Counter struct {
+	desc
+	shards []paddedUint64
+}
+
+func newCounter(name, help string) *Counter {
+	return &Counter{desc: desc{name, help}, shards: make([]paddedUint64, numShards)}
+}
+
+// Add adds n to the count
+func (c *Counter) Add(n uint64) {
+	c.shards[shard()].Add(n)
+}
+
+// Inc adds one to the count
+func (c *Counter) Inc() {
+	c.Add(1)
+}
+
+// Value returns the count
+func (c *Counter) Value() uint64 {
+	var total uint64
+	for i := range c.shards {
+		total += c.shards[i].Load()
+	}
+	return total
+}
+
+// Gauge is a value that can go up and down, such as a queue depth
+type Gauge struct {
+	desc
+	bits atomic.Uint64
+}
+
+// Set sets the gauge to v
+func (g *Gauge) Set(v float64) {
+	g.bits.Store(math.Float64bits(v))
+}
+
+// Add adds delta to the gauge
+func (g *Gauge) Add(delta float64) {
+	for {
+		old := g.bits.Load()
+		if g.bits.CompareAndSwap(old, math.Float64bits(math.Float64frombits(old)+delta)) {
+			return
+		}
+	}
+}
+
+// Value returns the gauge's value
+func (g *Gauge) Value() float64 {
+	return math.Float64frombits(g.bits.Load())
+}
+
+// gaugeFunc is a gauge read from a callback at export time
+type gaugeFunc struct {
+	desc
+	fn func() float64
+}
+
+// desc is the name and help text every metric has
+type desc struct {
+	name, help string
+}
+
+func (d desc) metricName() string {
+	return d.name
+}
@@ -0,0 +1,143 @@
+package metrics
+
+import (
+	"bytes"
+	"io"
+	"math"
+	"net/http/httptest"
+	"strings"
+	"sync"
+	"testing"
+	"time"
+)
+
+func TestBucketBounds(t *testing.T) {
+	for i := 0; i < numBuckets; i++ {
+		lo, hi := bucketBounds(i)
+		if bucketOf(lo) != i || bucketOf(hi) != i {
+			t.Fatalf("Bucket %d holds [%d, %d], but they map to buckets %d and %d", i, lo, hi, bucketOf(lo), bucketOf(hi))
+		}
+		if i > 0 {
+			if _, prevHi := bucketBounds(i - 1); prevHi+1 != lo {
+				t.Fatalf("Bucket %d starts at %d, expected %d", i, lo, prevHi+1)
+			}
+		}
+	}
+	if _, hi := bucketBounds(numBuckets - 1); hi != math.MaxUint64 {
+		t.Errorf("Last bucket ends at %d, expected %d", hi, uint64(math.MaxUint64))
+	}
+}
+
+func TestHistogramQuantiles(t *testing.T) {
+	h := newHistogram("test", "", 1)
+	for v := uint64(1); v <= 1000; v++ {
+		h.Observe(v)
+	}
+
+	snap := h.Snapshot()
+	if snap.Count != 1000 || snap.Sum() != 500500 {
+		t.Fatalf("Expected 1000 values summing to 500500, got %d summing to %f", snap.Count, snap.Sum())
+	}
+	for _, q := range []float64{0.5, 0.9, 0.99} {
+		want := q * 1000
+		if got := snap.Quantile(q); math.Abs(got-want) > want/subBuckets {
+			t.Errorf("Quantile %.2f is %f, expected within 1/%d of %f", q, got, subBuckets, want)
+		}
+	}
+}
+
+func TestConcurrentUpdates(t *testing.T) {
+	c := newCounter("test_total", "")
+	h := newHistogram("test_seconds", "", 1e-9)
+
+	var wg sync.WaitGroup
+	for g := 0; g < 8; g++ {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			for i := 0; i < 1000; i++ {
+				c.Inc()
+				h.ObserveDuration(time.Microsecond)
+			}
+		}()
+	}
+	wg.Wait()
+
+	if c.Value() != 8000 {
+		t.Errorf("Expected count 8000, got %d", c.Value())
+	}
+	if snap := h.Snapshot(); snap.Count != 8000 || math.Abs(snap.Mean()-1e-6) > 1e-12 {
+		t.Errorf("Expected 8000 durations of 1us, got %d with mean %g", snap.Count, snap.Mean())
+	}
+}
+
+func TestWritePrometheus(t *testing.T) {
+	r := NewRegistry()
+	r.NewCounter("b_total", "Things counted").Add(3)
+	r.NewGaugeFunc("a_depth", "Queue depth", func() float64 { return 2 })
+	r.NewDurationHistogram("c_seconds", "Latency").ObserveDuration(2 * time.Millisecond)
+
+	var buf bytes.Buffer
+	if err := r.WritePrometheus(&buf); err != nil {
+		t.Fatal(err)
+	}
+	out := buf.String()
+
+	for _, want := range []string{
+		"# TYPE a_depth gauge\na_depth 2\n",
+		"# HELP b_total Things counted\n# TYPE b_total counter\nb_total 3\n",
+		"# TYPE c_seconds summary\n",
+		"c_seconds_count 1\n",
+	} {
+		if !strings.Contains(out, want) {
+			t.Errorf("Expected output to contain %q, got:\n%s", want, out)
+		}
+	}
+	if strings.Index(out, "a_depth") > strings.Index(out, "b_total") {
+		t.Error("Expected metrics sorted by name")
+	}
+
+	defer func() {
+		if recover() == nil {
+			t.Error("Expected registering a name twice to panic")
+		}
+	}()
+	r.NewCounter("b_total", "")
+}
+
+func TestDebugHandler(t *testing.T) {
+	server := httptest.NewServer(DebugHandler())
+	defer server.Close()
+
+	for _, path := range []string{"/metrics", "/debug/pprof/"} {
+		resp, err := server.Client().Get(server.URL + path)
+		if err != nil {
+			t.Fatal(err)
+		}
+		io.Copy(io.Discard, resp.Body)
+		resp.Body.Close()
+		if resp.StatusCode != 200 {
+			t.Errorf("GET %s returned %d", path, resp.StatusCode)
+		}
+	}
+}
+
+func BenchmarkCounterInc(b *testing.B) {
+	c := newCounter("bench_total", "")
+	b.ReportAllocs()
+	b.RunParallel(func(pb *testing.PB) {
+		for pb.Next() {
+			c.Inc()
+		}
+	})
+}
+
+func BenchmarkHistogramObserve(b *testing.B) {
+	h := newHistogram("bench_seconds", "", 1e-9)
+	b.ReportAllocs()
+	b.RunParallel(func(pb *testing.PB) {
+		for v := uint64(0); pb.Next(); v++ {
+			h.Observe(v)
+		}
+	})
+}
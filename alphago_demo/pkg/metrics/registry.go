@@ -0,0 +1,179 @@
+package metrics
+
+import (
+	"bufio"
+	"fmt"
+	"io"
+	"math"
+	"net/http"
+	"sort"
+	"strconv"
+	"sync"
+)
+
+// exportedQuantiles are the quantiles a histogram exports
+var exportedQuantiles = []float64{0.5, 0.9, 0.99, 0.999}
+
+type metric interface {
+	metricName() string
+	writeTo(w *bufio.Writer)
+}
+
+// Registry is a set of metrics exported together
+type Registry struct {
+	mu      sync.Mutex
+	metrics map[string]metric
+}
+
+// NewRegistry returns an empty registry
+func NewRegistry() *Registry {
+	return &Registry{metrics: make(map[string]metric)}
+}
+
+// Default is the registry the package-level constructors register in
+var Default = NewRegistry()
+
+// register adds m, panicking if its name is taken: metric names are fixed
+// in the code, so a clash is a programming error
+func (r *Registry) register(m metric) {
+	r.mu.Lock()
+	defer r.mu.Unlock()
+	if _, ok := r.metrics[m.metricName()]; ok {
+		panic(fmt.Sprintf("metrics: %s registered twice", m.metricName()))
+	}
+	r.metrics[m.metricName()] = m
+}
+
+// NewCounter registers a counter. Counter names end in _total by convention.
+func (r *Registry) NewCounter(name, help string) *Counter {
+	c := newCounter(name, help)
+	r.register(c)
+	return c
+}
+
+// NewGauge registers a gauge
+func (r *Registry) NewGauge(name, help string) *Gauge {
+	g := &Gauge{desc: desc{name, help}}
+	r.register(g)
+	return g
+}
+
+// NewGaugeFunc registers a gauge whose value fn returns at export time. fn
+// must be safe to call from any goroutine.
+func (r *Registry) NewGaugeFunc(name, help string, fn func() float64) {
+	r.register(&gaugeFunc{desc: desc{name, help}, fn: fn})
+}
+
+// NewHistogram registers a histogram of plain values, such as batch sizes
+func (r *Registry) NewHistogram(name, help string) *Histogram {
+	h := newHistogram(name, help, 1)
+	r.register(h)
+	return h
+}
+
+// NewDurationHistogram registers a histogram of durations, recorded with
+// ObserveDuration or Since and exported in seconds. Its name should end in
+// _seconds.
+func (r *Registry) NewDurationHistogram(name, help string) *Histogram {
+	h := newHistogram(name, help, 1e-9)
+	r.register(h)
+	return h
+}
+
+// NewCounter registers a counter in Default
+func NewCounter(name, help string) *Counter {
+	return Default.NewCounter(name, help)
+}
+
+// NewGauge registers a gauge in Default
+func NewGauge(name, help string) *Gauge {
+	return Default.NewGauge(name, help)
+}
+
+// NewGaugeFunc registers a callback gauge in Default
+func NewGaugeFunc(name, help string, fn func() float64) {
+	Default.NewGaugeFunc(name, help, fn)
+}
+
+// NewHistogram registers a histogram in Default
+func NewHistogram(name, help string) *Histogram {
+	return Default.NewHistogram(name, help)
+}
+
+// NewDurationHistogram registers a duration histogram in Default
+func NewDurationHistogram(name, help string) *Histogram {
+	return Default.NewDurationHistogram(name, help)
+}
+
+// WritePrometheus writes every metric in the Prometheus text exposition
+// format, sorted by name. Histograms are written as summaries: their
+// quantiles are over everything recorded since the process started, so
+// recent behaviour is read from rate() of _sum and _count.
+func (r *Registry) WritePrometheus(w io.Writer) error {
+	r.mu.Lock()
+	metrics := make([]metric, 0, len(r.metrics))
+	for _, m := range r.metrics {
+		metrics = append(metrics, m)
+	}
+	r.mu.Unlock()
+	sort.Slice(metrics, func(i, j int) bool { return metrics[i].metricName() < metrics[j].metricName() })
+
+	bw := bufio.NewWriter(w)
+	for _, m := range metrics {
+		m.writeTo(bw)
+	}
+	return bw.Flush()
+}
+
+// Handler serves the registry to Prometheus scrapes
+func (r *Registry) Handler() http.Handler {
+	return http.HandlerFunc(func(w http.ResponseWriter, req *http.Request) {
+		w.Header().Set("Content-Type", "text/plain; version=0.0.4; charset=utf-8")
+		r.WritePrometheus(w)
+	})
+}
+
+// Handler serves Default to Prometheus scrapes
+func Handler() http.Handler {
+	return Default.Handler()
+}
+
+func writeHeader(w *bufio.Writer, d desc, kind string) {
+	fmt.Fprintf(w, "# HELP %s %s\n# TYPE %s %s\n", d.name, d.help, d.name, kind)
+}
+
+func formatFloat(v float64) string {
+	switch {
+	case math.IsInf(v, 1):
+		return "+Inf"
+	case math.IsInf(v, -1):
+		return "-Inf"
+	case math.IsNaN(v):
+		return "NaN"
+	}
+	return strconv.FormatFloat(v, 'g', -1, 64)
+}
+
+func (c *Counter) writeTo(w *bufio.Writer) {
+	writeHeader(w, c.desc, "counter")
+	fmt.Fprintf(w, "%s %d\n", c.name, c.Value())
+}
+
+func (g *Gauge) writeTo(w *bufio.Writer) {
+	writeHeader(w, g.desc, "gauge")
+	fmt.Fprintf(w, "%s %s\n", g.name, formatFloat(g.Value()))
+}
+
+func (g *gaugeFunc) writeTo(w *bufio.Writer) {
+	writeHeader(w, g.desc, "gauge")
+	fmt.Fprintf(w, "%s %s\n", g.name, formatFloat(g.fn()))
+}
+
+func (h *Histogram) writeTo(w *bufio.Writer) {
+	snap := h.Snapshot()
+	writeHeader(w, h.desc, "summary")
+	for _, q := range exportedQuantiles {
+		fmt.Fprintf(w, "%s{quantile=\"%s\"} %s\n", h.name, formatFloat(q), formatFloat(snap.Quantile(q)))
+	}
+	fmt.Fprintf(w, "%s_sum %s\n%s_count %d\n", h.name, formatFloat(snap.Sum()), h.name, snap.Count)
+}
@@ -0,0 +1,251 @@
+package replay
+
+import (
+	"compress/gzip"
+	"encoding/binary"
+	"errors"
+	"fmt"
+	"io"
+	"math"
+	"math/rand"
+	"os"
+	"path/filepath"
+	"sort"
+	"strings"
+
+	"github.com/zachbeta/neural_rps/alphago_demo/pkg/internal/mmapfile"
+)
+
+// shard is one opened shard file
+type shard struct {
+	records []byte // Record data after the header
+	count   int
+	release func() error
+}
+
+// Buffer is a read-only replay buffer over a set of shards. Uncompressed
+// shards are memory-mapped, so opening even a large buffer costs little
+// memory; pages are read in as examples are sampled. It is safe for
+// concurrent use.
+type Buffer struct {
+	layout Layout
+	shards []shard
+	starts []int // Index of each shard's first example
+	total  int
+}
+
+// ListShards returns the shard files in dir in the order they were written
+func ListShards(dir string) ([]string, error) {
+	entries, err := os.ReadDir(dir)
+	if err != nil {
+		return nil, err
+	}
+
+	var paths []string
+	for _, e := range entries {
+		name := e.Name()
+		if !e.IsDir() && (strings.HasSuffix(name, Extension) || strings.HasSuffix(name, CompressedExtension)) {
+			paths = append(paths, filepath.Join(dir, name))
+		}
+	}
+	sort.Strings(paths)
+	return paths, nil
+}
+
+// OpenDir opens the newest maxShards shards in dir, or all of them if
+// maxShards is 0. Dropping older shards gives the buffer a sliding window
+// over a long-running self-play directory.
+func OpenDir(dir string, maxShards int) (*Buffer, error) {
+	paths, err := ListShards(dir)
+	if err != nil {
+		return nil, err
+	}
+	if maxShards > 0 && len(paths) > maxShards {
+		paths = paths[len(paths)-maxShards:]
+	}
+	return Open(paths...)
+}
+
+// errNoHeader marks a shard too short to hold its header, such as the
+// current shard of a Writer that has not flushed yet
+var errNoHeader = errors.New("no header")
+
+// Open opens the given shards, which must share one layout. Shards without a
+// complete header or without a complete record hold no examples and are
+// skipped, so the buffer may be empty.
+func Open(paths ...string) (*Buffer, error) {
+	if len(paths) == 0 {
+		return nil, errors.New("no shards to open")
+	}
+
+	b := &Buffer{}
+	hasLayout := false
+	for _, path := range paths {
+		s, layout, err := openShard(path)
+		if err == errNoHeader {
+			continue
+		}
+		if err != nil {
+			b.Close()
+			return nil, fmt.Errorf("failed to open shard %s: %w", path, err)
+		}
+		if !hasLayout {
+			b.layout, hasLayout = layout, true
+		} else if layout != b.layout {
+			s.release()
+			b.Close()
+			return nil, fmt.Errorf("shard %s has layout %+v, expected %+v", path, layout, b.layout)
+		}
+		if s.count == 0 {
+			s.release()
+			continue
+		}
+
+		b.shards = append(b.shards, s)
+		b.starts = append(b.starts, b.total)
+		b.total += s.count
+	}
+	return b, nil
+}
+
+func openShard(path string) (shard, Layout, error) {
+	var (
+		data    []byte
+		release = func() error { return nil }
+		err     error
+	)
+	if strings.HasSuffix(path, CompressedExtension) {
+		data, err = readCompressed(path)
+	} else {
+		data, release, err = mmapfile.Map(path, false)
+	}
+	if err != nil {
+		return shard{}, Layout{}, err
+	}
+
+	if len(data) < headerSize {
+		release()
+		return shard{}, Layout{}, errNoHeader
+	}
+	if string(data[:8]) != magic {
+		release()
+		return shard{}, Layout{}, errors.New("bad magic")
+	}
+	layout := Layout{
+		Features: int(binary.LittleEndian.Uint32(data[8:])),
+		Policy:   int(binary.LittleEndian.Uint32(data[12:])),
+	}
+	records := data[headerSize:]
+	// A shard cut short (e.g. by a crash) keeps its complete records
+	count := len(records) / layout.recordSize()
+
+	return shard{records: records, count: count, release: release}, layout, nil
+}
+
+func readCompressed(path string) ([]byte, error) {
+	file, err := os.Open(path)
+	if err != nil {
+		return nil, err
+	}
+	defer file.Close()
+
+	gz, err := gzip.NewReader(file)
+	if err == io.EOF {
+		return nil, nil // Nothing written yet
+	}
+	if err != nil {
+		return nil, err
+	}
+	defer gz.Close()
+	return io.ReadAll(gz)
+}
+
+// Close unmaps every shard
+func (b *Buffer) Close() error {
+	var err error
+	for _, s := range b.shards {
+		if rerr := s.release(); err == nil {
+			err = rerr
+		}
+	}
+	b.shards, b.starts, b.total = nil, nil, 0
+	return err
+}
+
+// Len returns the number of examples in the buffer
+func (b *Buffer) Len() int {
+	return b.total
+}
+
+// Layout returns the shape of the buffer's examples
+func (b *Buffer) Layout() Layout {
+	return b.layout
+}
+
+// Example decodes example i into features and policy, which must match the
+// layout, and returns its value
+func (b *Buffer) Example(i int, features, policy []float64) float64 {
+	n := sort.Search(len(b.starts), func(j int) bool { return b.starts[j] > i }) - 1
+	s := &b.shards[n]
+	size := b.layout.recordSize()
+	record := s.records[(i-b.starts[n])*size : (i-b.starts[n]+1)*size]
+
+	off := 0
+	for j := range features[:b.layout.Features] {
+		features[j] = float64(math.Float32frombits(binary.LittleEndian.Uint32(record[off:])))
+		off += 4
+	}
+	for j := range policy[:b.layout.Policy] {
+		policy[j] = float64(math.Float32frombits(binary.LittleEndian.Uint32(record[off:])))
+		off += 4
+	}
+	return float64(math.Float32frombits(binary.LittleEndian.Uint32(record[off:])))
+}
+
+// Batch is a mini-batch in the form the networks' Train methods take. Its
+// rows are backed by buffers that are reused by the next Sample or Gather.
+type Batch struct {
+	States   [][]float64
+	Policies [][]float64
+	Values   []float64
+
+	features []float64
+	policy   []float64
+}
+
+func (batch *Batch) resize(n int, layout Layout) {
+	if cap(batch.Values) < n {
+		batch.States = make([][]float64, n)
+		batch.Policies = make([][]float64, n)
+		batch.Values = make([]float64, n)
+		batch.features = make([]float64, n*layout.Features)
+		batch.policy = make([]float64, n*layout.Policy)
+	}
+	batch.States = batch.States[:n]
+	batch.Policies = batch.Policies[:n]
+	batch.Values = batch.Values[:n]
+	for i := 0; i < n; i++ {
+		batch.States[i] = batch.features[i*layout.Features : (i+1)*layout.Features]
+		batch.Policies[i] = batch.policy[i*layout.Policy : (i+1)*layout.Policy]
+	}
+}
+
+// Gather decodes the examples at indexes into batch
+func (b *Buffer) Gather(indexes []int, batch *Batch) {
+	batch.resize(len(indexes), b.layout)
+	for i, idx := range indexes {
+		batch.Values[i] = b.Example(idx, batch.States[i], batch.Policies[i])
+	}
+}
+
+// Sample decodes n examples drawn uniformly at random, with replacement,
+// into batch. An empty buffer leaves batch empty.
+func (b *Buffer) Sample(rng *rand.Rand, n int, batch *Batch) {
+	if b.total == 0 {
+		n = 0
+	}
+	batch.resize(n, b.layout)
+	for i := 0; i < n; i++ {
+		batch.Values[i] = b.Example(rng.Intn(b.total), batch.States[i], batch.Policies[i])
+	}
+}
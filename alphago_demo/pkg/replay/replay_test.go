@@ -0,0 +1,304 @@
+package replay
+
+import (
+	"math/rand"
+	"os"
+	"path/filepath"
+	"sync"
+	"testing"
+)
+
+func example(i int) ([]float64, []float64, float64) {
+	features := make([]float64, RPSLayout.Features)
+	features[i%len(features)] = 1
+	policy := make([]float64, RPSLayout.Policy)
+	policy[i%len(policy)] = 0.5
+	return features, policy, float64(i) / 1000
+}
+
+func TestWriteAndRead(t *testing.T) {
+	for _, compress := range []bool{false, true} {
+		dir := t.TempDir()
+		config := DefaultWriterConfig()
+		config.ShardExamples = 7
+		config.Compress = compress
+
+		w, err := NewWriter(dir, config)
+		if err != nil {
+			t.Fatalf("NewWriter failed: %v", err)
+		}
+		for i := 0; i < 20; i++ {
+			features, policy, value := example(i)
+			if err := w.Write(features, policy, value); err != nil {
+				t.Fatalf("Write failed: %v", err)
+			}
+		}
+		if err := w.Close(); err != nil {
+			t.Fatalf("Close failed: %v", err)
+		}
+		if n := len(w.Paths()); n != 3 {
+			t.Errorf("Expected 20 examples to fill 3 shards of 7, got %d shards", n)
+		}
+
+		b, err := OpenDir(dir, 0)
+		if err != nil {
+			t.Fatalf("OpenDir failed: %v", err)
+		}
+		if b.Len() != 20 {
+			t.Fatalf("Expected 20 examples, got %d", b.Len())
+		}
+
+		features := make([]float64, RPSLayout.Features)
+		policy := make([]float64, RPSLayout.Policy)
+		for i := 0; i < 20; i++ {
+			value := b.Example(i, features, policy)
+			wantFeatures, wantPolicy, wantValue := example(i)
+			if float32(value) != float32(wantValue) {
+				t.Errorf("Example %d: expected value %f, got %f", i, wantValue, value)
+			}
+			for j := range wantFeatures {
+				if features[j] != wantFeatures[j] {
+					t.Fatalf("Example %d: feature %d is %f, expected %f", i, j, features[j], wantFeatures[j])
+				}
+			}
+			for j := range wantPolicy {
+				if policy[j] != wantPolicy[j] {
+					t.Fatalf("Example %d: policy %d is %f, expected %f", i, j, policy[j], wantPolicy[j])
+				}
+			}
+		}
+
+		var batch Batch
+		b.Gather([]int{19, 0, 7}, &batch)
+		if len(batch.States) != 3 || batch.Values[0] != float64(float32(0.019)) || batch.States[2][7] != 1 {
+			t.Errorf("Gather returned the wrong examples: values %v", batch.Values)
+		}
+		b.Close()
+	}
+}
+
+func TestOpenDirWindowAndNumbering(t *testing.T) {
+	dir := t.TempDir()
+	config := DefaultWriterConfig()
+	config.ShardExamples = 5
+
+	// Two runs into the same directory must not overwrite each other
+	for run := 0; run < 2; run++ {
+		w, err := NewWriter(dir, config)
+		if err != nil {
+			t.Fatalf("NewWriter failed: %v", err)
+		}
+		for i := 0; i < 10; i++ {
+			features, policy, value := example(i)
+			w.Write(features, policy, value)
+		}
+		w.Close()
+	}
+
+	paths, _ := ListShards(dir)
+	if len(paths) != 4 {
+		t.Fatalf("Expected 4 shards after two runs, got %d", len(paths))
+	}
+
+	b, err := OpenDir(dir, 3)
+	if err != nil {
+		t.Fatalf("OpenDir failed: %v", err)
+	}
+	defer b.Close()
+	if b.Len() != 15 {
+		t.Errorf("Expected the newest 3 shards to hold 15 examples, got %d", b.Len())
+	}
+}
+
+func TestTruncatedShard(t *testing.T) {
+	dir := t.TempDir()
+	w, _ := NewWriter(dir, DefaultWriterConfig())
+	for i := 0; i < 4; i++ {
+		features, policy, value := example(i)
+		w.Write(features, policy, value)
+	}
+	w.Close()
+
+	// Cut the last record in half, as a crash mid-write would
+	path := w.Paths()[0]
+	info, _ := os.Stat(path)
+	os.Truncate(path, info.Size()-int64(RPSLayout.recordSize()/2))
+
+	b, err := Open(path)
+	if err != nil {
+		t.Fatalf("Open failed: %v", err)
+	}
+	defer b.Close()
+	if b.Len() != 3 {
+		t.Errorf("Expected the 3 complete records, got %d", b.Len())
+	}
+}
+
+func TestOpenSkipsEmptyShards(t *testing.T) {
+	for _, compress := range []bool{false, true} {
+		dir := t.TempDir()
+		config := DefaultWriterConfig()
+		config.Compress = compress
+
+		flushed, _ := NewWriter(dir, config)
+		for i := 0; i < 5; i++ {
+			features, policy, value := example(i)
+			flushed.Write(features, policy, value)
+		}
+		flushed.Close()
+
+		// A writer that has not flushed leaves a 0-byte shard, a crash can
+		// leave part of a header or a header without a complete record
+		live, _ := NewWriter(dir, config)
+		defer live.Close()
+		features, policy, value := example(5)
+		live.Write(features, policy, value)
+		os.WriteFile(filepath.Join(dir, "partial-000000"+Extension), []byte(magic[:5]), 0644)
+		headerOnly, _ := NewWriter(dir, WriterConfig{Layout: RPSLayout, Prefix: "header"})
+		headerOnly.Write(features, policy, value)
+		headerOnly.Close()
+		os.Truncate(headerOnly.Paths()[0], headerSize)
+
+		b, err := OpenDir(dir, 0)
+		if err != nil {
+			t.Fatalf("compress=%t: OpenDir failed: %v", compress, err)
+		}
+		if b.Len() != 5 || len(b.shards) != 1 {
+			t.Errorf("compress=%t: expected 5 examples in 1 shard, got %d in %d", compress, b.Len(), len(b.shards))
+		}
+		b.Close()
+	}
+}
+
+func TestSampleEmptyBuffer(t *testing.T) {
+	dir := t.TempDir()
+	w, _ := NewWriter(dir, DefaultWriterConfig())
+	defer w.Close()
+	features, policy, value := example(0)
+	w.Write(features, policy, value)
+
+	b, err := OpenDir(dir, 0)
+	if err != nil {
+		t.Fatalf("OpenDir failed: %v", err)
+	}
+	defer b.Close()
+	if b.Len() != 0 {
+		t.Fatalf("Expected an unflushed shard to hold no examples, got %d", b.Len())
+	}
+
+	batch := Batch{Values: []float64{1}}
+	b.Sample(rand.New(rand.NewSource(1)), 8, &batch)
+	if len(batch.States) != 0 || len(batch.Values) != 0 {
+		t.Errorf("Expected Sample on an empty buffer to leave the batch empty, got %d rows", len(batch.Values))
+	}
+}
+
+func TestConcurrentWritersAndSample(t *testing.T) {
+	dir := t.TempDir()
+	w, _ := NewWriter(dir, WriterConfig{Layout: RPSLayout, ShardExamples: 64})
+
+	var wg sync.WaitGroup
+	for g := 0; g < 8; g++ {
+		wg.Add(1)
+		go func(g int) {
+			defer wg.Done()
+			var features, policies [][]float64
+			var values []float64
+			for i := 0; i < 50; i++ {
+				f, p, v := example(g*50 + i)
+				features, policies, values = append(features, f), append(policies, p), append(values, v)
+			}
+			if err := w.WriteBatch(features, policies, values); err != nil {
+				t.Errorf("WriteBatch failed: %v", err)
+			}
+		}(g)
+	}
+	wg.Wait()
+	w.Close()
+
+	b, err := OpenDir(dir, 0)
+	if err != nil {
+		t.Fatalf("OpenDir failed: %v", err)
+	}
+	defer b.Close()
+	if b.Len() != 400 || w.Count() != 400 {
+		t.Fatalf("Expected 400 examples, got %d in the buffer and %d written", b.Len(), w.Count())
+	}
+
+	var batch Batch
+	rng := rand.New(rand.NewSource(1))
+	b.Sample(rng, 32, &batch)
+	for i, state := range batch.States {
+		ones := 0
+		for _, v := range state {
+			if v == 1 {
+				ones++
+			}
+		}
+		if ones != 1 || len(batch.Policies[i]) != RPSLayout.Policy {
+			t.Fatalf("Sampled example %d is malformed", i)
+		}
+	}
+}
+
+func TestWriteRejectsWrongLayout(t *testing.T) {
+	w, _ := NewWriter(t.TempDir(), DefaultWriterConfig())
+	defer w.Close()
+	if err := w.Write(make([]float64, 3), make([]float64, 9), 0); err == nil {
+		t.Errorf("Expected an error for a short feature vector")
+	}
+}
+
+func TestRingKeepsNewest(t *testing.T) {
+	r := NewRing(RPSLayout, 10)
+	for i := 0; i < 25; i++ {
+		features, policy, value := example(i)
+		if err := r.Add(features, policy, value); err != nil {
+			t.Fatalf("Add failed: %v", err)
+		}
+	}
+	if r.Len() != 10 || r.Added() != 25 {
+		t.Fatalf("Expected 10 held of 25 added, got %d of %d", r.Len(), r.Added())
+	}
+
+	// Only examples 15-24 remain; each sampled row must be one of them intact
+	var batch Batch
+	r.Sample(rand.New(rand.NewSource(1)), 200, &batch)
+	for i, value := range batch.Values {
+		n := int(value*1000 + 0.5)
+		if n < 15 || n >= 25 {
+			t.Fatalf("Sampled overwritten example %d", n)
+		}
+		features, policy, _ := example(n)
+		if batch.States[i][n%len(features)] != 1 || float32(batch.Policies[i][n%len(policy)]) != 0.5 {
+			t.Fatalf("Row %d does not match example %d", i, n)
+		}
+	}
+
+	if err := r.Add(make([]float64, 3), make([]float64, 9), 0); err == nil {
+		t.Error("Expected an error for a wrong-sized example")
+	}
+}
+
+func TestRingMinimumCapacity(t *testing.T) {
+	for _, capacity := range []int{0, -3} {
+		r := NewRing(RPSLayout, capacity)
+		for i := 0; i < 3; i++ {
+			features, policy, value := example(i)
+			if err := r.Add(features, policy, value); err != nil {
+				t.Fatalf("Add failed: %v", err)
+			}
+		}
+		if r.Len() != 1 || r.Added() != 3 {
+			t.Fatalf("Capacity %d: expected a ring of 1 holding 1 of 3 added, got %d of %d", capacity, r.Len(), r.Added())
+		}
+
+		var batch Batch
+		r.Sample(rand.New(rand.NewSource(1)), 4, &batch)
+		for _, value := range batch.Values {
+			if float32(value) != float32(0.002) {
+				t.Fatalf("Capacity %d: expected only the newest example, sampled value %f", capacity, value)
+			}
+		}
+	}
+}
@@ -0,0 +1,99 @@
+package replay
+
+import (
+	"fmt"
+	"math/rand"
+	"sync"
+)
+
+// Ring is a bounded in-memory replay buffer: once full, each new example
+// replaces the oldest. Examples are held as float32, like shard records. It
+// suits an actor/learner loop, where actors add games while a learner
+// samples, better than shards, which are only readable once flushed.
+//
+// Ring is safe for concurrent use.
+type Ring struct {
+	layout   Layout
+	capacity int
+	stride   int // float32s per example
+
+	mu      sync.RWMutex
+	records []float32
+	next    int // Slot the next example is written to
+	size    int
+	added   int
+}
+
+// NewRing creates a ring holding up to capacity examples of the given
+// layout. A capacity below 1 is raised to 1.
+func NewRing(layout Layout, capacity int) *Ring {
+	capacity = max(capacity, 1)
+	stride := layout.Features + layout.Policy + 1
+	return &Ring{
+		layout:   layout,
+		capacity: capacity,
+		stride:   stride,
+		records:  make([]float32, capacity*stride),
+	}
+}
+
+// Add appends one example. features and policy must match the layout.
+func (r *Ring) Add(features, policy []float64, value float64) error {
+	if len(features) != r.layout.Features || len(policy) != r.layout.Policy {
+		return fmt.Errorf("example has %d features and %d policy values, ring layout is %d and %d",
+			len(features), len(policy), r.layout.Features, r.layout.Policy)
+	}
+
+	r.mu.Lock()
+	defer r.mu.Unlock()
+
+	record := r.records[r.next*r.stride : (r.next+1)*r.stride]
+	for i, v := range features {
+		record[i] = float32(v)
+	}
+	for i, v := range policy {
+		record[r.layout.Features+i] = float32(v)
+	}
+	record[r.stride-1] = float32(value)
+
+	r.next = (r.next + 1) % r.capacity
+	r.size = min(r.size+1, r.capacity)
+	r.added++
+	return nil
+}
+
+// Len returns the number of examples currently held
+func (r *Ring) Len() int {
+	r.mu.RLock()
+	defer r.mu.RUnlock()
+	return r.size
+}
+
+// Added returns the number of examples ever added, including those since
+// overwritten
+func (r *Ring) Added() int {
+	r.mu.RLock()
+	defer r.mu.RUnlock()
+	return r.added
+}
+
+// Sample decodes n examples drawn uniformly at random, with replacement,
+// from those currently held into batch. The ring must not be empty.
+func (r *Ring) Sample(rng *rand.Rand, n int, batch *Batch) {
+	batch.resize(n, r.layout)
+
+	r.mu.RLock()
+	defer r.mu.RUnlock()
+	for i := 0; i < n; i++ {
+		slot := rng.Intn(r.size)
+		record := r.records[slot*r.stride : (slot+1)*r.stride]
+
+		for j := range batch.States[i] {
+			batch.States[i][j] = float64(record[j])
+		}
+		for j := range batch.Policies[i] {
+			batch.Policies[i][j] = float64(record[r.layout.Features+j])
+		}
+		batch.Values[i] = float64(record[r.stride-1])
+	}
+}
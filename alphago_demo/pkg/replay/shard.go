@@ -0,0 +1,258 @@
+// Package replay stores self-play training examples in fixed-width binary
+// shard files as they are generated, and reads them back through a
+// memory-mapped replay buffer that samples mini-batches. A self-play run's
+// memory use is then bounded by the shards being written, not by NumGames.
+// Ring is the in-memory counterpart for loops that sample while they add.
+package replay
+
+import (
+	"bufio"
+	"compress/gzip"
+	"encoding/binary"
+	"errors"
+	"fmt"
+	"io"
+	"math"
+	"os"
+	"path/filepath"
+	"sync"
+)
+
+// File layout, little-endian:
+//
+//	header (16 bytes): magic "RPSSHRD\x00", feature count u32, policy count u32
+//	records (4*(features+policy+1) bytes each):
+//	                   features f32[features], policy f32[policy], value f32
+//
+// A compressed shard (.shard.gz) is the same layout gzipped as a whole.
+const (
+	magic      = "RPSSHRD\x00"
+	headerSize = 16
+
+	// Extension is the file extension of uncompressed shards
+	Extension = ".shard"
+	// CompressedExtension is the file extension of gzipped shards
+	CompressedExtension = ".shard.gz"
+)
+
+// Layout is the shape of one example
+type Layout struct {
+	Features int
+	Policy   int
+}
+
+// RPSLayout is the layout of RPS card game examples: the 81 board features
+// and a policy over the 9 squares
+var RPSLayout = Layout{Features: 81, Policy: 9}
+
+func (l Layout) recordSize() int {
+	return 4 * (l.Features + l.Policy + 1)
+}
+
+// WriterConfig controls how a Writer splits and encodes its shards
+type WriterConfig struct {
+	Layout        Layout
+	ShardExamples int    // Examples per shard before starting the next one
+	Compress      bool   // Gzip shards; they are then read into memory rather than mapped
+	Prefix        string // Shard file name prefix, e.g. "selfplay"
+}
+
+// DefaultWriterConfig returns a configuration for RPS self-play examples
+func DefaultWriterConfig() WriterConfig {
+	return WriterConfig{
+		Layout:        RPSLayout,
+		ShardExamples: 1 << 16,
+		Prefix:        "selfplay",
+	}
+}
+
+// Writer appends examples to a sequence of shard files in one directory. It
+// is safe for concurrent use, so self-play workers can share one.
+type Writer struct {
+	dir    string
+	config WriterConfig
+
+	mu      sync.Mutex
+	file    *os.File
+	gz      *gzip.Writer
+	buf     *bufio.Writer
+	record  []byte
+	inShard int
+	next    int // Number of the next shard file
+	paths   []string
+	total   int
+}
+
+// NewWriter creates dir if needed and prepares to write shards into it.
+// Shard numbering continues after any shards with the same prefix already
+// in dir, so repeated runs add to a replay directory rather than overwrite it.
+func NewWriter(dir string, config WriterConfig) (*Writer, error) {
+	defaults := DefaultWriterConfig()
+	if config.Layout.Features <= 0 || config.Layout.Policy < 0 {
+		return nil, fmt.Errorf("invalid shard layout %+v", config.Layout)
+	}
+	if config.ShardExamples < 1 {
+		config.ShardExamples = defaults.ShardExamples
+	}
+	if config.Prefix == "" {
+		config.Prefix = defaults.Prefix
+	}
+
+	if err := os.MkdirAll(dir, 0755); err != nil {
+		return nil, err
+	}
+	existing, err := ListShards(dir)
+	if err != nil {
+		return nil, err
+	}
+
+	w := &Writer{
+		dir:    dir,
+		config: config,
+		record: make([]byte, config.Layout.recordSize()),
+	}
+	for _, path := range existing {
+		var n int
+		if _, err := fmt.Sscanf(filepath.Base(path), config.Prefix+"-%06d", &n); err == nil && n >= w.next {
+			w.next = n + 1
+		}
+	}
+	return w, nil
+}
+
+// Write appends one example. features and policy must match the layout.
+func (w *Writer) Write(features, policy []float64, value float64) error {
+	w.mu.Lock()
+	defer w.mu.Unlock()
+	return w.writeLocked(features, policy, value)
+}
+
+// WriteBatch appends several examples together, e.g. one game's positions,
+// so they end up adjacent in the same shard where possible
+func (w *Writer) WriteBatch(features, policies [][]float64, values []float64) error {
+	if len(features) != len(policies) || len(features) != len(values) {
+		return errors.New("mismatched batch lengths")
+	}
+
+	w.mu.Lock()
+	defer w.mu.Unlock()
+	for i := range features {
+		if err := w.writeLocked(features[i], policies[i], values[i]); err != nil {
+			return err
+		}
+	}
+	return nil
+}
+
+func (w *Writer) writeLocked(features, policy []float64, value float64) error {
+	layout := w.config.Layout
+	if len(features) != layout.Features || len(policy) != layout.Policy {
+		return fmt.Errorf("example has %d features and %d policy values, shard layout is %d and %d",
+			len(features), len(policy), layout.Features, layout.Policy)
+	}
+
+	if w.buf == nil {
+		if err := w.openShard(); err != nil {
+			return err
+		}
+	}
+
+	off := 0
+	for _, v := range features {
+		binary.LittleEndian.PutUint32(w.record[off:], math.Float32bits(float32(v)))
+		off += 4
+	}
+	for _, v := range policy {
+		binary.LittleEndian.PutUint32(w.record[off:], math.Float32bits(float32(v)))
+		off += 4
+	}
+	binary.LittleEndian.PutUint32(w.record[off:], math.Float32bits(float32(value)))
+
+	if _, err := w.buf.Write(w.record); err != nil {
+		return err
+	}
+	w.inShard++
+	w.total++
+
+	if w.inShard >= w.config.ShardExamples {
+		return w.closeShard()
+	}
+	return nil
+}
+
+func (w *Writer) openShard() error {
+	ext := Extension
+	if w.config.Compress {
+		ext = CompressedExtension
+	}
+	path := filepath.Join(w.dir, fmt.Sprintf("%s-%06d%s", w.config.Prefix, w.next, ext))
+	w.next++
+
+	file, err := os.Create(path)
+	if err != nil {
+		return err
+	}
+
+	var out io.Writer = file
+	if w.config.Compress {
+		w.gz = gzip.NewWriter(file)
+		out = w.gz
+	}
+	w.file = file
+	w.buf = bufio.NewWriterSize(out, 1<<16)
+	w.inShard = 0
+	w.paths = append(w.paths, path)
+
+	var header [headerSize]byte
+	copy(header[:8], magic)
+	binary.LittleEndian.PutUint32(header[8:], uint32(w.config.Layout.Features))
+	binary.LittleEndian.PutUint32(header[12:], uint32(w.config.Layout.Policy))
+	_, err = w.buf.Write(header[:])
+	return err
+}
+
+func (w *Writer) closeShard() error {
+	if w.buf == nil {
+		return nil
+	}
+
+	err := w.buf.Flush()
+	if w.gz != nil {
+		if cerr := w.gz.Close(); err == nil {
+			err = cerr
+		}
+		w.gz = nil
+	}
+	if cerr := w.file.Close(); err == nil {
+		err = cerr
+	}
+	w.file, w.buf = nil, nil
+	return err
+}
+
+// Flush finishes the current shard, so everything written so far can be
+// opened by a Buffer. The next Write starts a new shard.
+func (w *Writer) Flush() error {
+	w.mu.Lock()
+	defer w.mu.Unlock()
+	return w.closeShard()
+}
+
+// Close finishes the current shard
+func (w *Writer) Close() error {
+	return w.Flush()
+}
+
+// Paths returns the shards this writer has created
+func (w *Writer) Paths() []string {
+	w.mu.Lock()
+	defer w.mu.Unlock()
+	return append([]string(nil), w.paths...)
+}
+
+// Count returns the number of examples written
+func (w *Writer) Count() int {
+	w.mu.Lock()
+	defer w.mu.Unlock()
+	return w.total
+}
@@ -0,0 +1,122 @@
+package neural
+
+import "github.com/zachbeta/neural_rps/alphago_demo/pkg/game"
+
+// BatchScratch holds the buffers used by batched forward passes, one row per
+// position. Like Scratch it must not be shared between goroutines.
+type BatchScratch struct {
+	Features  []float64 // batch x 81 encoded game states
+	Hidden    []float64 // batch x hiddenSize activations
+	Output    []float64 // batch x outputSize values
+	rows      [][]float64
+	quantized int8Activations // Activations quantized for int8 layers
+
+	// Cache misses gathered by EvalCache's batch lookups
+	missIndex  []int
+	missStates []*game.RPSGame
+}
+
+// ensure grows the batch buffers for batch positions
+func (s *BatchScratch) ensure(batch, inputSize, hiddenSize, outputSize int) {
+	s.Features = growFloats(s.Features, batch*inputSize)
+	s.Hidden = growFloats(s.Hidden, batch*hiddenSize)
+	s.Output = growFloats(s.Output, batch*outputSize)
+}
+
+// forwardInt8 runs each position of the batch through int8 weights w, one
+// at a time: the int8 layers are small enough to stay in cache, so there is
+// nothing to gain from streaming them once per batch
+func (s *BatchScratch) forwardInt8(w *quantizedWeights, biasesHidden, biasesOutput []float64, batch int) {
+	inputSize, hiddenSize, outputSize := len(s.Features)/batch, len(biasesHidden), len(biasesOutput)
+	for b := 0; b < batch; b++ {
+		w.forward(s.Features[b*inputSize:(b+1)*inputSize], s.Hidden[b*hiddenSize:(b+1)*hiddenSize],
+			s.Output[b*outputSize:(b+1)*outputSize], biasesHidden, biasesOutput, &s.quantized)
+	}
+}
+
+func growFloats(buf []float64, n int) []float64 {
+	if cap(buf) < n {
+		return make([]float64, n)
+	}
+	return buf[:n]
+}
+
+// denseBatch applies dense (or denseReLU when activate is set) to batch
+// inputs stored row-major in input, writing one row of len(bias) outputs per
+// input. Each weight row is used for the whole batch before moving to the
+// next, so the weights are streamed from memory once per batch rather than
+// once per position. Results are identical to the single-position kernels.
+func denseBatch(weights, bias, input, out []float64, batch int, activate bool) {
+	cols := len(input) / batch
+	rows := len(bias)
+	for i := 0; i < rows; i++ {
+		row := weights[i*cols : i*cols+cols]
+		for b := 0; b < batch; b++ {
+			v := bias[i] + dot(row, input[b*cols:b*cols+cols])
+			if activate {
+				v = relu(v)
+			}
+			out[b*rows+i] = v
+		}
+	}
+}
+
+// fillFeatures encodes states into consecutive rows of features
+func fillFeatures(states []*game.RPSGame, features []float64, inputSize int) {
+	for b, state := range states {
+		state.FillBoardFeatures(features[b*inputSize : (b+1)*inputSize])
+	}
+}
+
+// PredictBatch returns the position probabilities for each of states, as
+// one forward pass over the whole batch. Row i corresponds to states[i]; the
+// rows alias scratch and are only valid until it is reused. No states give
+// no rows.
+func (n *RPSPolicyNetwork) PredictBatch(states []*game.RPSGame, scratch *BatchScratch) [][]float64 {
+	batch := len(states)
+	if batch == 0 {
+		return nil
+	}
+	scratch.ensure(batch, n.inputSize, n.hiddenSize, n.outputSize)
+	fillFeatures(states, scratch.Features, n.inputSize)
+
+	if n.quantized != nil {
+		scratch.forwardInt8(n.quantized, n.biasesHidden, n.biasesOutput, batch)
+	} else {
+		denseBatch(n.weightsInputHidden, n.biasesHidden, scratch.Features, scratch.Hidden, batch, true)
+		denseBatch(n.weightsHiddenOutput, n.biasesOutput, scratch.Hidden, scratch.Output, batch, false)
+	}
+
+	scratch.rows = scratch.rows[:0]
+	for b := 0; b < batch; b++ {
+		row := scratch.Output[b*n.outputSize : (b+1)*n.outputSize : (b+1)*n.outputSize]
+		softmaxInPlace(row)
+		scratch.rows = append(scratch.rows, row)
+	}
+	return scratch.rows
+}
+
+// PredictBatch returns the value of each of states, as one forward pass over
+// the whole batch. The result aliases scratch and is only valid until it is
+// reused. No states give no values.
+func (n *RPSValueNetwork) PredictBatch(states []*game.RPSGame, scratch *BatchScratch) []float64 {
+	batch := len(states)
+	if batch == 0 {
+		return nil
+	}
+	scratch.ensure(batch, n.inputSize, n.hiddenSize, n.outputSize)
+	fillFeatures(states, scratch.Features, n.inputSize)
+
+	if n.quantized != nil {
+		scratch.forwardInt8(n.quantized, n.biasesHidden, n.biasesOutput[:1], batch)
+	} else {
+		denseBatch(n.weightsInputHidden, n.biasesHidden, scratch.Features, scratch.Hidden, batch, true)
+		denseBatch(n.weightsHiddenOutput[:n.hiddenSize], n.biasesOutput[:1], scratch.Hidden, scratch.Output, batch, false)
+	}
+
+	values := scratch.Output[:batch]
+	for b := range values {
+		values[b] = sigmoid(values[b])
+	}
+	return values
+}
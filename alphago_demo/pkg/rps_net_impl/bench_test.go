@@ -0,0 +1,89 @@
+package neural
+
+import (
+	"fmt"
+	"testing"
+)
+
+// benchHiddenSizes are the hidden layer sizes the forward pass benchmarks
+// cover: the test networks' size, the default and a large one
+var benchHiddenSizes = []int{32, 64, 128}
+
+// benchBatchSize is the batch of positions the PredictBatch benchmarks
+// evaluate per call, about what a leaf-batched search gathers
+const benchBatchSize = 64
+
+// reportPositions reports positions evaluated per second
+func reportPositions(b *testing.B, positions int) {
+	if s := b.Elapsed().Seconds(); s > 0 {
+		b.ReportMetric(float64(positions)/s, "positions/sec")
+	}
+}
+
+// benchPrecisions runs bench once with the float network and once with its
+// int8 copy
+func benchPrecisions[N any](b *testing.B, hidden int, newNet func(int) *N, quantize func(*N) *N, bench func(*testing.B, *N)) {
+	net := newNet(hidden)
+	b.Run(fmt.Sprintf("hidden=%d/float64", hidden), func(b *testing.B) { bench(b, net) })
+	b.Run(fmt.Sprintf("hidden=%d/int8", hidden), func(b *testing.B) { bench(b, quantize(net)) })
+}
+
+func BenchmarkPolicyPredict(b *testing.B) {
+	states := quantizeTestStates()
+	for _, hidden := range benchHiddenSizes {
+		benchPrecisions(b, hidden, NewRPSPolicyNetwork, (*RPSPolicyNetwork).Quantized, func(b *testing.B, n *RPSPolicyNetwork) {
+			scratch := NewScratch(hidden)
+			b.ReportAllocs()
+			b.ResetTimer()
+			for i := 0; i < b.N; i++ {
+				n.PredictWithScratch(states[i%len(states)], scratch)
+			}
+			reportPositions(b, b.N)
+		})
+	}
+}
+
+func BenchmarkValuePredict(b *testing.B) {
+	states := quantizeTestStates()
+	for _, hidden := range benchHiddenSizes {
+		benchPrecisions(b, hidden, NewRPSValueNetwork, (*RPSValueNetwork).Quantized, func(b *testing.B, n *RPSValueNetwork) {
+			scratch := NewScratch(hidden)
+			b.ReportAllocs()
+			b.ResetTimer()
+			for i := 0; i < b.N; i++ {
+				n.PredictWithScratch(states[i%len(states)], scratch)
+			}
+			reportPositions(b, b.N)
+		})
+	}
+}
+
+func BenchmarkPolicyPredictBatch(b *testing.B) {
+	states := quantizeTestStates()[:benchBatchSize]
+	for _, hidden := range benchHiddenSizes {
+		benchPrecisions(b, hidden, NewRPSPolicyNetwork, (*RPSPolicyNetwork).Quantized, func(b *testing.B, n *RPSPolicyNetwork) {
+			var scratch BatchScratch
+			b.ReportAllocs()
+			b.ResetTimer()
+			for i := 0; i < b.N; i++ {
+				n.PredictBatch(states, &scratch)
+			}
+			reportPositions(b, b.N*len(states))
+		})
+	}
+}
+
+func BenchmarkValuePredictBatch(b *testing.B) {
+	states := quantizeTestStates()[:benchBatchSize]
+	for _, hidden := range benchHiddenSizes {
+		benchPrecisions(b, hidden, NewRPSValueNetwork, (*RPSValueNetwork).Quantized, func(b *testing.B, n *RPSValueNetwork) {
+			var scratch BatchScratch
+			b.ReportAllocs()
+			b.ResetTimer()
+			for i := 0; i < b.N; i++ {
+				n.PredictBatch(states, &scratch)
+			}
+			reportPositions(b, b.N*len(states))
+		})
+	}
+}
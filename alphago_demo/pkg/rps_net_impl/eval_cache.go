@@ -0,0 +1,359 @@
+package neural
+
+import (
+	"sync"
+	"sync/atomic"
+
+	"github.com/zachbeta/neural_rps/alphago_demo/pkg/game"
+	"github.com/zachbeta/neural_rps/alphago_demo/pkg/metrics"
+)
+
+// modelVersions hands out model versions; 0 means not yet assigned
+var modelVersions atomic.Uint64
+
+// modelVersion identifies a network's current weights for EvalCache. It is
+// assigned on first use and replaced whenever the weights change, so a
+// retrained or reloaded network never hits entries cached for its old weights.
+type modelVersion struct {
+	v atomic.Uint64
+}
+
+func (m *modelVersion) get() uint64 {
+	if v := m.v.Load(); v != 0 {
+		return v
+	}
+	m.v.CompareAndSwap(0, modelVersions.Add(1))
+	return m.v.Load()
+}
+
+func (m *modelVersion) bump() {
+	m.v.Store(modelVersions.Add(1))
+}
+
+// share gives m the same version as other, for networks with identical weights
+func (m *modelVersion) share(other *modelVersion) {
+	m.v.Store(other.get())
+}
+
+const evalCacheShards = 64
+
+// DefaultEvalCacheEntries is a cache size suited to one self-play or
+// evaluation run
+const DefaultEvalCacheEntries = 1 << 16
+
+type evalCacheKey struct {
+	position uint64 // game.RPSGame.FeatureKey
+	model    uint64 // modelVersion of the network
+}
+
+type evalCacheEntry struct {
+	key        evalCacheKey
+	policy     []float64 // Unused for value network entries
+	value      float64
+	referenced bool // Set on a hit; spares the entry from one CLOCK sweep
+}
+
+type evalCacheShard struct {
+	mu      sync.Mutex
+	index   map[evalCacheKey]int32
+	entries []evalCacheEntry
+	limit   int
+	hand    int // CLOCK hand: next entry considered for eviction
+}
+
+// EvalCache memoizes policy and value network outputs by position, so a
+// position reached again (by a transposition, a later search on the same
+// game, or another game that opens the same way) costs a lookup instead of
+// a forward pass. Entries are keyed by the network's current weights, so one
+// cache can serve several networks, and training, loading or SetWeights make
+// a network's old entries unreachable; CLOCK eviction then recycles them.
+//
+// EvalCache is safe for concurrent use. A nil *EvalCache is valid and
+// evaluates every position.
+type EvalCache struct {
+	shards [evalCacheShards]evalCacheShard
+	hits   atomic.Uint64
+	misses atomic.Uint64
+}
+
+// NewEvalCache creates a cache holding up to about entries positions
+func NewEvalCache(entries int) *EvalCache {
+	limit := (entries + evalCacheShards - 1) / evalCacheShards
+	if limit < 1 {
+		limit = 1
+	}
+
+	c := &EvalCache{}
+	for i := range c.shards {
+		c.shards[i].index = make(map[evalCacheKey]int32, limit)
+		c.shards[i].entries = make([]evalCacheEntry, 0, limit)
+		c.shards[i].limit = limit
+	}
+	return c
+}
+
+// Process-wide cache metrics, the sums over every EvalCache
+var (
+	evalCacheHitsTotal = metrics.NewCounter("neural_eval_cache_hits_total",
+		"Network evaluations answered from an EvalCache")
+	evalCacheMissesTotal = metrics.NewCounter("neural_eval_cache_misses_total",
+		"Network evaluations an EvalCache did not hold")
+)
+
+func (c *EvalCache) hit(n int) {
+	c.hits.Add(uint64(n))
+	evalCacheHitsTotal.Add(uint64(n))
+}
+
+func (c *EvalCache) miss(n int) {
+	c.misses.Add(uint64(n))
+	evalCacheMissesTotal.Add(uint64(n))
+}
+
+func (c *EvalCache) shard(key evalCacheKey) *evalCacheShard {
+	h := (key.position ^ key.model*0xbf58476d1ce4e5b9) * 0x9e3779b97f4a7c15
+	return &c.shards[h>>58]
+}
+
+// Policy returns n's position probabilities for state, from the cache if
+// possible. Like RPSPolicyNetwork.Predict, the returned slice is owned by the
+// caller.
+func (c *EvalCache) Policy(n *RPSPolicyNetwork, state *game.RPSGame) []float64 {
+	return c.PolicyInto(n, state, make([]float64, 0, n.outputSize))
+}
+
+// PolicyInto is Policy writing the probabilities to dst[:0], like
+// RPSPolicyNetwork.PredictInto, so a caller that owns the storage (such as
+// an MCTS node arena) evaluates positions without allocating
+func (c *EvalCache) PolicyInto(n *RPSPolicyNetwork, state *game.RPSGame, dst []float64) []float64 {
+	if c == nil {
+		return n.PredictInto(state, dst)
+	}
+
+	key := evalCacheKey{position: state.FeatureKey(), model: n.version.get()}
+	s := c.shard(key)
+
+	s.mu.Lock()
+	if i, ok := s.index[key]; ok {
+		e := &s.entries[i]
+		e.referenced = true
+		dst = append(dst[:0], e.policy...)
+		s.mu.Unlock()
+		c.hit(1)
+		return dst
+	}
+	s.mu.Unlock()
+	c.miss(1)
+
+	dst = n.PredictInto(state, dst)
+
+	s.mu.Lock()
+	e := s.insert(key)
+	e.policy = append(e.policy[:0], dst...)
+	s.mu.Unlock()
+	return dst
+}
+
+// Value returns n's value for state, from the cache if possible
+func (c *EvalCache) Value(n *RPSValueNetwork, state *game.RPSGame) float64 {
+	if c == nil {
+		return n.Predict(state)
+	}
+
+	key := evalCacheKey{position: state.FeatureKey(), model: n.version.get()}
+	s := c.shard(key)
+
+	s.mu.Lock()
+	if i, ok := s.index[key]; ok {
+		e := &s.entries[i]
+		e.referenced = true
+		value := e.value
+		s.mu.Unlock()
+		c.hit(1)
+		return value
+	}
+	s.mu.Unlock()
+	c.miss(1)
+
+	value := n.Predict(state)
+
+	s.mu.Lock()
+	s.insert(key).value = value
+	s.mu.Unlock()
+	return value
+}
+
+// PolicyBatch is Policy for several states at once: positions not in the
+// cache are evaluated together by one RPSPolicyNetwork.PredictBatch. Row i
+// corresponds to states[i] and, like Policy's result, is owned by the caller.
+func (c *EvalCache) PolicyBatch(n *RPSPolicyNetwork, states []*game.RPSGame, scratch *BatchScratch) [][]float64 {
+	result := make([][]float64, len(states))
+	if c == nil {
+		for i, probs := range n.PredictBatch(states, scratch) {
+			result[i] = append([]float64(nil), probs...)
+		}
+		return result
+	}
+
+	model := n.version.get()
+	scratch.missIndex, scratch.missStates = scratch.missIndex[:0], scratch.missStates[:0]
+	for i, state := range states {
+		key := evalCacheKey{position: state.FeatureKey(), model: model}
+		s := c.shard(key)
+
+		s.mu.Lock()
+		if j, ok := s.index[key]; ok {
+			e := &s.entries[j]
+			e.referenced = true
+			result[i] = append([]float64(nil), e.policy...)
+		}
+		s.mu.Unlock()
+		if result[i] == nil {
+			scratch.missIndex = append(scratch.missIndex, i)
+			scratch.missStates = append(scratch.missStates, state)
+		}
+	}
+	c.hit(len(states) - len(scratch.missIndex))
+	c.miss(len(scratch.missIndex))
+	if len(scratch.missIndex) == 0 {
+		return result
+	}
+
+	for k, probs := range n.PredictBatch(scratch.missStates, scratch) {
+		i := scratch.missIndex[k]
+		result[i] = append([]float64(nil), probs...)
+
+		key := evalCacheKey{position: states[i].FeatureKey(), model: model}
+		s := c.shard(key)
+		s.mu.Lock()
+		e := s.insert(key)
+		e.policy = append(e.policy[:0], probs...)
+		s.mu.Unlock()
+	}
+	return result
+}
+
+// ValueBatch is Value for several states at once, writing the value of
+// states[i] to values[i]. Positions not in the cache are evaluated together
+// by one RPSValueNetwork.PredictBatch.
+func (c *EvalCache) ValueBatch(n *RPSValueNetwork, states []*game.RPSGame, values []float64, scratch *BatchScratch) {
+	if c == nil {
+		copy(values, n.PredictBatch(states, scratch))
+		return
+	}
+
+	model := n.version.get()
+	scratch.missIndex, scratch.missStates = scratch.missIndex[:0], scratch.missStates[:0]
+	for i, state := range states {
+		key := evalCacheKey{position: state.FeatureKey(), model: model}
+		s := c.shard(key)
+
+		s.mu.Lock()
+		j, ok := s.index[key]
+		if ok {
+			e := &s.entries[j]
+			e.referenced = true
+			values[i] = e.value
+		}
+		s.mu.Unlock()
+		if !ok {
+			scratch.missIndex = append(scratch.missIndex, i)
+			scratch.missStates = append(scratch.missStates, state)
+		}
+	}
+	c.hit(len(states) - len(scratch.missIndex))
+	c.miss(len(scratch.missIndex))
+	if len(scratch.missIndex) == 0 {
+		return
+	}
+
+	for k, value := range n.PredictBatch(scratch.missStates, scratch) {
+		i := scratch.missIndex[k]
+		values[i] = value
+
+		key := evalCacheKey{position: states[i].FeatureKey(), model: model}
+		s := c.shard(key)
+		s.mu.Lock()
+		s.insert(key).value = value
+		s.mu.Unlock()
+	}
+}
+
+// insert returns the entry for key, claiming a free or evicted slot if key
+// is not present. Callers hold s.mu.
+func (s *evalCacheShard) insert(key evalCacheKey) *evalCacheEntry {
+	// Another goroutine may have filled the same key while we computed it
+	if i, ok := s.index[key]; ok {
+		return &s.entries[i]
+	}
+
+	var i int
+	if len(s.entries) < s.limit {
+		s.entries = append(s.entries, evalCacheEntry{})
+		i = len(s.entries) - 1
+	} else {
+		for s.entries[s.hand].referenced {
+			s.entries[s.hand].referenced = false
+			s.hand = (s.hand + 1) % len(s.entries)
+		}
+		i = s.hand
+		s.hand = (s.hand + 1) % len(s.entries)
+		delete(s.index, s.entries[i].key)
+	}
+
+	e := &s.entries[i]
+	e.key = key
+	e.referenced = false
+	s.index[key] = int32(i)
+	return e
+}
+
+// Stats returns hits, misses and hit rate (percent), like
+// analysis.ZobristTable.GetStats
+func (c *EvalCache) Stats() (int, int, float64) {
+	if c == nil {
+		return 0, 0, 0.0
+	}
+	hits := int(c.hits.Load())
+	misses := int(c.misses.Load())
+
+	total := hits + misses
+	hitRate := 0.0
+	if total > 0 {
+		hitRate = float64(hits) / float64(total) * 100.0
+	}
+
+	return hits, misses, hitRate
+}
+
+// Len returns the number of cached positions
+func (c *EvalCache) Len() int {
+	if c == nil {
+		return 0
+	}
+	n := 0
+	for i := range c.shards {
+		s := &c.shards[i]
+		s.mu.Lock()
+		n += len(s.entries)
+		s.mu.Unlock()
+	}
+	return n
+}
+
+// Clear empties the cache and resets its statistics
+func (c *EvalCache) Clear() {
+	if c == nil {
+		return
+	}
+	for i := range c.shards {
+		s := &c.shards[i]
+		s.mu.Lock()
+		clear(s.index)
+		s.entries = s.entries[:0]
+		s.hand = 0
+		s.mu.Unlock()
+	}
+	c.hits.Store(0)
+	c.misses.Store(0)
+}
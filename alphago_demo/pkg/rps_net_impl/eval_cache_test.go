@@ -0,0 +1,228 @@
+package neural
+
+import (
+	"math"
+	"sync"
+	"testing"
+
+	"github.com/zachbeta/neural_rps/alphago_demo/pkg/game"
+)
+
+func TestEvalCacheMatchesNetwork(t *testing.T) {
+	policy := NewRPSPolicyNetwork(16)
+	value := NewRPSValueNetwork(16)
+	cache := NewEvalCache(1024)
+
+	state := game.NewRPSGame(21, 5, 10)
+	for round := 0; round < 2; round++ {
+		probs := cache.Policy(policy, state)
+		want := policy.Predict(state)
+		for i := range want {
+			if probs[i] != want[i] {
+				t.Fatalf("Round %d: cached policy %v, expected %v", round, probs, want)
+			}
+		}
+		if v := cache.Value(value, state); v != value.Predict(state) {
+			t.Fatalf("Round %d: cached value %f, expected %f", round, v, value.Predict(state))
+		}
+
+		// Callers own the returned slice
+		probs[0] = -1
+	}
+
+	hits, misses, _ := cache.Stats()
+	if hits != 2 || misses != 2 {
+		t.Errorf("Expected 2 hits and 2 misses, got %d and %d", hits, misses)
+	}
+}
+
+func TestEvalCacheInvalidatesOnWeightChange(t *testing.T) {
+	value := NewRPSValueNetwork(16)
+	cache := NewEvalCache(1024)
+	state := game.NewRPSGame(21, 5, 10)
+
+	cache.Value(value, state)
+
+	weights := value.GetWeights()
+	for i := range weights {
+		weights[i] = 0.5
+	}
+	if err := value.SetWeights(weights); err != nil {
+		t.Fatal(err)
+	}
+
+	if v := cache.Value(value, state); v != value.Predict(state) {
+		t.Errorf("Expected a fresh value after SetWeights, got stale %f", v)
+	}
+	if hits, _, _ := cache.Stats(); hits != 0 {
+		t.Errorf("Expected no hits across a weight change, got %d", hits)
+	}
+
+	// A clone has the same weights, so it may use the same entries
+	cache.Value(value.Clone(), state)
+	if hits, _, _ := cache.Stats(); hits != 1 {
+		t.Errorf("Expected the clone to hit its original's entry, got %d hits", hits)
+	}
+}
+
+func TestEvalCacheEviction(t *testing.T) {
+	value := NewRPSValueNetwork(16)
+	cache := NewEvalCache(evalCacheShards) // One entry per shard
+
+	state := game.NewRPSGame(21, 5, 10)
+	for !state.IsGameOver() {
+		cache.Value(value, state)
+		move, err := state.GetRandomMove()
+		if err != nil {
+			break
+		}
+		state.MakeMove(move)
+	}
+
+	if n := cache.Len(); n > evalCacheShards {
+		t.Errorf("Expected at most %d entries, got %d", evalCacheShards, n)
+	}
+
+	cache.Clear()
+	if n := cache.Len(); n != 0 {
+		t.Errorf("Expected an empty cache after Clear, got %d entries", n)
+	}
+}
+
+func TestEvalCacheConcurrent(t *testing.T) {
+	policy := NewRPSPolicyNetwork(16)
+	cache := NewEvalCache(256)
+
+	var wg sync.WaitGroup
+	for w := 0; w < 8; w++ {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			for g := 0; g < 20; g++ {
+				state := game.NewRPSGame(21, 5, 10)
+				for !state.IsGameOver() {
+					probs := cache.Policy(policy, state)
+					if len(probs) != 9 {
+						t.Errorf("Expected 9 probabilities, got %d", len(probs))
+						return
+					}
+					move, err := state.GetRandomMove()
+					if err != nil {
+						break
+					}
+					state.MakeMove(move)
+				}
+			}
+		}()
+	}
+	wg.Wait()
+
+	if hits, _, _ := cache.Stats(); hits == 0 {
+		t.Errorf("Expected repeated opening positions to hit the cache")
+	}
+}
+
+func TestNilEvalCache(t *testing.T) {
+	var cache *EvalCache
+	value := NewRPSValueNetwork(16)
+	state := game.NewRPSGame(21, 5, 10)
+
+	if v := cache.Value(value, state); v != value.Predict(state) {
+		t.Errorf("Expected a nil cache to evaluate directly")
+	}
+	if hits, misses, _ := cache.Stats(); hits != 0 || misses != 0 {
+		t.Errorf("Expected no stats from a nil cache")
+	}
+}
+
+func TestEvalCacheBatchMatchesNetwork(t *testing.T) {
+	policy := NewRPSPolicyNetwork(16)
+	value := NewRPSValueNetwork(16)
+	cache := NewEvalCache(1024)
+
+	// A few distinct positions, one of them already cached
+	var states []*game.RPSGame
+	state := game.NewRPSGame(21, 5, 10)
+	for i := 0; i < 5; i++ {
+		states = append(states, state.Copy())
+		state.MakeMove(state.GetValidMoves()[0])
+	}
+	cache.Policy(policy, states[2])
+	cache.Value(value, states[2])
+
+	var scratch BatchScratch
+	for _, c := range []*EvalCache{cache, nil} {
+		probs := c.PolicyBatch(policy, states, &scratch)
+		values := make([]float64, len(states))
+		c.ValueBatch(value, states, values, &scratch)
+
+		for i, s := range states {
+			want := policy.Predict(s)
+			for j := range want {
+				if probs[i][j] != want[j] {
+					t.Fatalf("Position %d: batched policy %v, expected %v", i, probs[i], want)
+				}
+			}
+			if values[i] != value.Predict(s) {
+				t.Fatalf("Position %d: batched value %f, expected %f", i, values[i], value.Predict(s))
+			}
+		}
+	}
+
+	hits, misses, _ := cache.Stats()
+	if hits != 2 || misses != 10 {
+		t.Errorf("Expected 2 hits and 10 misses, got %d and %d", hits, misses)
+	}
+}
+
+func TestEmptyBatch(t *testing.T) {
+	var scratch BatchScratch
+	for _, quantized := range []bool{false, true} {
+		policy, value := NewRPSPolicyNetwork(16), NewRPSValueNetwork(16)
+		if quantized {
+			policy, value = policy.Quantized(), value.Quantized()
+		}
+
+		if rows := policy.PredictBatch(nil, &scratch); len(rows) != 0 {
+			t.Errorf("quantized=%t: expected no policy rows, got %d", quantized, len(rows))
+		}
+		if values := value.PredictBatch(nil, &scratch); len(values) != 0 {
+			t.Errorf("quantized=%t: expected no values, got %d", quantized, len(values))
+		}
+		for _, c := range []*EvalCache{NewEvalCache(16), nil} {
+			if rows := c.PolicyBatch(policy, nil, &scratch); len(rows) != 0 {
+				t.Errorf("quantized=%t: expected no cached policy rows, got %d", quantized, len(rows))
+			}
+			c.ValueBatch(value, nil, nil, &scratch)
+		}
+	}
+}
+
+func TestEvalCachePolicyInto(t *testing.T) {
+	policy := NewRPSPolicyNetwork(16)
+	state := game.NewRPSGame(21, 5, 10)
+	want := policy.Predict(state)
+	dst := make([]float64, 0, policy.GetOutputSize())
+
+	for _, cache := range []*EvalCache{NewEvalCache(1024), nil} {
+		// A miss, then (for a real cache) a hit
+		for i := 0; i < 2; i++ {
+			probs := cache.PolicyInto(policy, state, dst)
+			if len(probs) != len(want) || &probs[0] != &dst[:1][0] {
+				t.Fatalf("Expected PolicyInto to write into dst")
+			}
+			for j := range want {
+				if math.Abs(probs[j]-want[j]) > 1e-12 {
+					t.Errorf("Probability %d is %f, expected %f", j, probs[j], want[j])
+				}
+			}
+		}
+
+		allocs := testing.AllocsPerRun(100, func() {
+			cache.PolicyInto(policy, state, dst)
+		})
+		if allocs != 0 && !raceEnabled {
+			t.Errorf("Expected PolicyInto into a sized buffer to be allocation-free, got %.1f allocs/op", allocs)
+		}
+	}
+}
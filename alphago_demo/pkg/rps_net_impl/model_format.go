@@ -0,0 +1,489 @@
+package neural
+
+import (
+	"encoding/binary"
+	"encoding/json"
+	"errors"
+	"fmt"
+	"hash/crc32"
+	"math"
+	"os"
+	"unsafe"
+
+	"github.com/zachbeta/neural_rps/alphago_demo/pkg/internal/mmapfile"
+)
+
+// Binary model files, little-endian:
+//
+//	header (32 bytes): magic "RPSNET\x00\x00", format version u16, network
+//	                   kind u8 (1 policy, 2 value), bytes per weight u8
+//	                   (1, 4 or 8), reserved u32, input, hidden and output
+//	                   sizes u32, CRC-32C of the weight blocks u32
+//	weight blocks:     input->hidden weights (hidden x input, row-major),
+//	                   hidden biases, hidden->output weights (output x
+//	                   hidden, row-major), output biases
+//
+// The blocks start 8-byte aligned, and float64 blocks have exactly the
+// layout of the networks' flat weight buffers, so on little-endian machines
+// a file's bytes are used as the weights without decoding. In int8 files
+// each weight matrix is preceded by its per-row float64 scales and the
+// biases are float64, so a quantized network round-trips exactly.
+// LoadFromFile accepts both this format and the JSON written by SaveToFile.
+const (
+	modelMagic         = "RPSNET\x00\x00"
+	modelFormatVersion = 1
+	modelHeaderSize    = 32
+	maxModelDimension  = 1 << 20 // Bounds header sizes so a corrupt file can't overflow
+)
+
+var modelCRCTable = crc32.MakeTable(crc32.Castagnoli)
+
+// WeightPrecision is the size of each weight in a binary model file
+type WeightPrecision int
+
+const (
+	PrecisionFloat64 WeightPrecision = 8 // Exact; mapped without decoding
+	PrecisionFloat32 WeightPrecision = 4 // Half the size; decoded on load
+	PrecisionInt8    WeightPrecision = 1 // Quantized; loads as a quantized network
+)
+
+var weightPrecisions = []WeightPrecision{PrecisionFloat64, PrecisionFloat32, PrecisionInt8}
+
+// String returns the name accepted by ParseWeightPrecision
+func (p WeightPrecision) String() string {
+	switch p {
+	case PrecisionFloat64:
+		return "float64"
+	case PrecisionFloat32:
+		return "float32"
+	case PrecisionInt8:
+		return "int8"
+	default:
+		return fmt.Sprintf("WeightPrecision(%d)", int(p))
+	}
+}
+
+// ParseWeightPrecision parses "float64", "float32" or "int8"
+func ParseWeightPrecision(name string) (WeightPrecision, error) {
+	for _, p := range weightPrecisions {
+		if name == p.String() {
+			return p, nil
+		}
+	}
+	return 0, fmt.Errorf("unknown weight precision %q (want float64, float32 or int8)", name)
+}
+
+func (p WeightPrecision) valid() bool {
+	return p == PrecisionFloat64 || p == PrecisionFloat32 || p == PrecisionInt8
+}
+
+type modelKind uint8
+
+const (
+	policyModel modelKind = 1
+	valueModel  modelKind = 2
+)
+
+func (k modelKind) String() string {
+	if k == policyModel {
+		return "policy"
+	}
+	return "value"
+}
+
+// modelData is a network's sizes and flat parameters, in file order, and
+// its int8 weights if it is quantized
+type modelData struct {
+	kind                  modelKind
+	input, hidden, output int
+	tensors               [4][]float64
+	quantized             *quantizedWeights
+}
+
+// sizes returns the number of values in each tensor
+func (m modelData) sizes() [4]int {
+	return [4]int{m.hidden * m.input, m.hidden, m.output * m.hidden, m.output}
+}
+
+// bodySize returns the length of the weight blocks at a precision
+func (m modelData) bodySize(precision WeightPrecision) int {
+	sizes := m.sizes()
+	if precision != PrecisionInt8 {
+		return (sizes[0] + sizes[1] + sizes[2] + sizes[3]) * int(precision)
+	}
+	// Scales and biases are float64
+	return sizes[0] + sizes[2] + (m.hidden+sizes[1]+m.output+sizes[3])*8
+}
+
+// IsBinaryModel reports whether data starts with a binary model header
+func IsBinaryModel(data []byte) bool {
+	return len(data) >= len(modelMagic) && string(data[:len(modelMagic)]) == modelMagic
+}
+
+// encodeModel serializes m with the given precision
+func encodeModel(m modelData, precision WeightPrecision) ([]byte, error) {
+	if !precision.valid() {
+		return nil, fmt.Errorf("unsupported weight precision %v", precision)
+	}
+
+	data := make([]byte, modelHeaderSize+m.bodySize(precision))
+	body := data[modelHeaderSize:]
+	if precision == PrecisionInt8 {
+		encodeInt8(body, m)
+	} else {
+		off := 0
+		for _, t := range m.tensors {
+			for _, v := range t {
+				if precision == PrecisionFloat64 {
+					binary.LittleEndian.PutUint64(body[off:], math.Float64bits(v))
+				} else {
+					binary.LittleEndian.PutUint32(body[off:], math.Float32bits(float32(v)))
+				}
+				off += int(precision)
+			}
+		}
+	}
+
+	copy(data, modelMagic)
+	binary.LittleEndian.PutUint16(data[8:], modelFormatVersion)
+	data[10] = byte(m.kind)
+	data[11] = byte(precision)
+	binary.LittleEndian.PutUint32(data[16:], uint32(m.input))
+	binary.LittleEndian.PutUint32(data[20:], uint32(m.hidden))
+	binary.LittleEndian.PutUint32(data[24:], uint32(m.output))
+	binary.LittleEndian.PutUint32(data[28:], crc32.Checksum(body, modelCRCTable))
+	return data, nil
+}
+
+// encodeInt8 writes m's weight blocks quantized to int8, quantizing them
+// first if m is a float network
+func encodeInt8(body []byte, m modelData) {
+	w := m.quantized
+	if w == nil {
+		w = quantizeWeights(m)
+	}
+
+	off := 0
+	putFloats := func(values []float64) {
+		for _, v := range values {
+			binary.LittleEndian.PutUint64(body[off:], math.Float64bits(v))
+			off += 8
+		}
+	}
+	putLayer := func(l int8Layer) {
+		putFloats(l.scales)
+		for i := 0; i < l.rows; i++ {
+			for j := 0; j < l.cols; j++ {
+				body[off] = byte(l.at(i, j))
+				off++
+			}
+		}
+	}
+	putLayer(w.inputHidden)
+	putFloats(m.tensors[1])
+	putLayer(w.hiddenOutput)
+	putFloats(m.tensors[3])
+}
+
+// decodeInt8 reads int8 weight blocks into m, with float tensors holding the
+// dequantized weights
+func decodeInt8(body []byte, m *modelData) {
+	off := 0
+	getFloats := func(n int) []float64 {
+		values := make([]float64, n)
+		for i := range values {
+			values[i] = math.Float64frombits(binary.LittleEndian.Uint64(body[off:]))
+			off += 8
+		}
+		return values
+	}
+	getLayer := func(rows, cols int) int8Layer {
+		l := newInt8Layer(rows, cols)
+		l.scales = getFloats(rows)
+		for i := 0; i < rows; i++ {
+			for j := 0; j < cols; j++ {
+				l.set(i, j, int8(body[off]))
+				off++
+			}
+		}
+		return l
+	}
+
+	w := &quantizedWeights{}
+	w.inputHidden = getLayer(m.hidden, m.input)
+	m.tensors[1] = getFloats(m.hidden)
+	w.hiddenOutput = getLayer(m.output, m.hidden)
+	m.tensors[3] = getFloats(m.output)
+	m.tensors[0], m.tensors[2] = w.inputHidden.dequantize(), w.hiddenOutput.dequantize()
+	m.quantized = w
+}
+
+// decodeModel parses a binary model of the given kind. Where the file's
+// layout matches memory, the tensors alias data, which must then outlive
+// them and stay writable if the network may be trained.
+func decodeModel(data []byte, kind modelKind) (modelData, error) {
+	if !IsBinaryModel(data) || len(data) < modelHeaderSize {
+		return modelData{}, errors.New("not a binary model file")
+	}
+	if v := binary.LittleEndian.Uint16(data[8:]); v != modelFormatVersion {
+		return modelData{}, fmt.Errorf("unsupported model format version %d", v)
+	}
+	if k := modelKind(data[10]); k != kind {
+		return modelData{}, fmt.Errorf("file holds a %s network, not a %s network", k, kind)
+	}
+	precision := WeightPrecision(data[11])
+	if !precision.valid() {
+		return modelData{}, fmt.Errorf("unsupported weight precision %d", data[11])
+	}
+
+	m := modelData{
+		kind:   kind,
+		input:  int(binary.LittleEndian.Uint32(data[16:])),
+		hidden: int(binary.LittleEndian.Uint32(data[20:])),
+		output: int(binary.LittleEndian.Uint32(data[24:])),
+	}
+	if m.input > maxModelDimension || m.hidden > maxModelDimension || m.output > maxModelDimension {
+		return modelData{}, fmt.Errorf("model file has implausible sizes %d/%d/%d", m.input, m.hidden, m.output)
+	}
+	body := data[modelHeaderSize:]
+	if len(body) != m.bodySize(precision) {
+		return modelData{}, fmt.Errorf("model file has %d bytes of weights, expected %d", len(body), m.bodySize(precision))
+	}
+	if crc32.Checksum(body, modelCRCTable) != binary.LittleEndian.Uint32(data[28:]) {
+		return modelData{}, errors.New("model file checksum mismatch")
+	}
+	if precision == PrecisionInt8 {
+		decodeInt8(body, &m)
+		return m, nil
+	}
+
+	alias := modelAliases(data)
+	off := 0
+	for k, n := range m.sizes() {
+		block := body[off : off+n*int(precision)]
+		off += len(block)
+		if n == 0 {
+			m.tensors[k] = []float64{}
+			continue
+		}
+
+		if alias {
+			m.tensors[k] = unsafe.Slice((*float64)(unsafe.Pointer(&block[0])), n)
+			continue
+		}
+		t := make([]float64, n)
+		for i := range t {
+			if precision == PrecisionFloat64 {
+				t[i] = math.Float64frombits(binary.LittleEndian.Uint64(block[i*8:]))
+			} else {
+				t[i] = float64(math.Float32frombits(binary.LittleEndian.Uint32(block[i*4:])))
+			}
+		}
+		m.tensors[k] = t
+	}
+	return m, nil
+}
+
+// modelAliases reports whether decodeModel uses data's weight blocks in
+// place: they hold float64s in native byte order at an aligned address
+func modelAliases(data []byte) bool {
+	x := uint16(1)
+	littleEndian := *(*byte)(unsafe.Pointer(&x)) == 1
+	body := unsafe.Pointer(unsafe.SliceData(data[modelHeaderSize:]))
+	return WeightPrecision(data[11]) == PrecisionFloat64 && littleEndian && uintptr(body)%8 == 0
+}
+
+// writeModelFile encodes m and writes it to filename
+func writeModelFile(filename string, m modelData, precision WeightPrecision) error {
+	data, err := encodeModel(m, precision)
+	if err != nil {
+		return err
+	}
+	return os.WriteFile(filename, data, 0644)
+}
+
+func (n *RPSPolicyNetwork) modelData() modelData {
+	return modelData{
+		kind:      policyModel,
+		input:     n.inputSize,
+		hidden:    n.hiddenSize,
+		output:    n.outputSize,
+		tensors:   [4][]float64{n.weightsInputHidden, n.biasesHidden, n.weightsHiddenOutput, n.biasesOutput},
+		quantized: n.quantized,
+	}
+}
+
+// setModelData adopts m's sizes, tensors and int8 weights
+func (n *RPSPolicyNetwork) setModelData(m modelData) {
+	n.inputSize, n.hiddenSize, n.outputSize = m.input, m.hidden, m.output
+	n.weightsInputHidden, n.biasesHidden = m.tensors[0], m.tensors[1]
+	n.weightsHiddenOutput, n.biasesOutput = m.tensors[2], m.tensors[3]
+	n.quantized = m.quantized
+	n.version.bump()
+}
+
+// SaveBinaryFile saves the network in the binary model format
+func (n *RPSPolicyNetwork) SaveBinaryFile(filename string, precision WeightPrecision) error {
+	return writeModelFile(filename, n.modelData(), precision)
+}
+
+// loadBinary loads a binary policy model, which must have the network's
+// input and output sizes. The weights may alias data.
+func (n *RPSPolicyNetwork) loadBinary(data []byte) error {
+	m, err := decodeModel(data, policyModel)
+	if err != nil {
+		return err
+	}
+	if m.input != n.inputSize || m.output != n.outputSize {
+		return errors.New("incompatible network structure")
+	}
+	n.setModelData(m)
+	return nil
+}
+
+func (n *RPSValueNetwork) modelData() modelData {
+	return modelData{
+		kind:      valueModel,
+		input:     n.inputSize,
+		hidden:    n.hiddenSize,
+		output:    n.outputSize,
+		tensors:   [4][]float64{n.weightsInputHidden, n.biasesHidden, n.weightsHiddenOutput, n.biasesOutput},
+		quantized: n.quantized,
+	}
+}
+
+// setModelData adopts m's sizes, tensors and int8 weights
+func (n *RPSValueNetwork) setModelData(m modelData) {
+	n.inputSize, n.hiddenSize, n.outputSize = m.input, m.hidden, m.output
+	n.weightsInputHidden, n.biasesHidden = m.tensors[0], m.tensors[1]
+	n.weightsHiddenOutput, n.biasesOutput = m.tensors[2], m.tensors[3]
+	n.quantized = m.quantized
+	n.version.bump()
+}
+
+// SaveBinaryFile saves the network in the binary model format
+func (n *RPSValueNetwork) SaveBinaryFile(filename string, precision WeightPrecision) error {
+	return writeModelFile(filename, n.modelData(), precision)
+}
+
+// loadBinary loads a binary value model, which must have the network's
+// input and output sizes. The weights may alias data.
+func (n *RPSValueNetwork) loadBinary(data []byte) error {
+	m, err := decodeModel(data, valueModel)
+	if err != nil {
+		return err
+	}
+	if m.input != n.inputSize || m.output != n.outputSize {
+		return errors.New("incompatible network structure")
+	}
+	n.setModelData(m)
+	return nil
+}
+
+// MapPolicyNetwork loads a policy network from a model file in either
+// format. A float64 binary file is memory-mapped copy-on-write and used as
+// the network's weights in place, so loading costs a checksum pass rather
+// than a decode; the mapping lasts for the life of the process. Training a
+// mapped network never writes to the file.
+func MapPolicyNetwork(filename string) (*RPSPolicyNetwork, error) {
+	n := &RPSPolicyNetwork{inputSize: 81, outputSize: 9, biasesOutput: make([]float64, 9)}
+	if err := loadMapped(filename, n.loadBinary, n.LoadFromFile); err != nil {
+		return nil, fmt.Errorf("failed to load policy network: %v", err)
+	}
+	return n, nil
+}
+
+// MapValueNetwork is MapPolicyNetwork for value networks
+func MapValueNetwork(filename string) (*RPSValueNetwork, error) {
+	n := &RPSValueNetwork{inputSize: 81, outputSize: 1}
+	if err := loadMapped(filename, n.loadBinary, n.LoadFromFile); err != nil {
+		return nil, fmt.Errorf("failed to load value network: %v", err)
+	}
+	return n, nil
+}
+
+// loadMapped maps filename and passes it to loadBinary, keeping the mapping
+// only if the network ended up aliasing it. The mapping is private, so
+// networks using it in place can still be trained without touching the file.
+// Files that aren't binary models go through load instead.
+func loadMapped(filename string, loadBinary func([]byte) error, load func(string) error) error {
+	data, unmap, err := mmapfile.Map(filename, true)
+	if err != nil || !IsBinaryModel(data) {
+		if unmap != nil {
+			unmap()
+		}
+		return load(filename)
+	}
+
+	if err := loadBinary(data); err != nil {
+		unmap()
+		return err
+	}
+	if !modelAliases(data) {
+		// The weights were decoded into fresh slices
+		unmap()
+	}
+	return nil
+}
+
+// ConvertModelFile rewrites a policy or value model file, in either format,
+// as a binary model file with the given precision, and returns which kind of
+// network it holds. dst may be src; it is replaced atomically.
+func ConvertModelFile(src, dst string, precision WeightPrecision) (string, error) {
+	raw, err := os.ReadFile(src)
+	if err != nil {
+		return "", err
+	}
+
+	var kind modelKind
+	if IsBinaryModel(raw) {
+		if len(raw) < modelHeaderSize {
+			return "", errors.New("truncated binary model file")
+		}
+		kind = modelKind(raw[10])
+	} else {
+		// Only policy files record an output size
+		var probe struct {
+			OutputSize *int `json:"outputSize"`
+		}
+		if err := json.Unmarshal(raw, &probe); err != nil {
+			return "", fmt.Errorf("not a binary or JSON model file: %v", err)
+		}
+		kind = valueModel
+		if probe.OutputSize != nil {
+			kind = policyModel
+		}
+	}
+
+	var m modelData
+	switch kind {
+	case policyModel:
+		n, err := MapPolicyNetwork(src)
+		if err != nil {
+			return "", err
+		}
+		m = n.modelData()
+	case valueModel:
+		n, err := MapValueNetwork(src)
+		if err != nil {
+			return "", err
+		}
+		m = n.modelData()
+	default:
+		return "", fmt.Errorf("unknown network kind %d", kind)
+	}
+
+	data, err := encodeModel(m, precision)
+	if err != nil {
+		return "", err
+	}
+	tmp := dst + ".tmp"
+	if err := os.WriteFile(tmp, data, 0644); err != nil {
+		return "", err
+	}
+	if err := os.Rename(tmp, dst); err != nil {
+		os.Remove(tmp)
+		return "", err
+	}
+	return kind.String(), nil
+}
@@ -0,0 +1,157 @@
+package neural
+
+import (
+	"bytes"
+	"math"
+	"os"
+	"path/filepath"
+	"testing"
+
+	"github.com/zachbeta/neural_rps/alphago_demo/pkg/game"
+)
+
+func TestBinaryModelRoundTrip(t *testing.T) {
+	dir := t.TempDir()
+	policy, value := NewRPSPolicyNetwork(24), NewRPSValueNetwork(24)
+	state := game.NewRPSGame(21, 5, 10)
+	wantProbs, wantValue := policy.Predict(state), value.Predict(state)
+
+	for _, precision := range []WeightPrecision{PrecisionFloat64, PrecisionFloat32} {
+		policyPath := filepath.Join(dir, precision.String()+"_policy.model")
+		valuePath := filepath.Join(dir, precision.String()+"_value.model")
+		if err := policy.SaveBinaryFile(policyPath, precision); err != nil {
+			t.Fatalf("%s: saving policy: %v", precision, err)
+		}
+		if err := value.SaveBinaryFile(valuePath, precision); err != nil {
+			t.Fatalf("%s: saving value: %v", precision, err)
+		}
+
+		// Float32 files round weights, so only float64 must be exact
+		tolerance := 0.0
+		if precision == PrecisionFloat32 {
+			tolerance = 1e-5
+		}
+
+		loadedPolicy := NewRPSPolicyNetwork(8)
+		if err := loadedPolicy.LoadFromFile(policyPath); err != nil {
+			t.Fatalf("%s: loading policy: %v", precision, err)
+		}
+		mappedPolicy, err := MapPolicyNetwork(policyPath)
+		if err != nil {
+			t.Fatalf("%s: mapping policy: %v", precision, err)
+		}
+		for _, n := range []*RPSPolicyNetwork{loadedPolicy, mappedPolicy} {
+			if n.GetHiddenSize() != 24 {
+				t.Fatalf("%s: loaded hidden size %d, expected 24", precision, n.GetHiddenSize())
+			}
+			for i, p := range n.Predict(state) {
+				if math.Abs(p-wantProbs[i]) > tolerance {
+					t.Fatalf("%s: loaded policy predicts %v, expected %v", precision, n.Predict(state), wantProbs)
+				}
+			}
+		}
+
+		loadedValue := NewRPSValueNetwork(8)
+		if err := loadedValue.LoadFromFile(valuePath); err != nil {
+			t.Fatalf("%s: loading value: %v", precision, err)
+		}
+		mappedValue, err := MapValueNetwork(valuePath)
+		if err != nil {
+			t.Fatalf("%s: mapping value: %v", precision, err)
+		}
+		for _, n := range []*RPSValueNetwork{loadedValue, mappedValue} {
+			if v := n.Predict(state); math.Abs(v-wantValue) > tolerance {
+				t.Fatalf("%s: loaded value predicts %f, expected %f", precision, v, wantValue)
+			}
+		}
+	}
+}
+
+func TestMappedModelTrainsWithoutWritingFile(t *testing.T) {
+	path := filepath.Join(t.TempDir(), "policy.model")
+	if err := NewRPSPolicyNetwork(16).SaveBinaryFile(path, PrecisionFloat64); err != nil {
+		t.Fatal(err)
+	}
+	before, _ := os.ReadFile(path)
+
+	mapped, err := MapPolicyNetwork(path)
+	if err != nil {
+		t.Fatal(err)
+	}
+	inputs, targets := [][]float64{make([]float64, 81)}, [][]float64{make([]float64, 9)}
+	inputs[0][3], targets[0][4] = 1, 1
+	mapped.Train(inputs, targets, 0.1)
+
+	if after, _ := os.ReadFile(path); !bytes.Equal(before, after) {
+		t.Error("Training a mapped network changed its file")
+	}
+}
+
+func TestBinaryModelRejectsBadFiles(t *testing.T) {
+	dir := t.TempDir()
+	path := filepath.Join(dir, "policy.model")
+	if err := NewRPSPolicyNetwork(16).SaveBinaryFile(path, PrecisionFloat64); err != nil {
+		t.Fatal(err)
+	}
+
+	if err := NewRPSValueNetwork(16).LoadFromFile(path); err == nil {
+		t.Error("Expected an error loading a policy file as a value network")
+	}
+
+	data, _ := os.ReadFile(path)
+	data[len(data)-1] ^= 0xff
+	corrupt := filepath.Join(dir, "corrupt.model")
+	os.WriteFile(corrupt, data, 0644)
+	if err := NewRPSPolicyNetwork(16).LoadFromFile(corrupt); err == nil {
+		t.Error("Expected a checksum error for a corrupted file")
+	}
+	if _, err := MapPolicyNetwork(corrupt); err == nil {
+		t.Error("Expected a checksum error mapping a corrupted file")
+	}
+}
+
+func TestMapLoadsJSONModels(t *testing.T) {
+	path := filepath.Join(t.TempDir(), "value.model")
+	value := NewRPSValueNetwork(12)
+	if err := value.SaveToFile(path); err != nil {
+		t.Fatal(err)
+	}
+
+	mapped, err := MapValueNetwork(path)
+	if err != nil {
+		t.Fatal(err)
+	}
+	state := game.NewRPSGame(21, 5, 10)
+	if got, want := mapped.Predict(state), value.Predict(state); math.Abs(got-want) > 1e-12 {
+		t.Errorf("JSON model mapped to value %f, expected %f", got, want)
+	}
+}
+
+func TestConvertModelFile(t *testing.T) {
+	dir := t.TempDir()
+	policy, value := NewRPSPolicyNetwork(10), NewRPSValueNetwork(10)
+	policyPath, valuePath := filepath.Join(dir, "a_policy.model"), filepath.Join(dir, "a_value.model")
+	policy.SaveToFile(policyPath)
+	value.SaveToFile(valuePath)
+
+	for path, want := range map[string]string{policyPath: "policy", valuePath: "value"} {
+		kind, err := ConvertModelFile(path, path, PrecisionFloat64)
+		if err != nil || kind != want {
+			t.Fatalf("Converting %s: got %q, %v; expected %q", path, kind, err, want)
+		}
+		if data, _ := os.ReadFile(path); !IsBinaryModel(data) {
+			t.Fatalf("%s was not rewritten in the binary format", path)
+		}
+	}
+
+	state := game.NewRPSGame(21, 5, 10)
+	converted := NewRPSPolicyNetwork(4)
+	if err := converted.LoadFromFile(policyPath); err != nil {
+		t.Fatal(err)
+	}
+	for i, p := range converted.Predict(state) {
+		if math.Abs(p-policy.Predict(state)[i]) > 1e-12 {
+			t.Fatalf("Converted policy predicts %v, expected %v", converted.Predict(state), policy.Predict(state))
+		}
+	}
+}
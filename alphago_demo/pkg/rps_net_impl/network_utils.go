@@ -30,11 +30,14 @@ func (n *RPSValueNetwork) Clone() *RPSValueNetwork {
 		inputSize:           n.inputSize,
 		hiddenSize:          n.hiddenSize,
 		outputSize:          n.outputSize,
-		weightsInputHidden:  CloneFloat64Matrix(n.weightsInputHidden),
+		weightsInputHidden:  CloneFloat64Slice(n.weightsInputHidden),
 		biasesHidden:        CloneFloat64Slice(n.biasesHidden),
-		weightsHiddenOutput: CloneFloat64Matrix(n.weightsHiddenOutput),
+		weightsHiddenOutput: CloneFloat64Slice(n.weightsHiddenOutput),
 		biasesOutput:        CloneFloat64Slice(n.biasesOutput),
+		quantized:           n.quantized,
 	}
+	// Same weights, so the clone can share the original's cache entries
+	clone.version.share(&n.version)
 
 	// Clone debug information if present
 	if n.DebugEpochCount != nil {
@@ -51,11 +54,14 @@ func (n *RPSPolicyNetwork) Clone() *RPSPolicyNetwork {
 		inputSize:           n.inputSize,
 		hiddenSize:          n.hiddenSize,
 		outputSize:          n.outputSize,
-		weightsInputHidden:  CloneFloat64Matrix(n.weightsInputHidden),
+		weightsInputHidden:  CloneFloat64Slice(n.weightsInputHidden),
 		biasesHidden:        CloneFloat64Slice(n.biasesHidden),
-		weightsHiddenOutput: CloneFloat64Matrix(n.weightsHiddenOutput),
+		weightsHiddenOutput: CloneFloat64Slice(n.weightsHiddenOutput),
 		biasesOutput:        CloneFloat64Slice(n.biasesOutput),
+		quantized:           n.quantized,
 	}
+	// Same weights, so the clone can share the original's cache entries
+	clone.version.share(&n.version)
 
 	// Clone debug information if present
 	if n.DebugEpochCount != nil {
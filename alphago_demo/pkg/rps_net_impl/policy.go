@@ -97,6 +97,54 @@ func (n *AGPolicyNetwork) PredictMove(gameState *game.AGGame) game.AGMove {
 	return bestMove
 }
 
+// PredictBatch returns Predict for each state. Each weight row is read once
+// for the whole batch rather than once per state, which is what makes
+// evaluating a search's leaves together cheaper than one at a time.
+func (n *AGPolicyNetwork) PredictBatch(states []*game.AGGame) [][]float64 {
+	hidden := agHiddenBatch(n.weightsInputHidden, n.biasesHidden, states)
+
+	output := make([]float64, len(states)*n.outputSize)
+	for i, row := range n.weightsHiddenOutput {
+		for s := range states {
+			h := hidden[s*n.hiddenSize : (s+1)*n.hiddenSize]
+			sum := n.biasesOutput[i]
+			for j, w := range row {
+				sum += w * h[j]
+			}
+			output[s*n.outputSize+i] = sum
+		}
+	}
+
+	probs := make([][]float64, len(states))
+	for s := range probs {
+		probs[s] = output[s*n.outputSize : (s+1)*n.outputSize : (s+1)*n.outputSize]
+		softmaxInPlace(probs[s])
+	}
+	return probs
+}
+
+// agHiddenBatch returns the ReLU hidden activations of every state, one
+// row of len(biases) per state
+func agHiddenBatch(weights [][]float64, biases []float64, states []*game.AGGame) []float64 {
+	inputs := make([][]float64, len(states))
+	for s, state := range states {
+		inputs[s] = state.GetBoardAsFeatures()
+	}
+
+	hiddenSize := len(biases)
+	hidden := make([]float64, len(states)*hiddenSize)
+	for i, row := range weights {
+		for s, input := range inputs {
+			sum := biases[i]
+			for j, w := range row {
+				sum += w * input[j]
+			}
+			hidden[s*hiddenSize+i] = relu(sum)
+		}
+	}
+	return hidden
+}
+
 // forward performs a forward pass through the network
 func (n *AGPolicyNetwork) forward(input []float64) []float64 {
 	// Hidden layer activation
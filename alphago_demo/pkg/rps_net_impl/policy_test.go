@@ -0,0 +1,37 @@
+package neural
+
+import (
+	"math"
+	"testing"
+
+	"github.com/zachbeta/neural_rps/alphago_demo/pkg/game"
+)
+
+func TestAGPredictBatch(t *testing.T) {
+	policy, value := NewAGPolicyNetwork(9, 16), NewAGValueNetwork(9, 16)
+
+	// A few positions along a game, ending with a finished one
+	var states []*game.AGGame
+	state := game.NewAGGame()
+	for !state.IsGameOver() {
+		states = append(states, state.Copy())
+		move, err := state.GetRandomMove()
+		if err != nil {
+			t.Fatal(err)
+		}
+		state.MakeMove(move)
+	}
+	states = append(states, state)
+
+	probs, values := policy.PredictBatch(states), value.PredictBatch(states)
+	for i, state := range states {
+		for j, p := range policy.Predict(state) {
+			if math.Abs(probs[i][j]-p) > 1e-12 {
+				t.Fatalf("Batched policy row %d is %v, expected %v", i, probs[i], policy.Predict(state))
+			}
+		}
+		if want := value.Predict(state); math.Abs(values[i]-want) > 1e-12 {
+			t.Errorf("Batched value %d is %f, expected %f", i, values[i], want)
+		}
+	}
+}
@@ -0,0 +1,316 @@
+package neural
+
+import (
+	"math"
+	"sync"
+)
+
+// int8Layer is a dense layer's weight matrix quantized to int8 with one
+// scale per row (output): weight i,j is approximately q[i*cols+j] *
+// scales[i]. A per-row scale keeps one large weight from costing every other
+// neuron its precision.
+//
+// Layers with many outputs are stored transposed instead (inputMajor, weight
+// i,j at q[j*rows+i]), so denseInt8 reads each input's weights for every
+// output contiguously.
+type int8Layer struct {
+	q          []int8
+	scales     []float64
+	rows, cols int
+	inputMajor bool
+}
+
+// inputMajorRows is the number of outputs from which a layer is stored
+// input-major; below it the per-input loop is too short to pay for itself
+const inputMajorRows = 16
+
+// quantizeLayer quantizes a row-major rows x cols weight matrix
+func quantizeLayer(weights []float64, rows, cols int) int8Layer {
+	l := newInt8Layer(rows, cols)
+	row := make([]int8, cols)
+	for i := 0; i < rows; i++ {
+		l.scales[i] = quantizeInto(weights[i*cols:(i+1)*cols], row)
+		for j, q := range row {
+			l.set(i, j, q)
+		}
+	}
+	return l
+}
+
+func newInt8Layer(rows, cols int) int8Layer {
+	return int8Layer{
+		q:          make([]int8, rows*cols),
+		scales:     make([]float64, rows),
+		rows:       rows,
+		cols:       cols,
+		inputMajor: rows >= inputMajorRows,
+	}
+}
+
+func (l int8Layer) index(i, j int) int {
+	if l.inputMajor {
+		return j*l.rows + i
+	}
+	return i*l.cols + j
+}
+
+// at returns quantized weight i,j
+func (l int8Layer) at(i, j int) int8 {
+	return l.q[l.index(i, j)]
+}
+
+func (l int8Layer) set(i, j int, q int8) {
+	l.q[l.index(i, j)] = q
+}
+
+// dequantize returns the float weights the layer computes with, row-major
+func (l int8Layer) dequantize() []float64 {
+	weights := make([]float64, len(l.q))
+	for i, scale := range l.scales {
+		for j := 0; j < l.cols; j++ {
+			weights[i*l.cols+j] = float64(l.at(i, j)) * scale
+		}
+	}
+	return weights
+}
+
+// quantizeInto writes x to q with one symmetric scale, chosen so the
+// largest magnitude maps to 127, and returns the scale
+func quantizeInto(x []float64, q []int8) float64 {
+	maxAbs := 0.0
+	for _, v := range x {
+		if a := math.Abs(v); a > maxAbs {
+			maxAbs = a
+		}
+	}
+	if maxAbs == 0 {
+		clear(q[:len(x)])
+		return 0
+	}
+
+	inv := 127 / maxAbs
+	for i, v := range x {
+		q[i] = roundInt8(v * inv)
+	}
+	return maxAbs / 127
+}
+
+// roundInt8 rounds v, which is within [-127, 127], half away from zero like
+// math.Round but without the call
+func roundInt8(v float64) int8 {
+	if v < 0 {
+		return int8(v - 0.5)
+	}
+	return int8(v + 0.5)
+}
+
+// quantizedWeights are the int8 layers of a quantized network. They are
+// never modified once built, so networks may share them.
+type quantizedWeights struct {
+	inputHidden  int8Layer // hiddenSize x inputSize
+	hiddenOutput int8Layer // outputSize x hiddenSize
+}
+
+func quantizeWeights(m modelData) *quantizedWeights {
+	return &quantizedWeights{
+		inputHidden:  quantizeLayer(m.tensors[0], m.hidden, m.input),
+		hiddenOutput: quantizeLayer(m.tensors[2], m.output, m.hidden),
+	}
+}
+
+// int8Activations is an activation vector quantized for denseInt8, kept as
+// its nonzero entries: the one-hot board features and ReLU outputs are
+// mostly zero, and zeros contribute nothing to the int32 sums
+type int8Activations struct {
+	index []int32
+	value []int32
+	acc   []int32 // Per-output sums
+}
+
+// set quantizes x with one symmetric scale and returns the scale
+func (a *int8Activations) set(x []float64) float64 {
+	maxAbs := 0.0
+	for _, v := range x {
+		if a := math.Abs(v); a > maxAbs {
+			maxAbs = a
+		}
+	}
+	a.index, a.value = a.index[:0], a.value[:0]
+	if maxAbs == 0 {
+		return 0
+	}
+
+	inv := 127 / maxAbs
+	for i, v := range x {
+		if v == 0 {
+			continue
+		}
+		if q := roundInt8(v * inv); q != 0 {
+			a.index = append(a.index, int32(i))
+			a.value = append(a.value, int32(q))
+		}
+	}
+	return maxAbs / 127
+}
+
+// forward runs input through both layers: hidden gets the ReLU activations
+// and out the output layer's values before softmax or sigmoid. Activations
+// are quantized per vector into buf, products accumulate in int32, and each
+// sum is dequantized with its row's scale before the bias is added.
+func (w *quantizedWeights) forward(input, hidden, out, biasesHidden, biasesOutput []float64, buf *int8Activations) {
+	denseInt8(w.inputHidden, biasesHidden, input, hidden, buf, true)
+	denseInt8(w.hiddenOutput, biasesOutput, hidden, out, buf, false)
+}
+
+// denseInt8 is dense (or denseReLU when activate is set) for an int8 layer.
+// Only nonzero activations are visited, so the work scales with the inputs
+// that are set rather than with all of them. Sums cannot overflow: even 2^16
+// inputs contribute less than 2^31.
+func denseInt8(l int8Layer, bias, input, out []float64, x *int8Activations, activate bool) {
+	inputScale := x.set(input)
+
+	if cap(x.acc) < l.rows {
+		x.acc = make([]int32, l.rows)
+	}
+	acc := x.acc[:l.rows]
+	value := x.value[:len(x.index)]
+	if l.inputMajor {
+		// Each nonzero activation adds its column of weights to the sums
+		clear(acc)
+		for k, j := range x.index {
+			v := value[k]
+			col := l.q[int(j)*l.rows : int(j)*l.rows+l.rows]
+			acc := acc[:len(col)]
+			i := 0
+			for ; i+4 <= len(col); i += 4 {
+				c4, a4 := col[i:i+4:i+4], acc[i:i+4:i+4]
+				a4[0] += int32(c4[0]) * v
+				a4[1] += int32(c4[1]) * v
+				a4[2] += int32(c4[2]) * v
+				a4[3] += int32(c4[3]) * v
+			}
+			for ; i < len(col); i++ {
+				acc[i] += int32(col[i]) * v
+			}
+		}
+	} else {
+		// Few outputs: gather each row's weights for the nonzero activations
+		for i := range acc {
+			row := l.q[i*l.cols : (i+1)*l.cols]
+			var s0, s1 int32
+			k := 0
+			for ; k+2 <= len(x.index); k += 2 {
+				s0 += int32(row[x.index[k]]) * value[k]
+				s1 += int32(row[x.index[k+1]]) * value[k+1]
+			}
+			if k < len(x.index) {
+				s0 += int32(row[x.index[k]]) * value[k]
+			}
+			acc[i] = s0 + s1
+		}
+	}
+
+	for i := range out {
+		v := bias[i] + float64(acc[i])*l.scales[i]*inputScale
+		if activate {
+			v = relu(v)
+		}
+		out[i] = v
+	}
+}
+
+// quantizedCache holds the copy built by a network's Quantized method and
+// the weights version it was built from
+type quantizedCache[N any] struct {
+	mu   sync.Mutex
+	from uint64
+	net  *N
+}
+
+// get returns the cached copy if it was built from version, building it
+// otherwise
+func (c *quantizedCache[N]) get(version uint64, build func() *N) *N {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	if c.net == nil || c.from != version {
+		c.net, c.from = build(), version
+	}
+	return c.net
+}
+
+// Quantized returns a copy of n that evaluates with int8 weights (see
+// quantizedWeights), for hosts where inference is bound by memory
+// bandwidth. Its float weights are the dequantized int8 weights, so saving,
+// cloning or training it stays consistent with what it predicts; training
+// requantizes. The copy is built once per version of n's weights, and n
+// itself is returned if it is already quantized.
+func (n *RPSPolicyNetwork) Quantized() *RPSPolicyNetwork {
+	if n.quantized != nil {
+		return n
+	}
+	return n.quantizedCopy.get(n.version.get(), func() *RPSPolicyNetwork {
+		q := &RPSPolicyNetwork{inputSize: n.inputSize, outputSize: n.outputSize}
+		q.setQuantized(n.modelData(), quantizeWeights(n.modelData()))
+		return q
+	})
+}
+
+// IsQuantized reports whether n evaluates with int8 weights
+func (n *RPSPolicyNetwork) IsQuantized() bool {
+	return n.quantized != nil
+}
+
+// setQuantized adopts m's sizes and biases with int8 weights w
+func (n *RPSPolicyNetwork) setQuantized(m modelData, w *quantizedWeights) {
+	m.tensors = [4][]float64{
+		w.inputHidden.dequantize(), CloneFloat64Slice(m.tensors[1]),
+		w.hiddenOutput.dequantize(), CloneFloat64Slice(m.tensors[3]),
+	}
+	m.quantized = w
+	n.setModelData(m)
+}
+
+// weightsChanged gives n a new version after its weights are updated in
+// place, requantizing a quantized network
+func (n *RPSPolicyNetwork) weightsChanged() {
+	if n.quantized != nil {
+		n.quantized = quantizeWeights(n.modelData())
+	}
+	n.version.bump()
+}
+
+// Quantized is RPSPolicyNetwork.Quantized for value networks
+func (n *RPSValueNetwork) Quantized() *RPSValueNetwork {
+	if n.quantized != nil {
+		return n
+	}
+	return n.quantizedCopy.get(n.version.get(), func() *RPSValueNetwork {
+		q := &RPSValueNetwork{inputSize: n.inputSize, outputSize: n.outputSize}
+		q.setQuantized(n.modelData(), quantizeWeights(n.modelData()))
+		return q
+	})
+}
+
+// IsQuantized reports whether n evaluates with int8 weights
+func (n *RPSValueNetwork) IsQuantized() bool {
+	return n.quantized != nil
+}
+
+// setQuantized adopts m's sizes and biases with int8 weights w
+func (n *RPSValueNetwork) setQuantized(m modelData, w *quantizedWeights) {
+	m.tensors = [4][]float64{
+		w.inputHidden.dequantize(), CloneFloat64Slice(m.tensors[1]),
+		w.hiddenOutput.dequantize(), CloneFloat64Slice(m.tensors[3]),
+	}
+	m.quantized = w
+	n.setModelData(m)
+}
+
+// weightsChanged gives n a new version after its weights are updated in
+// place, requantizing a quantized network
+func (n *RPSValueNetwork) weightsChanged() {
+	if n.quantized != nil {
+		n.quantized = quantizeWeights(n.modelData())
+	}
+	n.version.bump()
+}
@@ -0,0 +1,160 @@
+package neural
+
+import (
+	"math"
+	"path/filepath"
+	"testing"
+
+	"github.com/zachbeta/neural_rps/alphago_demo/pkg/game"
+)
+
+// quantizeTestStates returns positions from a few random games
+func quantizeTestStates() []*game.RPSGame {
+	var states []*game.RPSGame
+	for g := 0; g < 10; g++ {
+		state := game.NewRPSGame(21, 5, 10)
+		for !state.IsGameOver() {
+			states = append(states, state.Copy())
+			move, err := state.GetRandomMove()
+			if err != nil {
+				break
+			}
+			state.MakeMove(move)
+		}
+	}
+	return states
+}
+
+func TestQuantizedMatchesFloat(t *testing.T) {
+	policy, value := NewRPSPolicyNetwork(64), NewRPSValueNetwork(64)
+	qPolicy, qValue := policy.Quantized(), value.Quantized()
+	if !qPolicy.IsQuantized() || !qValue.IsQuantized() || policy.IsQuantized() {
+		t.Fatal("Expected only the copies to be quantized")
+	}
+	if policy.Quantized() != qPolicy || qPolicy.Quantized() != qPolicy {
+		t.Error("Expected Quantized to reuse the copy for unchanged weights")
+	}
+
+	for _, state := range quantizeTestStates() {
+		want, got := policy.Predict(state), qPolicy.Predict(state)
+		for i := range want {
+			if math.Abs(got[i]-want[i]) > 0.02 {
+				t.Fatalf("Quantized policy predicts %v, expected about %v", got, want)
+			}
+		}
+		if want, got := value.Predict(state), qValue.Predict(state); math.Abs(got-want) > 0.01 {
+			t.Fatalf("Quantized value predicts %f, expected about %f", got, want)
+		}
+	}
+}
+
+func TestQuantizedPredictBatch(t *testing.T) {
+	policy, value := NewRPSPolicyNetwork(32).Quantized(), NewRPSValueNetwork(32).Quantized()
+	states := quantizeTestStates()[:20]
+
+	var scratch BatchScratch
+	for i, probs := range policy.PredictBatch(states, &scratch) {
+		for j, p := range policy.Predict(states[i]) {
+			if probs[j] != p {
+				t.Fatalf("Batched quantized policy row %d is %v, expected %v", i, probs, policy.Predict(states[i]))
+			}
+		}
+	}
+	for i, v := range value.PredictBatch(states, &scratch) {
+		if want := value.Predict(states[i]); v != want {
+			t.Fatalf("Batched quantized value %d is %f, expected %f", i, v, want)
+		}
+	}
+}
+
+func TestQuantizedModelRoundTrip(t *testing.T) {
+	dir := t.TempDir()
+	policy, value := NewRPSPolicyNetwork(24), NewRPSValueNetwork(24)
+	policyPath, valuePath := filepath.Join(dir, "q_policy.model"), filepath.Join(dir, "q_value.model")
+	if err := policy.SaveBinaryFile(policyPath, PrecisionInt8); err != nil {
+		t.Fatal(err)
+	}
+	if err := value.SaveBinaryFile(valuePath, PrecisionInt8); err != nil {
+		t.Fatal(err)
+	}
+
+	loaded := NewRPSPolicyNetwork(8)
+	if err := loaded.LoadFromFile(policyPath); err != nil {
+		t.Fatal(err)
+	}
+	mapped, err := MapValueNetwork(valuePath)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if !loaded.IsQuantized() || !mapped.IsQuantized() {
+		t.Fatal("Expected int8 files to load as quantized networks")
+	}
+
+	// The file holds exactly what Quantized computes with
+	for _, state := range quantizeTestStates()[:20] {
+		want, got := policy.Quantized().Predict(state), loaded.Predict(state)
+		for i := range want {
+			if got[i] != want[i] {
+				t.Fatalf("Loaded int8 policy predicts %v, expected %v", got, want)
+			}
+		}
+		if want, got := value.Quantized().Predict(state), mapped.Predict(state); got != want {
+			t.Fatalf("Loaded int8 value predicts %f, expected %f", got, want)
+		}
+	}
+
+	// Converting back to float keeps the dequantized weights
+	if _, err := ConvertModelFile(policyPath, policyPath, PrecisionFloat64); err != nil {
+		t.Fatal(err)
+	}
+	float := NewRPSPolicyNetwork(8)
+	if err := float.LoadFromFile(policyPath); err != nil {
+		t.Fatal(err)
+	}
+	if float.IsQuantized() {
+		t.Error("Expected a float64 file to load as a float network")
+	}
+	for i, w := range float.GetWeights() {
+		if w != loaded.GetWeights()[i] {
+			t.Fatalf("Weight %d is %f after conversion, expected %f", i, w, loaded.GetWeights()[i])
+		}
+	}
+}
+
+func TestQuantizedRequantizesOnWeightChange(t *testing.T) {
+	policy := NewRPSPolicyNetwork(16)
+	before := policy.Quantized()
+	weights := policy.GetWeights()
+	for i := range weights {
+		weights[i] *= -1
+	}
+	policy.SetWeights(weights)
+	after := policy.Quantized()
+	if after == before {
+		t.Fatal("Expected new weights to build a new quantized copy")
+	}
+
+	// Updating a quantized network requantizes it
+	before.SetWeights(weights)
+	state := quantizeTestStates()[5]
+	want, got := after.Predict(state), before.Predict(state)
+	for i := range want {
+		if math.Abs(got[i]-want[i]) > 1e-9 {
+			t.Fatalf("Quantized network with new weights predicts %v, expected %v", got, want)
+		}
+	}
+}
+
+func TestQuantizedPredictAllocations(t *testing.T) {
+	policy := NewRPSPolicyNetwork(32).Quantized()
+	scratch := NewScratch(32)
+	state := game.NewRPSGame(21, 5, 10)
+	policy.PredictWithScratch(state, scratch)
+
+	allocs := testing.AllocsPerRun(100, func() {
+		policy.PredictWithScratch(state, scratch)
+	})
+	if allocs != 0 {
+		t.Errorf("Expected quantized PredictWithScratch to be allocation-free, got %.1f allocs/op", allocs)
+	}
+}
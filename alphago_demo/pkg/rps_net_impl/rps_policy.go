@@ -1,10 +1,12 @@
 package neural
 
 import (
+	"encoding/json"
 	"errors"
 	"fmt"
 	"math"
 	"math/rand"
+	"os"
 
 	"github.com/zachbeta/neural_rps/alphago_demo/pkg/game"
 )
@@ -16,12 +18,21 @@ type RPSPolicyNetwork struct {
 	hiddenSize int
 	outputSize int
 
-	// Weights and biases
-	weightsInputHidden  [][]float64
+	// Weights and biases. Weight matrices are stored row-major in one flat
+	// buffer per layer: row i holds the incoming weights of neuron i.
+	weightsInputHidden  []float64 // hiddenSize x inputSize
 	biasesHidden        []float64
-	weightsHiddenOutput [][]float64
+	weightsHiddenOutput []float64 // outputSize x hiddenSize
 	biasesOutput        []float64
 
+	// Identifies the current weights to EvalCache
+	version modelVersion
+
+	// Int8 weights, set for a quantized network, and the quantized copy of
+	// this one handed out by Quantized
+	quantized     *quantizedWeights
+	quantizedCopy quantizedCache[RPSPolicyNetwork]
+
 	// Debug information
 	DebugEpochCount []int
 }
@@ -38,9 +49,9 @@ func NewRPSPolicyNetwork(hiddenSize int) *RPSPolicyNetwork {
 		hiddenSize: hiddenSize,
 		outputSize: outputSize,
 
-		weightsInputHidden:  make([][]float64, hiddenSize),
+		weightsInputHidden:  make([]float64, hiddenSize*inputSize),
 		biasesHidden:        make([]float64, hiddenSize),
-		weightsHiddenOutput: make([][]float64, outputSize),
+		weightsHiddenOutput: make([]float64, outputSize*hiddenSize),
 		biasesOutput:        make([]float64, outputSize),
 	}
 
@@ -50,18 +61,16 @@ func NewRPSPolicyNetwork(hiddenSize int) *RPSPolicyNetwork {
 
 	// Initialize input->hidden weights and biases
 	for i := 0; i < hiddenSize; i++ {
-		network.weightsInputHidden[i] = make([]float64, inputSize)
 		for j := 0; j < inputSize; j++ {
-			network.weightsInputHidden[i][j] = (rand.Float64()*2 - 1) * xavierInput
+			network.weightsInputHidden[i*inputSize+j] = (rand.Float64()*2 - 1) * xavierInput
 		}
 		network.biasesHidden[i] = 0
 	}
 
 	// Initialize hidden->output weights and biases
 	for i := 0; i < outputSize; i++ {
-		network.weightsHiddenOutput[i] = make([]float64, hiddenSize)
 		for j := 0; j < hiddenSize; j++ {
-			network.weightsHiddenOutput[i][j] = (rand.Float64()*2 - 1) * xavierHidden
+			network.weightsHiddenOutput[i*hiddenSize+j] = (rand.Float64()*2 - 1) * xavierHidden
 		}
 		network.biasesOutput[i] = 0
 	}
@@ -69,13 +78,29 @@ func NewRPSPolicyNetwork(hiddenSize int) *RPSPolicyNetwork {
 	return network
 }
 
-// Predict returns the position probabilities for a given game state
+// Predict returns the position probabilities for a given game state.
+// The returned slice is owned by the caller.
 func (n *RPSPolicyNetwork) Predict(gameState *game.RPSGame) []float64 {
-	// Convert game state to input features
-	input := gameState.GetBoardAsFeatures()
+	return n.PredictInto(gameState, make([]float64, 0, n.outputSize))
+}
+
+// PredictInto appends the position probabilities for a given game state to
+// dst[:0] and returns the result. With GetOutputSize() elements of capacity
+// in dst it does not allocate.
+func (n *RPSPolicyNetwork) PredictInto(gameState *game.RPSGame, dst []float64) []float64 {
+	s := getScratch(n.inputSize, n.hiddenSize, n.outputSize)
+	dst = append(dst[:0], n.PredictWithScratch(gameState, s)...)
+	putScratch(s)
+	return dst
+}
 
-	// Forward pass through the network
-	return n.forward(input)
+// PredictWithScratch returns the position probabilities for a given game state
+// without allocating. The result aliases scratch.Output and is only valid until
+// the scratch is reused.
+func (n *RPSPolicyNetwork) PredictWithScratch(gameState *game.RPSGame, scratch *Scratch) []float64 {
+	scratch.ensure(n.inputSize, n.hiddenSize, n.outputSize)
+	gameState.FillBoardFeatures(scratch.Features)
+	return n.ForwardWithScratch(scratch.Features, scratch)
 }
 
 // PredictMove returns the best move according to the policy network
@@ -116,35 +141,42 @@ func (n *RPSPolicyNetwork) PredictMove(gameState *game.RPSGame) game.RPSMove {
 	return validMoves[0]
 }
 
-// forward performs a forward pass through the network
+// forward performs a forward pass through the network and returns a new slice
 func (n *RPSPolicyNetwork) forward(input []float64) []float64 {
-	// Hidden layer activation
-	hidden := make([]float64, n.hiddenSize)
-	for i := 0; i < n.hiddenSize; i++ {
-		sum := n.biasesHidden[i]
-		for j := 0; j < n.inputSize; j++ {
-			sum += n.weightsInputHidden[i][j] * input[j]
-		}
-		hidden[i] = relu(sum)
-	}
+	s := getScratch(n.inputSize, n.hiddenSize, n.outputSize)
+	probs := n.ForwardWithScratch(input, s)
 
-	// Output layer
-	output := make([]float64, n.outputSize)
-	for i := 0; i < n.outputSize; i++ {
-		sum := n.biasesOutput[i]
-		for j := 0; j < n.hiddenSize; j++ {
-			sum += n.weightsHiddenOutput[i][j] * hidden[j]
-		}
-		output[i] = sum
+	result := make([]float64, len(probs))
+	copy(result, probs)
+	putScratch(s)
+	return result
+}
+
+// ForwardWithScratch performs a forward pass using the caller's scratch buffers.
+// The result aliases scratch.Output.
+func (n *RPSPolicyNetwork) ForwardWithScratch(input []float64, scratch *Scratch) []float64 {
+	scratch.ensure(n.inputSize, n.hiddenSize, n.outputSize)
+
+	if n.quantized != nil {
+		n.quantized.forward(input[:n.inputSize], scratch.Hidden, scratch.Output, n.biasesHidden, n.biasesOutput, &scratch.quantized)
+	} else {
+		// Hidden layer activation
+		denseReLU(n.weightsInputHidden, n.biasesHidden, input[:n.inputSize], scratch.Hidden)
+
+		// Output layer
+		dense(n.weightsHiddenOutput, n.biasesOutput, scratch.Hidden, scratch.Output)
 	}
 
 	// Apply softmax to get probabilities
-	return softmax(output)
+	softmaxInPlace(scratch.Output)
+	return scratch.Output
 }
 
 // Train updates the network weights based on a batch of input features and target probabilities
 // Returns the average loss across the batch
 func (n *RPSPolicyNetwork) Train(inputFeatures [][]float64, targetProbs [][]float64, learningRate float64) float64 {
+	defer n.weightsChanged()
+
 	batchSize := len(inputFeatures)
 	if batchSize == 0 {
 		return 0
@@ -161,26 +193,31 @@ func (n *RPSPolicyNetwork) Train(inputFeatures [][]float64, targetProbs [][]floa
 	// Gradient clipping threshold
 	const gradientThreshold = 1.0
 
+	// Buffers reused by every example
+	hidden := make([]float64, n.hiddenSize)
+	logits := make([]float64, n.outputSize)
+	probs := make([]float64, n.outputSize)
+	outputGradients := make([]float64, n.outputSize)
+	hiddenGradients := make([]float64, n.hiddenSize)
+
 	for b := 0; b < batchSize; b++ {
 		input := inputFeatures[b]
 		target := targetProbs[b]
 
 		// Forward pass
-		hidden := make([]float64, n.hiddenSize)
 		for i := 0; i < n.hiddenSize; i++ {
 			sum := n.biasesHidden[i]
 			for j := 0; j < n.inputSize; j++ {
-				sum += n.weightsInputHidden[i][j] * input[j]
+				sum += n.weightsInputHidden[i*n.inputSize+j] * input[j]
 			}
 			hidden[i] = relu(sum)
 		}
 
 		// Output before softmax
-		logits := make([]float64, n.outputSize)
 		for i := 0; i < n.outputSize; i++ {
 			sum := n.biasesOutput[i]
 			for j := 0; j < n.hiddenSize; j++ {
-				sum += n.weightsHiddenOutput[i][j] * hidden[j]
+				sum += n.weightsHiddenOutput[i*n.hiddenSize+j] * hidden[j]
 			}
 			logits[i] = sum
 
@@ -191,7 +228,8 @@ func (n *RPSPolicyNetwork) Train(inputFeatures [][]float64, targetProbs [][]floa
 		}
 
 		// Apply softmax
-		probs := softmax(logits)
+		copy(probs, logits)
+		softmaxInPlace(probs)
 
 		// Check for NaN in probabilities which indicates unstable training
 		for i, p := range probs {
@@ -222,7 +260,6 @@ func (n *RPSPolicyNetwork) Train(inputFeatures [][]float64, targetProbs [][]floa
 
 		// Backward pass: calculate gradients
 		// Output layer gradients
-		outputGradients := make([]float64, n.outputSize)
 		for i := 0; i < n.outputSize; i++ {
 			outputGradients[i] = probs[i] - target[i]
 			// Apply gradient clipping to prevent explosion
@@ -235,16 +272,16 @@ func (n *RPSPolicyNetwork) Train(inputFeatures [][]float64, targetProbs [][]floa
 				update := learningRate * outputGradients[i] * hidden[j]
 				// Apply additional safety: clip the weight update
 				update = clipGradient(update, 0.1)
-				n.weightsHiddenOutput[i][j] -= update
+				n.weightsHiddenOutput[i*n.hiddenSize+j] -= update
 			}
 			n.biasesOutput[i] -= learningRate * outputGradients[i]
 		}
 
 		// Hidden layer gradients
-		hiddenGradients := make([]float64, n.hiddenSize)
+		clear(hiddenGradients)
 		for i := 0; i < n.hiddenSize; i++ {
 			for j := 0; j < n.outputSize; j++ {
-				hiddenGradients[i] += outputGradients[j] * n.weightsHiddenOutput[j][i]
+				hiddenGradients[i] += outputGradients[j] * n.weightsHiddenOutput[j*n.hiddenSize+i]
 			}
 			// Apply ReLU gradient
 			if hidden[i] <= 0 {
@@ -260,7 +297,7 @@ func (n *RPSPolicyNetwork) Train(inputFeatures [][]float64, targetProbs [][]floa
 				update := learningRate * hiddenGradients[i] * input[j]
 				// Apply additional safety: clip the weight update
 				update = clipGradient(update, 0.1)
-				n.weightsInputHidden[i][j] -= update
+				n.weightsInputHidden[i*n.inputSize+j] -= update
 			}
 			n.biasesHidden[i] -= learningRate * hiddenGradients[i]
 		}
@@ -276,9 +313,9 @@ func (n *RPSPolicyNetwork) SaveToFile(filename string) error {
 		"inputSize":           n.inputSize,
 		"hiddenSize":          n.hiddenSize,
 		"outputSize":          n.outputSize,
-		"weightsInputHidden":  n.weightsInputHidden,
+		"weightsInputHidden":  flatRows(n.weightsInputHidden, n.hiddenSize, n.inputSize),
 		"biasesHidden":        n.biasesHidden,
-		"weightsHiddenOutput": n.weightsHiddenOutput,
+		"weightsHiddenOutput": flatRows(n.weightsHiddenOutput, n.outputSize, n.hiddenSize),
 		"biasesOutput":        n.biasesOutput,
 	}
 
@@ -286,14 +323,24 @@ func (n *RPSPolicyNetwork) SaveToFile(filename string) error {
 	return saveToJSON(filename, data)
 }
 
-// LoadFromFile loads the network weights and biases from a file
+// LoadFromFile loads the network weights and biases from a file written by
+// SaveToFile or SaveBinaryFile
 func (n *RPSPolicyNetwork) LoadFromFile(filename string) error {
+	defer n.version.bump()
+
 	// Load data from file
-	var data map[string]interface{}
-	err := loadFromJSON(filename, &data)
+	raw, err := os.ReadFile(filename)
 	if err != nil {
 		return err
 	}
+	if IsBinaryModel(raw) {
+		return n.loadBinary(raw)
+	}
+	var data map[string]interface{}
+	if err := json.Unmarshal(raw, &data); err != nil {
+		return err
+	}
+	n.quantized = nil // JSON files hold float weights
 
 	// Extract structure and size information
 	inputSize, ok1 := data["inputSize"].(float64)
@@ -312,20 +359,15 @@ func (n *RPSPolicyNetwork) LoadFromFile(filename string) error {
 	// Resize network if hidden size differs
 	if int(hiddenSize) != n.hiddenSize {
 		n.hiddenSize = int(hiddenSize)
-		n.weightsInputHidden = make([][]float64, n.hiddenSize)
+		n.weightsInputHidden = make([]float64, n.hiddenSize*n.inputSize)
 		n.biasesHidden = make([]float64, n.hiddenSize)
-		for i := 0; i < n.hiddenSize; i++ {
-			n.weightsInputHidden[i] = make([]float64, n.inputSize)
-		}
-		for i := 0; i < n.outputSize; i++ {
-			n.weightsHiddenOutput[i] = make([]float64, n.hiddenSize)
-		}
+		n.weightsHiddenOutput = make([]float64, n.outputSize*n.hiddenSize)
 	}
 
 	// Load weights and biases
-	loadWeightsMatrix(data["weightsInputHidden"], &n.weightsInputHidden)
+	loadWeightsFlatMatrix(data["weightsInputHidden"], n.weightsInputHidden, n.hiddenSize, n.inputSize)
 	loadWeightsVector(data["biasesHidden"], &n.biasesHidden)
-	loadWeightsMatrix(data["weightsHiddenOutput"], &n.weightsHiddenOutput)
+	loadWeightsFlatMatrix(data["weightsHiddenOutput"], n.weightsHiddenOutput, n.outputSize, n.hiddenSize)
 	loadWeightsVector(data["biasesOutput"], &n.biasesOutput)
 
 	return nil
@@ -336,25 +378,16 @@ func (n *RPSPolicyNetwork) GetHiddenSize() int {
 	return n.hiddenSize
 }
 
+// GetOutputSize returns the number of probabilities Predict returns
+func (n *RPSPolicyNetwork) GetOutputSize() int {
+	return n.outputSize
+}
+
 // GetWeights returns flattened network weights (input->hidden, hidden->output)
 func (n *RPSPolicyNetwork) GetWeights() []float64 {
-	total := n.hiddenSize*n.inputSize + n.outputSize*n.hiddenSize
-	weights := make([]float64, total)
-	idx := 0
-	// input->hidden weights
-	for i := 0; i < n.hiddenSize; i++ {
-		for j := 0; j < n.inputSize; j++ {
-			weights[idx] = n.weightsInputHidden[i][j]
-			idx++
-		}
-	}
-	// hidden->output weights
-	for i := 0; i < n.outputSize; i++ {
-		for j := 0; j < n.hiddenSize; j++ {
-			weights[idx] = n.weightsHiddenOutput[i][j]
-			idx++
-		}
-	}
+	weights := make([]float64, 0, len(n.weightsInputHidden)+len(n.weightsHiddenOutput))
+	weights = append(weights, n.weightsInputHidden...)
+	weights = append(weights, n.weightsHiddenOutput...)
 	return weights
 }
 
@@ -364,20 +397,8 @@ func (n *RPSPolicyNetwork) SetWeights(weights []float64) error {
 	if len(weights) != expected {
 		return fmt.Errorf("policy weights length mismatch: expected %d, got %d", expected, len(weights))
 	}
-	idx := 0
-	// input->hidden
-	for i := 0; i < n.hiddenSize; i++ {
-		for j := 0; j < n.inputSize; j++ {
-			n.weightsInputHidden[i][j] = weights[idx]
-			idx++
-		}
-	}
-	// hidden->output
-	for i := 0; i < n.outputSize; i++ {
-		for j := 0; j < n.hiddenSize; j++ {
-			n.weightsHiddenOutput[i][j] = weights[idx]
-			idx++
-		}
-	}
+	split := copy(n.weightsInputHidden, weights)
+	copy(n.weightsHiddenOutput, weights[split:])
+	n.weightsChanged()
 	return nil
 }
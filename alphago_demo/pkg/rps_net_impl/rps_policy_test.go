@@ -25,9 +25,9 @@ func TestNewRPSPolicyNetwork(t *testing.T) {
 	}
 
 	// Check that weights and biases were properly initialized
-	if len(network.weightsInputHidden) != network.hiddenSize {
+	if len(network.weightsInputHidden) != network.hiddenSize*network.inputSize {
 		t.Errorf("Expected weightsInputHidden to have size %d, got %d",
-			network.hiddenSize, len(network.weightsInputHidden))
+			network.hiddenSize*network.inputSize, len(network.weightsInputHidden))
 	}
 
 	if len(network.biasesHidden) != network.hiddenSize {
@@ -35,9 +35,9 @@ func TestNewRPSPolicyNetwork(t *testing.T) {
 			network.hiddenSize, len(network.biasesHidden))
 	}
 
-	if len(network.weightsHiddenOutput) != network.outputSize {
+	if len(network.weightsHiddenOutput) != network.outputSize*network.hiddenSize {
 		t.Errorf("Expected weightsHiddenOutput to have size %d, got %d",
-			network.outputSize, len(network.weightsHiddenOutput))
+			network.outputSize*network.hiddenSize, len(network.weightsHiddenOutput))
 	}
 
 	if len(network.biasesOutput) != network.outputSize {
@@ -75,6 +75,29 @@ func TestRPSPolicyPredict(t *testing.T) {
 	}
 }
 
+func TestRPSPolicyPredictWithScratch(t *testing.T) {
+	network := NewRPSPolicyNetwork(32)
+	gameInstance := game.NewRPSGame(15, 5, 10)
+	scratch := NewScratch(network.GetHiddenSize())
+
+	// Scratch-based prediction must match the allocating path
+	expected := network.Predict(gameInstance)
+	probs := network.PredictWithScratch(gameInstance, scratch)
+	for i := range expected {
+		if math.Abs(expected[i]-probs[i]) > 1e-12 {
+			t.Errorf("Prediction mismatch at index %d: got %f, want %f", i, probs[i], expected[i])
+		}
+	}
+
+	// And must not allocate once the scratch is sized
+	allocs := testing.AllocsPerRun(100, func() {
+		network.PredictWithScratch(gameInstance, scratch)
+	})
+	if allocs != 0 {
+		t.Errorf("Expected PredictWithScratch to be allocation-free, got %.1f allocs/op", allocs)
+	}
+}
+
 func TestRPSPolicyPredictMove(t *testing.T) {
 	network := NewRPSPolicyNetwork(32)
 	gameInstance := game.NewRPSGame(15, 5, 10)
@@ -1,10 +1,12 @@
 package neural
 
 import (
+	"encoding/json"
 	"errors"
 	"fmt"
 	"math"
 	"math/rand"
+	"os"
 
 	"github.com/zachbeta/neural_rps/alphago_demo/pkg/game"
 )
@@ -16,12 +18,21 @@ type RPSValueNetwork struct {
 	hiddenSize int
 	outputSize int
 
-	// Weights and biases
-	weightsInputHidden  [][]float64
+	// Weights and biases. Weight matrices are stored row-major in one flat
+	// buffer per layer: row i holds the incoming weights of neuron i.
+	weightsInputHidden  []float64 // hiddenSize x inputSize
 	biasesHidden        []float64
-	weightsHiddenOutput [][]float64
+	weightsHiddenOutput []float64 // outputSize x hiddenSize
 	biasesOutput        []float64
 
+	// Identifies the current weights to EvalCache
+	version modelVersion
+
+	// Int8 weights, set for a quantized network, and the quantized copy of
+	// this one handed out by Quantized
+	quantized     *quantizedWeights
+	quantizedCopy quantizedCache[RPSValueNetwork]
+
 	// Debug information
 	DebugEpochCount []int
 }
@@ -37,9 +48,9 @@ func NewRPSValueNetwork(hiddenSize int) *RPSValueNetwork {
 		hiddenSize: hiddenSize,
 		outputSize: outputSize,
 
-		weightsInputHidden:  make([][]float64, hiddenSize),
+		weightsInputHidden:  make([]float64, hiddenSize*inputSize),
 		biasesHidden:        make([]float64, hiddenSize),
-		weightsHiddenOutput: make([][]float64, outputSize),
+		weightsHiddenOutput: make([]float64, outputSize*hiddenSize),
 		biasesOutput:        make([]float64, outputSize),
 	}
 
@@ -49,18 +60,16 @@ func NewRPSValueNetwork(hiddenSize int) *RPSValueNetwork {
 
 	// Initialize input->hidden weights and biases
 	for i := 0; i < hiddenSize; i++ {
-		network.weightsInputHidden[i] = make([]float64, inputSize)
 		for j := 0; j < inputSize; j++ {
-			network.weightsInputHidden[i][j] = (rand.Float64()*2 - 1) * xavierInput
+			network.weightsInputHidden[i*inputSize+j] = (rand.Float64()*2 - 1) * xavierInput
 		}
 		network.biasesHidden[i] = 0
 	}
 
 	// Initialize hidden->output weights and biases
 	for i := 0; i < outputSize; i++ {
-		network.weightsHiddenOutput[i] = make([]float64, hiddenSize)
 		for j := 0; j < hiddenSize; j++ {
-			network.weightsHiddenOutput[i][j] = (rand.Float64()*2 - 1) * xavierHidden
+			network.weightsHiddenOutput[i*hiddenSize+j] = (rand.Float64()*2 - 1) * xavierHidden
 		}
 		network.biasesOutput[i] = 0
 	}
@@ -70,30 +79,42 @@ func NewRPSValueNetwork(hiddenSize int) *RPSValueNetwork {
 
 // Predict returns the value (win probability) for a given game state
 func (n *RPSValueNetwork) Predict(gameState *game.RPSGame) float64 {
-	// Convert game state to input features
-	input := gameState.GetBoardAsFeatures()
+	s := getScratch(n.inputSize, n.hiddenSize, n.outputSize)
+	value := n.PredictWithScratch(gameState, s)
+	putScratch(s)
+	return value
+}
 
-	// Forward pass through the network
-	return n.forward(input)
+// PredictWithScratch returns the value for a given game state using the
+// caller's scratch buffers, without allocating
+func (n *RPSValueNetwork) PredictWithScratch(gameState *game.RPSGame, scratch *Scratch) float64 {
+	scratch.ensure(n.inputSize, n.hiddenSize, n.outputSize)
+	gameState.FillBoardFeatures(scratch.Features)
+	return n.ForwardWithScratch(scratch.Features, scratch)
 }
 
 // forward performs a forward pass through the network
 func (n *RPSValueNetwork) forward(input []float64) float64 {
-	// Hidden layer activation
-	hidden := make([]float64, n.hiddenSize)
-	for i := 0; i < n.hiddenSize; i++ {
-		sum := n.biasesHidden[i]
-		for j := 0; j < n.inputSize; j++ {
-			sum += n.weightsInputHidden[i][j] * input[j]
-		}
-		hidden[i] = relu(sum)
+	s := getScratch(n.inputSize, n.hiddenSize, n.outputSize)
+	value := n.ForwardWithScratch(input, s)
+	putScratch(s)
+	return value
+}
+
+// ForwardWithScratch performs a forward pass using the caller's scratch buffers
+func (n *RPSValueNetwork) ForwardWithScratch(input []float64, scratch *Scratch) float64 {
+	scratch.ensure(n.inputSize, n.hiddenSize, n.outputSize)
+
+	if n.quantized != nil {
+		n.quantized.forward(input[:n.inputSize], scratch.Hidden, scratch.Output[:1], n.biasesHidden, n.biasesOutput, &scratch.quantized)
+		return sigmoid(scratch.Output[0])
 	}
 
+	// Hidden layer activation
+	denseReLU(n.weightsInputHidden, n.biasesHidden, input[:n.inputSize], scratch.Hidden)
+
 	// Output layer
-	output := n.biasesOutput[0]
-	for i := 0; i < n.hiddenSize; i++ {
-		output += n.weightsHiddenOutput[0][i] * hidden[i]
-	}
+	output := n.biasesOutput[0] + dot(n.weightsHiddenOutput[:n.hiddenSize], scratch.Hidden)
 
 	// Apply sigmoid to get a value between 0 and 1
 	return sigmoid(output)
@@ -102,6 +123,8 @@ func (n *RPSValueNetwork) forward(input []float64) float64 {
 // Train updates the network weights based on a batch of input features and target values
 // Returns the average loss across the batch
 func (n *RPSValueNetwork) Train(inputFeatures [][]float64, targetValues []float64, learningRate float64) float64 {
+	defer n.weightsChanged()
+
 	batchSize := len(inputFeatures)
 	if batchSize == 0 {
 		return 0
@@ -118,16 +141,19 @@ func (n *RPSValueNetwork) Train(inputFeatures [][]float64, targetValues []float6
 	// Gradient clipping threshold
 	const gradientThreshold = 1.0
 
+	// Buffers reused by every example
+	hidden := make([]float64, n.hiddenSize)
+	hiddenGradients := make([]float64, n.hiddenSize)
+
 	for b := 0; b < batchSize; b++ {
 		input := inputFeatures[b]
 		target := targetValues[b]
 
 		// Forward pass
-		hidden := make([]float64, n.hiddenSize)
 		for i := 0; i < n.hiddenSize; i++ {
 			sum := n.biasesHidden[i]
 			for j := 0; j < n.inputSize; j++ {
-				sum += n.weightsInputHidden[i][j] * input[j]
+				sum += n.weightsInputHidden[i*n.inputSize+j] * input[j]
 			}
 			hidden[i] = relu(sum)
 		}
@@ -135,7 +161,7 @@ func (n *RPSValueNetwork) Train(inputFeatures [][]float64, targetValues []float6
 		// Output before sigmoid
 		logit := n.biasesOutput[0]
 		for i := 0; i < n.hiddenSize; i++ {
-			logit += n.weightsHiddenOutput[0][i] * hidden[i]
+			logit += n.weightsHiddenOutput[i] * hidden[i]
 		}
 
 		// Debug output for very large logits that might lead to sigmoid instability
@@ -177,14 +203,13 @@ func (n *RPSValueNetwork) Train(inputFeatures [][]float64, targetValues []float6
 			update := learningRate * outputGradient * hidden[i]
 			// Apply additional safety: clip the weight update
 			update = clipGradient(update, 0.1)
-			n.weightsHiddenOutput[0][i] -= update
+			n.weightsHiddenOutput[i] -= update
 		}
 		n.biasesOutput[0] -= learningRate * outputGradient
 
 		// Hidden layer gradients
-		hiddenGradients := make([]float64, n.hiddenSize)
 		for i := 0; i < n.hiddenSize; i++ {
-			hiddenGradients[i] = outputGradient * n.weightsHiddenOutput[0][i]
+			hiddenGradients[i] = outputGradient * n.weightsHiddenOutput[i]
 			// Apply ReLU gradient
 			if hidden[i] <= 0 {
 				hiddenGradients[i] = 0
@@ -199,7 +224,7 @@ func (n *RPSValueNetwork) Train(inputFeatures [][]float64, targetValues []float6
 				update := learningRate * hiddenGradients[i] * input[j]
 				// Apply additional safety: clip the weight update
 				update = clipGradient(update, 0.1)
-				n.weightsInputHidden[i][j] -= update
+				n.weightsInputHidden[i*n.inputSize+j] -= update
 			}
 			n.biasesHidden[i] -= learningRate * hiddenGradients[i]
 		}
@@ -214,9 +239,9 @@ func (n *RPSValueNetwork) SaveToFile(filename string) error {
 	data := map[string]interface{}{
 		"inputSize":           n.inputSize,
 		"hiddenSize":          n.hiddenSize,
-		"weightsInputHidden":  n.weightsInputHidden,
+		"weightsInputHidden":  flatRows(n.weightsInputHidden, n.hiddenSize, n.inputSize),
 		"biasesHidden":        n.biasesHidden,
-		"weightsHiddenOutput": n.weightsHiddenOutput,
+		"weightsHiddenOutput": flatRows(n.weightsHiddenOutput, n.outputSize, n.hiddenSize),
 		"biasOutput":          n.biasesOutput[0],
 	}
 
@@ -224,14 +249,24 @@ func (n *RPSValueNetwork) SaveToFile(filename string) error {
 	return saveToJSON(filename, data)
 }
 
-// LoadFromFile loads the network weights and biases from a file
+// LoadFromFile loads the network weights and biases from a file written by
+// SaveToFile or SaveBinaryFile
 func (n *RPSValueNetwork) LoadFromFile(filename string) error {
+	defer n.version.bump()
+
 	// Load data from file
-	var data map[string]interface{}
-	err := loadFromJSON(filename, &data)
+	raw, err := os.ReadFile(filename)
 	if err != nil {
 		return err
 	}
+	if IsBinaryModel(raw) {
+		return n.loadBinary(raw)
+	}
+	var data map[string]interface{}
+	if err := json.Unmarshal(raw, &data); err != nil {
+		return err
+	}
+	n.quantized = nil // JSON files hold float weights
 
 	// Extract structure and size information
 	inputSize, ok1 := data["inputSize"].(float64)
@@ -249,22 +284,16 @@ func (n *RPSValueNetwork) LoadFromFile(filename string) error {
 	// Resize network if hidden size differs
 	if int(hiddenSize) != n.hiddenSize {
 		n.hiddenSize = int(hiddenSize)
-		n.weightsInputHidden = make([][]float64, n.hiddenSize)
+		n.weightsInputHidden = make([]float64, n.hiddenSize*n.inputSize)
 		n.biasesHidden = make([]float64, n.hiddenSize)
-		for i := 0; i < n.hiddenSize; i++ {
-			n.weightsInputHidden[i] = make([]float64, n.inputSize)
-		}
-		n.weightsHiddenOutput = make([][]float64, n.outputSize)
-		for i := 0; i < n.outputSize; i++ {
-			n.weightsHiddenOutput[i] = make([]float64, n.hiddenSize)
-		}
+		n.weightsHiddenOutput = make([]float64, n.outputSize*n.hiddenSize)
 		n.biasesOutput = make([]float64, n.outputSize)
 	}
 
 	// Load weights and biases
-	loadWeightsMatrix(data["weightsInputHidden"], &n.weightsInputHidden)
+	loadWeightsFlatMatrix(data["weightsInputHidden"], n.weightsInputHidden, n.hiddenSize, n.inputSize)
 	loadWeightsVector(data["biasesHidden"], &n.biasesHidden)
-	loadWeightsMatrix(data["weightsHiddenOutput"], &n.weightsHiddenOutput)
+	loadWeightsFlatMatrix(data["weightsHiddenOutput"], n.weightsHiddenOutput, n.outputSize, n.hiddenSize)
 
 	// Load bias output (which is a single value)
 	if biasOutput, ok := data["biasOutput"].(float64); ok {
@@ -281,23 +310,9 @@ func (n *RPSValueNetwork) GetHiddenSize() int {
 
 // GetWeights returns flattened network weights (input->hidden, hidden->output)
 func (n *RPSValueNetwork) GetWeights() []float64 {
-	total := n.hiddenSize*n.inputSize + n.outputSize*n.hiddenSize
-	weights := make([]float64, total)
-	idx := 0
-	// input->hidden weights
-	for i := 0; i < n.hiddenSize; i++ {
-		for j := 0; j < n.inputSize; j++ {
-			weights[idx] = n.weightsInputHidden[i][j]
-			idx++
-		}
-	}
-	// hidden->output weights
-	for i := 0; i < n.outputSize; i++ {
-		for j := 0; j < n.hiddenSize; j++ {
-			weights[idx] = n.weightsHiddenOutput[i][j]
-			idx++
-		}
-	}
+	weights := make([]float64, 0, len(n.weightsInputHidden)+len(n.weightsHiddenOutput))
+	weights = append(weights, n.weightsInputHidden...)
+	weights = append(weights, n.weightsHiddenOutput...)
 	return weights
 }
 
@@ -307,20 +322,8 @@ func (n *RPSValueNetwork) SetWeights(weights []float64) error {
 	if len(weights) != expected {
 		return fmt.Errorf("value weights length mismatch: expected %d, got %d", expected, len(weights))
 	}
-	idx := 0
-	// input->hidden weights
-	for i := 0; i < n.hiddenSize; i++ {
-		for j := 0; j < n.inputSize; j++ {
-			n.weightsInputHidden[i][j] = weights[idx]
-			idx++
-		}
-	}
-	// hidden->output weights
-	for i := 0; i < n.outputSize; i++ {
-		for j := 0; j < n.hiddenSize; j++ {
-			n.weightsHiddenOutput[i][j] = weights[idx]
-			idx++
-		}
-	}
+	split := copy(n.weightsInputHidden, weights)
+	copy(n.weightsHiddenOutput, weights[split:])
+	n.weightsChanged()
 	return nil
 }
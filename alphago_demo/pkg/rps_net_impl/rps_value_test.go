@@ -26,16 +26,16 @@ func TestNewRPSValueNetwork(t *testing.T) {
 	}
 
 	// Check that weights and biases are initialized
-	if len(network.weightsInputHidden) != 64 {
-		t.Errorf("Expected 64 input-hidden weight vectors, got %d", len(network.weightsInputHidden))
+	if len(network.weightsInputHidden) != 64*81 {
+		t.Errorf("Expected %d input-hidden weights, got %d", 64*81, len(network.weightsInputHidden))
 	}
 
 	if len(network.biasesHidden) != 64 {
 		t.Errorf("Expected 64 hidden biases, got %d", len(network.biasesHidden))
 	}
 
-	if len(network.weightsHiddenOutput) != 1 {
-		t.Errorf("Expected 1 hidden-output weight vector, got %d", len(network.weightsHiddenOutput))
+	if len(network.weightsHiddenOutput) != 64 {
+		t.Errorf("Expected 64 hidden-output weights, got %d", len(network.weightsHiddenOutput))
 	}
 
 	if len(network.biasesOutput) != 1 {
@@ -54,6 +54,23 @@ func TestRPSValuePredict(t *testing.T) {
 	}
 }
 
+func TestRPSValuePredictAllocations(t *testing.T) {
+	network := NewRPSValueNetwork(64)
+	gameState := game.NewRPSGame(21, 5, 10)
+	scratch := NewScratch(network.GetHiddenSize())
+
+	if got, want := network.PredictWithScratch(gameState, scratch), network.Predict(gameState); math.Abs(got-want) > 1e-12 {
+		t.Errorf("PredictWithScratch = %f, Predict = %f", got, want)
+	}
+
+	allocs := testing.AllocsPerRun(100, func() {
+		network.PredictWithScratch(gameState, scratch)
+	})
+	if allocs != 0 {
+		t.Errorf("Expected PredictWithScratch to be allocation-free, got %.1f allocs/op", allocs)
+	}
+}
+
 func TestRPSValueTrain(t *testing.T) {
 	network := NewRPSValueNetwork(64)
 
@@ -0,0 +1,126 @@
+package neural
+
+import (
+	"math"
+	"sync"
+)
+
+// Scratch holds the intermediate buffers used by a forward pass so that
+// repeated inference does not allocate. A Scratch must not be shared between
+// goroutines; give each search worker its own.
+type Scratch struct {
+	Features []float64 // Encoded game state (81 features)
+	Hidden   []float64 // Hidden layer activations
+	Output   []float64 // Output layer values
+
+	quantized int8Activations // Activations quantized for int8 layers
+}
+
+// NewScratch creates scratch space large enough for a network with the given hidden size
+func NewScratch(hiddenSize int) *Scratch {
+	s := &Scratch{}
+	s.ensure(81, hiddenSize, 9)
+	return s
+}
+
+// ensure grows the scratch buffers to the requested sizes
+func (s *Scratch) ensure(inputSize, hiddenSize, outputSize int) {
+	if cap(s.Features) < inputSize {
+		s.Features = make([]float64, inputSize)
+	}
+	if cap(s.Hidden) < hiddenSize {
+		s.Hidden = make([]float64, hiddenSize)
+	}
+	if cap(s.Output) < outputSize {
+		s.Output = make([]float64, outputSize)
+	}
+	s.Features = s.Features[:inputSize]
+	s.Hidden = s.Hidden[:hiddenSize]
+	s.Output = s.Output[:outputSize]
+}
+
+// scratchPool hands out Scratch buffers to callers that don't manage their own
+var scratchPool = sync.Pool{
+	New: func() interface{} { return &Scratch{} },
+}
+
+func getScratch(inputSize, hiddenSize, outputSize int) *Scratch {
+	s := scratchPool.Get().(*Scratch)
+	s.ensure(inputSize, hiddenSize, outputSize)
+	return s
+}
+
+func putScratch(s *Scratch) {
+	scratchPool.Put(s)
+}
+
+// denseReLU computes out[i] = relu(bias[i] + dot(weights[i*len(input):], input))
+// for a row-major weight matrix with len(out) rows
+func denseReLU(weights, bias, input, out []float64) {
+	cols := len(input)
+	for i := range out {
+		row := weights[i*cols : i*cols+cols]
+		out[i] = relu(bias[i] + dot(row, input))
+	}
+}
+
+// dense computes out[i] = bias[i] + dot(weights[i*len(input):], input)
+// for a row-major weight matrix with len(out) rows
+func dense(weights, bias, input, out []float64) {
+	cols := len(input)
+	for i := range out {
+		row := weights[i*cols : i*cols+cols]
+		out[i] = bias[i] + dot(row, input)
+	}
+}
+
+// dot returns the dot product of two equal-length vectors. Four independent
+// accumulators break the add dependency chain so the loop is throughput- rather
+// than latency-bound; this module has no assembly, so it is the portable
+// stand-in for a vector kernel.
+func dot(a, b []float64) float64 {
+	b = b[:len(a)]
+	var s0, s1, s2, s3 float64
+	j := 0
+	for ; j+4 <= len(a); j += 4 {
+		a4, b4 := a[j:j+4:j+4], b[j:j+4:j+4]
+		s0 += a4[0] * b4[0]
+		s1 += a4[1] * b4[1]
+		s2 += a4[2] * b4[2]
+		s3 += a4[3] * b4[3]
+	}
+	for ; j < len(a); j++ {
+		s0 += a[j] * b[j]
+	}
+	return (s0 + s1) + (s2 + s3)
+}
+
+// softmaxInPlace applies softmax to values without allocating
+func softmaxInPlace(values []float64) {
+	max := values[0]
+	for _, v := range values {
+		if v > max {
+			max = v
+		}
+	}
+
+	expSum := 0.0
+	for i, v := range values {
+		exp := math.Exp(v - max)
+		values[i] = exp
+		expSum += exp
+	}
+
+	for i := range values {
+		values[i] /= expSum
+	}
+}
+
+// flatRows returns row views into a row-major matrix, used for the JSON model format
+func flatRows(flat []float64, rows, cols int) [][]float64 {
+	matrix := make([][]float64, rows)
+	for i := 0; i < rows; i++ {
+		matrix[i] = flat[i*cols : (i+1)*cols : (i+1)*cols]
+	}
+	return matrix
+}
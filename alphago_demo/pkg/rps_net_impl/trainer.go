@@ -0,0 +1,429 @@
+package neural
+
+import (
+	"fmt"
+	"math"
+	"runtime"
+	"strings"
+	"sync"
+)
+
+// Optimizer selects how a trainer turns a batch's averaged gradient into a
+// weight update
+type Optimizer int
+
+const (
+	// OptimizerSGD steps against the gradient
+	OptimizerSGD Optimizer = iota
+	// OptimizerMomentum steps along an exponentially decaying sum of gradients
+	OptimizerMomentum
+	// OptimizerAdam scales each weight's step by running gradient moments
+	OptimizerAdam
+)
+
+func (o Optimizer) String() string {
+	switch o {
+	case OptimizerSGD:
+		return "sgd"
+	case OptimizerMomentum:
+		return "momentum"
+	case OptimizerAdam:
+		return "adam"
+	}
+	return fmt.Sprintf("Optimizer(%d)", int(o))
+}
+
+// ParseOptimizer parses an optimizer name as printed by Optimizer.String
+func ParseOptimizer(name string) (Optimizer, error) {
+	for _, o := range []Optimizer{OptimizerSGD, OptimizerMomentum, OptimizerAdam} {
+		if strings.EqualFold(name, o.String()) {
+			return o, nil
+		}
+	}
+	return 0, fmt.Errorf("unknown optimizer %q (want sgd, momentum or adam)", name)
+}
+
+// TrainerConfig configures a PolicyTrainer or ValueTrainer
+type TrainerConfig struct {
+	Optimizer Optimizer
+	Momentum  float64 // Momentum coefficient; Adam's first moment decay
+	Beta2     float64 // Adam's second moment decay
+	Epsilon   float64 // Adam's denominator floor
+	Workers   int     // Goroutines sharing each batch's gradient computation (0 = GOMAXPROCS)
+}
+
+// DefaultTrainerConfig returns Adam with the usual moment decays
+func DefaultTrainerConfig() TrainerConfig {
+	return TrainerConfig{
+		Optimizer: OptimizerAdam,
+		Momentum:  0.9,
+		Beta2:     0.999,
+		Epsilon:   1e-8,
+		Workers:   0,
+	}
+}
+
+// Bounds carried over from the per-example Train methods
+const (
+	trainGradientThreshold = 1.0 // Per-example clip on output and hidden deltas
+	trainUpdateThreshold   = 0.1 // Clip on each weight's update
+)
+
+// minRowsPerWorker keeps small batches on fewer goroutines, where the
+// fan-out would cost more than the arithmetic it spreads
+const minRowsPerWorker = 16
+
+// layers is a view of a two-layer network's parameters. Slices alias the
+// network's own buffers.
+type layers struct {
+	inputSize, hiddenSize, outputSize int
+
+	weightsInputHidden  []float64 // hiddenSize x inputSize
+	biasesHidden        []float64
+	weightsHiddenOutput []float64 // outputSize x hiddenSize
+	biasesOutput        []float64
+}
+
+func (l *layers) tensors() [4][]float64 {
+	return [4][]float64{l.weightsInputHidden, l.biasesHidden, l.weightsHiddenOutput, l.biasesOutput}
+}
+
+// gradients holds one worker's gradient sums and the activations of the rows
+// it is working on
+type gradients struct {
+	tensors [4][]float64 // Same order as layers.tensors
+
+	hidden  []float64 // rows x hiddenSize activations
+	output  []float64 // rows x outputSize outputs, then deltas
+	dHidden []float64 // hiddenSize delta for the current row
+
+	loss float64
+	nan  bool
+}
+
+func (g *gradients) reset(l *layers, rows int) {
+	for k, t := range l.tensors() {
+		if len(g.tensors[k]) != len(t) {
+			g.tensors[k] = make([]float64, len(t))
+		} else {
+			clear(g.tensors[k])
+		}
+	}
+	if cap(g.hidden) < rows*l.hiddenSize {
+		g.hidden = make([]float64, rows*l.hiddenSize)
+	}
+	if cap(g.output) < rows*l.outputSize {
+		g.output = make([]float64, rows*l.outputSize)
+	}
+	if cap(g.dHidden) < l.hiddenSize {
+		g.dHidden = make([]float64, l.hiddenSize)
+	}
+	g.hidden = g.hidden[:rows*l.hiddenSize]
+	g.output = g.output[:rows*l.outputSize]
+	g.dHidden = g.dHidden[:l.hiddenSize]
+	g.loss, g.nan = 0, false
+}
+
+// outputDelta turns row's forward outputs into its loss gradient with
+// respect to the output layer's pre-activations, in place, and returns the
+// row's loss
+type outputDelta func(row int, output []float64) float64
+
+// trainer holds the optimizer state and per-worker buffers shared by
+// PolicyTrainer and ValueTrainer
+type trainer struct {
+	config  TrainerConfig
+	workers []*gradients
+	moment1 [4][]float64
+	moment2 [4][]float64
+	steps   int
+}
+
+func newTrainer(config TrainerConfig) trainer {
+	defaults := DefaultTrainerConfig()
+	if config.Momentum <= 0 || config.Momentum >= 1 {
+		config.Momentum = defaults.Momentum
+	}
+	if config.Beta2 <= 0 || config.Beta2 >= 1 {
+		config.Beta2 = defaults.Beta2
+	}
+	if config.Epsilon <= 0 {
+		config.Epsilon = defaults.Epsilon
+	}
+	return trainer{config: config}
+}
+
+// step computes the gradient of the mean loss over inputs, sharded across
+// workers, and applies one optimizer update. It returns the mean loss, and
+// leaves the weights untouched if any output was NaN.
+func (t *trainer) step(l *layers, inputs [][]float64, delta outputDelta, learningRate float64) (float64, bool) {
+	rows := len(inputs)
+
+	workers := t.config.Workers
+	if workers <= 0 {
+		workers = runtime.GOMAXPROCS(0)
+	}
+	workers = max(min(workers, rows/minRowsPerWorker), 1)
+	for len(t.workers) < workers {
+		t.workers = append(t.workers, &gradients{})
+	}
+
+	per := (rows + workers - 1) / workers
+	var wg sync.WaitGroup
+	for w := 0; w < workers; w++ {
+		start, end := w*per, min((w+1)*per, rows)
+		g := t.workers[w]
+		g.reset(l, end-start)
+		if start >= end {
+			continue
+		}
+		if w == workers-1 {
+			// The calling goroutine takes the last shard
+			accumulate(l, inputs, start, end, delta, g)
+			continue
+		}
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			accumulate(l, inputs, start, end, delta, g)
+		}()
+	}
+	wg.Wait()
+
+	// Reduce into the first worker's sums
+	total := t.workers[0]
+	for _, g := range t.workers[1:workers] {
+		total.loss += g.loss
+		total.nan = total.nan || g.nan
+		for k := range total.tensors {
+			axpy(1, g.tensors[k], total.tensors[k])
+		}
+	}
+	loss := total.loss / float64(rows)
+	if total.nan {
+		return loss, false
+	}
+
+	scale := 1.0 / float64(rows)
+	for k := range total.tensors {
+		for i := range total.tensors[k] {
+			total.tensors[k][i] *= scale
+		}
+	}
+	t.apply(l, &total.tensors, learningRate)
+	return loss, true
+}
+
+// accumulate runs the forward and backward passes for rows [start, end) of
+// inputs, adding their gradients to g. Each layer is handled for the whole
+// block of rows before moving on, so a layer's weights stay in cache while
+// they are reused.
+func accumulate(l *layers, inputs [][]float64, start, end int, delta outputDelta, g *gradients) {
+	in, hid, out := l.inputSize, l.hiddenSize, l.outputSize
+	dW1, dB1, dW2, dB2 := g.tensors[0], g.tensors[1], g.tensors[2], g.tensors[3]
+
+	// Forward: hidden = relu(X W1^T + b1), output = hidden W2^T + b2
+	for r := start; r < end; r++ {
+		row := r - start
+		denseReLU(l.weightsInputHidden, l.biasesHidden, inputs[r][:in], g.hidden[row*hid:(row+1)*hid])
+	}
+	for r := start; r < end; r++ {
+		row := r - start
+		dense(l.weightsHiddenOutput, l.biasesOutput, g.hidden[row*hid:(row+1)*hid], g.output[row*out:(row+1)*out])
+	}
+
+	// Output deltas
+	for r := start; r < end; r++ {
+		row := r - start
+		o := g.output[row*out : (row+1)*out]
+		loss := delta(r, o)
+		if CheckForNaN(loss) {
+			g.nan = true
+			return
+		}
+		g.loss += loss
+		for i := range o {
+			o[i] = clipGradient(o[i], trainGradientThreshold)
+		}
+	}
+
+	// Backward: dW2 += delta^T hidden, dHidden = delta W2 masked by relu,
+	// dW1 += dHidden^T X
+	for r := start; r < end; r++ {
+		row := r - start
+		h := g.hidden[row*hid : (row+1)*hid]
+		o := g.output[row*out : (row+1)*out]
+		for i, d := range o {
+			axpy(d, h, dW2[i*hid:(i+1)*hid])
+			dB2[i] += d
+		}
+
+		dh := g.dHidden
+		clear(dh)
+		for i, d := range o {
+			axpy(d, l.weightsHiddenOutput[i*hid:(i+1)*hid], dh)
+		}
+		x := inputs[r][:in]
+		for i, d := range dh {
+			// Inactive units pass no gradient, which skips most rows of dW1
+			if h[i] <= 0 || d == 0 {
+				continue
+			}
+			d = clipGradient(d, trainGradientThreshold)
+			axpy(d, x, dW1[i*in:(i+1)*in])
+			dB1[i] += d
+		}
+	}
+}
+
+// apply takes one optimizer step with the averaged gradient grads
+func (t *trainer) apply(l *layers, grads *[4][]float64, learningRate float64) {
+	params := l.tensors()
+	for k := range params {
+		if len(t.moment1[k]) != len(params[k]) {
+			// First step, or the network was resized by LoadFromFile
+			t.moment1[k] = make([]float64, len(params[k]))
+			t.moment2[k] = make([]float64, len(params[k]))
+			t.steps = 0
+		}
+	}
+	t.steps++
+
+	mu, beta2, eps := t.config.Momentum, t.config.Beta2, t.config.Epsilon
+	correction1 := 1 - math.Pow(mu, float64(t.steps))
+	correction2 := 1 - math.Pow(beta2, float64(t.steps))
+
+	for k, p := range params {
+		g, m, v := grads[k], t.moment1[k], t.moment2[k]
+		// Weight matrices are even and bias vectors odd in tensors()
+		isWeights := k%2 == 0
+
+		for i := range p {
+			var update float64
+			switch t.config.Optimizer {
+			case OptimizerMomentum:
+				m[i] = mu*m[i] + g[i]
+				update = learningRate * m[i]
+			case OptimizerAdam:
+				m[i] = mu*m[i] + (1-mu)*g[i]
+				v[i] = beta2*v[i] + (1-beta2)*g[i]*g[i]
+				update = learningRate * (m[i] / correction1) / (math.Sqrt(v[i]/correction2) + eps)
+			default:
+				update = learningRate * g[i]
+			}
+			if isWeights {
+				update = clipGradient(update, trainUpdateThreshold)
+			}
+			p[i] -= update
+		}
+	}
+}
+
+// axpy computes y += alpha * x
+func axpy(alpha float64, x, y []float64) {
+	y = y[:len(x)]
+	j := 0
+	for ; j+4 <= len(x); j += 4 {
+		x4, y4 := x[j:j+4:j+4], y[j:j+4:j+4]
+		y4[0] += alpha * x4[0]
+		y4[1] += alpha * x4[1]
+		y4[2] += alpha * x4[2]
+		y4[3] += alpha * x4[3]
+	}
+	for ; j < len(x); j++ {
+		y[j] += alpha * x[j]
+	}
+}
+
+// PolicyTrainer trains an RPSPolicyNetwork with one weight update per
+// mini-batch. Where RPSPolicyNetwork.Train updates after every example on a
+// single goroutine, a PolicyTrainer averages the batch's gradient, computed
+// in parallel shards, and feeds it to an optimizer. It keeps optimizer state
+// between batches, so use one trainer for the whole run.
+//
+// A PolicyTrainer is not safe for concurrent use, and the network must not
+// be trained by other means while it is in use.
+type PolicyTrainer struct {
+	network *RPSPolicyNetwork
+	trainer
+}
+
+// NewPolicyTrainer creates a mini-batch trainer for n
+func NewPolicyTrainer(n *RPSPolicyNetwork, config TrainerConfig) *PolicyTrainer {
+	return &PolicyTrainer{network: n, trainer: newTrainer(config)}
+}
+
+// Train takes one optimizer step on a batch of input features and target
+// probabilities, using softmax cross-entropy loss. It returns the batch's
+// average loss before the update.
+func (t *PolicyTrainer) Train(inputFeatures [][]float64, targetProbs [][]float64, learningRate float64) float64 {
+	n := t.network
+	if len(inputFeatures) == 0 {
+		return 0
+	}
+	defer n.weightsChanged()
+
+	l := &layers{
+		inputSize: n.inputSize, hiddenSize: n.hiddenSize, outputSize: n.outputSize,
+		weightsInputHidden: n.weightsInputHidden, biasesHidden: n.biasesHidden,
+		weightsHiddenOutput: n.weightsHiddenOutput, biasesOutput: n.biasesOutput,
+	}
+	loss, ok := t.step(l, inputFeatures, func(row int, output []float64) float64 {
+		softmaxInPlace(output)
+		target := targetProbs[row]
+		loss := 0.0
+		for i, p := range output {
+			if target[i] > 0 {
+				loss -= target[i] * math.Log(math.Max(p, 1e-15))
+			}
+			output[i] = p - target[i]
+		}
+		return loss
+	}, learningRate)
+
+	if !ok {
+		fmt.Println("ERROR: NaN detected in policy mini-batch; skipping update")
+		return 100.0
+	}
+	return loss
+}
+
+// ValueTrainer is the RPSValueNetwork counterpart of PolicyTrainer
+type ValueTrainer struct {
+	network *RPSValueNetwork
+	trainer
+}
+
+// NewValueTrainer creates a mini-batch trainer for n
+func NewValueTrainer(n *RPSValueNetwork, config TrainerConfig) *ValueTrainer {
+	return &ValueTrainer{network: n, trainer: newTrainer(config)}
+}
+
+// Train takes one optimizer step on a batch of input features and target
+// values, using mean squared error on the sigmoid output. It returns the
+// batch's average loss before the update.
+func (t *ValueTrainer) Train(inputFeatures [][]float64, targetValues []float64, learningRate float64) float64 {
+	n := t.network
+	if len(inputFeatures) == 0 {
+		return 0
+	}
+	defer n.weightsChanged()
+
+	l := &layers{
+		inputSize: n.inputSize, hiddenSize: n.hiddenSize, outputSize: n.outputSize,
+		weightsInputHidden: n.weightsInputHidden, biasesHidden: n.biasesHidden,
+		weightsHiddenOutput: n.weightsHiddenOutput, biasesOutput: n.biasesOutput,
+	}
+	loss, ok := t.step(l, inputFeatures, func(row int, output []float64) float64 {
+		prediction := sigmoid(output[0])
+		diff := prediction - targetValues[row]
+		output[0] = 2 * diff * prediction * (1 - prediction)
+		return diff * diff
+	}, learningRate)
+
+	if !ok {
+		fmt.Println("ERROR: NaN detected in value mini-batch; skipping update")
+		return 100.0
+	}
+	return loss
+}
@@ -0,0 +1,154 @@
+package neural
+
+import (
+	"math"
+	"math/rand"
+	"testing"
+)
+
+func trainerTestData(rng *rand.Rand, batchSize int) ([][]float64, [][]float64, []float64) {
+	inputs := make([][]float64, batchSize)
+	policies := make([][]float64, batchSize)
+	values := make([]float64, batchSize)
+	for i := range inputs {
+		inputs[i] = make([]float64, 81)
+		for j := range inputs[i] {
+			if rng.Float64() < 0.2 {
+				inputs[i][j] = 1
+			}
+		}
+		policies[i] = make([]float64, 9)
+		policies[i][rng.Intn(9)] = 1
+		values[i] = rng.Float64()
+	}
+	return inputs, policies, values
+}
+
+func policyLoss(n *RPSPolicyNetwork, inputs, targets [][]float64) float64 {
+	loss := 0.0
+	for b, input := range inputs {
+		probs := n.forward(input)
+		for i, p := range probs {
+			if targets[b][i] > 0 {
+				loss -= targets[b][i] * math.Log(math.Max(p, 1e-15))
+			}
+		}
+	}
+	return loss / float64(len(inputs))
+}
+
+func TestPolicyTrainerGradient(t *testing.T) {
+	rng := rand.New(rand.NewSource(1))
+	inputs, targets, _ := trainerTestData(rng, 8)
+	network := NewRPSPolicyNetwork(16)
+
+	// One SGD step moves each weight by -lr * dLoss/dw, so the step recovers
+	// the backward pass's gradient to compare against finite differences
+	const lr, h = 1e-6, 1e-5
+	trained := network.Clone()
+	NewPolicyTrainer(trained, TrainerConfig{Optimizer: OptimizerSGD, Workers: 1}).Train(inputs, targets, lr)
+
+	check := func(name string, before, after []float64, i int) {
+		t.Helper()
+		analytic := (before[i] - after[i]) / lr
+
+		probe := network.Clone()
+		params := map[string][]float64{
+			"weightsInputHidden":  probe.weightsInputHidden,
+			"weightsHiddenOutput": probe.weightsHiddenOutput,
+			"biasesOutput":        probe.biasesOutput,
+		}[name]
+		params[i] = before[i] + h
+		plus := policyLoss(probe, inputs, targets)
+		params[i] = before[i] - h
+		minus := policyLoss(probe, inputs, targets)
+		numeric := (plus - minus) / (2 * h)
+
+		if math.Abs(analytic-numeric) > 1e-4+1e-3*math.Abs(numeric) {
+			t.Errorf("%s[%d]: backprop gradient %g, numeric %g", name, i, analytic, numeric)
+		}
+	}
+	for i := 0; i < len(network.weightsInputHidden); i += 97 {
+		check("weightsInputHidden", network.weightsInputHidden, trained.weightsInputHidden, i)
+	}
+	for i := 0; i < len(network.weightsHiddenOutput); i += 7 {
+		check("weightsHiddenOutput", network.weightsHiddenOutput, trained.weightsHiddenOutput, i)
+	}
+	for i := range network.biasesOutput {
+		check("biasesOutput", network.biasesOutput, trained.biasesOutput, i)
+	}
+}
+
+func TestTrainerWorkersAgree(t *testing.T) {
+	rng := rand.New(rand.NewSource(2))
+	inputs, policies, values := trainerTestData(rng, 100)
+	policy := NewRPSPolicyNetwork(32)
+	value := NewRPSValueNetwork(32)
+
+	config := DefaultTrainerConfig()
+	config.Workers = 1
+	serialPolicy, serialValue := policy.Clone(), value.Clone()
+	serialPT, serialVT := NewPolicyTrainer(serialPolicy, config), NewValueTrainer(serialValue, config)
+	config.Workers = 4
+	parallelPolicy, parallelValue := policy.Clone(), value.Clone()
+	parallelPT, parallelVT := NewPolicyTrainer(parallelPolicy, config), NewValueTrainer(parallelValue, config)
+
+	for step := 0; step < 5; step++ {
+		sp, pp := serialPT.Train(inputs, policies, 0.01), parallelPT.Train(inputs, policies, 0.01)
+		sv, pv := serialVT.Train(inputs, values, 0.01), parallelVT.Train(inputs, values, 0.01)
+		if math.Abs(sp-pp) > 1e-9 || math.Abs(sv-pv) > 1e-9 {
+			t.Fatalf("step %d: serial losses %f/%f, parallel %f/%f", step, sp, sv, pp, pv)
+		}
+	}
+
+	for i, w := range serialPolicy.GetWeights() {
+		if got := parallelPolicy.GetWeights()[i]; math.Abs(got-w) > 1e-9 {
+			t.Fatalf("policy weight %d: serial %f, parallel %f", i, w, got)
+		}
+	}
+	for i, w := range serialValue.GetWeights() {
+		if got := parallelValue.GetWeights()[i]; math.Abs(got-w) > 1e-9 {
+			t.Fatalf("value weight %d: serial %f, parallel %f", i, w, got)
+		}
+	}
+}
+
+func TestTrainerOptimizersReduceLoss(t *testing.T) {
+	rng := rand.New(rand.NewSource(3))
+	inputs, policies, values := trainerTestData(rng, 64)
+
+	for _, optimizer := range []Optimizer{OptimizerSGD, OptimizerMomentum, OptimizerAdam} {
+		config := DefaultTrainerConfig()
+		config.Optimizer = optimizer
+		lr := 0.01
+		if optimizer == OptimizerSGD {
+			lr = 0.1
+		}
+
+		policy, value := NewRPSPolicyNetwork(32), NewRPSValueNetwork(32)
+		pt, vt := NewPolicyTrainer(policy, config), NewValueTrainer(value, config)
+		firstPolicy, firstValue := pt.Train(inputs, policies, lr), vt.Train(inputs, values, lr)
+		var lastPolicy, lastValue float64
+		for i := 0; i < 50; i++ {
+			lastPolicy, lastValue = pt.Train(inputs, policies, lr), vt.Train(inputs, values, lr)
+		}
+
+		if lastPolicy >= firstPolicy {
+			t.Errorf("%s: policy loss went from %f to %f", optimizer, firstPolicy, lastPolicy)
+		}
+		if lastValue >= firstValue {
+			t.Errorf("%s: value loss went from %f to %f", optimizer, firstValue, lastValue)
+		}
+	}
+}
+
+func TestParseOptimizer(t *testing.T) {
+	for _, optimizer := range []Optimizer{OptimizerSGD, OptimizerMomentum, OptimizerAdam} {
+		if got, err := ParseOptimizer(optimizer.String()); err != nil || got != optimizer {
+			t.Errorf("ParseOptimizer(%q) = %v, %v", optimizer, got, err)
+		}
+	}
+	if _, err := ParseOptimizer("rmsprop"); err == nil {
+		t.Error("Expected an error for an unknown optimizer")
+	}
+}
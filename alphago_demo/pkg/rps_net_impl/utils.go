@@ -21,28 +21,9 @@ func sigmoid(x float64) float64 {
 }
 
 func softmax(values []float64) []float64 {
-	// Find the maximum value to prevent overflow
-	max := values[0]
-	for _, v := range values {
-		if v > max {
-			max = v
-		}
-	}
-
-	// Apply exp and sum
-	expSum := 0.0
 	output := make([]float64, len(values))
-	for i, v := range values {
-		exp := math.Exp(v - max)
-		output[i] = exp
-		expSum += exp
-	}
-
-	// Normalize
-	for i := range output {
-		output[i] /= expSum
-	}
-
+	copy(output, values)
+	softmaxInPlace(output)
 	return output
 }
 
@@ -56,35 +37,23 @@ func saveToJSON(filename string, data interface{}) error {
 	return os.WriteFile(filename, jsonData, 0644)
 }
 
-func loadFromJSON(filename string, data interface{}) error {
-	jsonData, err := os.ReadFile(filename)
-	if err != nil {
-		return err
-	}
-
-	return json.Unmarshal(jsonData, data)
-}
-
-// Helper functions for loading weights from JSON data
-func loadWeightsMatrix(data interface{}, target *[][]float64) error {
+// loadWeightsFlatMatrix loads a JSON matrix into a row-major flat weight buffer
+func loadWeightsFlatMatrix(data interface{}, target []float64, rows, cols int) error {
 	if data == nil {
 		return errors.New("weights data is nil")
 	}
 
-	// Try to cast the data to a slice of slices
 	matrix, ok := data.([]interface{})
 	if !ok {
 		return errors.New("invalid matrix format")
 	}
 
-	// Ensure target matrix is initialized
-	if *target == nil || len(*target) == 0 {
+	if len(target) < rows*cols {
 		return errors.New("target matrix not initialized")
 	}
 
-	// Load matrix values
 	for i, row := range matrix {
-		if i >= len(*target) {
+		if i >= rows {
 			break
 		}
 
@@ -94,12 +63,12 @@ func loadWeightsMatrix(data interface{}, target *[][]float64) error {
 		}
 
 		for j, val := range rowData {
-			if j >= len((*target)[i]) {
+			if j >= cols {
 				break
 			}
 
 			if floatVal, ok := val.(float64); ok {
-				(*target)[i][j] = floatVal
+				target[i*cols+j] = floatVal
 			}
 		}
 	}
@@ -74,6 +74,26 @@ func (n *AGValueNetwork) Predict(gameState *game.AGGame) float64 {
 	return n.forward(input)
 }
 
+// PredictBatch returns Predict for each state, reading each weight row once
+// for the whole batch (see AGPolicyNetwork.PredictBatch)
+func (n *AGValueNetwork) PredictBatch(states []*game.AGGame) []float64 {
+	hidden := agHiddenBatch(n.weightsInputHidden, n.biasesHidden, states)
+
+	values := make([]float64, len(states))
+	for s, state := range states {
+		if state.IsGameOver() {
+			values[s] = n.Predict(state)
+			continue
+		}
+		sum := n.biasOutput
+		for i, w := range n.weightsHiddenOutput {
+			sum += w * hidden[s*n.hiddenSize+i]
+		}
+		values[s] = sigmoid(sum)
+	}
+	return values
+}
+
 // forward performs a forward pass through the network
 func (n *AGValueNetwork) forward(input []float64) float64 {
 	// Hidden layer activation
@@ -0,0 +1,299 @@
+// Package tournament schedules head-to-head games between agents on a pool
+// of workers. Games from many matchups are in flight at once, but results
+// are handed back in a fixed order, so ratings computed from them do not
+// depend on which worker finished first.
+package tournament
+
+import (
+	"runtime"
+	"sync"
+	"time"
+
+	"github.com/zachbeta/neural_rps/alphago_demo/pkg/game"
+)
+
+// Agent is a game-playing agent, as used by the tournament commands
+type Agent interface {
+	GetMove(state *game.RPSGame) (game.RPSMove, error)
+	Name() string
+}
+
+// Forker is implemented by agents that keep search state between moves,
+// such as an MCTS tree. Each worker plays with its own fork of such an
+// agent; agents that do not implement Forker are shared by all workers and
+// must be safe for concurrent use. Either way agents must be comparable,
+// which pointer types are.
+type Forker interface {
+	Fork() Agent
+}
+
+// Outcome is the result of one game
+type Outcome int
+
+const (
+	Draw Outcome = iota
+	FirstWins
+	SecondWins
+
+	// Unscored is returned by Play for a game that produced no result, such
+	// as one whose agent failed. It is applied like any other outcome: it
+	// takes its place in Matchup.Outcomes and is passed to OnResult, which
+	// should award no points for it, and it is counted in Stats.Games and
+	// Stats.Unscored.
+	Unscored
+)
+
+// Matchup is a series of games between two agents
+type Matchup struct {
+	First, Second Agent
+	Games         int
+	Data          interface{} // Caller's data, passed through to Play and the callbacks
+
+	ID       int       // Position in scheduling order, assigned by Run
+	Outcomes []Outcome // Filled in game order as results are applied
+
+	played   []Outcome // Results by game, including those ahead of their turn
+	received []bool
+	pending  int  // Games not yet returned by a worker
+	checked  bool // Keep has been consulted
+	dropped  bool
+	mu       sync.Mutex
+}
+
+func (m *Matchup) isDropped() bool {
+	m.mu.Lock()
+	defer m.mu.Unlock()
+	return m.dropped
+}
+
+// Config describes a tournament to Run. Next, Keep, OnResult and
+// OnMatchupDone are called from the goroutine running Run, so they may
+// update ratings and other state without locking; only Play runs on workers.
+type Config struct {
+	Workers   int // Game-playing goroutines (0 = GOMAXPROCS)
+	Lookahead int // Games queued ahead of the workers (0 = 4 per worker)
+
+	// Next returns the next matchup to schedule, with First, Second and Games
+	// set, or false when there are none left. It is called again after each
+	// matchup finishes, so it sees the effect of OnMatchupDone.
+	Next func() (*Matchup, bool)
+
+	// Play plays game g of m between first and second, which are the
+	// worker's own forks of m.First and m.Second. Called on worker goroutines.
+	Play func(m *Matchup, g int, first, second Agent) Outcome
+
+	// Keep, if set, is asked once per matchup, just before its results are
+	// applied, whether to keep it. Returning false discards the matchup and
+	// cancels its unplayed games, e.g. when one of its agents has been pruned
+	// by an earlier matchup's results.
+	Keep func(m *Matchup) bool
+
+	// OnResult receives each game's outcome, in matchup order and then game
+	// order regardless of which worker finished first
+	OnResult func(m *Matchup, g int, outcome Outcome)
+
+	// OnMatchupDone is called once every game of a kept matchup is applied
+	OnMatchupDone func(m *Matchup)
+}
+
+// Stats summarises a Run
+type Stats struct {
+	Games    int // Played and applied, including Unscored games
+	Unscored int // Games applied with the Unscored outcome
+	Matchups int // Completed
+	Dropped  int // Matchups discarded by Keep
+	Elapsed  time.Duration
+}
+
+type task struct {
+	m *Matchup
+	g int
+}
+
+type result struct {
+	m       *Matchup
+	g       int
+	outcome Outcome
+}
+
+// taskQueue is a FIFO that never blocks the producer, so Run can enqueue
+// games while workers wait on it to drain results
+type taskQueue struct {
+	mu     sync.Mutex
+	cond   *sync.Cond
+	tasks  []task
+	closed bool
+}
+
+func newTaskQueue() *taskQueue {
+	q := &taskQueue{}
+	q.cond = sync.NewCond(&q.mu)
+	return q
+}
+
+func (q *taskQueue) push(t task) {
+	q.mu.Lock()
+	q.tasks = append(q.tasks, t)
+	q.mu.Unlock()
+	q.cond.Signal()
+}
+
+func (q *taskQueue) pop() (task, bool) {
+	q.mu.Lock()
+	defer q.mu.Unlock()
+	for len(q.tasks) == 0 && !q.closed {
+		q.cond.Wait()
+	}
+	if len(q.tasks) == 0 {
+		return task{}, false
+	}
+	t := q.tasks[0]
+	q.tasks = q.tasks[1:]
+	return t, true
+}
+
+func (q *taskQueue) close() {
+	q.mu.Lock()
+	q.closed = true
+	q.mu.Unlock()
+	q.cond.Broadcast()
+}
+
+// Run plays matchups from config.Next until it has none left, and returns
+// once every result has been applied
+func Run(config Config) Stats {
+	start := time.Now()
+	workers := config.Workers
+	if workers <= 0 {
+		workers = runtime.GOMAXPROCS(0)
+	}
+	lookahead := config.Lookahead
+	if lookahead <= 0 {
+		lookahead = 4 * workers
+	}
+
+	queue := newTaskQueue()
+	// Run only ever blocks receiving, so the buffer is just slack that keeps
+	// workers busy while results are being applied
+	results := make(chan result, workers)
+
+	var wg sync.WaitGroup
+	for w := 0; w < workers; w++ {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			forks := make(map[Agent]Agent)
+			fork := func(a Agent) Agent {
+				if f, ok := forks[a]; ok {
+					return f
+				}
+				f := a
+				if forker, ok := a.(Forker); ok {
+					f = forker.Fork()
+				}
+				forks[a] = f
+				return f
+			}
+
+			for {
+				t, ok := queue.pop()
+				if !ok {
+					return
+				}
+				var outcome Outcome
+				if !t.m.isDropped() {
+					outcome = config.Play(t.m, t.g, fork(t.m.First), fork(t.m.Second))
+				}
+				results <- result{m: t.m, g: t.g, outcome: outcome}
+			}
+		}()
+	}
+
+	var (
+		stats     Stats
+		window    []*Matchup // Scheduled matchups, oldest first
+		pending   int        // Games queued or playing
+		exhausted bool
+		nextID    int
+	)
+	fill := func() {
+		for !exhausted && pending < lookahead {
+			m, ok := config.Next()
+			if !ok {
+				exhausted = true
+				return
+			}
+			if m.Games <= 0 {
+				continue
+			}
+			m.ID = nextID
+			nextID++
+			m.Outcomes = make([]Outcome, 0, m.Games)
+			m.played = make([]Outcome, m.Games)
+			m.received = make([]bool, m.Games)
+			m.pending = m.Games
+			window = append(window, m)
+			for g := 0; g < m.Games; g++ {
+				queue.push(task{m: m, g: g})
+			}
+			pending += m.Games
+		}
+	}
+
+	fill()
+	for len(window) > 0 {
+		r := <-results
+		pending--
+		r.m.pending--
+		r.m.received[r.g] = true
+		r.m.played[r.g] = r.outcome
+
+		// Apply everything that is now contiguous from the head of the window
+		for len(window) > 0 {
+			head := window[0]
+			if !head.checked {
+				head.checked = true
+				if config.Keep != nil && !config.Keep(head) {
+					head.mu.Lock()
+					head.dropped = true
+					head.mu.Unlock()
+				}
+			}
+
+			if head.dropped {
+				if head.pending > 0 {
+					break // Wait for its in-flight games before forgetting it
+				}
+				stats.Dropped++
+			} else {
+				for g := len(head.Outcomes); g < head.Games && head.received[g]; g++ {
+					head.Outcomes = append(head.Outcomes, head.played[g])
+					stats.Games++
+					if head.played[g] == Unscored {
+						stats.Unscored++
+					}
+					if config.OnResult != nil {
+						config.OnResult(head, g, head.played[g])
+					}
+				}
+				if len(head.Outcomes) < head.Games {
+					break
+				}
+				stats.Matchups++
+				if config.OnMatchupDone != nil {
+					config.OnMatchupDone(head)
+				}
+			}
+
+			window[0] = nil
+			window = window[1:]
+			fill()
+		}
+		fill()
+	}
+
+	queue.close()
+	wg.Wait()
+	stats.Elapsed = time.Since(start)
+	return stats
+}
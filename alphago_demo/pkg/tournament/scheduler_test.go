@@ -0,0 +1,182 @@
+package tournament
+
+import (
+	"fmt"
+	"math/rand"
+	"sync"
+	"sync/atomic"
+	"testing"
+	"time"
+
+	"github.com/zachbeta/neural_rps/alphago_demo/pkg/game"
+)
+
+type testAgent struct {
+	name   string
+	forks  *atomic.Int32
+	parent *testAgent
+}
+
+func (a *testAgent) GetMove(state *game.RPSGame) (game.RPSMove, error) {
+	return game.RPSMove{}, nil
+}
+
+func (a *testAgent) Name() string { return a.name }
+
+func (a *testAgent) Fork() Agent {
+	a.forks.Add(1)
+	return &testAgent{name: a.name, forks: a.forks, parent: a}
+}
+
+func newTestAgents(n int) []*testAgent {
+	agents := make([]*testAgent, n)
+	for i := range agents {
+		agents[i] = &testAgent{name: fmt.Sprintf("agent%d", i), forks: &atomic.Int32{}}
+	}
+	return agents
+}
+
+// roundRobin returns a Next over every pair, skipping agents in pruned
+func roundRobin(agents []*testAgent, games int, pruned map[string]bool) func() (*Matchup, bool) {
+	i, j := 0, 0
+	return func() (*Matchup, bool) {
+		for {
+			j++
+			if j >= len(agents) {
+				i++
+				j = i + 1
+			}
+			if j >= len(agents) {
+				return nil, false
+			}
+			if !pruned[agents[i].name] && !pruned[agents[j].name] {
+				return &Matchup{First: agents[i], Second: agents[j], Games: games}, true
+			}
+		}
+	}
+}
+
+// outcomeFor is a deterministic result that does not depend on timing
+func outcomeFor(m *Matchup, g int) Outcome {
+	return Outcome((len(m.First.Name())*7 + len(m.Second.Name()) + m.ID*3 + g) % 3)
+}
+
+func TestRunAppliesResultsInOrder(t *testing.T) {
+	agents := newTestAgents(6)
+
+	run := func(workers int) []string {
+		var applied []string
+		var mu sync.Mutex
+		inPlay := map[*testAgent]bool{}
+		Run(Config{
+			Workers: workers,
+			Next:    roundRobin(agents, 5, nil),
+			Play: func(m *Matchup, g int, first, second Agent) Outcome {
+				f, s := first.(*testAgent), second.(*testAgent)
+				if f.parent != m.First || s.parent != m.Second {
+					t.Errorf("Expected the worker's forks of %s and %s", m.First.Name(), m.Second.Name())
+				}
+				mu.Lock()
+				if inPlay[f] || inPlay[s] {
+					t.Errorf("Fork used by two games at once")
+				}
+				inPlay[f], inPlay[s] = true, true
+				mu.Unlock()
+
+				time.Sleep(time.Duration(rand.Intn(200)) * time.Microsecond)
+
+				mu.Lock()
+				inPlay[f], inPlay[s] = false, false
+				mu.Unlock()
+				return outcomeFor(m, g)
+			},
+			OnResult: func(m *Matchup, g int, outcome Outcome) {
+				applied = append(applied, fmt.Sprintf("%d/%d:%d", m.ID, g, outcome))
+			},
+		})
+		return applied
+	}
+
+	serial, parallel := run(1), run(8)
+	if len(serial) != 15*5 {
+		t.Fatalf("Expected 75 results, got %d", len(serial))
+	}
+	for i := range serial {
+		if serial[i] != parallel[i] {
+			t.Fatalf("Result %d applied as %s with 8 workers, %s with 1", i, parallel[i], serial[i])
+		}
+	}
+
+	for _, a := range agents {
+		if n := a.forks.Load(); n > 1+8 {
+			t.Errorf("%s forked %d times; expected at most one fork per worker per run", a.name, n)
+		}
+	}
+}
+
+func TestRunPrunesWithinRound(t *testing.T) {
+	agents := newTestAgents(5)
+	pruned := map[string]bool{}
+
+	stats := Run(Config{
+		Workers:   4,
+		Lookahead: 64, // Schedule far ahead so pruning has to cancel queued matchups
+		Next:      roundRobin(agents, 3, pruned),
+		Play: func(m *Matchup, g int, first, second Agent) Outcome {
+			return FirstWins
+		},
+		Keep: func(m *Matchup) bool {
+			return !pruned[m.First.Name()] && !pruned[m.Second.Name()]
+		},
+		OnResult: func(m *Matchup, g int, outcome Outcome) {
+			if pruned[m.First.Name()] || pruned[m.Second.Name()] {
+				t.Errorf("Applied a result for pruned agents in matchup %d", m.ID)
+			}
+		},
+		OnMatchupDone: func(m *Matchup) {
+			// agent0 beats everyone; prune the first agent it beats
+			if m.ID == 0 {
+				pruned[m.Second.Name()] = true
+			}
+		},
+	})
+
+	// agent1 is pruned after its first matchup: its other 3 matchups drop
+	if stats.Matchups != 10-3 || stats.Dropped != 3 {
+		t.Errorf("Expected 7 matchups and 3 dropped, got %d and %d", stats.Matchups, stats.Dropped)
+	}
+	if stats.Games != 7*3 {
+		t.Errorf("Expected 21 games applied, got %d", stats.Games)
+	}
+}
+
+func TestRunUnscoredGames(t *testing.T) {
+	agents := newTestAgents(3)
+	var unscored int
+	stats := Run(Config{
+		Workers: 4,
+		Next:    roundRobin(agents, 4, nil),
+		Play: func(m *Matchup, g int, first, second Agent) Outcome {
+			if g%2 == 1 {
+				return Unscored
+			}
+			return FirstWins
+		},
+		OnResult: func(m *Matchup, g int, outcome Outcome) {
+			if outcome == Unscored {
+				unscored++
+			}
+		},
+		OnMatchupDone: func(m *Matchup) {
+			for g, outcome := range m.Outcomes {
+				if (outcome == Unscored) != (g%2 == 1) {
+					t.Errorf("Matchup %d game %d has outcome %d", m.ID, g, outcome)
+				}
+			}
+		},
+	})
+
+	if stats.Games != 12 || stats.Unscored != 6 || unscored != 6 {
+		t.Errorf("Expected 12 games applied with 6 unscored, got %+v and %d passed to OnResult", stats, unscored)
+	}
+}
@@ -76,83 +76,24 @@ func randomSubset(exclude, n, max int) []int {
 	return indices[:n]
 }
 
-// runGames runs 'games' matches between evalGenome and opponent, returns (wins, draws) for evalGenome.
-func runGames(evalGenome, opponent *Genome, games int) (wins int, draws int) {
-	params := training.DefaultRPSSelfPlayParams()
-	deckSize, handSize, maxRounds := params.DeckSize, params.HandSize, params.MaxRounds
-	mctsParams := params.MCTSParams
-
-	// Build networks for each genome
-	p1Pol, p1Val := evalGenome.ToNetworks()
-	p2Pol, p2Val := opponent.ToNetworks()
-
-	for i := 0; i < games; i++ {
-		// Alternate who is player 1/2
-		var (
-			player1Pol  *neural.RPSPolicyNetwork
-			player1Val  *neural.RPSValueNetwork
-			player2Pol  *neural.RPSPolicyNetwork
-			player2Val  *neural.RPSValueNetwork
-			isEvalFirst bool
-		)
-		if i%2 == 0 {
-			player1Pol, player1Val = p1Pol, p1Val
-			player2Pol, player2Val = p2Pol, p2Val
-			isEvalFirst = true
-		} else {
-			player1Pol, player1Val = p2Pol, p2Val
-			player2Pol, player2Val = p1Pol, p1Val
-			isEvalFirst = false
-		}
-
-		gme := game.NewRPSGame(deckSize, handSize, maxRounds)
-		e1 := mcts.NewRPSMCTS(player1Pol, player1Val, mctsParams)
-		e2 := mcts.NewRPSMCTS(player2Pol, player2Val, mctsParams)
-
-		for !gme.IsGameOver() {
-			if gme.CurrentPlayer == game.Player1 {
-				e1.SetRootState(gme)
-				if node := e1.Search(); node != nil && node.Move != nil {
-					gme.MakeMove(*node.Move)
-				}
-			} else {
-				e2.SetRootState(gme)
-				if node := e2.Search(); node != nil && node.Move != nil {
-					gme.MakeMove(*node.Move)
-				}
-			}
-		}
-
-		winner := gme.GetWinner()
-		if winner == game.NoPlayer {
-			draws++
-		} else if (winner == game.Player1 && isEvalFirst) || (winner == game.Player2 && !isEvalFirst) {
-			wins++
-		}
-	}
-	return wins, draws
-}
-
 // parallelEvaluate evaluates all genomes in pop against round robin and HOF opponents in parallel.
 func parallelEvaluate(pop *Population, hof []*Genome) []*GenomeResult {
 	startTime := time.Now()
 	matches := prepareMatches(pop, hof)
 	matchCount := len(matches)
-	fmt.Printf("Evaluating %d genomes with %d total matches (%d workers)...\n",
-		len(pop.Genomes), matchCount, runtime.NumCPU()-1)
+	numWorkers := workerCount()
+	fmt.Printf("Evaluating %d genomes with %d total matches (%d workers, %d games each in lockstep)...\n",
+		len(pop.Genomes), matchCount, numWorkers, lockstepGames)
 
 	results := make([]*GenomeResult, len(pop.Genomes))
 	for i := range results {
 		results[i] = &GenomeResult{}
 	}
 
-	numWorkers := runtime.NumCPU() - 1
-	if numWorkers < 1 {
-		numWorkers = 1
-	}
-
-	workCh := make(chan Match, len(matches))
-	var wg sync.WaitGroup
+	// Networks are built once per genome for the generation, so a genome's
+	// cached evaluations are shared by all of its matches
+	cache := neural.NewEvalCache(neural.DefaultEvalCacheEntries)
+	evaluator := newLockstepEvaluator(pop, hof, matches, results, cache, numWorkers)
 
 	// Progress tracking
 	completedMatches := int32(0)
@@ -193,29 +134,8 @@ func parallelEvaluate(pop *Population, hof []*Genome) []*GenomeResult {
 		}
 	}()
 
-	for i := 0; i < numWorkers; i++ {
-		wg.Add(1)
-		go func(workerId int) {
-			defer wg.Done()
-			for match := range workCh {
-				wins, draws := runGames(pop.Genomes[match.GenomeIdx], match.Opponent, match.Games)
-				atomic.AddInt32(&results[match.GenomeIdx].Wins, int32(wins))
-				atomic.AddInt32(&results[match.GenomeIdx].Draws, int32(draws))
-				atomic.AddInt32(&results[match.GenomeIdx].Games, int32(match.Games))
-
-				// Update progress counter
-				atomic.AddInt32(&completedMatches, 1)
-
-				// We've removed the detailed worker logs here to reduce console noise
-			}
-		}(i)
-	}
-
-	for _, m := range matches {
-		workCh <- m
-	}
-	close(workCh)
-	wg.Wait()
+	evaluator.onMatchEnd = func() { atomic.AddInt32(&completedMatches, 1) }
+	evaluator.run(numWorkers)
 
 	// Stop progress reporting
 	done <- true
@@ -223,8 +143,9 @@ func parallelEvaluate(pop *Population, hof []*Genome) []*GenomeResult {
 
 	// Print summary
 	duration := time.Since(startTime)
-	fmt.Printf("Evaluation complete - took %s (%.1f matches/sec)\n",
-		duration.Round(time.Second), float64(matchCount)/duration.Seconds())
+	_, _, hitRate := cache.Stats()
+	fmt.Printf("Evaluation complete - took %s (%.1f matches/sec, %.1f%% eval cache hits)\n",
+		duration.Round(time.Second), float64(matchCount)/duration.Seconds(), hitRate)
 
 	return results
 }
@@ -242,6 +163,11 @@ func Evaluate(g *Genome, games, threads int) float64 {
 	deckSize, handSize, maxRounds := params.DeckSize, params.HandSize, params.MaxRounds
 	mctsParams := params.MCTSParams
 
+	// Both sides play the same genome, so they share one set of networks and
+	// one cache across every game
+	policyNet, valueNet := g.ToNetworks()
+	cache := neural.NewEvalCache(neural.DefaultEvalCacheEntries)
+
 	winsCh := make(chan int, threads)
 	drawsCh := make(chan int, threads)
 	var wg sync.WaitGroup
@@ -259,10 +185,9 @@ func Evaluate(g *Genome, games, threads int) float64 {
 			localWins, localDraws := 0, 0
 			for i := 0; i < count; i++ {
 				gme := game.NewRPSGame(deckSize, handSize, maxRounds)
-				p1, v1 := g.ToNetworks()
-				p2, v2 := g.ToNetworks()
-				e1 := mcts.NewRPSMCTS(p1, v1, mctsParams)
-				e2 := mcts.NewRPSMCTS(p2, v2, mctsParams)
+				e1 := mcts.NewRPSMCTS(policyNet, valueNet, mctsParams)
+				e2 := mcts.NewRPSMCTS(policyNet, valueNet, mctsParams)
+				e1.Cache, e2.Cache = cache, cache
 
 				first := ((offset + i) % 2) == 0
 				for !gme.IsGameOver() {
@@ -0,0 +1,331 @@
+package neat
+
+import (
+	"runtime"
+	"sync"
+	"sync/atomic"
+
+	"github.com/zachbeta/neural_rps/alphago_demo/pkg/game"
+	"github.com/zachbeta/neural_rps/alphago_demo/pkg/mcts"
+	neural "github.com/zachbeta/neural_rps/alphago_demo/pkg/rps_net_impl"
+	"github.com/zachbeta/neural_rps/alphago_demo/pkg/training"
+)
+
+// lockstepGames is the number of games each evaluation worker keeps in
+// flight. Games are claimed in runs of this many, and prepareMatches lists a
+// genome's matches together, so most of a worker's games share the genome
+// being evaluated and its leaves batch together.
+const lockstepGames = 16
+
+// genomeNetworks are a genome's networks, built once per generation
+type genomeNetworks struct {
+	policy *neural.RPSPolicyNetwork
+	value  *neural.RPSValueNetwork
+}
+
+// buildNetworks converts every genome to networks in parallel. Genomes
+// appearing more than once are built once.
+func buildNetworks(genomes []*Genome, workers int) map[*Genome]genomeNetworks {
+	nets := make(map[*Genome]genomeNetworks, len(genomes))
+	for _, g := range genomes {
+		nets[g] = genomeNetworks{}
+	}
+	unique := make([]*Genome, 0, len(nets))
+	for g := range nets {
+		unique = append(unique, g)
+	}
+
+	built := make([]genomeNetworks, len(unique))
+	var next atomic.Int64
+	var wg sync.WaitGroup
+	for w := 0; w < workers; w++ {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			for i := int(next.Add(1) - 1); i < len(unique); i = int(next.Add(1) - 1) {
+				policy, value := unique[i].ToNetworks()
+				built[i] = genomeNetworks{policy: policy, value: value}
+			}
+		}()
+	}
+	wg.Wait()
+
+	for i, g := range unique {
+		nets[g] = built[i]
+	}
+	return nets
+}
+
+// gameTask is one game of a match
+type gameTask struct {
+	match     int
+	evalFirst bool // The evaluated genome plays Player1
+}
+
+// lockstepGame is a game in progress on a lockstepEvaluator worker
+type lockstepGame struct {
+	gameTask
+	state   *game.RPSGame
+	engines [2]*mcts.RPSMCTS // Indexed by player: Player1 then Player2
+	sims    int              // Simulations run for the current move
+
+	// The current simulation's node to evaluate and its value
+	node  *mcts.RPSMCTSNode
+	value float64
+}
+
+func (g *lockstepGame) engine() *mcts.RPSMCTS {
+	if g.state.CurrentPlayer == game.Player1 {
+		return g.engines[0]
+	}
+	return g.engines[1]
+}
+
+// lockstepEvaluator plays a generation's evaluation matches. Each worker
+// advances many games one simulation at a time; after every game has
+// selected its leaf, pending policy and value evaluations are grouped by
+// network, and so by genome, and each group is evaluated with one batched
+// forward pass through the shared cache.
+type lockstepEvaluator struct {
+	matches    []Match
+	genomes    []*Genome
+	nets       map[*Genome]genomeNetworks
+	cache      *neural.EvalCache
+	params     training.RPSSelfPlayParams
+	results    []*GenomeResult
+	tasks      []gameTask
+	next       atomic.Int64 // Next unclaimed task
+	remaining  []atomic.Int32
+	onMatchEnd func()
+}
+
+func newLockstepEvaluator(pop *Population, hof []*Genome, matches []Match, results []*GenomeResult, cache *neural.EvalCache, workers int) *lockstepEvaluator {
+	e := &lockstepEvaluator{
+		matches:   matches,
+		genomes:   pop.Genomes,
+		nets:      buildNetworks(append(append([]*Genome(nil), pop.Genomes...), hof...), workers),
+		cache:     cache,
+		params:    training.DefaultRPSSelfPlayParams(),
+		results:   results,
+		remaining: make([]atomic.Int32, len(matches)),
+	}
+	for m, match := range matches {
+		e.remaining[m].Store(int32(match.Games))
+		for i := 0; i < match.Games; i++ {
+			// Alternate who is player 1/2
+			e.tasks = append(e.tasks, gameTask{match: m, evalFirst: i%2 == 0})
+		}
+	}
+	return e
+}
+
+// run plays every match on workers goroutines
+func (e *lockstepEvaluator) run(workers int) {
+	var wg sync.WaitGroup
+	for w := 0; w < workers; w++ {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			e.work()
+		}()
+	}
+	wg.Wait()
+}
+
+// claim returns the next run of up to n unplayed games
+func (e *lockstepEvaluator) claim(n int) []gameTask {
+	end := int(e.next.Add(int64(n)))
+	start := end - n
+	if start >= len(e.tasks) {
+		return nil
+	}
+	return e.tasks[start:min(end, len(e.tasks))]
+}
+
+// newGame sets up a game and its two engines
+func (e *lockstepEvaluator) newGame(task gameTask) *lockstepGame {
+	match := e.matches[task.match]
+	evalNets, oppNets := e.nets[e.genomes[match.GenomeIdx]], e.nets[match.Opponent]
+	first, second := evalNets, oppNets
+	if !task.evalFirst {
+		first, second = oppNets, evalNets
+	}
+
+	g := &lockstepGame{
+		gameTask: task,
+		state:    game.NewRPSGame(e.params.DeckSize, e.params.HandSize, e.params.MaxRounds),
+	}
+	for i, nets := range [2]genomeNetworks{first, second} {
+		g.engines[i] = mcts.NewRPSMCTS(nets.policy, nets.value, e.params.MCTSParams)
+		g.engines[i].Cache = e.cache
+	}
+	return g
+}
+
+// finish records a finished game's result for the evaluated genome
+func (e *lockstepEvaluator) finish(g *lockstepGame) {
+	result := e.results[e.matches[g.match].GenomeIdx]
+	winner := g.state.GetWinner()
+	if winner == game.NoPlayer {
+		atomic.AddInt32(&result.Draws, 1)
+	} else if (winner == game.Player1) == g.evalFirst {
+		atomic.AddInt32(&result.Wins, 1)
+	}
+	atomic.AddInt32(&result.Games, 1)
+
+	if e.remaining[g.match].Add(-1) == 0 && e.onMatchEnd != nil {
+		e.onMatchEnd()
+	}
+}
+
+// policyGroup and valueGroup collect one step's pending evaluations for a
+// network
+type policyGroup struct {
+	network *neural.RPSPolicyNetwork
+	games   []*lockstepGame
+	states  []*game.RPSGame
+}
+
+type valueGroup struct {
+	network *neural.RPSValueNetwork
+	games   []*lockstepGame
+	states  []*game.RPSGame
+	values  []float64
+}
+
+// work plays claimed games in lockstep until none are left
+func (e *lockstepEvaluator) work() {
+	var (
+		active  []*lockstepGame
+		queued  []gameTask
+		scratch neural.BatchScratch
+
+		policyGroups []*policyGroup
+		valueGroups  []*valueGroup
+		policyIndex  = make(map[*neural.RPSPolicyNetwork]*policyGroup)
+		valueIndex   = make(map[*neural.RPSValueNetwork]*valueGroup)
+	)
+	simulations := max(e.params.MCTSParams.NumSimulations, 1)
+
+	for {
+		// Top up the games in flight
+		for len(active) < lockstepGames {
+			if len(queued) == 0 {
+				if queued = e.claim(lockstepGames); len(queued) == 0 {
+					break
+				}
+			}
+			active = append(active, e.newGame(queued[0]))
+			queued = queued[1:]
+		}
+		if len(active) == 0 {
+			return
+		}
+
+		// Selection: every game runs its current simulation down to a leaf,
+		// queueing the leaves that need priors
+		for _, g := range active {
+			engine := g.engine()
+			if g.sims == 0 {
+				engine.SetRootState(g.state)
+				engine.BeginSearch()
+			}
+
+			node, expand := engine.SelectLeaf()
+			g.node = node
+			if expand {
+				group := policyIndex[engine.PolicyNetwork]
+				if group == nil {
+					group = &policyGroup{network: engine.PolicyNetwork}
+					policyIndex[engine.PolicyNetwork] = group
+					policyGroups = append(policyGroups, group)
+				}
+				group.games = append(group.games, g)
+				group.states = append(group.states, node.GameState)
+			}
+		}
+
+		// Expansion: one batched policy evaluation per network
+		for _, group := range policyGroups {
+			if len(group.states) == 0 {
+				continue
+			}
+			priors := e.cache.PolicyBatch(group.network, group.states, &scratch)
+			for i, g := range group.games {
+				g.node = g.engine().ExpandLeaf(g.node, priors[i])
+			}
+			group.games, group.states = group.games[:0], group.states[:0]
+		}
+
+		// Evaluation: terminal nodes score themselves, the rest are batched
+		// per value network
+		for _, g := range active {
+			if value, ok := mcts.TerminalValue(g.node); ok {
+				g.value = value
+				continue
+			}
+			network := g.engine().ValueNetwork
+			group := valueIndex[network]
+			if group == nil {
+				group = &valueGroup{network: network}
+				valueIndex[network] = group
+				valueGroups = append(valueGroups, group)
+			}
+			group.games = append(group.games, g)
+			group.states = append(group.states, g.node.GameState)
+		}
+		for _, group := range valueGroups {
+			if len(group.states) == 0 {
+				continue
+			}
+			group.values = group.values[:0]
+			for range group.states {
+				group.values = append(group.values, 0)
+			}
+			e.cache.ValueBatch(group.network, group.states, group.values, &scratch)
+			for i, g := range group.games {
+				g.value = group.values[i]
+			}
+			group.games, group.states = group.games[:0], group.states[:0]
+		}
+
+		// Backpropagation, then move for games whose search is complete
+		kept := active[:0]
+		for _, g := range active {
+			engine := g.engine()
+			engine.Backup(g.node, g.value)
+			g.node = nil
+
+			g.sims++
+			if g.sims == simulations {
+				g.sims = 0
+				if best := engine.Root.MostVisitedChild(); best != nil && best.Move != nil {
+					g.state.MakeMove(*best.Move)
+				}
+				if g.state.IsGameOver() {
+					e.finish(g)
+					continue
+				}
+			}
+			kept = append(kept, g)
+		}
+		for i := len(kept); i < len(active); i++ {
+			active[i] = nil
+		}
+		active = kept
+
+		// Networks of finished games may not come back, so drop the groups
+		// once there are more of them than the games in flight could use
+		if len(policyGroups)+len(valueGroups) > 4*lockstepGames {
+			policyGroups, valueGroups = policyGroups[:0], valueGroups[:0]
+			clear(policyIndex)
+			clear(valueIndex)
+		}
+	}
+}
+
+// workerCount is the number of evaluation goroutines, leaving a core for
+// the caller
+func workerCount() int {
+	return max(runtime.NumCPU()-1, 1)
+}
@@ -0,0 +1,47 @@
+package neat
+
+import (
+	"sync/atomic"
+	"testing"
+)
+
+func TestLockstepEvaluatorPlaysEveryGame(t *testing.T) {
+	cfg := Config{
+		PopSize:    4,
+		WeightStd:  0.1,
+		HiddenSize: 8,
+	}
+	pop := NewPopulation(cfg)
+	hof := []*Genome{pop.Genomes[0].Copy()}
+
+	matches := prepareMatches(pop, hof)
+	results := make([]*GenomeResult, len(pop.Genomes))
+	for i := range results {
+		results[i] = &GenomeResult{}
+	}
+
+	evaluator := newLockstepEvaluator(pop, hof, matches, results, nil, 2)
+	evaluator.params.MCTSParams.NumSimulations = 10
+	if len(evaluator.nets) != len(pop.Genomes)+len(hof) {
+		t.Fatalf("Expected networks for %d genomes, built %d", len(pop.Genomes)+len(hof), len(evaluator.nets))
+	}
+	var ended atomic.Int32
+	evaluator.onMatchEnd = func() { ended.Add(1) }
+	evaluator.run(2)
+
+	if int(ended.Load()) != len(matches) {
+		t.Errorf("Expected %d finished matches, got %d", len(matches), ended.Load())
+	}
+	want := make([]int32, len(pop.Genomes))
+	for _, m := range matches {
+		want[m.GenomeIdx] += int32(m.Games)
+	}
+	for i, r := range results {
+		if r.Games != want[i] {
+			t.Errorf("Genome %d: played %d games, expected %d", i, r.Games, want[i])
+		}
+		if r.Wins+r.Draws > r.Games {
+			t.Errorf("Genome %d: %d wins and %d draws in %d games", i, r.Wins, r.Draws, r.Games)
+		}
+	}
+}
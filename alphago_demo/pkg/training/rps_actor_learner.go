@@ -0,0 +1,281 @@
+package training
+
+import (
+	"fmt"
+	"math/rand"
+	"runtime"
+	"sync"
+	"sync/atomic"
+	"time"
+
+	"github.com/zachbeta/neural_rps/alphago_demo/pkg/replay"
+	neural "github.com/zachbeta/neural_rps/alphago_demo/pkg/rps_net_impl"
+)
+
+// ActorLearnerParams configures an ActorLearner
+type ActorLearnerParams struct {
+	SelfPlay RPSSelfPlayParams // Game and MCTS settings; NumGames is the run's game budget
+
+	Actors         int // Self-play goroutines (0 = SelfPlay.NumThreads, else NumCPU-1)
+	BufferCapacity int // Examples held by the replay ring
+	MinBufferSize  int // Examples to collect before the learner starts
+
+	BatchSize    int
+	LearningRate float64
+	Trainer      neural.TrainerConfig
+
+	// PublishEvery is the number of learner batches between weight
+	// publications to the actors
+	PublishEvery int
+	// SampleRatio caps the examples trained on per example generated, so
+	// the learner does not overfit a young buffer while actors catch up.
+	// 0 lets the learner run flat out.
+	SampleRatio float64
+
+	StatsInterval time.Duration // Progress report period when verbose
+}
+
+// DefaultActorLearnerParams returns parameters for a modest run
+func DefaultActorLearnerParams() ActorLearnerParams {
+	return ActorLearnerParams{
+		SelfPlay:       DefaultRPSSelfPlayParams(),
+		Actors:         0,
+		BufferCapacity: 1 << 16,
+		MinBufferSize:  256,
+		BatchSize:      32,
+		LearningRate:   0.001,
+		Trainer:        neural.DefaultTrainerConfig(),
+		PublishEvery:   50,
+		SampleRatio:    4,
+		StatsInterval:  5 * time.Second,
+	}
+}
+
+// ActorLearnerStats summarises a run. Rates are over the whole run.
+type ActorLearnerStats struct {
+	Games        int
+	Examples     int // Generated by actors
+	Samples      int // Trained on by the learner
+	Batches      int
+	Publications int
+	Elapsed      time.Duration
+
+	GamesPerSecond   float64
+	SamplesPerSecond float64
+
+	PolicyLoss float64 // Mean over the last reporting period
+	ValueLoss  float64
+}
+
+// networkSnapshot is a published, immutable pair of networks. Actors share
+// it for reading; the learner never touches it again after publishing.
+type networkSnapshot struct {
+	policy *neural.RPSPolicyNetwork
+	value  *neural.RPSValueNetwork
+}
+
+// ActorLearner overlaps self-play with training. Actor goroutines play
+// games with the latest published networks and add their positions to a
+// bounded replay ring, while a learner goroutine trains its own copy of the
+// networks on mini-batches sampled from the ring. Every PublishEvery batches
+// the learner publishes clones of its networks, which actors pick up
+// atomically at the start of their next game.
+type ActorLearner struct {
+	params ActorLearnerParams
+	sp     *RPSSelfPlay // Game playing and the shared eval cache
+
+	// The learner's networks, only touched by the learner goroutine
+	policy *neural.RPSPolicyNetwork
+	value  *neural.RPSValueNetwork
+
+	published atomic.Pointer[networkSnapshot]
+	ring      *replay.Ring
+
+	claimed atomic.Int64 // Games handed to actors
+	games   atomic.Int64 // Games finished
+	added   chan struct{}
+}
+
+// NewActorLearner creates a pipeline that trains policy and value in place
+func NewActorLearner(policy *neural.RPSPolicyNetwork, value *neural.RPSValueNetwork, params ActorLearnerParams) *ActorLearner {
+	defaults := DefaultActorLearnerParams()
+	if params.BufferCapacity < 1 {
+		params.BufferCapacity = defaults.BufferCapacity
+	}
+	if params.BatchSize < 1 {
+		params.BatchSize = defaults.BatchSize
+	}
+	if params.PublishEvery < 1 {
+		params.PublishEvery = defaults.PublishEvery
+	}
+	params.MinBufferSize = min(max(params.MinBufferSize, params.BatchSize), params.BufferCapacity)
+	if params.Actors < 1 {
+		params.Actors = params.SelfPlay.NumThreads
+	}
+	if params.Actors < 1 {
+		params.Actors = max(runtime.NumCPU()-1, 1)
+	}
+
+	al := &ActorLearner{
+		params: params,
+		sp:     NewRPSSelfPlay(policy, value, params.SelfPlay),
+		policy: policy,
+		value:  value,
+		ring:   replay.NewRing(replay.RPSLayout, params.BufferCapacity),
+		added:  make(chan struct{}, 1),
+	}
+	al.publish()
+	return al
+}
+
+// publish makes copies of the learner's current weights available to actors
+func (al *ActorLearner) publish() {
+	al.published.Store(&networkSnapshot{
+		policy: al.policy.Clone(),
+		value:  al.value.Clone(),
+	})
+}
+
+// Run plays NumGames games while training, and returns once every game is
+// played and the learner has caught up with SampleRatio. The networks
+// passed to NewActorLearner then hold the trained weights.
+func (al *ActorLearner) Run(verbose bool) ActorLearnerStats {
+	start := time.Now()
+	numGames := int64(al.params.SelfPlay.NumGames)
+
+	if verbose {
+		fmt.Printf("Starting actor/learner pipeline: %d actors, %d games, replay buffer of %d\n",
+			al.params.Actors, numGames, al.params.BufferCapacity)
+	}
+
+	actorsDone := make(chan struct{})
+	var wg sync.WaitGroup
+	for i := 0; i < al.params.Actors; i++ {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			al.act(numGames)
+		}()
+	}
+	go func() {
+		wg.Wait()
+		close(actorsDone)
+	}()
+
+	stats := al.learn(actorsDone, start, verbose)
+	stats.Elapsed = time.Since(start)
+	stats.Games = int(al.games.Load())
+	stats.Examples = al.ring.Added()
+	stats.GamesPerSecond = float64(stats.Games) / stats.Elapsed.Seconds()
+	stats.SamplesPerSecond = float64(stats.Samples) / stats.Elapsed.Seconds()
+
+	if verbose {
+		_, _, hitRate := al.sp.cache.Stats()
+		fmt.Printf("Pipeline finished in %s: %d games (%.2f games/sec), %d examples, %d samples trained (%.0f samples/sec), %d publications, %.1f%% eval cache hits\n",
+			stats.Elapsed.Round(time.Millisecond), stats.Games, stats.GamesPerSecond, stats.Examples,
+			stats.Samples, stats.SamplesPerSecond, stats.Publications, hitRate)
+	}
+	return stats
+}
+
+// act plays games until the budget is claimed
+func (al *ActorLearner) act(numGames int64) {
+	for al.claimed.Add(1) <= numGames {
+		snapshot := al.published.Load()
+		examples := al.sp.playGameWithNetworks(snapshot.policy, snapshot.value, false)
+		for _, example := range examples {
+			// Self-play examples always match RPSLayout
+			_ = al.ring.Add(example.BoardState, example.PolicyTarget, example.ValueTarget)
+		}
+		al.games.Add(1)
+
+		// Wake the learner if it is waiting for data
+		select {
+		case al.added <- struct{}{}:
+		default:
+		}
+	}
+}
+
+// learn trains from the ring until the actors are done and the sample
+// budget is met
+func (al *ActorLearner) learn(actorsDone <-chan struct{}, start time.Time, verbose bool) ActorLearnerStats {
+	var stats ActorLearnerStats
+	policyTrainer := neural.NewPolicyTrainer(al.policy, al.params.Trainer)
+	valueTrainer := neural.NewValueTrainer(al.value, al.params.Trainer)
+	rng := rand.New(rand.NewSource(time.Now().UnixNano()))
+	var batch replay.Batch
+
+	var periodPolicy, periodValue float64
+	periodBatches := 0
+	lastReport := start
+
+	for {
+		done := false
+		select {
+		case <-actorsDone:
+			done = true
+		default:
+		}
+
+		// Decide whether there is anything to train on yet
+		held, generated := al.ring.Len(), al.ring.Added()
+		ready := held >= al.params.MinBufferSize || (done && held > 0)
+		if ready && al.params.SampleRatio > 0 {
+			ready = float64(stats.Samples) < al.params.SampleRatio*float64(generated)
+		} else if ready && done {
+			// Without a ratio the learner only runs alongside the actors
+			ready = false
+		}
+		if !ready {
+			if done {
+				break
+			}
+			select {
+			case <-al.added:
+			case <-actorsDone:
+			}
+			continue
+		}
+
+		al.ring.Sample(rng, al.params.BatchSize, &batch)
+		periodPolicy += policyTrainer.Train(batch.States, batch.Policies, al.params.LearningRate)
+		periodValue += valueTrainer.Train(batch.States, batch.Values, al.params.LearningRate)
+		periodBatches++
+		stats.Batches++
+		stats.Samples += len(batch.Values)
+
+		if stats.Batches%al.params.PublishEvery == 0 {
+			stats.Publications++
+			al.publish()
+		}
+
+		if verbose && al.params.StatsInterval > 0 && time.Since(lastReport) >= al.params.StatsInterval {
+			elapsed := time.Since(start).Seconds()
+			fmt.Printf("  Pipeline: %d games (%.2f games/sec), buffer %d/%d, %d samples (%.0f samples/sec), policy loss %.4f, value loss %.4f, generation %d\n",
+				al.games.Load(), float64(al.games.Load())/elapsed, held, al.params.BufferCapacity,
+				stats.Samples, float64(stats.Samples)/elapsed,
+				periodPolicy/float64(periodBatches), periodValue/float64(periodBatches), stats.Publications)
+			stats.PolicyLoss, stats.ValueLoss = periodPolicy/float64(periodBatches), periodValue/float64(periodBatches)
+			periodPolicy, periodValue, periodBatches = 0, 0, 0
+			lastReport = time.Now()
+		}
+	}
+
+	if periodBatches > 0 {
+		stats.PolicyLoss, stats.ValueLoss = periodPolicy/float64(periodBatches), periodValue/float64(periodBatches)
+	}
+	// Leave the final weights published for anyone reading a snapshot
+	if stats.Batches%al.params.PublishEvery != 0 {
+		stats.Publications++
+		al.publish()
+	}
+	return stats
+}
+
+// Published returns the networks most recently published to the actors.
+// They must be treated as read-only.
+func (al *ActorLearner) Published() (*neural.RPSPolicyNetwork, *neural.RPSValueNetwork) {
+	snapshot := al.published.Load()
+	return snapshot.policy, snapshot.value
+}
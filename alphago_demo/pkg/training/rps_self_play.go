@@ -9,6 +9,7 @@ import (
 
 	"github.com/zachbeta/neural_rps/alphago_demo/pkg/game"
 	"github.com/zachbeta/neural_rps/alphago_demo/pkg/mcts"
+	"github.com/zachbeta/neural_rps/alphago_demo/pkg/replay"
 	neural "github.com/zachbeta/neural_rps/alphago_demo/pkg/rps_net_impl"
 )
 
@@ -28,6 +29,12 @@ type RPSSelfPlayParams struct {
 	MCTSParams    mcts.RPSMCTSParams
 	ForceParallel bool // Force parallel execution regardless of game count
 	NumThreads    int  // Specific number of threads to use (0 = auto)
+
+	EvalCacheEntries int // Network outputs memoized across moves and games (0 disables)
+
+	// Trainer selects mini-batch training with the given optimizer, one
+	// weight update per batch. Nil keeps the networks' per-example Train.
+	Trainer *neural.TrainerConfig
 }
 
 // DefaultRPSSelfPlayParams returns default self-play parameters
@@ -40,6 +47,8 @@ func DefaultRPSSelfPlayParams() RPSSelfPlayParams {
 		MCTSParams:    mcts.DefaultRPSMCTSParams(),
 		ForceParallel: false,
 		NumThreads:    0, // Auto-select thread count
+
+		EvalCacheEntries: neural.DefaultEvalCacheEntries,
 	}
 }
 
@@ -49,35 +58,84 @@ type RPSSelfPlay struct {
 	policyNetwork *neural.RPSPolicyNetwork
 	valueNetwork  *neural.RPSValueNetwork
 	examples      []RPSTrainingExample
+
+	// Shared by every game's engine. Worker clones keep their original's
+	// model version, so they share entries too.
+	cache *neural.EvalCache
 }
 
 // NewRPSSelfPlay creates a new self-play instance
 func NewRPSSelfPlay(policyNetwork *neural.RPSPolicyNetwork, valueNetwork *neural.RPSValueNetwork, params RPSSelfPlayParams) *RPSSelfPlay {
-	return &RPSSelfPlay{
+	sp := &RPSSelfPlay{
 		params:        params,
 		policyNetwork: policyNetwork,
 		valueNetwork:  valueNetwork,
 		examples:      make([]RPSTrainingExample, 0),
 	}
+	if params.EvalCacheEntries > 0 {
+		sp.cache = neural.NewEvalCache(params.EvalCacheEntries)
+	}
+	return sp
 }
 
 // GenerateGames generates games through self-play
 func (sp *RPSSelfPlay) GenerateGames(verbose bool) []RPSTrainingExample {
 	sp.examples = make([]RPSTrainingExample, 0)
+	sp.generate(verbose, func(examples []RPSTrainingExample) error {
+		sp.examples = append(sp.examples, examples...)
+		return nil
+	})
+	return sp.examples
+}
+
+// GenerateGamesTo plays games like GenerateGames but streams each game's
+// examples to w as the game finishes instead of keeping them, so memory use
+// does not grow with NumGames. It returns the number of examples written.
+// The examples are not available to TrainNetworks; train from a
+// replay.Buffer over w's shards with TrainNetworksFromBuffer instead.
+func (sp *RPSSelfPlay) GenerateGamesTo(w *replay.Writer, verbose bool) (int, error) {
+	sp.examples = make([]RPSTrainingExample, 0)
+	total, err := sp.generate(verbose, func(examples []RPSTrainingExample) error {
+		states := make([][]float64, len(examples))
+		policies := make([][]float64, len(examples))
+		values := make([]float64, len(examples))
+		for i, example := range examples {
+			states[i], policies[i], values[i] = example.BoardState, example.PolicyTarget, example.ValueTarget
+		}
+		return w.WriteBatch(states, policies, values)
+	})
+	if err != nil {
+		return total, err
+	}
+	return total, w.Flush()
+}
+
+// generate plays NumGames games, handing each game's examples to consume
+// from a single goroutine. It stops handing over examples after the first
+// error, which it returns.
+func (sp *RPSSelfPlay) generate(verbose bool, consume func([]RPSTrainingExample) error) (int, error) {
+	var err error
+	guarded := func(examples []RPSTrainingExample) {
+		if err == nil {
+			err = consume(examples)
+		}
+	}
 
 	// Use serial or parallel generation based on game count and available cores
+	var total int
 	if (sp.params.NumGames < 5 || runtime.NumCPU() <= 2) && !sp.params.ForceParallel {
 		// Use original serial implementation for small jobs or limited cores
-		return sp.generateGamesSerial(verbose)
+		total = sp.generateGamesSerial(verbose, guarded)
 	} else {
 		// Use parallel implementation for larger jobs with multiple cores
 		// or when explicitly requested with ForceParallel
-		return sp.generateGamesParallel(verbose)
+		total = sp.generateGamesParallel(verbose, guarded)
 	}
+	return total, err
 }
 
 // generateGamesSerial generates games serially (original implementation)
-func (sp *RPSSelfPlay) generateGamesSerial(verbose bool) []RPSTrainingExample {
+func (sp *RPSSelfPlay) generateGamesSerial(verbose bool, consume func([]RPSTrainingExample)) int {
 	startTime := time.Now()
 	totalExamples := 0
 
@@ -88,7 +146,7 @@ func (sp *RPSSelfPlay) generateGamesSerial(verbose bool) []RPSTrainingExample {
 		}
 
 		gameExamples := sp.playGame(verbose && i == 0)
-		sp.examples = append(sp.examples, gameExamples...)
+		consume(gameExamples)
 		totalExamples += len(gameExamples)
 
 		// Report progress for long runs
@@ -109,15 +167,16 @@ func (sp *RPSSelfPlay) generateGamesSerial(verbose bool) []RPSTrainingExample {
 	gamesPerSecond := float64(sp.params.NumGames) / elapsed.Seconds()
 
 	if verbose {
-		fmt.Printf("Generated %d training examples in %s (%.1f examples/game, %.2f games/sec)\n",
-			totalExamples, elapsed, examplesPerGame, gamesPerSecond)
+		_, _, hitRate := sp.cache.Stats()
+		fmt.Printf("Generated %d training examples in %s (%.1f examples/game, %.2f games/sec, %.1f%% eval cache hits)\n",
+			totalExamples, elapsed, examplesPerGame, gamesPerSecond, hitRate)
 	}
 
-	return sp.examples
+	return totalExamples
 }
 
 // generateGamesParallel generates games in parallel using multiple goroutines
-func (sp *RPSSelfPlay) generateGamesParallel(verbose bool) []RPSTrainingExample {
+func (sp *RPSSelfPlay) generateGamesParallel(verbose bool, consume func([]RPSTrainingExample)) int {
 	startTime := time.Now()
 
 	// Determine number of workers based on CPU count
@@ -132,8 +191,9 @@ func (sp *RPSSelfPlay) generateGamesParallel(verbose bool) []RPSTrainingExample
 		numWorkers = sp.params.NumThreads
 	}
 
-	// Create a buffered channel for game examples
-	gamesChan := make(chan []RPSTrainingExample, sp.params.NumGames)
+	// Create a buffered channel for game examples. A few games per worker
+	// is enough slack for the consumer; more would only hold games in memory.
+	gamesChan := make(chan []RPSTrainingExample, 4*numWorkers)
 
 	// For progress tracking
 	progressChan := make(chan int, sp.params.NumGames)
@@ -229,12 +289,11 @@ func (sp *RPSSelfPlay) generateGamesParallel(verbose bool) []RPSTrainingExample
 		}
 	}()
 
-	// Collect all game examples
-	allExamples := make([]RPSTrainingExample, 0)
+	// Hand over each game's examples as it arrives
 	totalExamples := 0
 
 	for examples := range gamesChan {
-		allExamples = append(allExamples, examples...)
+		consume(examples)
 		totalExamples += len(examples)
 	}
 
@@ -243,11 +302,11 @@ func (sp *RPSSelfPlay) generateGamesParallel(verbose bool) []RPSTrainingExample
 	examplesPerGame := float64(totalExamples) / float64(sp.params.NumGames)
 	gamesPerSecond := float64(sp.params.NumGames) / elapsed.Seconds()
 
-	fmt.Printf("Generated %d training examples in %s (%.1f examples/game, %.2f games/sec)\n",
-		totalExamples, elapsed, examplesPerGame, gamesPerSecond)
+	_, _, hitRate := sp.cache.Stats()
+	fmt.Printf("Generated %d training examples in %s (%.1f examples/game, %.2f games/sec, %.1f%% eval cache hits)\n",
+		totalExamples, elapsed, examplesPerGame, gamesPerSecond, hitRate)
 
-	sp.examples = allExamples
-	return allExamples
+	return totalExamples
 }
 
 // playGameWithNetworks plays a single game using the provided networks
@@ -265,6 +324,7 @@ func (sp *RPSSelfPlay) playGameWithNetworks(
 	// Create MCTS instance with the worker's network copies
 	mctsParams := sp.params.MCTSParams
 	mctsEngine := mcts.NewRPSMCTS(policyNetwork, valueNetwork, mctsParams)
+	mctsEngine.Cache = sp.cache
 
 	// Play until game is over
 	for !gameInstance.IsGameOver() {
@@ -277,8 +337,8 @@ func (sp *RPSSelfPlay) playGameWithNetworks(
 		// Search for best move
 		bestNode := mctsEngine.Search()
 
-		// Extract policy from MCTS visit counts
-		policy := sp.extractPolicy(bestNode)
+		// Extract policy from the root's child visit counts
+		policy := sp.extractPolicy(mctsEngine.Root)
 		policyHistory = append(policyHistory, policy)
 
 		// Make the move
@@ -352,16 +412,25 @@ func (sp *RPSSelfPlay) extractPolicy(node *mcts.RPSMCTSNode) []float64 {
 	// Initialize policy target with zeros (9 possible positions)
 	policyTarget := make([]float64, 9)
 
+	// Without a node there is nothing to go on; use a uniform distribution
+	if node == nil {
+		for i := range policyTarget {
+			policyTarget[i] = 1.0 / 9.0
+		}
+		return policyTarget
+	}
+
 	// Check if node and children are valid
-	if node == nil || len(node.Children) == 0 {
+	if len(node.Children) == 0 {
 		// No children, return uniform distribution or zeros if no valid moves
-		if node != nil && node.GameState != nil {
+		if node.GameState != nil {
 			validMoves := node.GameState.GetValidMoves()
 			if len(validMoves) > 0 {
+				// Several cards can target the same position, so accumulate
 				prob := 1.0 / float64(len(validMoves))
 				for _, move := range validMoves {
 					if move.Position >= 0 && move.Position < 9 {
-						policyTarget[move.Position] = prob
+						policyTarget[move.Position] += prob
 					}
 				}
 			}
@@ -391,10 +460,11 @@ func (sp *RPSSelfPlay) extractPolicy(node *mcts.RPSMCTSNode) []float64 {
 		if node.GameState != nil {
 			validMoves := node.GameState.GetValidMoves()
 			if len(validMoves) > 0 {
+				// Several cards can target the same position, so accumulate
 				prob := 1.0 / float64(len(validMoves))
 				for _, move := range validMoves {
 					if move.Position >= 0 && move.Position < 9 {
-						policyTarget[move.Position] = prob
+						policyTarget[move.Position] += prob
 					}
 				}
 			}
@@ -419,6 +489,56 @@ func (sp *RPSSelfPlay) TrainNetworks(numEpochs int, batchSize int, learningRate
 		sp.examples[i], sp.examples[j] = sp.examples[j], sp.examples[i]
 	})
 
+	return sp.trainEpochs(len(sp.examples), numEpochs, batchSize, learningRate, verbose,
+		func(epoch, start, end int) ([][]float64, [][]float64, []float64) {
+			batch := sp.examples[start:end]
+
+			// Create batch inputs and targets
+			states := make([][]float64, len(batch))
+			policyTargets := make([][]float64, len(batch))
+			valueTargets := make([]float64, len(batch))
+
+			for i, example := range batch {
+				states[i] = example.BoardState
+				policyTargets[i] = example.PolicyTarget
+				valueTargets[i] = example.ValueTarget
+			}
+			return states, policyTargets, valueTargets
+		})
+}
+
+// TrainNetworksFromBuffer trains the policy and value networks on the
+// examples in a replay buffer, e.g. the shards written by GenerateGamesTo.
+// Each epoch visits every example once in a fresh random order; only the
+// current mini-batch is decoded into memory.
+func (sp *RPSSelfPlay) TrainNetworksFromBuffer(buffer *replay.Buffer, numEpochs int, batchSize int, learningRate float64, verbose bool) ([]float64, []float64) {
+	if buffer.Len() == 0 {
+		if verbose {
+			fmt.Println("No training examples to learn from!")
+		}
+		return nil, nil
+	}
+
+	order := make([]int, buffer.Len())
+	for i := range order {
+		order[i] = i
+	}
+	var batch replay.Batch
+
+	return sp.trainEpochs(len(order), numEpochs, batchSize, learningRate, verbose,
+		func(epoch, start, end int) ([][]float64, [][]float64, []float64) {
+			if start == 0 {
+				rand.Shuffle(len(order), func(i, j int) { order[i], order[j] = order[j], order[i] })
+			}
+			buffer.Gather(order[start:end], &batch)
+			return batch.States, batch.Policies, batch.Values
+		})
+}
+
+// trainEpochs runs the training loop over numExamples examples in batches,
+// getting each batch's inputs and targets from batchAt
+func (sp *RPSSelfPlay) trainEpochs(numExamples, numEpochs, batchSize int, learningRate float64, verbose bool,
+	batchAt func(epoch, start, end int) ([][]float64, [][]float64, []float64)) ([]float64, []float64) {
 	// Track losses for each epoch
 	policyLosses := make([]float64, numEpochs)
 	valueLosses := make([]float64, numEpochs)
@@ -427,6 +547,13 @@ func (sp *RPSSelfPlay) TrainNetworks(numEpochs int, batchSize int, learningRate
 	sp.policyNetwork.DebugEpochCount = []int{0}
 	sp.valueNetwork.DebugEpochCount = []int{0}
 
+	// Per-example updates unless a mini-batch optimizer is configured
+	trainPolicy, trainValue := sp.policyNetwork.Train, sp.valueNetwork.Train
+	if sp.params.Trainer != nil {
+		trainPolicy = neural.NewPolicyTrainer(sp.policyNetwork, *sp.params.Trainer).Train
+		trainValue = neural.NewValueTrainer(sp.valueNetwork, *sp.params.Trainer).Train
+	}
+
 	// Train networks
 	for epoch := 0; epoch < numEpochs; epoch++ {
 		// Update epoch counter for debugging
@@ -444,24 +571,13 @@ func (sp *RPSSelfPlay) TrainNetworks(numEpochs int, batchSize int, learningRate
 		}
 
 		// Process in batches
-		for b := 0; b < len(sp.examples); b += batchSize {
+		for b := 0; b < numExamples; b += batchSize {
 			end := b + batchSize
-			if end > len(sp.examples) {
-				end = len(sp.examples)
+			if end > numExamples {
+				end = numExamples
 			}
 
-			batch := sp.examples[b:end]
-
-			// Create batch inputs and targets
-			states := make([][]float64, len(batch))
-			policyTargets := make([][]float64, len(batch))
-			valueTargets := make([]float64, len(batch))
-
-			for i, example := range batch {
-				states[i] = example.BoardState
-				policyTargets[i] = example.PolicyTarget
-				valueTargets[i] = example.ValueTarget
-			}
+			states, policyTargets, valueTargets := batchAt(epoch, b, end)
 
 			// Train policy network with lower learning rate for larger networks
 			actualLR := learningRate
@@ -470,16 +586,16 @@ func (sp *RPSSelfPlay) TrainNetworks(numEpochs int, batchSize int, learningRate
 				actualLR = learningRate * 0.5
 			}
 
-			policyLossBatch := sp.policyNetwork.Train(states, policyTargets, actualLR)
+			policyLossBatch := trainPolicy(states, policyTargets, actualLR)
 			policyLoss += policyLossBatch
 
 			// Train value network with same adjusted learning rate
-			valueLossBatch := sp.valueNetwork.Train(states, valueTargets, actualLR)
+			valueLossBatch := trainValue(states, valueTargets, actualLR)
 			valueLoss += valueLossBatch
 		}
 
 		// Calculate average loss
-		batchCount := (len(sp.examples) + batchSize - 1) / batchSize
+		batchCount := (numExamples + batchSize - 1) / batchSize
 		if batchCount > 0 {
 			policyLoss /= float64(batchCount)
 			valueLoss /= float64(batchCount)
@@ -5,6 +5,7 @@ import (
 
 	"github.com/zachbeta/neural_rps/alphago_demo/pkg/game"
 	"github.com/zachbeta/neural_rps/alphago_demo/pkg/mcts"
+	"github.com/zachbeta/neural_rps/alphago_demo/pkg/replay"
 	neural "github.com/zachbeta/neural_rps/alphago_demo/pkg/rps_net_impl"
 )
 
@@ -169,7 +170,7 @@ func TestRPSSelfPlayExtractPolicy(t *testing.T) {
 		childState.MakeMove(move)
 
 		child := mcts.NewRPSMCTSNode(childState, &move, root, nil)
-		child.Visits = (i + 1) * 10 // Position 0: 10 visits, Position 1: 20 visits, Position 2: 30 visits
+		child.Visits.Store(int64((i + 1) * 10)) // Position 0: 10 visits, Position 1: 20 visits, Position 2: 30 visits
 
 		root.Children = append(root.Children, child)
 	}
@@ -314,3 +315,98 @@ func TestRPSSelfPlayFullPipeline(t *testing.T) {
 			gameState.CurrentPlayer, bestMove.Player)
 	}
 }
+
+func TestRPSSelfPlayShardPipeline(t *testing.T) {
+	policyNetwork := neural.NewRPSPolicyNetwork(16)
+	valueNetwork := neural.NewRPSValueNetwork(16)
+
+	params := DefaultRPSSelfPlayParams()
+	params.NumGames = 6
+	params.ForceParallel = true
+	params.NumThreads = 3
+	params.MCTSParams.NumSimulations = 10
+	selfPlay := NewRPSSelfPlay(policyNetwork, valueNetwork, params)
+
+	dir := t.TempDir()
+	config := replay.DefaultWriterConfig()
+	config.ShardExamples = 16
+	writer, err := replay.NewWriter(dir, config)
+	if err != nil {
+		t.Fatalf("NewWriter failed: %v", err)
+	}
+
+	written, err := selfPlay.GenerateGamesTo(writer, false)
+	if err != nil {
+		t.Fatalf("GenerateGamesTo failed: %v", err)
+	}
+	if written == 0 || writer.Count() != written {
+		t.Fatalf("Expected the writer to receive all %d examples, got %d", written, writer.Count())
+	}
+	if len(selfPlay.examples) != 0 {
+		t.Errorf("Expected streamed examples not to be kept in memory, got %d", len(selfPlay.examples))
+	}
+
+	buffer, err := replay.OpenDir(dir, 0)
+	if err != nil {
+		t.Fatalf("OpenDir failed: %v", err)
+	}
+	defer buffer.Close()
+	if buffer.Len() != written {
+		t.Fatalf("Expected %d examples in the buffer, got %d", written, buffer.Len())
+	}
+
+	policyLosses, valueLosses := selfPlay.TrainNetworksFromBuffer(buffer, 2, 8, 0.01, false)
+	if len(policyLosses) != 2 || len(valueLosses) != 2 {
+		t.Errorf("Expected a loss per epoch, got %d and %d", len(policyLosses), len(valueLosses))
+	}
+}
+
+func TestActorLearnerPipeline(t *testing.T) {
+	policyNetwork := neural.NewRPSPolicyNetwork(16)
+	valueNetwork := neural.NewRPSValueNetwork(16)
+	initialWeights := policyNetwork.GetWeights()
+
+	params := DefaultActorLearnerParams()
+	params.SelfPlay.NumGames = 8
+	params.SelfPlay.MCTSParams.NumSimulations = 10
+	params.Actors = 3
+	params.MinBufferSize = 16
+	params.BatchSize = 8
+	params.PublishEvery = 2
+	params.SampleRatio = 2
+	pipeline := NewActorLearner(policyNetwork, valueNetwork, params)
+
+	stats := pipeline.Run(false)
+	if stats.Games != 8 {
+		t.Errorf("Expected 8 games, got %d", stats.Games)
+	}
+	if stats.Examples == 0 || stats.Batches == 0 {
+		t.Fatalf("Expected examples and training, got %d examples and %d batches", stats.Examples, stats.Batches)
+	}
+	// The learner catches up with the sample ratio before returning
+	if want := 2 * stats.Examples; stats.Samples < want || stats.Samples >= want+params.BatchSize {
+		t.Errorf("Expected about %d samples trained, got %d", want, stats.Samples)
+	}
+
+	changed := false
+	for i, w := range policyNetwork.GetWeights() {
+		if w != initialWeights[i] {
+			changed = true
+			break
+		}
+	}
+	if !changed {
+		t.Error("Expected the learner to train the policy network in place")
+	}
+
+	// The final publication carries the trained weights
+	published, _ := pipeline.Published()
+	if published == policyNetwork {
+		t.Error("Expected actors to get a copy, not the learner's network")
+	}
+	for i, w := range published.GetWeights() {
+		if w != policyNetwork.GetWeights()[i] {
+			t.Fatal("Expected the final publication to match the trained network")
+		}
+	}
+}
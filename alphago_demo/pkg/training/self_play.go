@@ -3,6 +3,9 @@ package training
 import (
 	"fmt"
 	"math/rand"
+	"runtime"
+	"sync"
+	"sync/atomic"
 
 	"github.com/zachbeta/neural_rps/alphago_demo/pkg/game"
 	"github.com/zachbeta/neural_rps/alphago_demo/pkg/mcts"
@@ -18,8 +21,10 @@ type AGTrainingExample struct {
 
 // AGSelfPlayParams contains parameters for self-play
 type AGSelfPlayParams struct {
-	NumGames   int
-	MCTSParams mcts.AGMCTSParams
+	NumGames      int
+	MCTSParams    mcts.AGMCTSParams
+	ForceParallel bool // Force parallel execution regardless of game count
+	NumThreads    int  // Specific number of threads to use (0 = auto)
 }
 
 // DefaultAGSelfPlayParams returns default self-play parameters
@@ -48,22 +53,70 @@ func NewAGSelfPlay(policyNetwork *neural.AGPolicyNetwork, valueNetwork *neural.A
 	}
 }
 
-// GenerateGames generates games through self-play
+// GenerateGames generates games through self-play. Examples come back in
+// game order whether the games are played serially or in parallel.
 func (sp *AGSelfPlay) GenerateGames(verbose bool) []AGTrainingExample {
 	sp.examples = make([]AGTrainingExample, 0)
 
-	for i := 0; i < sp.params.NumGames; i++ {
-		if verbose && i%10 == 0 {
-			fmt.Printf("Playing game %d/%d\n", i+1, sp.params.NumGames)
+	// Use serial or parallel generation on the same terms as RPSSelfPlay
+	if (sp.params.NumGames < 5 || runtime.NumCPU() <= 2) && !sp.params.ForceParallel {
+		for i := 0; i < sp.params.NumGames; i++ {
+			if verbose && i%10 == 0 {
+				fmt.Printf("Playing game %d/%d\n", i+1, sp.params.NumGames)
+			}
+
+			gameExamples := sp.playGame(verbose && i == 0)
+			sp.examples = append(sp.examples, gameExamples...)
 		}
+		return sp.examples
+	}
 
-		gameExamples := sp.playGame(verbose && i == 0)
+	for _, gameExamples := range sp.generateGamesParallel(verbose) {
 		sp.examples = append(sp.examples, gameExamples...)
 	}
-
 	return sp.examples
 }
 
+// generateGamesParallel plays NumGames games on worker goroutines and
+// returns each game's examples by game index. The workers share the
+// networks: Predict only reads their weights.
+func (sp *AGSelfPlay) generateGamesParallel(verbose bool) [][]AGTrainingExample {
+	// Use N-1 workers to avoid saturating the system, like RPSSelfPlay
+	numWorkers := runtime.NumCPU() - 1
+	if numWorkers < 1 {
+		numWorkers = 1
+	}
+	if sp.params.NumThreads > 0 {
+		numWorkers = sp.params.NumThreads
+	}
+
+	if verbose {
+		fmt.Printf("Starting parallel self-play with %d workers for %d games...\n",
+			numWorkers, sp.params.NumGames)
+	}
+
+	games := make([][]AGTrainingExample, sp.params.NumGames)
+	var next, completed atomic.Int64
+	var wg sync.WaitGroup
+	for w := 0; w < numWorkers; w++ {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+
+			// Workers claim games one at a time so none is left idle
+			for i := int(next.Add(1) - 1); i < len(games); i = int(next.Add(1) - 1) {
+				games[i] = sp.playGame(verbose && i == 0)
+				if done := completed.Add(1); verbose && done%10 == 0 {
+					fmt.Printf("Completed game %d/%d\n", done, sp.params.NumGames)
+				}
+			}
+		}()
+	}
+	wg.Wait()
+
+	return games
+}
+
 // playGame plays a single game and returns training examples
 func (sp *AGSelfPlay) playGame(verbose bool) []AGTrainingExample {
 	gameInstance := game.NewAGGame()
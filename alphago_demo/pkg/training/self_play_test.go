@@ -0,0 +1,34 @@
+package training
+
+import (
+	"testing"
+
+	neural "github.com/zachbeta/neural_rps/alphago_demo/pkg/rps_net_impl"
+)
+
+func TestAGSelfPlayParallel(t *testing.T) {
+	params := DefaultAGSelfPlayParams()
+	params.NumGames = 6
+	params.MCTSParams.NumSimulations = 40
+	params.MCTSParams.NumTrees = 2
+	params.MCTSParams.LeafBatchSize = 4
+	params.ForceParallel = true
+	params.NumThreads = 3
+	selfPlay := NewAGSelfPlay(neural.NewAGPolicyNetwork(9, 16), neural.NewAGValueNetwork(9, 16), params)
+
+	examples := selfPlay.GenerateGames(false)
+
+	// Every game lasts between 5 and 9 moves, one example per move
+	if len(examples) < 5*params.NumGames || len(examples) > 9*params.NumGames {
+		t.Fatalf("Expected 5 to 9 examples per game, got %d for %d games", len(examples), params.NumGames)
+	}
+	for i, example := range examples {
+		if len(example.BoardState) != 9 || len(example.PolicyTarget) != 9 {
+			t.Fatalf("Example %d has %d features and %d policy entries, expected 9 each",
+				i, len(example.BoardState), len(example.PolicyTarget))
+		}
+		if example.ValueTarget != 0 && example.ValueTarget != 0.5 && example.ValueTarget != 1 {
+			t.Errorf("Example %d has value target %f", i, example.ValueTarget)
+		}
+	}
+}
@@ -5,12 +5,14 @@ import (
 	"fmt"
 	"log"
 	"math/rand"
+	"strconv"
+	"strings"
 	"time"
 
-	ort "github.com/yalue/onnxruntime_go"
 	// "github.com/zachbeta/neural_rps/pkg/neural" // Removed unused import
 	"github.com/zachbeta/neural_rps/pkg/neural/cpu"
 	"github.com/zachbeta/neural_rps/pkg/neural/gpu"
+	"github.com/zachbeta/neural_rps/pkg/neural/onnx"
 )
 
 const (
@@ -67,6 +69,73 @@ func benchmarkCPUBatch(network *cpu.RPSCPUPolicyNetwork, inputSize, batchSize, i
 	return elapsed
 }
 
+func benchmarkCPUBatchFloat32(network *cpu.RPSCPUPolicyNetwork, inputSize, batchSize, iterations int) time.Duration {
+	batch := make([][]float32, batchSize)
+	for i, row := range generateRandomBatch(batchSize, inputSize) {
+		batch[i] = make([]float32, inputSize)
+		for j, v := range row {
+			batch[i][j] = float32(v)
+		}
+	}
+
+	start := time.Now()
+	for i := 0; i < iterations; i++ {
+		_, err := network.ForwardBatchFloat32(batch)
+		if err != nil {
+			log.Fatalf("Error during CPU float32 batch prediction: %v", err)
+		}
+	}
+	elapsed := time.Since(start)
+
+	return elapsed
+}
+
+// runCPUBatchSweep reports per-item latency of the batched CPU kernels across
+// a range of batch sizes, alongside the one-at-a-time baseline
+func runCPUBatchSweep(inputSize, hiddenSize, outputSize, iterations int, batchSizes []int) {
+	fmt.Printf("CPU Batch Sweep (Ad-hoc Go Network, float32 kernels: %s):\n", cpu.KernelName())
+	cpuNetwork, err := cpu.NewRPSCPUPolicyNetwork(inputSize, hiddenSize, outputSize)
+	if err != nil {
+		log.Fatalf("Failed to create CPU network: %v", err)
+	}
+
+	singleTime := benchmarkCPUSingle(cpuNetwork, inputSize, iterations)
+	singleAvg := singleTime.Seconds() * 1e6 / float64(iterations)
+	fmt.Printf("  %-10s %14s %14s %10s\n", "Batch", "float64 µs/item", "float32 µs/item", "Speedup")
+	fmt.Printf("  %-10s %14.2f %14s %10s\n", "single", singleAvg, "-", "1.00x")
+
+	for _, batchSize := range batchSizes {
+		// Keep the total number of predictions roughly constant across sizes
+		batchIterations := iterations / batchSize
+		if batchIterations < 1 {
+			batchIterations = 1
+		}
+		items := float64(batchIterations * batchSize)
+
+		f64Avg := benchmarkCPUBatch(cpuNetwork, inputSize, batchSize, batchIterations).Seconds() * 1e6 / items
+		f32Avg := benchmarkCPUBatchFloat32(cpuNetwork, inputSize, batchSize, batchIterations).Seconds() * 1e6 / items
+		fmt.Printf("  %-10d %14.2f %14.2f %9.2fx\n", batchSize, f64Avg, f32Avg, singleAvg/f64Avg)
+	}
+	fmt.Println()
+}
+
+// parseBatchSizes parses a comma-separated list of positive batch sizes
+func parseBatchSizes(list string) ([]int, error) {
+	var sizes []int
+	for _, field := range strings.Split(list, ",") {
+		field = strings.TrimSpace(field)
+		if field == "" {
+			continue
+		}
+		size, err := strconv.Atoi(field)
+		if err != nil || size <= 0 {
+			return nil, fmt.Errorf("invalid batch size %q", field)
+		}
+		sizes = append(sizes, size)
+	}
+	return sizes, nil
+}
+
 func benchmarkGPUSingle(network *gpu.RPSGPUPolicyNetwork, inputSize, iterations int) time.Duration {
 	input := generateRandomInput(inputSize)
 
@@ -119,197 +188,80 @@ func runCPUAdHocBenchmark_Old(inputSize, hiddenSize, outputSize, iterations, bat
 
 // runCPUONNXBenchmark will run CPU benchmarks using a loaded ONNX model.
 // flagInputSize is the input_size passed from the command line, used for ad-hoc or as a reference.
-func runCPUONNXBenchmark(onnxModelPath string, flagInputSize, iterations, batchSize int) {
+func runCPUONNXBenchmark(config onnx.Config, flagInputSize, iterations, batchSize int) {
 	fmt.Println("CPU Benchmarks (ONNX Model):")
-	if onnxModelPath == "" {
+	if config.ModelPath == "" {
 		fmt.Println("  ONNX model path not provided, skipping ONNX CPU benchmark.")
 		fmt.Println()
 		return
 	}
-	fmt.Printf("  Attempting to load ONNX Model Path: %s\n", onnxModelPath)
+	fmt.Printf("  Attempting to load ONNX Model Path: %s (provider %s)\n", config.ModelPath, config.Provider)
 
-	// Set shared library path (assuming it's needed)
-	sharedLibraryPath := "/Users/zmorek/go/pkg/mod/github.com/yalue/onnxruntime_go@v1.19.0/test_data/onnxruntime_arm64.dylib"
-	ort.SetSharedLibraryPath(sharedLibraryPath)
-
-	err := ort.InitializeEnvironment()
+	config.MaxBatchSize = max(batchSize, 1)
+	network, err := onnx.NewNetwork(config)
 	if err != nil {
-		log.Fatalf("Failed to initialize ONNX Runtime environment: %v", err)
+		log.Fatalf("Failed to load ONNX model: %v", err)
 	}
-	defer ort.DestroyEnvironment()
+	defer network.Close()
 
-	// --- Infer Model Input Size ---
-	inputsInfo, _, err := ort.GetInputOutputInfo(onnxModelPath)
-	if err != nil {
-		log.Fatalf("Failed to get ONNX model input/output info for '%s': %v", onnxModelPath, err)
-		return
-	}
-	if len(inputsInfo) == 0 {
-		log.Fatalf("ONNX model '%s' has no inputs defined according to GetInputOutputInfo.", onnxModelPath)
-		return
-	}
-	firstInputDims := inputsInfo[0].Dimensions
-	if len(firstInputDims) < 2 {
-		log.Fatalf("First input of ONNX model '%s' has unexpected dimensions %v (expected at least 2).", onnxModelPath, firstInputDims)
-		return
-	}
-	modelFeatureInputSize := int(firstInputDims[1]) // Assuming shape [batch_size, features]
-	if modelFeatureInputSize <= 0 {
-		log.Fatalf("Inferred ONNX model input feature size (%d) must be positive. Dimensions from model: %v", modelFeatureInputSize, firstInputDims)
-		return
-	}
-	fmt.Printf("  Inferred ONNX Model Input Feature Size: %d (from model dimensions: %v)\n", modelFeatureInputSize, firstInputDims)
+	modelFeatureInputSize := network.GetInputSize()
+	fmt.Printf("  Inferred ONNX Model Input Feature Size: %d, Output Size: %d\n", modelFeatureInputSize, network.GetOutputSize())
 	if flagInputSize != modelFeatureInputSize {
 		fmt.Printf("  Note: Command-line --input-size (%d) differs from inferred ONNX model input feature size (%d). Using inferred size for ONNX benchmarks.\n", flagInputSize, modelFeatureInputSize)
 	}
 
-	inputNames := []string{"input"}   // Matches the name used during ONNX export from Python
-	outputNames := []string{"output"} // Matches the name used during ONNX export from Python
-
-	// Create a new dynamic ONNX session, explicitly specifying float32 for input and output generic types
-	session, err := ort.NewDynamicSession[float32, float32](onnxModelPath, inputNames, outputNames)
-	if err != nil {
-		log.Fatalf("Failed to create dynamic ONNX session for model '%s': %v", onnxModelPath, err)
-		return
-	}
-	defer session.Destroy() // Ensure resources are released
-
-	fmt.Printf("  Successfully loaded ONNX model and created dynamic session.\n")
-
-	// ----- DEBUG: Re-check output info just before running -----
-	_, checkOutputInfo, checkErr := ort.GetInputOutputInfo(onnxModelPath)
-	if checkErr != nil {
-		log.Printf("DEBUG: Failed to re-check output info: %v\n", checkErr)
-	} else {
-		log.Printf("DEBUG: Re-checked Output Info Count: %d\n", len(checkOutputInfo))
-		for i, info := range checkOutputInfo {
-			// Assuming float32 type for printing dimensions based on session creation
-			log.Printf("DEBUG: Re-checked Output %d - Name: %s, Dimensions: %v\n", i, info.Name, info.Dimensions)
+	toFloat32 := func(values []float64) []float32 {
+		out := make([]float32, len(values))
+		for i, v := range values {
+			out[i] = float32(v)
 		}
+		return out
 	}
-	// ----- END DEBUG -----
-
-	// --- Actual ONNX benchmarking logic starts here ---
-
-	// 1. Prepare a single input tensor
-	randomInputFloat64 := generateRandomInput(modelFeatureInputSize) // Returns []float64
-	randomInputFloat32 := make([]float32, modelFeatureInputSize)
-	for i, val := range randomInputFloat64 {
-		randomInputFloat32[i] = float32(val)
-	}
-	inputShape := ort.NewShape(1, int64(modelFeatureInputSize))
-	inputTensor, err := ort.NewTensor(inputShape, randomInputFloat32)
-	if err != nil {
-		log.Fatalf("Failed to create input tensor: %v", err)
-		return
-	}
-	defer inputTensor.Destroy()
-	fmt.Printf("  Successfully created input tensor with shape %v.\n", inputShape)
-
-	// 2. Run inference for a single input
-	// Input tensors slice must be of type []*ort.Tensor[InputT]
-	inputTensors := []*ort.Tensor[float32]{inputTensor} // inputTensor is *ort.Tensor[float32]
-
-	// Pre-allocate output tensor(s). For DynamicSession[InputT, OutputT],
-	// the Run method expects a slice of output tensors, []*Tensor[OutputT], to be filled.
-	// We need to know the expected output shape. Assuming policy model -> [1, 9]
-	// NOTE: This assumes the output is for a policy model!
-	outputShape := ort.NewShape(1, 9) // Batch size 1, 9 outputs for policy
-
-	outputPlaceholder, err := ort.NewEmptyTensor[float32](outputShape)
-	if err != nil {
-		log.Fatalf("Failed to create empty output tensor: %v", err)
-		return
-	}
-	defer outputPlaceholder.Destroy()
-	outputsToFill := []*ort.Tensor[float32]{outputPlaceholder}
 
 	// --- Single Prediction Benchmark Loop ---
 	fmt.Println("  Starting single prediction benchmark...")
+	single := [][]float32{toFloat32(generateRandomInput(modelFeatureInputSize))}
+	var outputs [][]float32
 	start := time.Now()
-
 	for i := 0; i < iterations; i++ {
-		err = session.Run(inputTensors, outputsToFill)
+		outputs, err = network.ForwardBatchFloat32(single)
 		if err != nil {
-			// Simple error handling for now
 			log.Fatalf("Failed to run ONNX inference during single prediction benchmark (iteration %d): %v", i, err)
-			return
 		}
 	}
 	elapsedSingle := time.Since(start)
 	avgSingleTime := float64(elapsedSingle.Microseconds()) / float64(iterations)
 	fmt.Printf("  Single prediction (ONNX): %v total, (avg %.2f µs/prediction) for %d iterations\n", elapsedSingle, avgSingleTime, iterations)
-
-	// We can verify the last output as a sanity check
-	outputTensor := outputsToFill[0] // This is our outputPlaceholder, now filled with data from the last iteration.
-	outputData := outputTensor.GetData()
-	if len(outputData) == 0 {
-		log.Printf("Warning: Output tensor data is empty after single prediction benchmark loop")
-	} else {
-		fmt.Printf("  Sample predicted value from last iteration (first element): %f\n", outputData[0])
+	if len(outputs) > 0 && len(outputs[0]) > 0 {
+		fmt.Printf("  Sample predicted value from last iteration (first element): %f\n", outputs[0][0])
 	}
 
 	// --- Batch Prediction Benchmark Loop ---
 	fmt.Println("  Starting batch prediction benchmark...")
-
-	// 1. Prepare a batch input tensor using modelFeatureInputSize
-	randomBatchFloat64 := generateRandomBatch(batchSize, modelFeatureInputSize) // Returns [][]float64
-	randomBatchFloat32 := make([]float32, 0, batchSize*modelFeatureInputSize)
-	for _, singleInputFloat64 := range randomBatchFloat64 {
-		for _, val := range singleInputFloat64 {
-			randomBatchFloat32 = append(randomBatchFloat32, float32(val))
-		}
-	}
-	batchInputShape := ort.NewShape(int64(batchSize), int64(modelFeatureInputSize))
-	batchInputTensor, err := ort.NewTensor(batchInputShape, randomBatchFloat32)
-	if err != nil {
-		log.Fatalf("Failed to create batch input tensor: %v", err)
-		return
+	randomBatch := generateRandomBatch(batchSize, modelFeatureInputSize)
+	batch := make([][]float32, len(randomBatch))
+	for i, input := range randomBatch {
+		batch[i] = toFloat32(input)
 	}
-	defer batchInputTensor.Destroy()
-	fmt.Printf("  Successfully created batch input tensor with shape %v.\n", batchInputShape)
-	batchInputTensors := []*ort.Tensor[float32]{batchInputTensor}
 
-	// 2. Prepare a batch output placeholder tensor
-	// NOTE: Assuming policy model output shape [batchSize, 9]
-	batchOutputShape := ort.NewShape(int64(batchSize), 9)
-	batchOutputPlaceholder, err := ort.NewEmptyTensor[float32](batchOutputShape)
-	if err != nil {
-		log.Fatalf("Failed to create batch empty output tensor: %v", err)
-		return
-	}
-	defer batchOutputPlaceholder.Destroy()
-	batchOutputsToFill := []*ort.Tensor[float32]{batchOutputPlaceholder}
-
-	// 3. Run batch inference loop
-	startBatch := time.Now()
-	// Calculate number of batches needed
 	numBatches := iterations / batchSize
 	if iterations%batchSize != 0 {
 		numBatches++
 	}
 	var totalActualPredictions int64 = 0
-
+	startBatch := time.Now()
 	for i := 0; i < numBatches; i++ {
-		err = session.Run(batchInputTensors, batchOutputsToFill)
+		outputs, err = network.ForwardBatchFloat32(batch)
 		if err != nil {
-			// Simple error handling for now
 			log.Fatalf("Failed to run ONNX inference during batch prediction benchmark (batch %d): %v", i, err)
-			return
 		}
-		totalActualPredictions += int64(batchSize) // Count predictions made
+		totalActualPredictions += int64(batchSize)
 	}
 	elapsedBatch := time.Since(startBatch)
 	avgBatchTime := float64(elapsedBatch.Microseconds()) / float64(totalActualPredictions)
 	fmt.Printf("  Batch prediction (ONNX): %v total, (avg %.2f µs/prediction/item) over %d batches (%d total predictions)\n", elapsedBatch, avgBatchTime, numBatches, totalActualPredictions)
-
-	// Sanity check the last batch output
-	batchOutputData := batchOutputPlaceholder.GetData()
-	if len(batchOutputData) == 0 {
-		log.Printf("Warning: Batch output tensor data is empty after benchmark loop")
-	} else {
-		// Print first element of the first prediction in the batch
-		fmt.Printf("  Sample predicted value from last batch iteration (first item, first element): %f\n", batchOutputData[0])
+	if len(outputs) > 0 && len(outputs[0]) > 0 {
+		fmt.Printf("  Sample predicted value from last batch iteration (first item, first element): %f\n", outputs[0][0])
 	}
 
 	fmt.Println()
@@ -396,7 +348,11 @@ func main() {
 	tfGpuAddr := flag.String("gpu-addr", defaultTfGpuAddr, "Address of the TensorFlow Python gRPC service (legacy GPU benchmark)")
 	onnxGpuPort := flag.Int("onnx-gpu-port", defaultOnnxGpuPort, "Port for the ONNX Python gRPC service (new GPU benchmark)")
 	onnxModelPath := flag.String("onnx-model", "", "Path to the ONNX model for CPU benchmarks (e.g., ./output/rps_value1.onnx)")
+	onnxLibrary := flag.String("onnx-lib", "", "Path to the ONNX Runtime shared library (default $"+onnx.LibraryPathEnv+", then the system library)")
+	onnxProvider := flag.String("onnx-provider", string(onnx.ProviderCPU), "ONNX Runtime execution provider: cpu, cuda, tensorrt or coreml")
 	neatPolicyModelPath := flag.String("neat-policy-model", "", "Path to the NEAT policy model (.model) for CPU benchmarks")
+	batchSweep := flag.String("batch-sweep", "1,8,32,64,128,256", "Comma-separated batch sizes for the CPU per-item latency sweep (empty to skip)")
+	noSIMD := flag.Bool("no-simd", false, "Force the scalar float32 CPU kernels even when AVX2/NEON is available")
 	runCPUAdHoc := flag.Bool("run-cpu-adhoc", true, "Run CPU benchmarks with ad-hoc Go network")
 	runCPUONNX := flag.Bool("run-cpu-onnx", true, "Run CPU benchmarks with ONNX model")
 	runCPUNEAT := flag.Bool("run-cpu-neat", true, "Run CPU benchmarks with NEAT model")
@@ -405,6 +361,10 @@ func main() {
 
 	flag.Parse()
 
+	if *noSIMD {
+		cpu.SetSIMDEnabled(false)
+	}
+
 	// Seed random number generator
 	rand.Seed(time.Now().UnixNano())
 
@@ -440,10 +400,21 @@ func main() {
 
 	if *runCPUAdHoc {
 		runCPUAdHocBenchmark_Old(*inputSize, *hiddenSize, *outputSize, *iterations, *batchSize)
+
+		sweepSizes, err := parseBatchSizes(*batchSweep)
+		if err != nil {
+			log.Fatalf("Invalid -batch-sweep: %v", err)
+		}
+		if len(sweepSizes) > 0 {
+			runCPUBatchSweep(*inputSize, *hiddenSize, *outputSize, *iterations, sweepSizes)
+		}
 	}
 
 	if *runCPUONNX {
-		runCPUONNXBenchmark(*onnxModelPath, *inputSize, *iterations, *batchSize)
+		onnxConfig := onnx.DefaultConfig(*onnxModelPath)
+		onnxConfig.SharedLibraryPath = *onnxLibrary
+		onnxConfig.Provider = onnx.Provider(*onnxProvider)
+		runCPUONNXBenchmark(onnxConfig, *inputSize, *iterations, *batchSize)
 	}
 
 	if *runCPUNEAT {
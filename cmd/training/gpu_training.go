@@ -22,6 +22,8 @@ func main() {
 	serviceAddr := flag.String("service", "localhost:50052", "GPU neural service address")
 	outputDir := flag.String("output", "output/gpu_training", "Directory for training output")
 	enableProfile := flag.Bool("profile", false, "Enable CPU profiling")
+	pipeline := flag.Int("pipeline", 2, "Batches of leaves each search keeps in flight (0 evaluates one leaf at a time)")
+	fused := flag.Bool("fused", false, "Evaluate policy and value in one streamed request (needs EvaluateStream support)")
 	flag.Parse()
 
 	// Set up logging
@@ -52,7 +54,11 @@ func main() {
 	params := mcts.DefaultMCTSParams()
 	params.NumSimulations = *iterations
 
-	agent, err := mcts.NewGPUBatchedMCTS(*serviceAddr, params)
+	newAgent := mcts.NewGPUBatchedMCTS
+	if *fused {
+		newAgent = mcts.NewFusedGPUBatchedMCTS
+	}
+	agent, err := newAgent(*serviceAddr, params)
 	if err != nil {
 		log.Fatalf("Failed to create GPU-accelerated MCTS: %v", err)
 	}
@@ -60,6 +66,7 @@ func main() {
 
 	// Set batch size
 	agent.SetBatchSize(*batchSize)
+	agent.SetPipelineDepth(*pipeline)
 
 	// Run self-play games
 	log.Printf("Starting %d self-play games with %d iterations per move\n", *games, *iterations)
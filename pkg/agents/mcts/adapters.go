@@ -34,91 +34,7 @@ func (g *RPSGameStateAdapter) GetLastMove() game.RPSCardMove {
 
 // ToTensor converts the game state to tensor representation
 func (g *RPSGameStateAdapter) ToTensor() []float32 {
-	// Convert the board to a flat representation for the neural network
-	features := make([]float32, 0, 64) // Using 64 as a common size for neural input
-
-	// Board state (27 features: 9 positions x 3 states per position)
-	for pos := 0; pos < 9; pos++ {
-		// One-hot encoding for each position
-		isRock := 0.0
-		isPaper := 0.0
-		isScissors := 0.0
-		isEmpty := 1.0
-
-		if g.BoardOwner[pos] != game.NoPlayer {
-			isEmpty = 0.0
-			if g.Board[pos] == game.Rock {
-				isRock = 1.0
-			} else if g.Board[pos] == game.Paper {
-				isPaper = 1.0
-			} else if g.Board[pos] == game.Scissors {
-				isScissors = 1.0
-			}
-		}
-
-		// Add ownership information
-		isPlayer1 := 0.0
-		isPlayer2 := 0.0
-		if g.BoardOwner[pos] == game.Player1 {
-			isPlayer1 = 1.0
-		} else if g.BoardOwner[pos] == game.Player2 {
-			isPlayer2 = 1.0
-		}
-
-		features = append(features, float32(isRock), float32(isPaper), float32(isScissors))
-		features = append(features, float32(isEmpty), float32(isPlayer1), float32(isPlayer2))
-	}
-
-	// Current player
-	if g.CurrentPlayer == game.Player1 {
-		features = append(features, 1.0, 0.0)
-	} else {
-		features = append(features, 0.0, 1.0)
-	}
-
-	// Player 1 hand (one-hot encoding for each card type)
-	rockCount := 0
-	paperCount := 0
-	scissorsCount := 0
-	for _, card := range g.Player1Hand {
-		if card == game.Rock {
-			rockCount++
-		} else if card == game.Paper {
-			paperCount++
-		} else if card == game.Scissors {
-			scissorsCount++
-		}
-	}
-	features = append(features, float32(rockCount)/float32(g.HandSize))
-	features = append(features, float32(paperCount)/float32(g.HandSize))
-	features = append(features, float32(scissorsCount)/float32(g.HandSize))
-
-	// Player 2 hand (one-hot encoding for each card type)
-	rockCount = 0
-	paperCount = 0
-	scissorsCount = 0
-	for _, card := range g.Player2Hand {
-		if card == game.Rock {
-			rockCount++
-		} else if card == game.Paper {
-			paperCount++
-		} else if card == game.Scissors {
-			scissorsCount++
-		}
-	}
-	features = append(features, float32(rockCount)/float32(g.HandSize))
-	features = append(features, float32(paperCount)/float32(g.HandSize))
-	features = append(features, float32(scissorsCount)/float32(g.HandSize))
-
-	// Round information
-	features = append(features, float32(g.Round)/float32(g.MaxRounds))
-
-	// Pad to 64 features if needed
-	for len(features) < 64 {
-		features = append(features, 0.0)
-	}
-
-	return features
+	return g.RPSCardGame.ToTensor()
 }
 
 // GetLegalMoves returns all valid moves for the current state
@@ -19,7 +19,8 @@ type BatchedMCTS struct {
 
 	// Batching-related fields
 	batchSize  int
-	positions  [][]float64
+	positions  [][]float64       // Rows of features, reused across batches
+	features   []float64         // Backing store for positions
 	nodesIndex map[int]*MCTSNode // Maps batch index to node
 	mu         sync.Mutex
 }
@@ -128,9 +129,10 @@ func (mcts *BatchedMCTS) collectNodesToEvaluate(count int) {
 		if node.Visits == 0 {
 			rpsAdapter, ok := node.State.(*RPSGameStateAdapter)
 			if !ok {
-				panic("BatchedMCTS expects node.State to be adaptable to RPSGameStateAdapter for extractFeatures")
+				panic("BatchedMCTS expects node.State to be adaptable to RPSGameStateAdapter for feature encoding")
 			}
-			features := mcts.extractFeatures(rpsAdapter.RPSCardGame)
+			features := mcts.nextRow()
+			rpsAdapter.EncodeBoardFeatures(features)
 			mcts.positions = append(mcts.positions, features)
 			mcts.nodesIndex[len(mcts.positions)-1] = node
 		}
@@ -318,10 +320,16 @@ func (mcts *BatchedMCTS) selectBestMove() game.RPSCardMove {
 	return bestMove
 }
 
-// extractFeatures extracts features for the neural network from the game state
-func (mcts *BatchedMCTS) extractFeatures(state *game.RPSCardGame) []float64 {
-	// Use the existing method from the game for feature extraction
-	return state.GetBoardAsFeatures()
+// nextRow returns the feature row for the next position in the batch,
+// carved from storage kept for the whole search
+func (mcts *BatchedMCTS) nextRow() []float64 {
+	start := len(mcts.positions) * game.BoardFeatureSize
+	end := start + game.BoardFeatureSize
+	if end > len(mcts.features) {
+		// Rows already handed out keep the old storage until the batch ends
+		mcts.features = make([]float64, max(mcts.batchSize*game.BoardFeatureSize, end))
+	}
+	return mcts.features[start:end:end]
 }
 
 // getMoveIndex converts a move to an index in the policy output
@@ -5,88 +5,108 @@ import (
 	"fmt"
 	"math"
 	"math/rand"
-	"sync"
+	"sync/atomic"
 	"time"
 
+	"github.com/zachbeta/neural_rps/pkg/common"
 	"github.com/zachbeta/neural_rps/pkg/game"
 	"github.com/zachbeta/neural_rps/pkg/neural/gpu"
 )
 
-// DefaultBatchSize is the default batch size for neural network evaluations
-const DefaultBatchSize = 64
-
-// MaxWaitTime is the maximum time to wait for batch completion
-const MaxWaitTime = 5 * time.Millisecond
-
-// GPUBatchedMCTS implements Monte Carlo Tree Search with GPU-accelerated batch evaluation
+// GPUBatchedMCTS implements Monte Carlo Tree Search with GPU-accelerated batch
+// evaluation. Leaves are evaluated through process-wide BatchDispatchers, so
+// every search and game talking to the same neural service fills the same
+// batches. A fused search sends each leaf once, to a dispatcher that gets
+// policy and value back together, instead of once to each model.
 type GPUBatchedMCTS struct {
 	// Base fields replicating BatchedMCTS
-	root      *MCTSNode
-	params    MCTSParams
-	batchSize int
+	root   *MCTSNode
+	params MCTSParams
 
-	// GPU clients
-	policyClient *gpu.NeuralClient
-	valueClient  *gpu.NeuralClient
+	// Shared batching dispatchers in front of the policy and value models,
+	// or a single fused dispatcher in front of both
+	policyDispatcher *gpu.BatchDispatcher
+	valueDispatcher  *gpu.BatchDispatcher
+	evalDispatcher   *gpu.BatchDispatcher
 
-	// Batch processing
-	policyQueue      []PolicyBatchItem
-	valueQueue       []ValueBatchItem
-	policyQueueMutex sync.Mutex
-	valueQueueMutex  sync.Mutex
+	// Leaves Search keeps in flight: pipelineDepth batches of batchSize
+	pipelineDepth int
+	batchSize     int
 
-	// Configuration
-	maxWaitTime time.Duration
+	// Feature rows for leaves in flight, encoded in place and returned once
+	// the leaf's result is applied
+	rows [][]float32
 
 	// Statistics
-	totalPolicyBatches int
-	totalValueBatches  int
-	totalNodes         int
+	totalNodes int
+	collisions int // Descents that reached a leaf already being evaluated
 }
 
-// PolicyBatchItem represents a state waiting for policy network evaluation
-type PolicyBatchItem struct {
-	state     GameState
-	resultCh  chan []float32
-	features  []float32
-	nodeIndex int
-}
-
-// ValueBatchItem represents a state waiting for value network evaluation
-type ValueBatchItem struct {
-	state     GameState
-	resultCh  chan float32
-	features  []float32
-	nodeIndex int
-}
-
-// NewGPUBatchedMCTS creates a new MCTS instance with GPU-accelerated batch evaluation
+// NewGPUBatchedMCTS creates a new MCTS instance with GPU-accelerated batch
+// evaluation, joining the shared dispatchers for serviceAddr
 func NewGPUBatchedMCTS(serviceAddr string, params MCTSParams) (*GPUBatchedMCTS, error) {
-	// Create GPU clients
-	policyClient, err := gpu.NewNeuralClient(serviceAddr, "policy")
+	policyDispatcher, err := gpu.AcquireSharedDispatcher(serviceAddr, "policy")
 	if err != nil {
 		return nil, fmt.Errorf("failed to create policy network client: %v", err)
 	}
 
-	valueClient, err := gpu.NewNeuralClient(serviceAddr, "value")
+	valueDispatcher, err := gpu.AcquireSharedDispatcher(serviceAddr, "value")
 	if err != nil {
+		policyDispatcher.Release()
 		return nil, fmt.Errorf("failed to create value network client: %v", err)
 	}
 
+	return NewGPUBatchedMCTSWithDispatchers(policyDispatcher, valueDispatcher, params), nil
+}
+
+// NewGPUBatchedMCTSWithDispatchers creates an MCTS instance that evaluates
+// through the given dispatchers. Close releases them.
+func NewGPUBatchedMCTSWithDispatchers(policyDispatcher, valueDispatcher *gpu.BatchDispatcher, params MCTSParams) *GPUBatchedMCTS {
+	return &GPUBatchedMCTS{
+		params:           params,
+		policyDispatcher: policyDispatcher,
+		valueDispatcher:  valueDispatcher,
+		batchSize:        gpu.DefaultDispatcherConfig().MaxBatchSize,
+		totalNodes:       0,
+	}
+}
+
+// NewGPUBatchedMCTSWithNetworks creates an MCTS instance that evaluates with
+// in-process networks, such as onnx.Network, batched through dispatchers of
+// its own. Close closes the networks.
+func NewGPUBatchedMCTSWithNetworks(policyNet, valueNet common.BatchedNeuralNetwork, params MCTSParams) *GPUBatchedMCTS {
+	config := gpu.DefaultDispatcherConfig()
+	return NewGPUBatchedMCTSWithDispatchers(
+		gpu.NewBatchDispatcher(gpu.NewLocalPredictor(policyNet), config),
+		gpu.NewBatchDispatcher(gpu.NewLocalPredictor(valueNet), config),
+		params)
+}
+
+// NewFusedGPUBatchedMCTS creates an MCTS instance that evaluates each leaf
+// with one fused policy+value request, joining the shared fused dispatcher
+// for serviceAddr. The service must implement EvaluateStream.
+func NewFusedGPUBatchedMCTS(serviceAddr string, params MCTSParams) (*GPUBatchedMCTS, error) {
+	evalDispatcher, err := gpu.AcquireSharedDispatcher(serviceAddr, gpu.FusedModelType)
+	if err != nil {
+		return nil, fmt.Errorf("failed to create fused network client: %v", err)
+	}
+
 	return &GPUBatchedMCTS{
-		params:             params,
-		policyClient:       policyClient,
-		valueClient:        valueClient,
-		policyQueue:        make([]PolicyBatchItem, 0, DefaultBatchSize),
-		valueQueue:         make([]ValueBatchItem, 0, DefaultBatchSize),
-		batchSize:          DefaultBatchSize,
-		maxWaitTime:        MaxWaitTime,
-		totalPolicyBatches: 0,
-		totalValueBatches:  0,
-		totalNodes:         0,
+		params:         params,
+		evalDispatcher: evalDispatcher,
+		batchSize:      gpu.DefaultDispatcherConfig().MaxBatchSize,
+		totalNodes:     0,
 	}, nil
 }
 
+// dispatchers returns the dispatchers this search evaluates through
+func (mcts *GPUBatchedMCTS) dispatchers() []*gpu.BatchDispatcher {
+	if mcts.evalDispatcher != nil {
+		return []*gpu.BatchDispatcher{mcts.evalDispatcher}
+	}
+	return []*gpu.BatchDispatcher{mcts.policyDispatcher, mcts.valueDispatcher}
+}
+
 // SetRootState sets the root state for the search
 func (mcts *GPUBatchedMCTS) SetRootState(state GameState) {
 	mcts.root = &MCTSNode{
@@ -99,49 +119,123 @@ func (mcts *GPUBatchedMCTS) SetRootState(state GameState) {
 	}
 }
 
-// SetBatchSize sets the batch size for neural network operations
+// SetBatchSize sets the batch size for neural network operations. The
+// dispatchers are shared, so this applies to every search using them.
 func (mcts *GPUBatchedMCTS) SetBatchSize(size int) {
-	if size < 1 {
-		size = 1
+	mcts.batchSize = max(size, 1)
+	for _, d := range mcts.dispatchers() {
+		d.SetMaxBatchSize(size)
 	}
-	mcts.batchSize = size
 }
 
-// SetMaxWaitTime sets the maximum time to wait before flushing non-full batches
+// SetMaxWaitTime sets the maximum time to wait before flushing non-full
+// batches. Like SetBatchSize, it applies to the shared dispatchers.
 func (mcts *GPUBatchedMCTS) SetMaxWaitTime(duration time.Duration) {
-	mcts.maxWaitTime = duration
+	for _, d := range mcts.dispatchers() {
+		d.SetMaxWait(duration)
+	}
 }
 
-// Search runs the MCTS algorithm with GPU batched operations and returns the best move
+// Search runs the MCTS algorithm with GPU batched operations and returns the
+// best move. Leaves are submitted without waiting for their results, up to
+// the pipeline limit (see SetPipelineDepth); results are applied as they
+// arrive while the search keeps descending under virtual loss.
 func (mcts *GPUBatchedMCTS) Search(ctx context.Context) game.RPSCardMove {
-	// Start background workers for batch processing
-	workerCtx, cancel := context.WithCancel(ctx)
-	defer cancel()
-
-	go mcts.policyWorker(workerCtx)
-	go mcts.valueWorker(workerCtx)
-
 	if mcts.root == nil {
 		panic("Root state not set")
 	}
 
-	// Run simulations
-	for i := 0; i < mcts.params.NumSimulations; i++ {
+	maxPending := mcts.maxPendingLeaves()
+	// Callbacks never block: there is room for every leaf that can be pending
+	results := make(chan leafResult, maxPending)
+	pending := make(map[*MCTSNode]bool, maxPending)
+	mcts.reserveRows(maxPending)
+
+	apply := func(r leafResult) {
+		delete(pending, r.node)
+		mcts.rows = append(mcts.rows, r.features)
+		mcts.applyVirtualLoss(r.node, -1)
+		mcts.expandNode(r.node, r.policy)
+		mcts.backpropagate(r.node, float64(r.value))
+	}
+
+	simulations := 0
+	for {
+		// Apply whatever has arrived without waiting
+	drain:
+		for len(pending) > 0 {
+			select {
+			case r := <-results:
+				apply(r)
+			default:
+				break drain
+			}
+		}
+		if simulations >= mcts.params.NumSimulations && len(pending) == 0 {
+			break
+		}
+
+		if simulations < mcts.params.NumSimulations && len(pending) < maxPending {
+			node := mcts.selectNode(mcts.root)
+			if !pending[node] {
+				simulations++
+				if mcts.evaluateLocally(node) {
+					continue
+				}
+				pending[node] = true
+				mcts.applyVirtualLoss(node, 1)
+				mcts.submitLeaf(node, results)
+				continue
+			}
+			// The descent reached a leaf that is already being evaluated;
+			// wait for a result to change the tree before trying again
+			mcts.collisions++
+		}
+
 		select {
+		case r := <-results:
+			apply(r)
 		case <-ctx.Done():
+			for node := range pending {
+				mcts.applyVirtualLoss(node, -1)
+			}
+			// The dispatchers may still read the pending leaves' rows
+			mcts.rows = nil
 			return mcts.selectBestMove(ctx)
-		default:
-			mcts.iteration(ctx)
 		}
 	}
 
 	return mcts.selectBestMove(ctx)
 }
 
-// iteration performs a single MCTS iteration
-func (mcts *GPUBatchedMCTS) iteration(ctx context.Context) {
-	node := mcts.selectNode(mcts.root)
+// leafResult is a leaf's network evaluation. A failed request leaves policy
+// nil, which expandNode treats as uniform, and value zero.
+type leafResult struct {
+	node     *MCTSNode
+	features []float32 // The row the leaf was submitted from
+	policy   []float32
+	value    float32
+}
+
+// SetPipelineDepth sets how many batches' worth of leaves Search keeps waiting
+// on the network at once; the dispatchers send up to their MaxInFlight of
+// those batches concurrently. Zero, the default, evaluates one leaf at a time.
+func (mcts *GPUBatchedMCTS) SetPipelineDepth(batches int) {
+	mcts.pipelineDepth = max(batches, 0)
+}
 
+// maxPendingLeaves is the number of leaves Search may have submitted but not
+// yet applied
+func (mcts *GPUBatchedMCTS) maxPendingLeaves() int {
+	if mcts.pipelineDepth == 0 {
+		return 1
+	}
+	return mcts.pipelineDepth * mcts.batchSize
+}
+
+// evaluateLocally backpropagates leaves that need no network evaluation and
+// reports whether node was one
+func (mcts *GPUBatchedMCTS) evaluateLocally(node *MCTSNode) bool {
 	if node.State.IsGameOver() {
 		winner := node.State.GetWinner()
 		var value float64
@@ -153,253 +247,119 @@ func (mcts *GPUBatchedMCTS) iteration(ctx context.Context) {
 			value = -1.0
 		}
 		mcts.backpropagate(node, value)
-		return
+		return true
 	}
 
-	if node.Visits == 0 {
-		mcts.queueNodeForEvaluation(ctx, node)
-		return
-	}
-
-	if len(node.Children) == 0 {
+	if node.Visits > 0 && len(node.Children) == 0 {
 		mcts.backpropagate(node, 0.0)
-		return
+		return true
 	}
+	return false
+}
 
-	childToExplore := mcts.selectBestChild(node)
-	if childToExplore == nil {
-		mcts.backpropagate(node, 0.0)
-		return
+// applyVirtualLoss adds (sign 1) or removes (sign -1) a virtual visit that
+// scores as a loss on every node from node to the root, steering concurrent
+// descents away from a path whose leaf is still being evaluated
+func (mcts *GPUBatchedMCTS) applyVirtualLoss(node *MCTSNode, sign int) {
+	for current := node; current != nil; current = current.Parent {
+		current.Visits += sign
+		current.TotalValue -= float64(sign)
 	}
 }
 
-// queueNodeForEvaluation queues a node for both policy and value evaluation
-func (mcts *GPUBatchedMCTS) queueNodeForEvaluation(ctx context.Context, node *MCTSNode) {
+// submitLeaf requests a leaf's evaluation and returns immediately. The result
+// is sent on results once policy and value are both known.
+func (mcts *GPUBatchedMCTS) submitLeaf(node *MCTSNode, results chan<- leafResult) {
 	rpsAdapter, ok := node.State.(*RPSGameStateAdapter)
 	if !ok {
-		panic("GPUBatchedMCTS expects node.State to be adaptable to RPSGameStateAdapter for extractFeatures")
+		panic("GPUBatchedMCTS expects node.State to be adaptable to RPSGameStateAdapter for feature encoding")
 	}
-	features := mcts.extractFeatures(rpsAdapter.RPSCardGame)
-
-	policyResultCh := make(chan []float32, 1)
-	mcts.policyQueueMutex.Lock()
-	mcts.policyQueue = append(mcts.policyQueue, PolicyBatchItem{
-		state:     node.State,
-		resultCh:  policyResultCh,
-		features:  features,
-		nodeIndex: mcts.totalNodes,
-	})
-	shouldFlushPolicy := len(mcts.policyQueue) >= mcts.batchSize
-	mcts.policyQueueMutex.Unlock()
-
-	valueResultCh := make(chan float32, 1)
-	mcts.valueQueueMutex.Lock()
-	mcts.valueQueue = append(mcts.valueQueue, ValueBatchItem{
-		state:     node.State,
-		resultCh:  valueResultCh,
-		features:  features,
-		nodeIndex: mcts.totalNodes,
-	})
-	shouldFlushValue := len(mcts.valueQueue) >= mcts.batchSize
-	mcts.valueQueueMutex.Unlock()
-
+	features := mcts.rows[len(mcts.rows)-1]
+	mcts.rows = mcts.rows[:len(mcts.rows)-1]
+	rpsAdapter.EncodeTensor(features)
 	mcts.totalNodes++
 
-	if shouldFlushPolicy {
-		go mcts.flushPolicyQueue(ctx)
-	}
-	if shouldFlushValue {
-		go mcts.flushValueQueue(ctx)
-	}
-
-	select {
-	case policy := <-policyResultCh:
-		mcts.expandNode(node, policy)
-		select {
-		case value := <-valueResultCh:
-			mcts.backpropagate(node, float64(value))
-		case <-ctx.Done():
-			return
-		case <-time.After(mcts.maxWaitTime):
-			mcts.backpropagate(node, 0.0)
-			return
-		}
-	case <-ctx.Done():
-		return
-	case <-time.After(mcts.maxWaitTime):
-		mcts.expandNode(node, nil)
-		select {
-		case value := <-valueResultCh:
-			mcts.backpropagate(node, float64(value))
-		case <-ctx.Done():
-			return
-		case <-time.After(mcts.maxWaitTime / 2):
-			mcts.backpropagate(node, 0.0)
-			return
-		}
-		return
-	}
-}
-
-// queueForValueEvaluation queues a node for value evaluation only
-func (mcts *GPUBatchedMCTS) queueForValueEvaluation(ctx context.Context, node *MCTSNode) {
-	rpsAdapter, ok := node.State.(*RPSGameStateAdapter)
-	if !ok {
-		panic("GPUBatchedMCTS expects node.State to be adaptable to RPSGameStateAdapter for extractFeatures")
-	}
-	features := mcts.extractFeatures(rpsAdapter.RPSCardGame)
-	valueResultCh := make(chan float32, 1)
-	mcts.valueQueueMutex.Lock()
-	mcts.valueQueue = append(mcts.valueQueue, ValueBatchItem{
-		state:     node.State,
-		resultCh:  valueResultCh,
-		features:  features,
-		nodeIndex: mcts.totalNodes,
-	})
-	shouldFlush := len(mcts.valueQueue) >= mcts.batchSize
-	mcts.valueQueueMutex.Unlock()
-
-	if shouldFlush {
-		go mcts.flushValueQueue(ctx)
-	}
-	select {
-	case value := <-valueResultCh:
-		mcts.backpropagate(node, float64(value))
-	case <-ctx.Done():
-		return
-	case <-time.After(mcts.maxWaitTime):
-		mcts.backpropagate(node, 0.0)
+	if mcts.evalDispatcher != nil {
+		mcts.evalDispatcher.Submit(features, func(resp *gpu.NeuralResponse, err error) {
+			r := leafResult{node: node, features: features}
+			if err == nil {
+				r.policy, r.value = resp.Probabilities, resp.Value
+			}
+			results <- r
+		})
 		return
 	}
-}
-
-// policyWorker processes policy evaluation batches periodically
-func (mcts *GPUBatchedMCTS) policyWorker(ctx context.Context) {
-	ticker := time.NewTicker(mcts.maxWaitTime)
-	defer ticker.Stop()
-
-	for {
-		select {
-		case <-ctx.Done():
-			return
-		case <-ticker.C:
-			mcts.flushPolicyQueue(ctx)
-		}
-	}
-}
 
-// valueWorker processes value evaluation batches periodically
-func (mcts *GPUBatchedMCTS) valueWorker(ctx context.Context) {
-	ticker := time.NewTicker(mcts.maxWaitTime)
-	defer ticker.Stop()
-
-	for {
-		select {
-		case <-ctx.Done():
-			return
-		case <-ticker.C:
-			mcts.flushValueQueue(ctx)
+	// The two halves are written by different callbacks; the last one to
+	// finish sends the result
+	r := &leafResult{node: node, features: features}
+	var remaining atomic.Int32
+	remaining.Store(2)
+	finish := func() {
+		if remaining.Add(-1) == 0 {
+			results <- *r
 		}
 	}
-}
 
-// flushPolicyQueue evaluates all queued positions with the policy network
-func (mcts *GPUBatchedMCTS) flushPolicyQueue(ctx context.Context) {
-	mcts.policyQueueMutex.Lock()
-	if len(mcts.policyQueue) == 0 {
-		mcts.policyQueueMutex.Unlock()
-		return
-	}
-
-	batch := mcts.policyQueue
-	mcts.policyQueue = make([]PolicyBatchItem, 0, mcts.batchSize)
-	mcts.policyQueueMutex.Unlock()
-
-	inputs := make([][]float32, len(batch))
-	for i, item := range batch {
-		inputs[i] = item.features
-	}
-
-	mcts.totalPolicyBatches++
-	outputs, err := mcts.policyClient.PredictBatch(ctx, inputs)
-
-	for i, item := range batch {
-		var policy []float32
-		if err != nil {
-			policy, _, err = mcts.policyClient.Predict(ctx, item.features)
-			if err != nil {
-				policy = makeUniformPolicy(mcts.policyClient.GetOutputSize())
-			}
-		} else {
-			policy = outputs[i].Probabilities
+	mcts.policyDispatcher.Submit(features, func(resp *gpu.NeuralResponse, err error) {
+		if err == nil {
+			r.policy = resp.Probabilities
 		}
-
-		select {
-		case item.resultCh <- policy:
-		default:
+		finish()
+	})
+	mcts.valueDispatcher.Submit(features, func(resp *gpu.NeuralResponse, err error) {
+		if err == nil {
+			r.value = resp.Value
 		}
-	}
+		finish()
+	})
 }
 
-// flushValueQueue evaluates all queued positions with the value network
-func (mcts *GPUBatchedMCTS) flushValueQueue(ctx context.Context) {
-	mcts.valueQueueMutex.Lock()
-	if len(mcts.valueQueue) == 0 {
-		mcts.valueQueueMutex.Unlock()
-		return
-	}
-
-	batch := mcts.valueQueue
-	mcts.valueQueue = make([]ValueBatchItem, 0, mcts.batchSize)
-	mcts.valueQueueMutex.Unlock()
-
-	inputs := make([][]float32, len(batch))
-	for i, item := range batch {
-		inputs[i] = item.features
-	}
-
-	mcts.totalValueBatches++
-	outputs, err := mcts.valueClient.PredictBatch(ctx, inputs)
-
-	for i, item := range batch {
-		var value float32
-		if err != nil {
-			_, value, err = mcts.valueClient.Predict(ctx, item.features)
-			if err != nil {
-				value = 0
-			}
-		} else {
-			value = outputs[i].Value
-		}
-
-		select {
-		case item.resultCh <- value:
-		default:
+// GetStats returns performance statistics for the GPU-accelerated MCTS. The
+// batch figures cover every search sharing the dispatchers.
+func (mcts *GPUBatchedMCTS) GetStats() map[string]interface{} {
+	if mcts.evalDispatcher != nil {
+		evalStats := mcts.evalDispatcher.Stats()
+		return map[string]interface{}{
+			"total_simulations":     mcts.params.NumSimulations,
+			"total_eval_batches":    evalStats.Batches,
+			"total_nodes":           mcts.totalNodes,
+			"pipeline_collisions":   mcts.collisions,
+			"avg_eval_batch_size":   evalStats.AvgBatchSize,
+			"avg_eval_latency_us":   evalStats.AvgLatencyUs,
+			"eval_batch_fill":       evalStats.FillHistogram,
+			"eval_deadline_batches": evalStats.DeadlineBatches,
+			"eval_cache_hits":       evalStats.CacheHits,
 		}
 	}
-}
 
-// GetStats returns performance statistics for the GPU-accelerated MCTS
-func (mcts *GPUBatchedMCTS) GetStats() map[string]interface{} {
-	policyStats := mcts.policyClient.GetStats()
-	valueStats := mcts.valueClient.GetStats()
+	policyStats := mcts.policyDispatcher.Stats()
+	valueStats := mcts.valueDispatcher.Stats()
 
 	return map[string]interface{}{
-		"total_simulations":     mcts.params.NumSimulations,
-		"total_policy_batches":  mcts.totalPolicyBatches,
-		"total_value_batches":   mcts.totalValueBatches,
-		"total_nodes":           mcts.totalNodes,
-		"avg_policy_batch_size": float64(policyStats.TotalPositions) / float64(policyStats.TotalCalls),
-		"avg_value_batch_size":  float64(valueStats.TotalPositions) / float64(valueStats.TotalCalls),
-		"avg_policy_latency_us": policyStats.AvgLatencyUs,
-		"avg_value_latency_us":  valueStats.AvgLatencyUs,
+		"total_simulations":       mcts.params.NumSimulations,
+		"total_policy_batches":    policyStats.Batches,
+		"total_value_batches":     valueStats.Batches,
+		"total_nodes":             mcts.totalNodes,
+		"pipeline_collisions":     mcts.collisions,
+		"avg_policy_batch_size":   policyStats.AvgBatchSize,
+		"avg_value_batch_size":    valueStats.AvgBatchSize,
+		"avg_policy_latency_us":   policyStats.AvgLatencyUs,
+		"avg_value_latency_us":    valueStats.AvgLatencyUs,
+		"policy_batch_fill":       policyStats.FillHistogram,
+		"value_batch_fill":        valueStats.FillHistogram,
+		"policy_deadline_batches": policyStats.DeadlineBatches,
+		"value_deadline_batches":  valueStats.DeadlineBatches,
+		"policy_cache_hits":       policyStats.CacheHits,
+		"value_cache_hits":        valueStats.CacheHits,
 	}
 }
 
-// Close releases resources used by the GPU-accelerated MCTS
+// Close releases this search's reference to the shared dispatchers
 func (mcts *GPUBatchedMCTS) Close() {
-	mcts.policyClient.Close()
-	mcts.valueClient.Close()
+	for _, d := range mcts.dispatchers() {
+		d.Release()
+	}
 }
 
 // selectNode traverses the tree to find a node to evaluate
@@ -457,7 +417,7 @@ func (mcts *GPUBatchedMCTS) selectBestChild(node *MCTSNode) *MCTSNode {
 	return bestChild
 }
 
-// expandNode expands a node by creating one of its unexplored children
+// expandNode creates every unexplored child of a node, with priors from policy
 func (mcts *GPUBatchedMCTS) expandNode(node *MCTSNode, policy []float32) *MCTSNode {
 	legalMoves := node.State.GetLegalMoves()
 
@@ -480,7 +440,6 @@ func (mcts *GPUBatchedMCTS) expandNode(node *MCTSNode, policy []float32) *MCTSNo
 		existingMoves[childNode.Move.String()] = true
 	}
 
-	addedChild := false
 	for i, move := range legalMoves {
 		if !existingMoves[move.String()] {
 			childState := node.State.Clone()
@@ -495,14 +454,8 @@ func (mcts *GPUBatchedMCTS) expandNode(node *MCTSNode, policy []float32) *MCTSNo
 				Move:       move,
 			}
 			node.Children = append(node.Children, newChild)
-			addedChild = true
-			return newChild
 		}
 	}
-
-	if !addedChild && len(node.Children) > 0 {
-		return node
-	}
 	return node
 }
 
@@ -542,10 +495,17 @@ func (mcts *GPUBatchedMCTS) selectBestMove(ctx context.Context) game.RPSCardMove
 	return bestMove
 }
 
-// extractFeatures converts a game state to neural network input features
-func (mcts *GPUBatchedMCTS) extractFeatures(state *game.RPSCardGame) []float32 {
-	features := state.ToTensor()
-	return features
+// reserveRows makes sure n feature rows are free, carving any that are
+// missing from one new block
+func (mcts *GPUBatchedMCTS) reserveRows(n int) {
+	missing := n - len(mcts.rows)
+	if missing <= 0 {
+		return
+	}
+	block := make([]float32, missing*game.TensorSize)
+	for i := 0; i < missing; i++ {
+		mcts.rows = append(mcts.rows, block[i*game.TensorSize:(i+1)*game.TensorSize:(i+1)*game.TensorSize])
+	}
 }
 
 // makeUniformPolicy creates a uniform policy distribution
@@ -557,21 +517,3 @@ func makeUniformPolicy(size int) []float32 {
 	}
 	return policy
 }
-
-// toFloat32Slice converts a float64 slice to float32
-func toFloat32Slice(src []float64) []float32 {
-	dst := make([]float32, len(src))
-	for i, v := range src {
-		dst[i] = float32(v)
-	}
-	return dst
-}
-
-// toFloat64Slice converts a float32 slice to float64
-func toFloat64Slice(src []float32) []float64 {
-	dst := make([]float64, len(src))
-	for i, v := range src {
-		dst[i] = float64(v)
-	}
-	return dst
-}
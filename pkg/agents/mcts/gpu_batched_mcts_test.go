@@ -0,0 +1,251 @@
+package mcts
+
+import (
+	"context"
+	"math"
+	"sync/atomic"
+	"testing"
+	"time"
+
+	"github.com/zachbeta/neural_rps/pkg/game"
+	"github.com/zachbeta/neural_rps/pkg/neural/gpu"
+)
+
+const testHandSize = 3
+
+// featureBackend is a stand-in network whose outputs are a function of the
+// features alone: a policy with one entry per legal move of the encoded
+// position, and a value. A result applied to the wrong leaf, or computed
+// from a row overwritten while in flight, shows up as a prior or value that
+// does not match the node it ended up on.
+type featureBackend struct {
+	latency time.Duration
+	batches atomic.Int64
+	maxSize atomic.Int64
+}
+
+// legalMoveCount decodes the number of legal moves from a ToTensor encoding:
+// the mover's hand size times the empty positions
+func legalMoveCount(features []float32) int {
+	empty := 0
+	for pos := 0; pos < 9; pos++ {
+		empty += int(features[pos*6+3])
+	}
+	hand := features[56:59]
+	if features[55] == 1 {
+		hand = features[59:62]
+	}
+	cards := 0.0
+	for _, fraction := range hand {
+		cards += float64(fraction) * testHandSize
+	}
+	return int(math.Round(cards)) * empty
+}
+
+// featureOutputs is the response featureBackend gives for features
+func featureOutputs(features []float32) *gpu.NeuralResponse {
+	var mix float64
+	for i, v := range features {
+		mix += float64(v) * float64(i%7+1)
+	}
+
+	resp := &gpu.NeuralResponse{Value: float32(math.Sin(mix))}
+	if n := legalMoveCount(features); n > 0 {
+		resp.Probabilities = make([]float32, n)
+		var sum float32
+		for i := range resp.Probabilities {
+			resp.Probabilities[i] = float32(1 + math.Mod(mix*float64(i+1), 3))
+			sum += resp.Probabilities[i]
+		}
+		for i := range resp.Probabilities {
+			resp.Probabilities[i] /= sum
+		}
+	}
+	return resp
+}
+
+func (b *featureBackend) PredictBatch(ctx context.Context, batch [][]float32) ([]*gpu.NeuralResponse, error) {
+	b.batches.Add(1)
+	for size := int64(len(batch)); ; {
+		current := b.maxSize.Load()
+		if size <= current || b.maxSize.CompareAndSwap(current, size) {
+			break
+		}
+	}
+	time.Sleep(b.latency)
+
+	results := make([]*gpu.NeuralResponse, len(batch))
+	for i, features := range batch {
+		results[i] = featureOutputs(features)
+	}
+	return results, nil
+}
+
+func (b *featureBackend) Close() error { return nil }
+
+// newTestSearch returns a search over backend, fused or with separate
+// policy and value dispatchers
+func newTestSearch(backend gpu.BatchPredictor, fused bool, params MCTSParams) *GPUBatchedMCTS {
+	config := gpu.DefaultDispatcherConfig()
+	config.CacheEntries = 0
+	config.MaxWait = 100 * time.Microsecond
+	if fused {
+		return &GPUBatchedMCTS{
+			params:         params,
+			evalDispatcher: gpu.NewBatchDispatcher(backend, config),
+			batchSize:      config.MaxBatchSize,
+		}
+	}
+	return NewGPUBatchedMCTSWithDispatchers(
+		gpu.NewBatchDispatcher(backend, config),
+		gpu.NewBatchDispatcher(backend, config),
+		params)
+}
+
+func testParams(simulations int) MCTSParams {
+	params := DefaultMCTSParams()
+	params.NumSimulations = simulations
+	return params
+}
+
+// checkTree verifies every node against the backend it was evaluated with:
+// children's priors are the policy for the node's own position, no virtual
+// loss is left behind, and each node's value is its own evaluation less its
+// children's
+func checkTree(t *testing.T, node *MCTSNode) {
+	t.Helper()
+	if len(node.Children) == 0 {
+		return
+	}
+
+	want := featureOutputs(node.State.ToTensor())
+	childVisits := 0
+	childValue := 0.0
+	for i, child := range node.Children {
+		if child.Prior != want.Probabilities[i] {
+			t.Fatalf("Child %d has prior %g, the network gives %g for its parent", i, child.Prior, want.Probabilities[i])
+		}
+		childVisits += child.Visits
+		childValue += child.TotalValue
+		checkTree(t, child)
+	}
+
+	if node.Visits != childVisits+1 {
+		t.Fatalf("Node has %d visits, expected its own evaluation plus %d through its children", node.Visits, childVisits)
+	}
+	if own := node.TotalValue + childValue; math.Abs(own-float64(want.Value)) > 1e-5 {
+		t.Fatalf("Node's own evaluation contributes %g, the network gives %g", own, want.Value)
+	}
+}
+
+// sameTree reports whether two searches built identical trees
+func sameTree(a, b *MCTSNode) bool {
+	if a.Visits != b.Visits || math.Abs(a.TotalValue-b.TotalValue) > 1e-9 ||
+		a.Prior != b.Prior || a.Move != b.Move || len(a.Children) != len(b.Children) {
+		return false
+	}
+	for i := range a.Children {
+		if !sameTree(a.Children[i], b.Children[i]) {
+			return false
+		}
+	}
+	return true
+}
+
+func TestGPUBatchedMCTSMatchesSerial(t *testing.T) {
+	root := NewRPSGameStateAdapter(game.NewRPSCardGame(9, testHandSize, 9))
+	run := func(fused bool, pipelineDepth int) (*GPUBatchedMCTS, game.RPSCardMove) {
+		search := newTestSearch(&featureBackend{}, fused, testParams(200))
+		if pipelineDepth > 0 {
+			search.SetBatchSize(1)
+			search.SetPipelineDepth(pipelineDepth)
+		}
+		search.SetRootState(root)
+		move := search.Search(context.Background())
+		search.Close()
+		return search, move
+	}
+
+	serial, serialMove := run(false, 0)
+	checkTree(t, serial.root)
+
+	// A fused search gets policy and value from one request instead of
+	// pairing two, and a pipeline of one leaf goes through the pipeline's
+	// bookkeeping; neither may change what is searched
+	for _, variant := range []struct {
+		name          string
+		fused         bool
+		pipelineDepth int
+	}{
+		{"fused", true, 0},
+		{"pipeline of one", false, 1},
+		{"fused pipeline of one", true, 1},
+	} {
+		search, move := run(variant.fused, variant.pipelineDepth)
+		if move != serialMove {
+			t.Errorf("%s: search chose %v, serial %v", variant.name, move, serialMove)
+		}
+		if !sameTree(serial.root, search.root) {
+			t.Errorf("%s: search built a different tree from the serial one", variant.name)
+		}
+	}
+}
+
+func TestGPUBatchedMCTSPipelinedSearch(t *testing.T) {
+	for _, fused := range []bool{false, true} {
+		const simulations = 400
+		backend := &featureBackend{latency: 200 * time.Microsecond}
+		search := newTestSearch(backend, fused, testParams(simulations))
+		search.SetBatchSize(8)
+		search.SetPipelineDepth(3)
+		search.SetRootState(NewRPSGameStateAdapter(game.NewRPSCardGame(9, testHandSize, 9)))
+
+		move := search.Search(context.Background())
+		search.Close()
+
+		if search.root.Visits != simulations {
+			t.Errorf("fused=%t: root has %d visits after %d simulations", fused, search.root.Visits, simulations)
+		}
+		checkTree(t, search.root)
+		if err := search.root.State.(*RPSGameStateAdapter).Copy().MakeMove(move); err != nil {
+			t.Errorf("fused=%t: search chose an invalid move %v: %v", fused, move, err)
+		}
+
+		// The leaves really were pipelined into shared batches
+		if backend.maxSize.Load() < 2 {
+			t.Errorf("fused=%t: expected batches of more than one leaf, largest was %d", fused, backend.maxSize.Load())
+		}
+		leaves := int64(search.totalNodes)
+		if !fused {
+			leaves *= 2 // Each leaf goes to the policy and the value dispatcher
+		}
+		if backend.batches.Load() >= leaves {
+			t.Errorf("fused=%t: %d leaves took %d batches", fused, search.totalNodes, backend.batches.Load())
+		}
+
+		// Rows went back to the pool once their results were applied
+		if len(search.rows) != search.maxPendingLeaves() {
+			t.Errorf("fused=%t: %d feature rows free after the search, expected %d", fused, len(search.rows), search.maxPendingLeaves())
+		}
+	}
+}
+
+func TestGPUBatchedMCTSCancelledSearch(t *testing.T) {
+	backend := &featureBackend{latency: 20 * time.Millisecond}
+	search := newTestSearch(backend, true, testParams(1<<20))
+	search.SetBatchSize(4)
+	search.SetPipelineDepth(2)
+	search.SetRootState(NewRPSGameStateAdapter(game.NewRPSCardGame(9, testHandSize, 9)))
+
+	ctx, cancel := context.WithTimeout(context.Background(), 100*time.Millisecond)
+	defer cancel()
+	search.Search(ctx)
+	search.Close()
+
+	// Virtual loss on the leaves still in flight is taken back, so the tree
+	// only counts evaluations that were applied
+	checkTree(t, search.root)
+	if search.rows != nil {
+		t.Error("Expected the rows of abandoned leaves not to be reused")
+	}
+}
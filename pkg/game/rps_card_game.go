@@ -56,8 +56,26 @@ type RPSCardGame struct {
 	DeckSize      int            // Initial deck size
 	HandSize      int            // Initial hand size
 	LastMove      RPSCardMove    // Last move made (for MCTS)
+
+	// ToTensor encoding of the fields above, kept up to date by MakeMove
+	tensor      [TensorSize]float32
+	tensorValid bool
 }
 
+// TensorSize is the length of the ToTensor encoding
+const TensorSize = 64
+
+// BoardFeatureSize is the length of the GetBoardAsFeatures encoding
+const BoardFeatureSize = 81
+
+// Offsets of the non-board entries in the ToTensor encoding; position pos
+// uses the six entries from pos*6
+const (
+	tensorPlayer = 54 // Player1, Player2 to move
+	tensorHands  = 56 // Player1 then Player2 hand counts by card type, over HandSize
+	tensorRound  = 62 // Round over MaxRounds
+)
+
 // NewRPSCardGame creates a new RPS card game
 func NewRPSCardGame(deckSize, handSize, maxRounds int) *RPSCardGame {
 	game := &RPSCardGame{
@@ -84,6 +102,7 @@ func NewRPSCardGame(deckSize, handSize, maxRounds int) *RPSCardGame {
 		game.Player2Hand[i] = RPSCardType(rand.Intn(3))
 	}
 
+	game.encodeTensor()
 	return game
 }
 
@@ -108,6 +127,9 @@ func (g *RPSCardGame) Copy() *RPSCardGame {
 	gameCopy.Player2Hand = make([]RPSCardType, len(g.Player2Hand))
 	copy(gameCopy.Player2Hand, g.Player2Hand)
 
+	gameCopy.tensor = g.tensor
+	gameCopy.tensorValid = g.tensorValid
+
 	return gameCopy
 }
 
@@ -190,6 +212,7 @@ func (g *RPSCardGame) MakeMove(move RPSCardMove) error {
 	}
 
 	// Switch player
+	mover := g.CurrentPlayer
 	if g.CurrentPlayer == Player1 {
 		g.CurrentPlayer = Player2
 	} else {
@@ -197,6 +220,19 @@ func (g *RPSCardGame) MakeMove(move RPSCardMove) error {
 		g.Round++
 	}
 
+	// Only the played position, the mover's hand, the player to move and
+	// the round change, so only their tensor entries are rewritten
+	if g.tensorValid {
+		g.encodePosition(move.Position)
+		g.encodePlayer()
+		if mover == Player1 {
+			g.encodeHand(g.Player1Hand, g.tensor[tensorHands:tensorHands+3])
+		} else {
+			g.encodeHand(g.Player2Hand, g.tensor[tensorHands+3:tensorHands+6])
+		}
+		g.encodeRound()
+	}
+
 	return nil
 }
 
@@ -247,9 +283,19 @@ func (g *RPSCardGame) GetWinner() Player {
 
 // GetBoardAsFeatures returns the board state as a feature vector for neural network input
 func (g *RPSCardGame) GetBoardAsFeatures() []float64 {
+	features := make([]float64, BoardFeatureSize)
+	g.EncodeBoardFeatures(features)
+	return features
+}
+
+// EncodeBoardFeatures writes the GetBoardAsFeatures encoding into
+// dst[:BoardFeatureSize], such as a row of a caller-owned batch, instead of
+// allocating a new slice
+func (g *RPSCardGame) EncodeBoardFeatures(dst []float64) {
 	// Use the same format as the alphago_demo implementation
 	// 9 board positions * 9 possible states (3 card types * 3 ownership states) = 81 inputs
-	features := make([]float64, 81)
+	dst = dst[:BoardFeatureSize]
+	clear(dst)
 
 	for pos := 0; pos < 9; pos++ {
 		// Skip empty positions
@@ -268,10 +314,8 @@ func (g *RPSCardGame) GetBoardAsFeatures() []float64 {
 
 		// Set the feature
 		index := pos*9 + int(g.Board[pos]) + indexOffset
-		features[index] = 1.0
+		dst[index] = 1.0
 	}
-
-	return features
 }
 
 // String returns a string representation of the game
@@ -363,91 +407,93 @@ func (g *RPSCardGame) ApplyMove(move RPSCardMove) {
 
 // ToTensor converts the game state to a tensor representation for neural networks
 func (g *RPSCardGame) ToTensor() []float32 {
-	// Convert the board to a flat representation for the neural network
-	features := make([]float32, 0, 64) // Using 64 as a common size for neural input
+	features := make([]float32, TensorSize)
+	g.EncodeTensor(features)
+	return features
+}
+
+// EncodeTensor writes the ToTensor encoding into dst[:TensorSize], such as a
+// row of a caller-owned batch tensor. The encoding is maintained as moves
+// are made, so this is a copy rather than a pass over the game.
+//
+// After InvalidateTensor, or for a game not made by NewRPSCardGame, the next
+// call rebuilds the encoding and stores it in the game. EncodeTensor and
+// ToTensor can therefore write to the game, so a game shared between
+// goroutines must not be encoded concurrently without synchronisation.
+func (g *RPSCardGame) EncodeTensor(dst []float32) {
+	if !g.tensorValid {
+		g.encodeTensor()
+	}
+	copy(dst[:TensorSize], g.tensor[:])
+}
+
+// InvalidateTensor discards the maintained ToTensor encoding. Call it after
+// changing the game's fields directly rather than through MakeMove.
+func (g *RPSCardGame) InvalidateTensor() {
+	g.tensorValid = false
+}
 
-	// Board state (27 features: 9 positions x 3 states per position)
+// encodeTensor rebuilds the whole ToTensor encoding
+func (g *RPSCardGame) encodeTensor() {
+	// Board state (54 features: 9 positions x card type, empty and ownership)
 	for pos := 0; pos < 9; pos++ {
-		// One-hot encoding for each position
-		isRock := 0.0
-		isPaper := 0.0
-		isScissors := 0.0
-		isEmpty := 1.0
-
-		if g.BoardOwner[pos] != NoPlayer {
-			isEmpty = 0.0
-			if g.Board[pos] == Rock {
-				isRock = 1.0
-			} else if g.Board[pos] == Paper {
-				isPaper = 1.0
-			} else if g.Board[pos] == Scissors {
-				isScissors = 1.0
-			}
-		}
+		g.encodePosition(pos)
+	}
+	g.encodePlayer()
+	g.encodeHand(g.Player1Hand, g.tensor[tensorHands:tensorHands+3])
+	g.encodeHand(g.Player2Hand, g.tensor[tensorHands+3:tensorHands+6])
+	g.encodeRound()
+
+	// Pad to TensorSize features
+	clear(g.tensor[tensorRound+1:])
+	g.tensorValid = true
+}
 
-		// Add ownership information
-		isPlayer1 := 0.0
-		isPlayer2 := 0.0
-		if g.BoardOwner[pos] == Player1 {
-			isPlayer1 = 1.0
-		} else if g.BoardOwner[pos] == Player2 {
-			isPlayer2 = 1.0
-		}
+// encodePosition writes position pos: one-hot card type, whether it is
+// empty, and one-hot ownership
+func (g *RPSCardGame) encodePosition(pos int) {
+	cell := g.tensor[pos*6 : pos*6+6]
+	clear(cell)
 
-		features = append(features, float32(isRock), float32(isPaper), float32(isScissors))
-		features = append(features, float32(isEmpty), float32(isPlayer1), float32(isPlayer2))
+	switch g.BoardOwner[pos] {
+	case NoPlayer:
+		cell[3] = 1.0
+		return
+	case Player1:
+		cell[4] = 1.0
+	case Player2:
+		cell[5] = 1.0
+	}
+	if t := g.Board[pos]; t >= Rock && t <= Scissors {
+		cell[t] = 1.0
 	}
+}
 
-	// Current player
+// encodePlayer writes the player to move, one-hot
+func (g *RPSCardGame) encodePlayer() {
 	if g.CurrentPlayer == Player1 {
-		features = append(features, 1.0, 0.0)
+		g.tensor[tensorPlayer], g.tensor[tensorPlayer+1] = 1.0, 0.0
 	} else {
-		features = append(features, 0.0, 1.0)
+		g.tensor[tensorPlayer], g.tensor[tensorPlayer+1] = 0.0, 1.0
 	}
+}
 
-	// Player 1 hand (one-hot encoding for each card type)
-	rockCount := 0
-	paperCount := 0
-	scissorsCount := 0
-	for _, card := range g.Player1Hand {
-		if card == Rock {
-			rockCount++
-		} else if card == Paper {
-			paperCount++
-		} else if card == Scissors {
-			scissorsCount++
+// encodeHand writes how many of each card type hand holds, over HandSize
+func (g *RPSCardGame) encodeHand(hand []RPSCardType, dst []float32) {
+	var counts [3]int
+	for _, card := range hand {
+		if card >= Rock && card <= Scissors {
+			counts[card]++
 		}
 	}
-	features = append(features, float32(rockCount)/float32(g.HandSize))
-	features = append(features, float32(paperCount)/float32(g.HandSize))
-	features = append(features, float32(scissorsCount)/float32(g.HandSize))
-
-	// Player 2 hand (one-hot encoding for each card type)
-	rockCount = 0
-	paperCount = 0
-	scissorsCount = 0
-	for _, card := range g.Player2Hand {
-		if card == Rock {
-			rockCount++
-		} else if card == Paper {
-			paperCount++
-		} else if card == Scissors {
-			scissorsCount++
-		}
-	}
-	features = append(features, float32(rockCount)/float32(g.HandSize))
-	features = append(features, float32(paperCount)/float32(g.HandSize))
-	features = append(features, float32(scissorsCount)/float32(g.HandSize))
-
-	// Round information
-	features = append(features, float32(g.Round)/float32(g.MaxRounds))
-
-	// Pad to 64 features if needed
-	for len(features) < 64 {
-		features = append(features, 0.0)
+	for t, count := range counts {
+		dst[t] = float32(count) / float32(g.HandSize)
 	}
+}
 
-	return features
+// encodeRound writes the round as a fraction of MaxRounds
+func (g *RPSCardGame) encodeRound() {
+	g.tensor[tensorRound] = float32(g.Round) / float32(g.MaxRounds)
 }
 
 // GetLastMove returns the last move made in the game
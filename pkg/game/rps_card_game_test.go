@@ -0,0 +1,99 @@
+package game
+
+import (
+	"math/rand"
+	"testing"
+)
+
+// freshTensor returns g's ToTensor encoding rebuilt from its fields, without
+// touching g's own copy
+func freshTensor(g *RPSCardGame) [TensorSize]float32 {
+	rebuilt := g.Copy()
+	rebuilt.encodeTensor()
+	return rebuilt.tensor
+}
+
+func encoded(g *RPSCardGame) [TensorSize]float32 {
+	var dst [TensorSize]float32
+	g.EncodeTensor(dst[:])
+	return dst
+}
+
+func randomMove(rng *rand.Rand, g *RPSCardGame) RPSCardMove {
+	moves := g.GetValidMoves()
+	return moves[rng.Intn(len(moves))]
+}
+
+func TestEncodeTensorAfterMoves(t *testing.T) {
+	rng := rand.New(rand.NewSource(1))
+	for _, size := range []struct{ deck, hand, rounds int }{{9, 3, 9}, {21, 5, 10}, {9, 3, 2}} {
+		for game := 0; game < 50; game++ {
+			g := NewRPSCardGame(size.deck, size.hand, size.rounds)
+			for ply := 0; !g.IsGameOver(); ply++ {
+				if err := g.MakeMove(randomMove(rng, g)); err != nil {
+					t.Fatal(err)
+				}
+				if got, want := encoded(g), freshTensor(g); got != want {
+					t.Fatalf("Game %d ply %d: incremental tensor\n%v\nexpected\n%v", game, ply, got, want)
+				}
+			}
+		}
+	}
+}
+
+func TestCopyKeepsTensorValid(t *testing.T) {
+	rng := rand.New(rand.NewSource(2))
+	g := NewRPSCardGame(9, 3, 9)
+	g.MakeMove(randomMove(rng, g))
+	before := encoded(g)
+
+	// The copy carries the maintained encoding and updates its own
+	c := g.Copy()
+	if !c.tensorValid || encoded(c) != before {
+		t.Fatal("Expected a copy to keep the original's valid encoding")
+	}
+	for !c.IsGameOver() {
+		c.MakeMove(randomMove(rng, c))
+		if got, want := encoded(c), freshTensor(c); got != want {
+			t.Fatalf("Copy's incremental tensor\n%v\nexpected\n%v", got, want)
+		}
+	}
+	if encoded(g) != before || freshTensor(g) != before {
+		t.Error("Expected moves on the copy to leave the original's encoding alone")
+	}
+
+	// A copy of a game whose encoding was invalidated rebuilds its own
+	g.InvalidateTensor()
+	c = g.Copy()
+	if got := encoded(c); got != before || !c.tensorValid {
+		t.Errorf("Expected the copy to rebuild the encoding, got\n%v", got)
+	}
+}
+
+func TestInvalidateTensor(t *testing.T) {
+	g := NewRPSCardGame(9, 3, 9)
+	before := encoded(g)
+
+	// Changing fields directly leaves the maintained encoding stale until
+	// it is invalidated
+	g.Round = 4
+	g.Board[4], g.BoardOwner[4] = Paper, Player2
+	if encoded(g) != before {
+		t.Fatal("Expected the encoding to be maintained only by MakeMove")
+	}
+	g.InvalidateTensor()
+	if got, want := encoded(g), freshTensor(g); got != want || got == before {
+		t.Errorf("Expected the encoding to be rebuilt after InvalidateTensor, got\n%v\nexpected\n%v", got, want)
+	}
+
+	// ToTensor is the same encoding, freshly allocated
+	tensor := g.ToTensor()
+	if len(tensor) != TensorSize {
+		t.Fatalf("Expected %d features, got %d", TensorSize, len(tensor))
+	}
+	for i, v := range encoded(g) {
+		if tensor[i] != v {
+			t.Fatalf("ToTensor feature %d is %g, EncodeTensor gives %g", i, tensor[i], v)
+		}
+	}
+}
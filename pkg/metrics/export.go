@@ -0,0 +1,41 @@
+package metrics
+
+import (
+	"bufio"
+	"fmt"
+	"io"
+	"net/http"
+	"strconv"
+)
+
+// exportedQuantiles are the quantiles a histogram exports
+var exportedQuantiles = []float64{0.5, 0.9, 0.99, 0.999}
+
+// WritePrometheus writes every registered histogram in the Prometheus text
+// exposition format, as a summary sorted by name. Quantiles are over
+// everything recorded since the process started, so recent behaviour is
+// read from rate() of _sum and _count.
+func WritePrometheus(w io.Writer) error {
+	bw := bufio.NewWriter(w)
+	for _, h := range registered() {
+		snap := h.Snapshot()
+		fmt.Fprintf(bw, "# HELP %s %s\n# TYPE %s summary\n", h.name, h.help, h.name)
+		for _, q := range exportedQuantiles {
+			fmt.Fprintf(bw, "%s{quantile=\"%s\"} %s\n", h.name, formatFloat(q), formatFloat(snap.Quantile(q)))
+		}
+		fmt.Fprintf(bw, "%s_sum %s\n%s_count %d\n", h.name, formatFloat(snap.Sum()), h.name, snap.Count)
+	}
+	return bw.Flush()
+}
+
+func formatFloat(v float64) string {
+	return strconv.FormatFloat(v, 'g', -1, 64)
+}
+
+// Handler serves the registered histograms to Prometheus scrapes
+func Handler() http.Handler {
+	return http.HandlerFunc(func(w http.ResponseWriter, req *http.Request) {
+		w.Header().Set("Content-Type", "text/plain; version=0.0.4; charset=utf-8")
+		WritePrometheus(w)
+	})
+}
@@ -0,0 +1,140 @@
+// Package metrics records latency distributions for the root module's network
+// clients and exports them in the Prometheus text format.
+//
+// It is deliberately small: duration histograms only, registered once as
+// package variables and exported together by WritePrometheus or Handler.
+package metrics
+
+import (
+	"fmt"
+	"math/bits"
+	"sort"
+	"sync"
+	"sync/atomic"
+	"time"
+)
+
+// Buckets are log-linear, as in HDR histograms: durations below subBuckets
+// nanoseconds have a bucket each, and every power of two above is split into
+// subBuckets equal buckets, so a recorded duration is known to within
+// 1/subBuckets of itself at any magnitude
+const (
+	subBucketBits = 3
+	subBuckets    = 1 << subBucketBits
+	numBuckets    = (64 - subBucketBits + 1) * subBuckets
+)
+
+// bucketOf returns the bucket holding v
+func bucketOf(v uint64) int {
+	if v < subBuckets {
+		return int(v)
+	}
+	shift := bits.Len64(v) - subBucketBits - 1
+	return (shift+1)*subBuckets + int(v>>shift&(subBuckets-1))
+}
+
+// bucketBounds returns the smallest and largest values bucket i holds
+func bucketBounds(i int) (lo, hi uint64) {
+	if i < subBuckets {
+		return uint64(i), uint64(i)
+	}
+	shift := i/subBuckets - 1
+	lo = uint64(subBuckets+i%subBuckets) << shift
+	return lo, lo + (1 << shift) - 1
+}
+
+// Histogram records the distribution of a latency. ObserveDuration costs
+// three atomic adds, so it can run per network call or per queued request.
+type Histogram struct {
+	name, help string
+	counts     [numBuckets]atomic.Uint64
+	count      atomic.Uint64
+	sumNs      atomic.Uint64
+}
+
+var (
+	registryMu sync.Mutex
+	registry   = make(map[string]*Histogram)
+)
+
+// NewDurationHistogram registers a histogram of durations, exported in
+// seconds. Its name should end in _seconds. Names are fixed in the code, so
+// registering one twice panics.
+func NewDurationHistogram(name, help string) *Histogram {
+	registryMu.Lock()
+	defer registryMu.Unlock()
+	if _, ok := registry[name]; ok {
+		panic(fmt.Sprintf("metrics: %s registered twice", name))
+	}
+	h := &Histogram{name: name, help: help}
+	registry[name] = h
+	return h
+}
+
+// registered returns every histogram, sorted by name
+func registered() []*Histogram {
+	registryMu.Lock()
+	defer registryMu.Unlock()
+	hs := make([]*Histogram, 0, len(registry))
+	for _, h := range registry {
+		hs = append(hs, h)
+	}
+	sort.Slice(hs, func(i, j int) bool { return hs[i].name < hs[j].name })
+	return hs
+}
+
+// ObserveDuration records d
+func (h *Histogram) ObserveDuration(d time.Duration) {
+	v := uint64(max(d, 0))
+	h.counts[bucketOf(v)].Add(1)
+	h.count.Add(1)
+	h.sumNs.Add(v)
+}
+
+// Since records the time elapsed since start
+func (h *Histogram) Since(start time.Time) {
+	h.ObserveDuration(time.Since(start))
+}
+
+// Snapshot returns the distribution recorded so far
+func (h *Histogram) Snapshot() HistogramSnapshot {
+	var snap HistogramSnapshot
+	for i := range h.counts {
+		if n := h.counts[i].Load(); n > 0 {
+			snap.counts[i] = n
+			snap.Count += n
+		}
+	}
+	snap.sumNs = h.sumNs.Load()
+	return snap
+}
+
+// HistogramSnapshot is a Histogram's distribution at one point in time
+type HistogramSnapshot struct {
+	Count  uint64 // Durations recorded
+	sumNs  uint64
+	counts [numBuckets]uint64
+}
+
+// Sum returns the total of the recorded durations, in seconds
+func (s *HistogramSnapshot) Sum() float64 {
+	return float64(s.sumNs) / 1e9
+}
+
+// Quantile returns the q-quantile (0 <= q <= 1) of the recorded durations in
+// seconds: the midpoint of the bucket holding it, or 0 if there are none
+func (s *HistogramSnapshot) Quantile(q float64) float64 {
+	if s.Count == 0 {
+		return 0
+	}
+	rank := uint64(q*float64(s.Count-1)) + 1
+	var seen uint64
+	for i, n := range s.counts {
+		seen += n
+		if seen >= rank {
+			lo, hi := bucketBounds(i)
+			return (float64(lo) + float64(hi-lo)/2) / 1e9
+		}
+	}
+	return 0
+}
@@ -0,0 +1,87 @@
+package metrics
+
+import (
+	"math"
+	"net/http/httptest"
+	"strings"
+	"sync"
+	"testing"
+	"time"
+)
+
+func TestBucketBounds(t *testing.T) {
+	for i := 0; i < numBuckets; i++ {
+		lo, hi := bucketBounds(i)
+		if bucketOf(lo) != i || bucketOf(hi) != i {
+			t.Fatalf("Bucket %d holds [%d, %d], but they map to buckets %d and %d", i, lo, hi, bucketOf(lo), bucketOf(hi))
+		}
+		if i > 0 {
+			if _, prevHi := bucketBounds(i - 1); prevHi+1 != lo {
+				t.Fatalf("Bucket %d starts at %d, expected %d", i, lo, prevHi+1)
+			}
+		}
+	}
+}
+
+func TestHistogramQuantiles(t *testing.T) {
+	h := &Histogram{name: "test_seconds"}
+	for v := 1; v <= 1000; v++ {
+		h.ObserveDuration(time.Duration(v) * time.Microsecond)
+	}
+
+	snap := h.Snapshot()
+	if snap.Count != 1000 || math.Abs(snap.Sum()-0.5005) > 1e-9 {
+		t.Fatalf("Expected 1000 durations summing to 0.5005s, got %d summing to %f", snap.Count, snap.Sum())
+	}
+	for _, q := range []float64{0.5, 0.9, 0.99} {
+		want := q * 1e-3
+		if got := snap.Quantile(q); math.Abs(got-want) > want/subBuckets {
+			t.Errorf("Quantile %.2f is %g, expected within 1/%d of %g", q, got, subBuckets, want)
+		}
+	}
+}
+
+func TestConcurrentObserve(t *testing.T) {
+	h := &Histogram{name: "test_seconds"}
+	var wg sync.WaitGroup
+	for g := 0; g < 8; g++ {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			for i := 0; i < 1000; i++ {
+				h.ObserveDuration(time.Microsecond)
+			}
+		}()
+	}
+	wg.Wait()
+	if snap := h.Snapshot(); snap.Count != 8000 {
+		t.Errorf("Expected 8000 durations, got %d", snap.Count)
+	}
+}
+
+func TestPrometheusExport(t *testing.T) {
+	h := NewDurationHistogram("metrics_test_wait_seconds", "Test wait")
+	h.ObserveDuration(2 * time.Millisecond)
+
+	rec := httptest.NewRecorder()
+	Handler().ServeHTTP(rec, httptest.NewRequest("GET", "/metrics", nil))
+	body := rec.Body.String()
+	for _, want := range []string{
+		"# HELP metrics_test_wait_seconds Test wait\n",
+		"# TYPE metrics_test_wait_seconds summary\n",
+		"metrics_test_wait_seconds{quantile=\"0.99\"} 0.002",
+		"metrics_test_wait_seconds_sum 0.002\n",
+		"metrics_test_wait_seconds_count 1\n",
+	} {
+		if !strings.Contains(body, want) {
+			t.Errorf("Expected %q in the export, got\n%s", want, body)
+		}
+	}
+
+	defer func() {
+		if recover() == nil {
+			t.Error("Expected registering a name twice to panic")
+		}
+	}()
+	NewDurationHistogram("metrics_test_wait_seconds", "")
+}
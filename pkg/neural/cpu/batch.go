@@ -0,0 +1,197 @@
+package cpu
+
+import "math"
+
+// hiddenTile is the number of output neurons processed per pass over the
+// batch. A hiddenTile x inputSize strip of the packed weights (~20 KB for the
+// 81-input policy network in float64) stays resident in L1 while every block
+// of batch rows is multiplied against it.
+const hiddenTile = 32
+
+// rowBlock is the number of batch rows accumulated together in registers, so
+// each weight loaded from the panel feeds rowBlock multiply-adds
+const rowBlock = 4
+
+// Float is the element type supported by the batched kernels
+type Float interface {
+	~float32 | ~float64
+}
+
+// packedWeights holds a two-layer network's weights transposed into
+// neuron-major panels: row j of w1T is the input weights of hidden neuron j,
+// laid out contiguously, which is the access pattern of the batched kernel.
+type packedWeights[T Float] struct {
+	inputSize  int
+	hiddenSize int
+	outputSize int
+	w1T        []T // hiddenSize x inputSize
+	b1         []T
+	w2T        []T // outputSize x hiddenSize
+	b2         []T
+}
+
+// packWeights transposes input-major weight matrices (w[i][j] = weight from
+// input i to neuron j) into packed panels of type T
+func packWeights[T Float](w1 [][]float64, b1 []float64, w2 [][]float64, b2 []float64) *packedWeights[T] {
+	inputSize, hiddenSize, outputSize := len(w1), len(b1), len(b2)
+	return &packedWeights[T]{
+		inputSize:  inputSize,
+		hiddenSize: hiddenSize,
+		outputSize: outputSize,
+		w1T:        transposePanel[T](w1, hiddenSize),
+		b1:         convertVector[T](b1),
+		w2T:        transposePanel[T](w2, outputSize),
+		b2:         convertVector[T](b2),
+	}
+}
+
+// forward runs the ReLU hidden layer and softmax output layer on a batch of
+// inputs. It allocates one flat hidden buffer and one flat output buffer per
+// call regardless of batch size.
+func (p *packedWeights[T]) forward(inputs [][]T) [][]T {
+	hidden := make([]T, len(inputs)*p.hiddenSize)
+	dense(inputs, p.w1T, p.b1, hidden, p.hiddenSize)
+	applyReLU(hidden)
+
+	output := make([]T, len(inputs)*p.outputSize)
+	dense(rowViews(hidden, p.hiddenSize), p.w2T, p.b2, output, p.outputSize)
+	softmaxRows(output, p.outputSize)
+
+	return rowViews(output, p.outputSize)
+}
+
+// gemmPanel computes out[b*n+j] = bias[j] + dot(in[b], wT[j*k:(j+1)*k]) for
+// every batch row b and neuron j, where k = len(in[b]).
+//
+// The loop nest is (neuron tile, block of rowBlock batch rows, neuron, k): the
+// weight strip for a tile is reused by every batch row while it is hot in L1,
+// and the rowBlock partial sums live in registers for the whole dot product.
+func gemmPanel[T Float](in [][]T, wT []T, bias []T, out []T, n int) {
+	batch := len(in)
+	if batch == 0 {
+		return
+	}
+	k := len(wT) / n
+
+	for j0 := 0; j0 < n; j0 += hiddenTile {
+		j1 := j0 + hiddenTile
+		if j1 > n {
+			j1 = n
+		}
+
+		b := 0
+		for ; b+rowBlock <= batch; b += rowBlock {
+			x0, x1, x2, x3 := in[b][:k], in[b+1][:k], in[b+2][:k], in[b+3][:k]
+			o0, o1, o2, o3 := out[b*n:], out[(b+1)*n:], out[(b+2)*n:], out[(b+3)*n:]
+
+			for j := j0; j < j1; j++ {
+				row := wT[j*k : (j+1)*k]
+				s0, s1, s2, s3 := bias[j], bias[j], bias[j], bias[j]
+				for i, w := range row {
+					s0 += x0[i] * w
+					s1 += x1[i] * w
+					s2 += x2[i] * w
+					s3 += x3[i] * w
+				}
+				o0[j], o1[j], o2[j], o3[j] = s0, s1, s2, s3
+			}
+		}
+
+		// Remaining rows that don't fill a block
+		for ; b < batch; b++ {
+			x := in[b][:k]
+			o := out[b*n:]
+			for j := j0; j < j1; j++ {
+				row := wT[j*k : (j+1)*k]
+				s := bias[j]
+				for i, w := range row {
+					s += x[i] * w
+				}
+				o[j] = s
+			}
+		}
+	}
+}
+
+// dense runs gemmPanel, routing float32 through the vectorized kernels
+func dense[T Float](in [][]T, wT []T, bias []T, out []T, n int) {
+	if in32, ok := any(in).([][]float32); ok {
+		gemmPanelF32(in32, any(wT).([]float32), any(bias).([]float32), any(out).([]float32), n)
+		return
+	}
+	gemmPanel(in, wT, bias, out, n)
+}
+
+// applyReLU is reluInPlace, routing float32 through the vectorized kernel
+func applyReLU[T Float](values []T) {
+	if v32, ok := any(values).([]float32); ok {
+		reluF32(v32)
+		return
+	}
+	reluInPlace(values)
+}
+
+// reluInPlace applies ReLU to every element of values
+func reluInPlace[T Float](values []T) {
+	for i, v := range values {
+		if v < 0 {
+			values[i] = 0
+		}
+	}
+}
+
+// softmaxRows applies softmax independently to each row of a flat batch*n buffer
+func softmaxRows[T Float](values []T, n int) {
+	for off := 0; off+n <= len(values); off += n {
+		row := values[off : off+n]
+
+		max := row[0]
+		for _, v := range row {
+			if v > max {
+				max = v
+			}
+		}
+
+		var sum T
+		for i, v := range row {
+			e := T(math.Exp(float64(v - max)))
+			row[i] = e
+			sum += e
+		}
+
+		for i := range row {
+			row[i] /= sum
+		}
+	}
+}
+
+// rowViews splits a flat batch*n buffer into per-row slices without copying
+func rowViews[T Float](flat []T, n int) [][]T {
+	rows := make([][]T, len(flat)/n)
+	for b := range rows {
+		rows[b] = flat[b*n : (b+1)*n : (b+1)*n]
+	}
+	return rows
+}
+
+// transposePanel converts an input-major matrix (len(w) rows of width n) into
+// a flat neuron-major panel of n rows of width len(w)
+func transposePanel[T Float](w [][]float64, n int) []T {
+	k := len(w)
+	panel := make([]T, n*k)
+	for i, row := range w {
+		for j := 0; j < n; j++ {
+			panel[j*k+i] = T(row[j])
+		}
+	}
+	return panel
+}
+
+// convertVector copies a float64 vector into element type T
+func convertVector[T Float](v []float64) []T {
+	out := make([]T, len(v))
+	for i, x := range v {
+		out[i] = T(x)
+	}
+	return out
+}
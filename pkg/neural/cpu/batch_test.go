@@ -0,0 +1,139 @@
+package cpu
+
+import (
+	"math"
+	"math/rand"
+	"sync"
+	"testing"
+)
+
+// randomInputs returns n inputs of the given size with values in [-1, 1)
+func randomInputs(rng *rand.Rand, n, size int) [][]float64 {
+	inputs := make([][]float64, n)
+	for i := range inputs {
+		inputs[i] = make([]float64, size)
+		for j := range inputs[i] {
+			inputs[i][j] = rng.Float64()*2 - 1
+		}
+	}
+	return inputs
+}
+
+func assertClose(t *testing.T, what string, got, want []float64, tol float64) {
+	t.Helper()
+	if len(got) != len(want) {
+		t.Fatalf("%s: got %d outputs, expected %d", what, len(got), len(want))
+	}
+	for i := range want {
+		if math.Abs(got[i]-want[i]) > tol {
+			t.Fatalf("%s: output %d is %g, expected %g", what, i, got[i], want[i])
+		}
+	}
+}
+
+func TestNetworkForwardBatchMatchesForward(t *testing.T) {
+	rng := rand.New(rand.NewSource(1))
+	nn := NewNetwork(81, 40, 9)
+
+	// Batch sizes around the 4-row block, and one spanning several neuron tiles
+	for _, batch := range []int{1, 3, 4, 5, 9, 64} {
+		inputs := randomInputs(rng, batch, nn.InputSize)
+		outputs, err := nn.ForwardBatch(inputs)
+		if err != nil {
+			t.Fatal(err)
+		}
+		for i, input := range inputs {
+			want, _ := nn.Forward(input)
+			assertClose(t, "ForwardBatch", outputs[i], want, 1e-12)
+		}
+	}
+}
+
+func TestPolicyNetworkForwardBatchMatchesForward(t *testing.T) {
+	rng := rand.New(rand.NewSource(2))
+	n, err := NewRPSCPUPolicyNetwork(81, 40, 9)
+	if err != nil {
+		t.Fatal(err)
+	}
+
+	inputs := randomInputs(rng, 13, n.InputSize)
+	outputs, err := n.ForwardBatch(inputs)
+	if err != nil {
+		t.Fatal(err)
+	}
+	for i, input := range inputs {
+		want, _ := n.Forward(input)
+		assertClose(t, "ForwardBatch", outputs[i], want, 1e-12)
+	}
+}
+
+func TestPackWeightsPicksUpWeightChanges(t *testing.T) {
+	rng := rand.New(rand.NewSource(3))
+	nn := NewNetwork(16, 8, 3)
+	input := randomInputs(rng, 1, nn.InputSize)
+
+	for i := range nn.Weights1 {
+		for j := range nn.Weights1[i] {
+			nn.Weights1[i][j] = rng.Float64()*2 - 1
+		}
+	}
+	nn.Bias2[0] += 1
+	nn.PackWeights()
+
+	outputs, _ := nn.ForwardBatch(input)
+	want, _ := nn.Forward(input[0])
+	assertClose(t, "ForwardBatch after PackWeights", outputs[0], want, 1e-12)
+}
+
+func TestForwardBatchStructLiteral(t *testing.T) {
+	// A network assembled without the constructor packs on first use
+	src := NewNetwork(10, 6, 3)
+	nn := &Network{
+		InputSize: src.InputSize, HiddenSize: src.HiddenSize, OutputSize: src.OutputSize,
+		Weights1: src.Weights1, Bias1: src.Bias1, Weights2: src.Weights2, Bias2: src.Bias2,
+	}
+
+	input := randomInputs(rand.New(rand.NewSource(4)), 1, nn.InputSize)
+	outputs, err := nn.ForwardBatch(input)
+	if err != nil {
+		t.Fatal(err)
+	}
+	want, _ := nn.Forward(input[0])
+	assertClose(t, "ForwardBatch", outputs[0], want, 1e-12)
+}
+
+func TestForwardBatchConcurrent(t *testing.T) {
+	rng := rand.New(rand.NewSource(5))
+	nn := NewNetwork(81, 32, 9)
+	policy, _ := NewRPSCPUPolicyNetwork(81, 32, 9)
+	inputs := randomInputs(rng, 8, 81)
+	inputs32 := toFloat32Rows(inputs)
+
+	// Batches racing each other and a repack; run with -race
+	var wg sync.WaitGroup
+	for g := 0; g < 4; g++ {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			for i := 0; i < 20; i++ {
+				nn.ForwardBatch(inputs)
+				policy.ForwardBatch(inputs)
+				policy.ForwardBatchFloat32(inputs32)
+			}
+		}()
+	}
+	nn.PackWeights()
+	policy.PackWeights()
+	wg.Wait()
+}
+
+func toFloat32Rows(rows [][]float64) [][]float32 {
+	out := make([][]float32, len(rows))
+	for i, row := range rows {
+		out[i] = make([]float32, len(row))
+		for j, v := range row {
+			out[i][j] = float32(v)
+		}
+	}
+	return out
+}
@@ -4,6 +4,7 @@ import (
 	"errors"
 	"math"
 	"math/rand"
+	"sync/atomic"
 
 	"github.com/zachbeta/neural_rps/pkg/common"
 )
@@ -17,6 +18,10 @@ type Network struct {
 	Bias1      []float64
 	Weights2   [][]float64
 	Bias2      []float64
+
+	// Transposed weight panel for ForwardBatch, swapped atomically so batches
+	// can run concurrently with each other and with PackWeights
+	packed atomic.Pointer[packedWeights[float64]]
 }
 
 // NewNetwork creates a new neural network with the given layer sizes
@@ -48,6 +53,7 @@ func NewNetwork(inputSize, hiddenSize, outputSize int) *Network {
 		}
 	}
 
+	nn.PackWeights()
 	return nn
 }
 
@@ -123,37 +129,50 @@ func (nn *Network) Predict(input []float64) (int, error) {
 	return maxIdx, nil
 }
 
-// ForwardBatch runs a forward pass for a batch of inputs
+// ForwardBatch runs a forward pass for a batch of inputs using the tiled
+// matrix-matrix kernel, on the weights as of the last PackWeights. It is safe
+// for concurrent use.
 func (nn *Network) ForwardBatch(inputs [][]float64) ([][]float64, error) {
 	if len(inputs) == 0 {
 		return nil, errors.New("empty batch")
 	}
-
-	outputs := make([][]float64, len(inputs))
-	for i, input := range inputs {
-		output, err := nn.Forward(input)
-		if err != nil {
-			return nil, err
+	for _, input := range inputs {
+		if len(input) != nn.InputSize {
+			return nil, errors.New("input size mismatch")
 		}
-		outputs[i] = output
 	}
 
-	return outputs, nil
+	return nn.panel().forward(inputs), nil
+}
+
+// PackWeights rebuilds the transposed weight panel used by ForwardBatch. Call
+// it after changing Weights1, Bias1, Weights2 or Bias2; batches already
+// running finish on the old panel.
+func (nn *Network) PackWeights() {
+	nn.packed.Store(packWeights[float64](nn.Weights1, nn.Bias1, nn.Weights2, nn.Bias2))
+}
+
+// panel returns the current packed panel. A network built as a struct
+// literal rather than by NewNetwork packs on first use; concurrent first
+// batches may each pack, and the panels are identical.
+func (nn *Network) panel() *packedWeights[float64] {
+	if p := nn.packed.Load(); p != nil {
+		return p
+	}
+	nn.packed.CompareAndSwap(nil, packWeights[float64](nn.Weights1, nn.Bias1, nn.Weights2, nn.Bias2))
+	return nn.packed.Load()
 }
 
 // PredictBatch returns the index of the highest output value for a batch of inputs
 func (nn *Network) PredictBatch(inputs [][]float64) ([]int, error) {
-	if len(inputs) == 0 {
-		return nil, errors.New("empty batch")
+	outputs, err := nn.ForwardBatch(inputs)
+	if err != nil {
+		return nil, err
 	}
 
-	predictions := make([]int, len(inputs))
-	for i, input := range inputs {
-		prediction, err := nn.Predict(input)
-		if err != nil {
-			return nil, err
-		}
-		predictions[i] = prediction
+	predictions := make([]int, len(outputs))
+	for i, output := range outputs {
+		predictions[i] = argmax(output)
 	}
 
 	return predictions, nil
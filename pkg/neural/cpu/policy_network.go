@@ -4,6 +4,7 @@ import (
 	"fmt"
 	"math"
 	"math/rand"
+	"sync/atomic"
 	"time"
 )
 
@@ -20,10 +21,21 @@ type RPSCPUPolicyNetwork struct {
 	Weights2 [][]float64
 	Bias2    []float64
 
+	// Transposed weight panels for the batched kernels, swapped atomically
+	// so batches can run concurrently with each other and with PackWeights
+	packed atomic.Pointer[policyPanels]
+
 	// Performance metrics
-	totalTime      time.Duration
-	totalCalls     int
-	totalBatchSize int
+	totalTime      atomic.Int64 // Nanoseconds
+	totalCalls     atomic.Int64
+	totalBatchSize atomic.Int64
+}
+
+// policyPanels are the float64 and float32 panels packed from one set of
+// weights
+type policyPanels struct {
+	f64 *packedWeights[float64]
+	f32 *packedWeights[float32]
 }
 
 // NewRPSCPUPolicyNetwork creates a new policy network with random weights
@@ -58,7 +70,7 @@ func NewRPSCPUPolicyNetwork(inputSize, hiddenSize, outputSize int) (*RPSCPUPolic
 
 	bias2 := make([]float64, outputSize)
 
-	return &RPSCPUPolicyNetwork{
+	n := &RPSCPUPolicyNetwork{
 		InputSize:  inputSize,
 		HiddenSize: hiddenSize,
 		OutputSize: outputSize,
@@ -66,14 +78,16 @@ func NewRPSCPUPolicyNetwork(inputSize, hiddenSize, outputSize int) (*RPSCPUPolic
 		Bias1:      bias1,
 		Weights2:   weights2,
 		Bias2:      bias2,
-	}, nil
+	}
+	n.PackWeights()
+	return n, nil
 }
 
 // Forward performs a forward pass through the neural network
 func (n *RPSCPUPolicyNetwork) Forward(input []float64) ([]float64, error) {
 	start := time.Now()
-	n.totalCalls++
-	n.totalBatchSize++
+	n.totalCalls.Add(1)
+	n.totalBatchSize.Add(1)
 
 	if len(input) != n.InputSize {
 		return nil, fmt.Errorf("input size mismatch: expected %d, got %d", n.InputSize, len(input))
@@ -102,7 +116,7 @@ func (n *RPSCPUPolicyNetwork) Forward(input []float64) ([]float64, error) {
 	// Apply softmax
 	softmax(output)
 
-	n.totalTime += time.Since(start)
+	n.totalTime.Add(int64(time.Since(start)))
 
 	return output, nil
 }
@@ -117,42 +131,89 @@ func (n *RPSCPUPolicyNetwork) Predict(input []float64) (int, error) {
 	return argmax(output), nil
 }
 
-// ForwardBatch performs forward passes for multiple inputs
+// ForwardBatch performs forward passes for multiple inputs with a single
+// tiled matrix-matrix kernel per layer, on the weights as of the last
+// PackWeights. It is safe for concurrent use.
 func (n *RPSCPUPolicyNetwork) ForwardBatch(inputs [][]float64) ([][]float64, error) {
 	start := time.Now()
-	n.totalCalls++
-	n.totalBatchSize += len(inputs)
-
-	outputs := make([][]float64, len(inputs))
-	for i, input := range inputs {
-		output, err := n.Forward(input)
-		if err != nil {
-			return nil, err
+	n.totalCalls.Add(1)
+	n.totalBatchSize.Add(int64(len(inputs)))
+
+	if len(inputs) == 0 {
+		return [][]float64{}, nil
+	}
+	for _, input := range inputs {
+		if len(input) != n.InputSize {
+			return nil, fmt.Errorf("input size mismatch: expected %d, got %d", n.InputSize, len(input))
 		}
-		outputs[i] = output
 	}
 
-	n.totalTime += time.Since(start)
+	outputs := n.panels().f64.forward(inputs)
+
+	n.totalTime.Add(int64(time.Since(start)))
 
 	return outputs, nil
 }
 
-// PredictBatch performs predictions for multiple inputs
-func (n *RPSCPUPolicyNetwork) PredictBatch(inputs [][]float64) ([]int, error) {
+// ForwardBatchFloat32 is ForwardBatch in single precision, halving the memory
+// traffic of the weight panels
+func (n *RPSCPUPolicyNetwork) ForwardBatchFloat32(inputs [][]float32) ([][]float32, error) {
 	start := time.Now()
-	n.totalCalls++
-	n.totalBatchSize += len(inputs)
-
-	predictions := make([]int, len(inputs))
-	for i, input := range inputs {
-		pred, err := n.Predict(input)
-		if err != nil {
-			return nil, err
+	n.totalCalls.Add(1)
+	n.totalBatchSize.Add(int64(len(inputs)))
+
+	if len(inputs) == 0 {
+		return [][]float32{}, nil
+	}
+	for _, input := range inputs {
+		if len(input) != n.InputSize {
+			return nil, fmt.Errorf("input size mismatch: expected %d, got %d", n.InputSize, len(input))
 		}
-		predictions[i] = pred
 	}
 
-	n.totalTime += time.Since(start)
+	outputs := n.panels().f32.forward(inputs)
+
+	n.totalTime.Add(int64(time.Since(start)))
+
+	return outputs, nil
+}
+
+// PackWeights rebuilds the transposed weight panels used by the batched
+// forward passes. Call it after changing Weights1, Bias1, Weights2 or Bias2;
+// batches already running finish on the old panels.
+func (n *RPSCPUPolicyNetwork) PackWeights() {
+	n.packed.Store(n.packPanels())
+}
+
+// panels returns the current packed panels. A network built as a struct
+// literal rather than by NewRPSCPUPolicyNetwork packs on first use;
+// concurrent first batches may each pack, and the panels are identical.
+func (n *RPSCPUPolicyNetwork) panels() *policyPanels {
+	if p := n.packed.Load(); p != nil {
+		return p
+	}
+	n.packed.CompareAndSwap(nil, n.packPanels())
+	return n.packed.Load()
+}
+
+func (n *RPSCPUPolicyNetwork) packPanels() *policyPanels {
+	return &policyPanels{
+		f64: packWeights[float64](n.Weights1, n.Bias1, n.Weights2, n.Bias2),
+		f32: packWeights[float32](n.Weights1, n.Bias1, n.Weights2, n.Bias2),
+	}
+}
+
+// PredictBatch performs predictions for multiple inputs
+func (n *RPSCPUPolicyNetwork) PredictBatch(inputs [][]float64) ([]int, error) {
+	outputs, err := n.ForwardBatch(inputs)
+	if err != nil {
+		return nil, err
+	}
+
+	predictions := make([]int, len(outputs))
+	for i, output := range outputs {
+		predictions[i] = argmax(output)
+	}
 
 	return predictions, nil
 }
@@ -0,0 +1,123 @@
+package cpu
+
+// Vectorized float32 kernels.
+//
+// The per-architecture files provide dotSIMD, dot4SIMD and reluSIMD backed by
+// Go assembly (AVX2+FMA on amd64, NEON on arm64) and set simdSupported from
+// CPU feature detection at startup. Everything else falls back to the scalar
+// loops below, which are also used for vectors too short to benefit.
+
+// simdMinLen is the shortest vector handed to the assembly kernels
+const simdMinLen = 8
+
+// useSIMD selects the vectorized kernels; it starts out equal to simdSupported
+var useSIMD = simdSupported
+
+// SIMDSupported reports whether this CPU has the vector extensions used by
+// the float32 kernels
+func SIMDSupported() bool {
+	return simdSupported
+}
+
+// SIMDEnabled reports whether the float32 kernels currently use SIMD
+func SIMDEnabled() bool {
+	return useSIMD
+}
+
+// SetSIMDEnabled turns the vectorized kernels on or off, e.g. to benchmark
+// against the scalar fallback. Enabling has no effect on CPUs that lack
+// support. It must not be called while inference is running.
+func SetSIMDEnabled(enabled bool) {
+	useSIMD = enabled && simdSupported
+}
+
+// KernelName describes the float32 kernel implementation in use
+func KernelName() string {
+	if useSIMD {
+		return simdName
+	}
+	return "scalar"
+}
+
+// dotF32 returns the dot product of two equal-length float32 vectors
+func dotF32(a, b []float32) float32 {
+	b = b[:len(a)]
+	if useSIMD && len(a) >= simdMinLen {
+		return dotSIMD(a, b)
+	}
+	return dotF32Scalar(a, b)
+}
+
+// dot4F32 returns the dot products of w with each of x0..x3, reading w once
+func dot4F32(w, x0, x1, x2, x3 []float32) (float32, float32, float32, float32) {
+	n := len(w)
+	x0, x1, x2, x3 = x0[:n], x1[:n], x2[:n], x3[:n]
+	if useSIMD && n >= simdMinLen {
+		return dot4SIMD(w, x0, x1, x2, x3)
+	}
+	return dot4F32Scalar(w, x0, x1, x2, x3)
+}
+
+// reluF32 applies ReLU to every element of values
+func reluF32(values []float32) {
+	if useSIMD && len(values) >= simdMinLen {
+		reluSIMD(values)
+		return
+	}
+	reluInPlace(values)
+}
+
+func dotF32Scalar(a, b []float32) float32 {
+	var sum float32
+	for i, v := range a {
+		sum += v * b[i]
+	}
+	return sum
+}
+
+func dot4F32Scalar(w, x0, x1, x2, x3 []float32) (float32, float32, float32, float32) {
+	var s0, s1, s2, s3 float32
+	for i, v := range w {
+		s0 += x0[i] * v
+		s1 += x1[i] * v
+		s2 += x2[i] * v
+		s3 += x3[i] * v
+	}
+	return s0, s1, s2, s3
+}
+
+// gemmPanelF32 is gemmPanel specialised for float32, with the inner dot
+// products done by the vector kernels
+func gemmPanelF32(in [][]float32, wT []float32, bias []float32, out []float32, n int) {
+	batch := len(in)
+	if batch == 0 {
+		return
+	}
+	k := len(wT) / n
+
+	for j0 := 0; j0 < n; j0 += hiddenTile {
+		j1 := j0 + hiddenTile
+		if j1 > n {
+			j1 = n
+		}
+
+		b := 0
+		for ; b+rowBlock <= batch; b += rowBlock {
+			x0, x1, x2, x3 := in[b][:k], in[b+1][:k], in[b+2][:k], in[b+3][:k]
+			o0, o1, o2, o3 := out[b*n:], out[(b+1)*n:], out[(b+2)*n:], out[(b+3)*n:]
+
+			for j := j0; j < j1; j++ {
+				s0, s1, s2, s3 := dot4F32(wT[j*k:(j+1)*k], x0, x1, x2, x3)
+				o0[j], o1[j], o2[j], o3[j] = bias[j]+s0, bias[j]+s1, bias[j]+s2, bias[j]+s3
+			}
+		}
+
+		for ; b < batch; b++ {
+			x := in[b][:k]
+			o := out[b*n:]
+			for j := j0; j < j1; j++ {
+				o[j] = bias[j] + dotF32(wT[j*k:(j+1)*k], x)
+			}
+		}
+	}
+}
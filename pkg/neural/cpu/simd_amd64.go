@@ -0,0 +1,60 @@
+package cpu
+
+const simdName = "avx2+fma"
+
+var simdSupported = detectAVX2FMA()
+
+// Implemented in simd_amd64.s
+//
+//go:noescape
+func dotAVX2(a, b *float32, n int) float32
+
+//go:noescape
+func dot4AVX2(w, x0, x1, x2, x3 *float32, n int, out *[4]float32)
+
+//go:noescape
+func reluAVX2(x *float32, n int)
+
+func cpuid(eaxArg, ecxArg uint32) (eax, ebx, ecx, edx uint32)
+
+func xgetbv() (eax, edx uint32)
+
+// detectAVX2FMA reports whether the CPU supports AVX2 and FMA and the OS
+// saves the YMM registers across context switches
+func detectAVX2FMA() bool {
+	maxLeaf, _, _, _ := cpuid(0, 0)
+	if maxLeaf < 7 {
+		return false
+	}
+
+	_, _, ecx1, _ := cpuid(1, 0)
+	hasFMA := ecx1&(1<<12) != 0
+	hasOSXSAVE := ecx1&(1<<27) != 0
+	hasAVX := ecx1&(1<<28) != 0
+	if !hasFMA || !hasOSXSAVE || !hasAVX {
+		return false
+	}
+
+	// XCR0 bits 1 and 2: SSE and AVX state enabled by the OS
+	xcr0, _ := xgetbv()
+	if xcr0&0x6 != 0x6 {
+		return false
+	}
+
+	_, ebx7, _, _ := cpuid(7, 0)
+	return ebx7&(1<<5) != 0
+}
+
+func dotSIMD(a, b []float32) float32 {
+	return dotAVX2(&a[0], &b[0], len(a))
+}
+
+func dot4SIMD(w, x0, x1, x2, x3 []float32) (float32, float32, float32, float32) {
+	var out [4]float32
+	dot4AVX2(&w[0], &x0[0], &x1[0], &x2[0], &x3[0], len(w), &out)
+	return out[0], out[1], out[2], out[3]
+}
+
+func reluSIMD(values []float32) {
+	reluAVX2(&values[0], len(values))
+}
@@ -0,0 +1,165 @@
+#include "textflag.h"
+
+// func dotAVX2(a, b *float32, n int) float32
+TEXT ·dotAVX2(SB), NOSPLIT, $0-28
+	MOVQ a+0(FP), SI
+	MOVQ b+8(FP), DI
+	MOVQ n+16(FP), CX
+	VXORPS Y0, Y0, Y0
+	VXORPS Y1, Y1, Y1
+	XORQ AX, AX
+
+	// Two independent accumulators, 16 floats per iteration
+dot_loop16:
+	LEAQ 16(AX), DX
+	CMPQ DX, CX
+	JGT  dot_loop8
+	VMOVUPS (SI)(AX*4), Y2
+	VMOVUPS 32(SI)(AX*4), Y3
+	VFMADD231PS (DI)(AX*4), Y2, Y0
+	VFMADD231PS 32(DI)(AX*4), Y3, Y1
+	MOVQ DX, AX
+	JMP  dot_loop16
+
+dot_loop8:
+	LEAQ 8(AX), DX
+	CMPQ DX, CX
+	JGT  dot_reduce
+	VMOVUPS (SI)(AX*4), Y2
+	VFMADD231PS (DI)(AX*4), Y2, Y0
+	MOVQ DX, AX
+
+dot_reduce:
+	VADDPS Y1, Y0, Y0
+	VEXTRACTF128 $1, Y0, X1
+	VADDPS X1, X0, X0
+	VHADDPS X0, X0, X0
+	VHADDPS X0, X0, X0
+
+	// Scalar tail; the VEX scalar ops clear the upper YMM lanes, which is
+	// why the reduction happens first
+dot_tail:
+	CMPQ AX, CX
+	JGE  dot_done
+	VMOVSS (SI)(AX*4), X2
+	VFMADD231SS (DI)(AX*4), X2, X0
+	INCQ AX
+	JMP  dot_tail
+
+dot_done:
+	VZEROUPPER
+	MOVSS X0, ret+24(FP)
+	RET
+
+// func dot4AVX2(w, x0, x1, x2, x3 *float32, n int, out *[4]float32)
+TEXT ·dot4AVX2(SB), NOSPLIT, $0-56
+	MOVQ w+0(FP), SI
+	MOVQ x0+8(FP), R8
+	MOVQ x1+16(FP), R9
+	MOVQ x2+24(FP), R10
+	MOVQ x3+32(FP), R11
+	MOVQ n+40(FP), CX
+	MOVQ out+48(FP), DI
+	VXORPS Y0, Y0, Y0
+	VXORPS Y1, Y1, Y1
+	VXORPS Y2, Y2, Y2
+	VXORPS Y3, Y3, Y3
+	XORQ AX, AX
+
+dot4_loop8:
+	LEAQ 8(AX), DX
+	CMPQ DX, CX
+	JGT  dot4_reduce
+	VMOVUPS (SI)(AX*4), Y4
+	VFMADD231PS (R8)(AX*4), Y4, Y0
+	VFMADD231PS (R9)(AX*4), Y4, Y1
+	VFMADD231PS (R10)(AX*4), Y4, Y2
+	VFMADD231PS (R11)(AX*4), Y4, Y3
+	MOVQ DX, AX
+	JMP  dot4_loop8
+
+dot4_reduce:
+	VEXTRACTF128 $1, Y0, X4
+	VADDPS X4, X0, X0
+	VEXTRACTF128 $1, Y1, X5
+	VADDPS X5, X1, X1
+	VEXTRACTF128 $1, Y2, X6
+	VADDPS X6, X2, X2
+	VEXTRACTF128 $1, Y3, X7
+	VADDPS X7, X3, X3
+
+	// Horizontal sums of the four accumulators land in lanes 0..3 of X0
+	VHADDPS X1, X0, X0
+	VHADDPS X3, X2, X2
+	VHADDPS X2, X0, X0
+	VMOVUPS X0, (DI)
+
+dot4_tail:
+	CMPQ AX, CX
+	JGE  dot4_done
+	VMOVSS (SI)(AX*4), X4
+	VMOVSS 0(DI), X0
+	VFMADD231SS (R8)(AX*4), X4, X0
+	VMOVSS X0, 0(DI)
+	VMOVSS 4(DI), X1
+	VFMADD231SS (R9)(AX*4), X4, X1
+	VMOVSS X1, 4(DI)
+	VMOVSS 8(DI), X2
+	VFMADD231SS (R10)(AX*4), X4, X2
+	VMOVSS X2, 8(DI)
+	VMOVSS 12(DI), X3
+	VFMADD231SS (R11)(AX*4), X4, X3
+	VMOVSS X3, 12(DI)
+	INCQ AX
+	JMP  dot4_tail
+
+dot4_done:
+	VZEROUPPER
+	RET
+
+// func reluAVX2(x *float32, n int)
+TEXT ·reluAVX2(SB), NOSPLIT, $0-16
+	MOVQ x+0(FP), SI
+	MOVQ n+8(FP), CX
+	VXORPS Y1, Y1, Y1
+	XORQ AX, AX
+
+relu_loop8:
+	LEAQ 8(AX), DX
+	CMPQ DX, CX
+	JGT  relu_tail
+	VMAXPS (SI)(AX*4), Y1, Y0
+	VMOVUPS Y0, (SI)(AX*4)
+	MOVQ DX, AX
+	JMP  relu_loop8
+
+relu_tail:
+	CMPQ AX, CX
+	JGE  relu_done
+	VMAXSS (SI)(AX*4), X1, X0
+	VMOVSS X0, (SI)(AX*4)
+	INCQ AX
+	JMP  relu_tail
+
+relu_done:
+	VZEROUPPER
+	RET
+
+// func cpuid(eaxArg, ecxArg uint32) (eax, ebx, ecx, edx uint32)
+TEXT ·cpuid(SB), NOSPLIT, $0-24
+	MOVL eaxArg+0(FP), AX
+	MOVL ecxArg+4(FP), CX
+	CPUID
+	MOVL AX, eax+8(FP)
+	MOVL BX, ebx+12(FP)
+	MOVL CX, ecx+16(FP)
+	MOVL DX, edx+20(FP)
+	RET
+
+// func xgetbv() (eax, edx uint32)
+TEXT ·xgetbv(SB), NOSPLIT, $0-8
+	MOVL $0, CX
+	XGETBV
+	MOVL AX, eax+0(FP)
+	MOVL DX, edx+4(FP)
+	RET
@@ -0,0 +1,50 @@
+package cpu
+
+const simdName = "neon"
+
+// Advanced SIMD is mandatory on arm64
+var simdSupported = true
+
+// Implemented in simd_arm64.s. The kernels process multiples of four floats
+// and store per-lane partial sums; the remainder is finished in Go.
+//
+//go:noescape
+func dotNEON(a, b *float32, n int, lanes *[4]float32)
+
+//go:noescape
+func dot4NEON(w, x0, x1, x2, x3 *float32, n int, lanes *[16]float32)
+
+func dotSIMD(a, b []float32) float32 {
+	var lanes [4]float32
+	n := len(a) &^ 3
+	dotNEON(&a[0], &b[0], n, &lanes)
+
+	sum := lanes[0] + lanes[1] + lanes[2] + lanes[3]
+	for i := n; i < len(a); i++ {
+		sum += a[i] * b[i]
+	}
+	return sum
+}
+
+func dot4SIMD(w, x0, x1, x2, x3 []float32) (float32, float32, float32, float32) {
+	var lanes [16]float32
+	n := len(w) &^ 3
+	dot4NEON(&w[0], &x0[0], &x1[0], &x2[0], &x3[0], n, &lanes)
+
+	s0 := lanes[0] + lanes[1] + lanes[2] + lanes[3]
+	s1 := lanes[4] + lanes[5] + lanes[6] + lanes[7]
+	s2 := lanes[8] + lanes[9] + lanes[10] + lanes[11]
+	s3 := lanes[12] + lanes[13] + lanes[14] + lanes[15]
+	for i := n; i < len(w); i++ {
+		s0 += x0[i] * w[i]
+		s1 += x1[i] * w[i]
+		s2 += x2[i] * w[i]
+		s3 += x3[i] * w[i]
+	}
+	return s0, s1, s2, s3
+}
+
+// The Go assembler has no vector FMAX, and ReLU is bandwidth-bound anyway
+func reluSIMD(values []float32) {
+	reluInPlace(values)
+}
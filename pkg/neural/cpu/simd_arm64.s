@@ -0,0 +1,55 @@
+#include "textflag.h"
+
+// func dotNEON(a, b *float32, n int, lanes *[4]float32)
+TEXT ·dotNEON(SB), NOSPLIT, $0-32
+	MOVD a+0(FP), R0
+	MOVD b+8(FP), R1
+	MOVD n+16(FP), R2
+	MOVD lanes+24(FP), R3
+	VEOR V0.B16, V0.B16, V0.B16
+
+dot_loop4:
+	CMP  $4, R2
+	BLT  dot_done
+	VLD1.P 16(R0), [V1.S4]
+	VLD1.P 16(R1), [V2.S4]
+	VFMLA V1.S4, V2.S4, V0.S4
+	SUB  $4, R2
+	B    dot_loop4
+
+dot_done:
+	VST1 [V0.S4], (R3)
+	RET
+
+// func dot4NEON(w, x0, x1, x2, x3 *float32, n int, lanes *[16]float32)
+TEXT ·dot4NEON(SB), NOSPLIT, $0-56
+	MOVD w+0(FP), R0
+	MOVD x0+8(FP), R1
+	MOVD x1+16(FP), R2
+	MOVD x2+24(FP), R3
+	MOVD x3+32(FP), R4
+	MOVD n+40(FP), R5
+	MOVD lanes+48(FP), R6
+	VEOR V0.B16, V0.B16, V0.B16
+	VEOR V1.B16, V1.B16, V1.B16
+	VEOR V2.B16, V2.B16, V2.B16
+	VEOR V3.B16, V3.B16, V3.B16
+
+dot4_loop4:
+	CMP  $4, R5
+	BLT  dot4_done
+	VLD1.P 16(R0), [V4.S4]
+	VLD1.P 16(R1), [V5.S4]
+	VLD1.P 16(R2), [V6.S4]
+	VLD1.P 16(R3), [V7.S4]
+	VLD1.P 16(R4), [V8.S4]
+	VFMLA V4.S4, V5.S4, V0.S4
+	VFMLA V4.S4, V6.S4, V1.S4
+	VFMLA V4.S4, V7.S4, V2.S4
+	VFMLA V4.S4, V8.S4, V3.S4
+	SUB  $4, R5
+	B    dot4_loop4
+
+dot4_done:
+	VST1 [V0.S4, V1.S4, V2.S4, V3.S4], (R6)
+	RET
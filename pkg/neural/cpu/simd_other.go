@@ -0,0 +1,19 @@
+//go:build !amd64 && !arm64
+
+package cpu
+
+const simdName = "scalar"
+
+var simdSupported = false
+
+func dotSIMD(a, b []float32) float32 {
+	return dotF32Scalar(a, b)
+}
+
+func dot4SIMD(w, x0, x1, x2, x3 []float32) (float32, float32, float32, float32) {
+	return dot4F32Scalar(w, x0, x1, x2, x3)
+}
+
+func reluSIMD(values []float32) {
+	reluInPlace(values)
+}
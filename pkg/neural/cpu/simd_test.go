@@ -0,0 +1,185 @@
+package cpu
+
+import (
+	"fmt"
+	"math"
+	"math/rand"
+	"testing"
+)
+
+// maxKernelLen covers the 16- and 8-wide loops and every tail length
+const maxKernelLen = 40
+
+func randomF32(rng *rand.Rand, n int) []float32 {
+	v := make([]float32, n)
+	for i := range v {
+		v[i] = rng.Float32()*2 - 1
+	}
+	return v
+}
+
+// dotTolerance bounds the float32 error of a dot product computed in a
+// different summation order: a few ulps of the sum of absolute products
+func dotTolerance(a, b []float32) float64 {
+	var mag float64
+	for i := range a {
+		mag += math.Abs(float64(a[i]) * float64(b[i]))
+	}
+	return 1e-5*mag + 1e-7
+}
+
+// forEachKernel runs fn with the vector kernels enabled and disabled,
+// restoring the default afterwards
+func forEachKernel(t *testing.T, fn func(t *testing.T)) {
+	defer SetSIMDEnabled(true)
+	for _, enabled := range []bool{true, false} {
+		SetSIMDEnabled(enabled)
+		if enabled && !SIMDEnabled() {
+			continue // No vector extensions on this CPU
+		}
+		t.Run(KernelName(), fn)
+	}
+}
+
+func TestDotF32(t *testing.T) {
+	forEachKernel(t, func(t *testing.T) {
+		rng := rand.New(rand.NewSource(1))
+		for n := 0; n <= maxKernelLen; n++ {
+			a, b := randomF32(rng, n), randomF32(rng, n)
+			got, want := dotF32(a, b), dotF32Scalar(a, b)
+			if math.Abs(float64(got-want)) > dotTolerance(a, b) {
+				t.Errorf("n=%d: dotF32 = %g, scalar = %g", n, got, want)
+			}
+		}
+	})
+}
+
+func TestDot4F32(t *testing.T) {
+	forEachKernel(t, func(t *testing.T) {
+		rng := rand.New(rand.NewSource(2))
+		for n := 0; n <= maxKernelLen; n++ {
+			w := randomF32(rng, n)
+			x := [4][]float32{randomF32(rng, n), randomF32(rng, n), randomF32(rng, n), randomF32(rng, n)}
+
+			var got, want [4]float32
+			got[0], got[1], got[2], got[3] = dot4F32(w, x[0], x[1], x[2], x[3])
+			want[0], want[1], want[2], want[3] = dot4F32Scalar(w, x[0], x[1], x[2], x[3])
+			for r := range got {
+				if math.Abs(float64(got[r]-want[r])) > dotTolerance(w, x[r]) {
+					t.Errorf("n=%d row %d: dot4F32 = %g, scalar = %g", n, r, got[r], want[r])
+				}
+			}
+		}
+	})
+}
+
+func TestReluF32(t *testing.T) {
+	forEachKernel(t, func(t *testing.T) {
+		rng := rand.New(rand.NewSource(3))
+		for n := 0; n <= maxKernelLen; n++ {
+			got := randomF32(rng, n)
+			want := append([]float32(nil), got...)
+			reluF32(got)
+			reluInPlace(want)
+			for i := range want {
+				if got[i] != want[i] {
+					t.Fatalf("n=%d: element %d is %g, expected %g", n, i, got[i], want[i])
+				}
+			}
+		}
+	})
+}
+
+// TestSIMDKernelsShortVectors calls the assembly kernels directly on vectors
+// shorter than simdMinLen, which the dispatchers never hand them, so their
+// tail loops are exercised on their own
+func TestSIMDKernelsShortVectors(t *testing.T) {
+	if !SIMDSupported() {
+		t.Skip("No vector extensions on this CPU")
+	}
+	rng := rand.New(rand.NewSource(4))
+	for n := 1; n <= maxKernelLen; n++ {
+		w := randomF32(rng, n)
+		x := [4][]float32{randomF32(rng, n), randomF32(rng, n), randomF32(rng, n), randomF32(rng, n)}
+
+		if got, want := dotSIMD(w, x[0]), dotF32Scalar(w, x[0]); math.Abs(float64(got-want)) > dotTolerance(w, x[0]) {
+			t.Errorf("n=%d: dotSIMD = %g, scalar = %g", n, got, want)
+		}
+
+		var got, want [4]float32
+		got[0], got[1], got[2], got[3] = dot4SIMD(w, x[0], x[1], x[2], x[3])
+		want[0], want[1], want[2], want[3] = dot4F32Scalar(w, x[0], x[1], x[2], x[3])
+		for r := range got {
+			if math.Abs(float64(got[r]-want[r])) > dotTolerance(w, x[r]) {
+				t.Errorf("n=%d row %d: dot4SIMD = %g, scalar = %g", n, r, got[r], want[r])
+			}
+		}
+
+		relu := append([]float32(nil), w...)
+		reluSIMD(relu)
+		for i, v := range w {
+			if want := float32(math.Max(float64(v), 0)); relu[i] != want {
+				t.Fatalf("n=%d: reluSIMD element %d is %g, expected %g", n, i, relu[i], want)
+			}
+		}
+	}
+}
+
+func TestGemmPanelF32(t *testing.T) {
+	forEachKernel(t, func(t *testing.T) {
+		rng := rand.New(rand.NewSource(5))
+		// Neuron counts below, at and across the tile width; batch sizes
+		// around the 4-row block
+		for _, neurons := range []int{1, 7, hiddenTile, hiddenTile + 3} {
+			for _, batch := range []int{1, 3, 4, 5, 9} {
+				for k := 0; k <= maxKernelLen; k++ {
+					name := fmt.Sprintf("n=%d/batch=%d/k=%d", neurons, batch, k)
+					in := make([][]float32, batch)
+					for b := range in {
+						in[b] = randomF32(rng, k)
+					}
+					wT, bias := randomF32(rng, neurons*k), randomF32(rng, neurons)
+
+					got := make([]float32, batch*neurons)
+					want := make([]float32, batch*neurons)
+					gemmPanelF32(in, wT, bias, got, neurons)
+					gemmPanel(in, wT, bias, want, neurons)
+
+					for b := 0; b < batch; b++ {
+						for j := 0; j < neurons; j++ {
+							i := b*neurons + j
+							tol := dotTolerance(in[b], wT[j*k:(j+1)*k]) + 1e-6
+							if math.Abs(float64(got[i]-want[i])) > tol {
+								t.Fatalf("%s: out[%d][%d] = %g, scalar = %g", name, b, j, got[i], want[i])
+							}
+						}
+					}
+				}
+			}
+		}
+	})
+}
+
+func TestForwardBatchFloat32MatchesForward(t *testing.T) {
+	forEachKernel(t, func(t *testing.T) {
+		rng := rand.New(rand.NewSource(6))
+		n, err := NewRPSCPUPolicyNetwork(81, 40, 9)
+		if err != nil {
+			t.Fatal(err)
+		}
+
+		inputs := randomInputs(rng, 11, n.InputSize)
+		outputs, err := n.ForwardBatchFloat32(toFloat32Rows(inputs))
+		if err != nil {
+			t.Fatal(err)
+		}
+		for i, input := range inputs {
+			want, _ := n.Forward(input)
+			for j := range want {
+				if math.Abs(float64(outputs[i][j])-want[j]) > 1e-5 {
+					t.Fatalf("Input %d output %d: float32 batch gives %g, Forward %g", i, j, outputs[i][j], want[j])
+				}
+			}
+		}
+	})
+}
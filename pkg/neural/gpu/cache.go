@@ -0,0 +1,161 @@
+package gpu
+
+import (
+	"math"
+	"sync"
+	"sync/atomic"
+)
+
+const predictionCacheShards = 64
+
+type predictionEntry struct {
+	hash       uint64
+	generation uint64
+	features   []float32 // Kept to rule out hash collisions
+	resp       *NeuralResponse
+	referenced bool // Set on a hit; spares the entry from one CLOCK sweep
+}
+
+type predictionShard struct {
+	mu      sync.Mutex
+	index   map[uint64]int32 // Feature hash to entry
+	entries []predictionEntry
+	limit   int
+	hand    int // CLOCK hand: next entry considered for eviction
+}
+
+// PredictionCache memoizes responses by feature vector, so a position that
+// comes up again, in a later search or another game, is answered without a
+// round trip. Entries belong to a model generation: Invalidate, called when
+// the model behind the cache is reloaded, makes every existing entry miss.
+// Cached responses are shared between callers and must not be modified.
+//
+// PredictionCache is safe for concurrent use. A nil *PredictionCache is
+// valid and caches nothing.
+type PredictionCache struct {
+	shards     [predictionCacheShards]predictionShard
+	generation atomic.Uint64
+	hits       atomic.Int64
+	misses     atomic.Int64
+}
+
+// NewPredictionCache creates a cache holding up to about entries responses
+func NewPredictionCache(entries int) *PredictionCache {
+	limit := max((entries+predictionCacheShards-1)/predictionCacheShards, 1)
+
+	c := &PredictionCache{}
+	for i := range c.shards {
+		c.shards[i].index = make(map[uint64]int32, limit)
+		c.shards[i].entries = make([]predictionEntry, 0, limit)
+		c.shards[i].limit = limit
+	}
+	return c
+}
+
+// hashFeatures is FNV-1a over the features' bit patterns
+func hashFeatures(features []float32) uint64 {
+	h := uint64(14695981039346656037)
+	for _, v := range features {
+		h ^= uint64(math.Float32bits(v))
+		h *= 1099511628211
+	}
+	return h
+}
+
+func sameFeatures(a, b []float32) bool {
+	if len(a) != len(b) {
+		return false
+	}
+	for i := range a {
+		if math.Float32bits(a[i]) != math.Float32bits(b[i]) {
+			return false
+		}
+	}
+	return true
+}
+
+// Get returns the cached response for features, if any
+func (c *PredictionCache) Get(features []float32) (*NeuralResponse, bool) {
+	if c == nil {
+		return nil, false
+	}
+
+	hash := hashFeatures(features)
+	generation := c.generation.Load()
+	s := &c.shards[hash>>58]
+
+	s.mu.Lock()
+	if i, ok := s.index[hash]; ok {
+		e := &s.entries[i]
+		if e.generation == generation && sameFeatures(e.features, features) {
+			e.referenced = true
+			resp := e.resp
+			s.mu.Unlock()
+			c.hits.Add(1)
+			return resp, true
+		}
+	}
+	s.mu.Unlock()
+	c.misses.Add(1)
+	return nil, false
+}
+
+// Put caches resp for features, evicting an older entry if the cache is full
+func (c *PredictionCache) Put(features []float32, resp *NeuralResponse) {
+	if c == nil {
+		return
+	}
+
+	hash := hashFeatures(features)
+	generation := c.generation.Load()
+	s := &c.shards[hash>>58]
+
+	s.mu.Lock()
+	defer s.mu.Unlock()
+
+	i, ok := s.index[hash]
+	if !ok {
+		if len(s.entries) < s.limit {
+			s.entries = append(s.entries, predictionEntry{})
+			i = int32(len(s.entries) - 1)
+		} else {
+			for s.entries[s.hand].referenced {
+				s.entries[s.hand].referenced = false
+				s.hand = (s.hand + 1) % len(s.entries)
+			}
+			i = int32(s.hand)
+			s.hand = (s.hand + 1) % len(s.entries)
+			delete(s.index, s.entries[i].hash)
+		}
+		s.index[hash] = i
+	}
+
+	e := &s.entries[i]
+	e.hash = hash
+	e.generation = generation
+	e.features = append(e.features[:0], features...)
+	e.resp = resp
+	e.referenced = false
+}
+
+// Invalidate makes every cached response miss, e.g. after a model reload.
+// Stale entries are recycled as new ones are added.
+func (c *PredictionCache) Invalidate() {
+	if c != nil {
+		c.generation.Add(1)
+	}
+}
+
+// Stats returns hits, misses and hit rate (percent)
+func (c *PredictionCache) Stats() (int64, int64, float64) {
+	if c == nil {
+		return 0, 0, 0.0
+	}
+	hits, misses := c.hits.Load(), c.misses.Load()
+
+	hitRate := 0.0
+	if total := hits + misses; total > 0 {
+		hitRate = float64(hits) / float64(total) * 100.0
+	}
+	return hits, misses, hitRate
+}
@@ -0,0 +1,434 @@
+package gpu
+
+import (
+	"context"
+	"errors"
+	"fmt"
+	"strings"
+	"sync"
+	"sync/atomic"
+	"time"
+)
+
+// BatchPredictor is anything that can evaluate a batch of feature vectors.
+// NeuralClient implements it.
+type BatchPredictor interface {
+	PredictBatch(ctx context.Context, batch [][]float32) ([]*NeuralResponse, error)
+	Close() error
+}
+
+// DispatcherConfig controls how a BatchDispatcher forms batches
+type DispatcherConfig struct {
+	MaxBatchSize int           // Requests per batch; a full batch is sent at once
+	MaxWait      time.Duration // Longest a request waits for its batch to fill
+	MaxInFlight  int           // Batches that may be in flight at the same time
+	CacheEntries int           // Responses memoized by feature vector; 0 disables the cache
+
+	// BatchTimeout bounds each PredictBatch call. A batch the backend has
+	// not answered by then fails with context.DeadlineExceeded, freeing its
+	// in-flight slot for the searches sharing the dispatcher.
+	BatchTimeout time.Duration
+}
+
+// DefaultDispatcherConfig returns the configuration used by shared dispatchers
+func DefaultDispatcherConfig() DispatcherConfig {
+	return DispatcherConfig{
+		MaxBatchSize: 256,
+		MaxWait:      2 * time.Millisecond,
+		MaxInFlight:  2,
+		CacheEntries: 1 << 16,
+		BatchTimeout: 10 * time.Second,
+	}
+}
+
+// fillBuckets is the number of histogram buckets; bucket i counts
+// batches filled to between i/fillBuckets and (i+1)/fillBuckets of capacity,
+// with full batches in the last bucket
+const fillBuckets = 10
+
+// ErrDispatcherClosed is returned for requests made after Close
+var ErrDispatcherClosed = errors.New("batch dispatcher closed")
+
+// DispatcherStats describes the batches a dispatcher has sent
+type DispatcherStats struct {
+	Requests        int64
+	Batches         int64
+	FullBatches     int64 // Sent because MaxBatchSize was reached
+	DeadlineBatches int64 // Sent because MaxWait expired
+	Errors          int64
+	CacheHits       int64 // Answered from the cache, without joining a batch
+	CacheMisses     int64
+	AvgBatchSize    float64
+	AvgLatencyUs    float64 // Per batch, from send to response
+	AvgQueueWaitUs  float64 // Per request, from Submit to its batch being sent
+	FillHistogram   [fillBuckets]int64
+}
+
+// String renders the fill histogram, one line per bucket
+func (s DispatcherStats) String() string {
+	var sb strings.Builder
+	fmt.Fprintf(&sb, "%d requests in %d batches (avg %.1f, %d full, %d deadline, %d errors)\n",
+		s.Requests, s.Batches, s.AvgBatchSize, s.FullBatches, s.DeadlineBatches, s.Errors)
+	if s.CacheHits > 0 || s.CacheMisses > 0 {
+		fmt.Fprintf(&sb, "  cache: %d hits, %d misses (%.1f%%)\n", s.CacheHits, s.CacheMisses,
+			float64(s.CacheHits)/float64(s.CacheHits+s.CacheMisses)*100)
+	}
+
+	var peak int64
+	for _, count := range s.FillHistogram {
+		peak = max(peak, count)
+	}
+	for i, count := range s.FillHistogram {
+		bar := 0
+		if peak > 0 {
+			bar = int(40 * count / peak)
+		}
+		fmt.Fprintf(&sb, "  %3d-%3d%% | %-40s %d\n", i*100/fillBuckets, (i+1)*100/fillBuckets,
+			strings.Repeat("#", bar), count)
+	}
+	return sb.String()
+}
+
+// dispatchRequest is one queued evaluation
+type dispatchRequest struct {
+	features []float32
+	done     func(*NeuralResponse, error)
+	queued   time.Time
+}
+
+// BatchDispatcher merges single-position requests from any number of
+// goroutines, searches and games into batched PredictBatch calls. A batch is
+// sent as soon as it is full or its oldest request has waited MaxWait, and
+// up to MaxInFlight batches run concurrently. With CacheEntries set, requests
+// whose features were evaluated before are answered from a PredictionCache.
+type BatchDispatcher struct {
+	backend      BatchPredictor
+	cache        *PredictionCache
+	maxBatchSize atomic.Int64
+	maxWait      atomic.Int64 // Nanoseconds
+	batchTimeout time.Duration
+	inFlight     chan struct{}
+
+	requests chan dispatchRequest
+	closed   chan struct{}
+	mu       sync.RWMutex // Held for reading while submitting, for writing to close
+	isClosed bool
+	wg       sync.WaitGroup
+
+	requestCount  atomic.Int64
+	batchCount    atomic.Int64
+	fullCount     atomic.Int64
+	deadlineCount atomic.Int64
+	errorCount    atomic.Int64
+	latencyNs     atomic.Int64
+	queueWaitNs   atomic.Int64
+	fill          [fillBuckets]atomic.Int64
+
+	// Shared dispatchers are reference counted, see AcquireSharedDispatcher
+	registryKey string
+	refs        int
+}
+
+// NewBatchDispatcher starts a dispatcher in front of backend
+func NewBatchDispatcher(backend BatchPredictor, config DispatcherConfig) *BatchDispatcher {
+	defaults := DefaultDispatcherConfig()
+	if config.MaxBatchSize < 1 {
+		config.MaxBatchSize = defaults.MaxBatchSize
+	}
+	if config.MaxWait <= 0 {
+		config.MaxWait = defaults.MaxWait
+	}
+	if config.MaxInFlight < 1 {
+		config.MaxInFlight = defaults.MaxInFlight
+	}
+	if config.BatchTimeout <= 0 {
+		config.BatchTimeout = defaults.BatchTimeout
+	}
+
+	d := &BatchDispatcher{
+		backend:      backend,
+		batchTimeout: config.BatchTimeout,
+		inFlight:     make(chan struct{}, config.MaxInFlight),
+		requests:     make(chan dispatchRequest, 4*config.MaxBatchSize),
+		closed:       make(chan struct{}),
+	}
+	if config.CacheEntries > 0 {
+		d.cache = NewPredictionCache(config.CacheEntries)
+	}
+	d.maxBatchSize.Store(int64(config.MaxBatchSize))
+	d.maxWait.Store(int64(config.MaxWait))
+
+	d.wg.Add(1)
+	go d.collect()
+	return d
+}
+
+// SetMaxBatchSize changes the batch size for batches formed from now on
+func (d *BatchDispatcher) SetMaxBatchSize(size int) {
+	d.maxBatchSize.Store(int64(max(size, 1)))
+}
+
+// SetMaxWait changes the fill deadline for batches formed from now on
+func (d *BatchDispatcher) SetMaxWait(wait time.Duration) {
+	if wait > 0 {
+		d.maxWait.Store(int64(wait))
+	}
+}
+
+// Submit queues features for evaluation and returns immediately. done is
+// called exactly once with the result: from a dispatcher goroutine, or
+// before Submit returns if the response is cached. features must not be
+// modified until then, and the response must not be modified at all.
+func (d *BatchDispatcher) Submit(features []float32, done func(*NeuralResponse, error)) {
+	d.mu.RLock()
+	if d.isClosed {
+		d.mu.RUnlock()
+		done(nil, ErrDispatcherClosed)
+		return
+	}
+	if resp, ok := d.cache.Get(features); ok {
+		d.mu.RUnlock()
+		done(resp, nil)
+		return
+	}
+	d.requests <- dispatchRequest{features: features, done: done, queued: time.Now()}
+	d.mu.RUnlock()
+}
+
+// Predict evaluates a single position, waiting for the batch it joins
+func (d *BatchDispatcher) Predict(ctx context.Context, features []float32) (*NeuralResponse, error) {
+	type result struct {
+		resp *NeuralResponse
+		err  error
+	}
+	ch := make(chan result, 1)
+	d.Submit(features, func(resp *NeuralResponse, err error) {
+		ch <- result{resp, err}
+	})
+
+	select {
+	case r := <-ch:
+		return r.resp, r.err
+	case <-ctx.Done():
+		return nil, ctx.Err()
+	}
+}
+
+// collect forms batches from incoming requests. It owns the only timer.
+func (d *BatchDispatcher) collect() {
+	defer d.wg.Done()
+
+	timer := time.NewTimer(time.Hour)
+	timer.Stop()
+
+	for {
+		var first dispatchRequest
+		select {
+		case first = <-d.requests:
+		case <-d.closed:
+			d.drain()
+			return
+		}
+
+		maxBatch := int(d.maxBatchSize.Load())
+		batch := make([]dispatchRequest, 1, maxBatch)
+		batch[0] = first
+		timer.Reset(time.Duration(d.maxWait.Load()))
+
+		full := len(batch) >= maxBatch
+	fill:
+		for !full {
+			select {
+			case req := <-d.requests:
+				batch = append(batch, req)
+				full = len(batch) >= maxBatch
+			case <-timer.C:
+				break fill
+			}
+		}
+		if full && !timer.Stop() {
+			<-timer.C
+		}
+
+		d.send(batch, maxBatch, full)
+	}
+}
+
+// send runs a batch once an in-flight slot is free. The backend call is
+// bounded by BatchTimeout, so a hung backend fails its batches rather than
+// holding every in-flight slot.
+func (d *BatchDispatcher) send(batch []dispatchRequest, maxBatch int, full bool) {
+	d.inFlight <- struct{}{}
+
+	d.requestCount.Add(int64(len(batch)))
+	d.batchCount.Add(1)
+	if full {
+		d.fullCount.Add(1)
+	} else {
+		d.deadlineCount.Add(1)
+	}
+	bucket := min(len(batch)*fillBuckets/maxBatch, fillBuckets-1)
+	d.fill[bucket].Add(1)
+	sent := time.Now()
+	var queueWait time.Duration
+	for _, req := range batch {
+		wait := sent.Sub(req.queued)
+		dispatchQueueWaitSeconds.ObserveDuration(wait)
+		queueWait += wait
+	}
+	d.queueWaitNs.Add(int64(queueWait))
+
+	d.wg.Add(1)
+	go func() {
+		defer d.wg.Done()
+		defer func() { <-d.inFlight }()
+
+		inputs := make([][]float32, len(batch))
+		for i, req := range batch {
+			inputs[i] = req.features
+		}
+
+		ctx, cancel := context.WithTimeout(context.Background(), d.batchTimeout)
+		start := time.Now()
+		outputs, err := d.backend.PredictBatch(ctx, inputs)
+		cancel()
+		elapsed := time.Since(start)
+		d.latencyNs.Add(int64(elapsed))
+		dispatchBatchSeconds.ObserveDuration(elapsed)
+
+		if err == nil && len(outputs) != len(batch) {
+			err = fmt.Errorf("batch of %d returned %d results", len(batch), len(outputs))
+		}
+		if err != nil {
+			d.errorCount.Add(1)
+		}
+
+		for i, req := range batch {
+			if err != nil {
+				req.done(nil, err)
+			} else {
+				d.cache.Put(req.features, outputs[i])
+				req.done(outputs[i], nil)
+			}
+		}
+	}()
+}
+
+// drain fails every request still queued after Close
+func (d *BatchDispatcher) drain() {
+	for {
+		select {
+		case req := <-d.requests:
+			req.done(nil, ErrDispatcherClosed)
+		default:
+			return
+		}
+	}
+}
+
+// Stats returns a snapshot of the dispatcher's counters
+func (d *BatchDispatcher) Stats() DispatcherStats {
+	stats := DispatcherStats{
+		Requests:        d.requestCount.Load(),
+		Batches:         d.batchCount.Load(),
+		FullBatches:     d.fullCount.Load(),
+		DeadlineBatches: d.deadlineCount.Load(),
+		Errors:          d.errorCount.Load(),
+	}
+	stats.CacheHits, stats.CacheMisses, _ = d.cache.Stats()
+	for i := range d.fill {
+		stats.FillHistogram[i] = d.fill[i].Load()
+	}
+	if stats.Batches > 0 {
+		stats.AvgBatchSize = float64(stats.Requests) / float64(stats.Batches)
+		stats.AvgLatencyUs = float64(d.latencyNs.Load()) / float64(stats.Batches) / 1e3
+		stats.AvgQueueWaitUs = float64(d.queueWaitNs.Load()) / float64(stats.Requests) / 1e3
+	}
+	return stats
+}
+
+// InvalidateCache drops every cached response, for use after the model
+// behind the dispatcher changes
+func (d *BatchDispatcher) InvalidateCache() {
+	d.cache.Invalidate()
+}
+
+// Close stops accepting requests, waits for batches in flight and closes the
+// backend. Queued requests fail with ErrDispatcherClosed.
+func (d *BatchDispatcher) Close() error {
+	d.mu.Lock()
+	if d.isClosed {
+		d.mu.Unlock()
+		return nil
+	}
+	d.isClosed = true
+	close(d.closed)
+	d.mu.Unlock()
+
+	d.wg.Wait()
+	return d.backend.Close()
+}
+
+var (
+	sharedMu          sync.Mutex
+	sharedDispatchers = make(map[string]*BatchDispatcher)
+)
+
+// AcquireSharedDispatcher returns the process-wide dispatcher for a model on
+// a neural service, connecting on first use. Every search in the process that
+// acquires the same address and model type shares one dispatcher, so their
+// requests fill the same batches. Call Release when done with it.
+// With FusedModelType, the dispatcher evaluates policy and value together
+// over one EvaluateStream and keeps its in-flight batches pipelined on it.
+func AcquireSharedDispatcher(addr string, modelType string) (*BatchDispatcher, error) {
+	key := addr + "/" + modelType
+
+	sharedMu.Lock()
+	defer sharedMu.Unlock()
+
+	if d, ok := sharedDispatchers[key]; ok {
+		d.refs++
+		return d, nil
+	}
+
+	client, err := NewNeuralClient(addr, modelType)
+	if err != nil {
+		return nil, err
+	}
+	var backend BatchPredictor = client
+	if modelType == FusedModelType {
+		stream, err := client.OpenEvaluateStream(context.Background())
+		if err != nil {
+			client.Close()
+			return nil, err
+		}
+		backend = streamBackend{stream}
+	}
+	d := NewBatchDispatcher(backend, DefaultDispatcherConfig())
+	d.registryKey = key
+	d.refs = 1
+	sharedDispatchers[key] = d
+	return d, nil
+}
+
+// Release gives up a reference from AcquireSharedDispatcher. The last
+// release closes the dispatcher. For dispatchers made with
+// NewBatchDispatcher it is the same as Close.
+func (d *BatchDispatcher) Release() error {
+	if d.registryKey == "" {
+		return d.Close()
+	}
+
+	sharedMu.Lock()
+	d.refs--
+	last := d.refs == 0
+	if last {
+		delete(sharedDispatchers, d.registryKey)
+	}
+	sharedMu.Unlock()
+
+	if last {
+		return d.Close()
+	}
+	return nil
+}
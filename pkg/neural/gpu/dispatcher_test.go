@@ -0,0 +1,181 @@
+//go:build gpu
+// +build gpu
+
+package gpu
+
+import (
+	"context"
+	"errors"
+	"sync"
+	"testing"
+	"time"
+)
+
+// recordingBackend runs batches on a MockGPUNetwork and records their sizes
+type recordingBackend struct {
+	*LocalPredictor
+
+	mu    sync.Mutex
+	sizes []int
+}
+
+func newRecordingBackend(t *testing.T) *recordingBackend {
+	network, err := NewMockGPUNetwork(8, 16, 4)
+	if err != nil {
+		t.Fatal(err)
+	}
+	return &recordingBackend{LocalPredictor: NewLocalPredictor(network)}
+}
+
+func (b *recordingBackend) PredictBatch(ctx context.Context, batch [][]float32) ([]*NeuralResponse, error) {
+	b.mu.Lock()
+	b.sizes = append(b.sizes, len(batch))
+	b.mu.Unlock()
+	return b.LocalPredictor.PredictBatch(ctx, batch)
+}
+
+func (b *recordingBackend) batchSizes() []int {
+	b.mu.Lock()
+	defer b.mu.Unlock()
+	return append([]int(nil), b.sizes...)
+}
+
+// hungBackend never answers; it returns only once its context ends
+type hungBackend struct{}
+
+func (hungBackend) PredictBatch(ctx context.Context, batch [][]float32) ([]*NeuralResponse, error) {
+	<-ctx.Done()
+	return nil, ctx.Err()
+}
+
+func (hungBackend) Close() error { return nil }
+
+func features(i int) []float32 {
+	f := make([]float32, 8)
+	f[i%8] = float32(i + 1)
+	return f
+}
+
+// submitAll submits n distinct requests from n goroutines and waits for all
+// of them
+func submitAll(t *testing.T, d *BatchDispatcher, n int) []*NeuralResponse {
+	results := make([]*NeuralResponse, n)
+	var wg sync.WaitGroup
+	for i := 0; i < n; i++ {
+		wg.Add(1)
+		go func(i int) {
+			defer wg.Done()
+			resp, err := d.Predict(context.Background(), features(i))
+			if err != nil {
+				t.Errorf("Request %d failed: %v", i, err)
+			}
+			results[i] = resp
+		}(i)
+	}
+	wg.Wait()
+	return results
+}
+
+func TestBatchDispatcherCoalescesFullBatch(t *testing.T) {
+	backend := newRecordingBackend(t)
+	const batchSize = 16
+	// A fill deadline far beyond the test, so only a full batch can be sent
+	d := NewBatchDispatcher(backend, DispatcherConfig{MaxBatchSize: batchSize, MaxWait: time.Hour})
+	defer d.Close()
+
+	results := submitAll(t, d, batchSize)
+
+	if sizes := backend.batchSizes(); len(sizes) != 1 || sizes[0] != batchSize {
+		t.Fatalf("Expected one batch of %d, got %v", batchSize, sizes)
+	}
+	stats := d.Stats()
+	if stats.FullBatches != 1 || stats.DeadlineBatches != 0 || stats.Requests != batchSize {
+		t.Errorf("Expected one full batch of %d requests, got %+v", batchSize, stats)
+	}
+	if stats.FillHistogram[fillBuckets-1] != 1 {
+		t.Errorf("Expected the full batch in the last fill bucket, got %v", stats.FillHistogram)
+	}
+
+	// Each request gets its own row back
+	for i, resp := range results {
+		want, err := backend.LocalPredictor.PredictBatch(context.Background(), [][]float32{features(i)})
+		if err != nil {
+			t.Fatal(err)
+		}
+		if resp == nil || len(resp.Probabilities) != len(want[0].Probabilities) {
+			t.Fatalf("Request %d: expected %d outputs, got %+v", i, len(want[0].Probabilities), resp)
+		}
+		for j := range want[0].Probabilities {
+			if resp.Probabilities[j] != want[0].Probabilities[j] {
+				t.Fatalf("Request %d got another request's result: %v, expected %v", i, resp.Probabilities, want[0].Probabilities)
+			}
+		}
+	}
+}
+
+func TestBatchDispatcherFlushesOnDeadline(t *testing.T) {
+	backend := newRecordingBackend(t)
+	const maxWait = 5 * time.Millisecond
+	d := NewBatchDispatcher(backend, DispatcherConfig{MaxBatchSize: 64, MaxWait: maxWait})
+	defer d.Close()
+
+	start := time.Now()
+	submitAll(t, d, 3)
+	if elapsed := time.Since(start); elapsed < maxWait {
+		t.Errorf("Expected a partial batch to wait for MaxWait (%v), it was answered in %v", maxWait, elapsed)
+	}
+
+	sizes := backend.batchSizes()
+	total := 0
+	for _, size := range sizes {
+		total += size
+	}
+	if total != 3 {
+		t.Fatalf("Expected 3 requests sent, got batches %v", sizes)
+	}
+	stats := d.Stats()
+	if stats.DeadlineBatches != int64(len(sizes)) || stats.FullBatches != 0 {
+		t.Errorf("Expected only deadline batches, got %+v", stats)
+	}
+	// The oldest request in each batch waits out MaxWait
+	if stats.AvgQueueWaitUs < float64(maxWait.Microseconds())/3 {
+		t.Errorf("Expected requests to queue for up to MaxWait (%v), average wait was %.0fus", maxWait, stats.AvgQueueWaitUs)
+	}
+}
+
+func TestBatchDispatcherBatchTimeout(t *testing.T) {
+	const timeout = 20 * time.Millisecond
+	d := NewBatchDispatcher(hungBackend{}, DispatcherConfig{
+		MaxBatchSize: 1,
+		MaxInFlight:  1,
+		BatchTimeout: timeout,
+	})
+	defer d.Close()
+
+	// A hung backend fails each batch at the timeout instead of holding the
+	// only in-flight slot forever
+	for i := 0; i < 2; i++ {
+		start := time.Now()
+		_, err := d.Predict(context.Background(), features(i))
+		if !errors.Is(err, context.DeadlineExceeded) {
+			t.Fatalf("Request %d: expected context.DeadlineExceeded, got %v", i, err)
+		}
+		if elapsed := time.Since(start); elapsed > 50*timeout {
+			t.Fatalf("Request %d took %v with a %v batch timeout", i, elapsed, timeout)
+		}
+	}
+	if stats := d.Stats(); stats.Errors != 2 {
+		t.Errorf("Expected 2 failed batches, got %d", stats.Errors)
+	}
+}
+
+func TestBatchDispatcherClose(t *testing.T) {
+	d := NewBatchDispatcher(newRecordingBackend(t), DispatcherConfig{MaxBatchSize: 4})
+	submitAll(t, d, 4)
+	if err := d.Close(); err != nil {
+		t.Fatal(err)
+	}
+	if _, err := d.Predict(context.Background(), features(0)); !errors.Is(err, ErrDispatcherClosed) {
+		t.Errorf("Expected ErrDispatcherClosed after Close, got %v", err)
+	}
+}
@@ -0,0 +1,303 @@
+package gpu
+
+import (
+	"context"
+	"encoding/binary"
+	"errors"
+	"fmt"
+	"io"
+	"math"
+	"sync"
+	"time"
+
+	"github.com/zachbeta/neural_rps/pkg/neural/proto"
+)
+
+// FusedModelType makes AcquireSharedDispatcher evaluate policy and value
+// together over an EvaluateStream, so each position needs one round trip
+const FusedModelType = "fused"
+
+// ErrStreamClosed is returned for batches sent after an EvaluateStream ends
+var ErrStreamClosed = errors.New("evaluate stream closed")
+
+// packTensor packs a batch of equal-length feature vectors into a
+// [batch, features] little-endian float32 tensor
+func packTensor(batch [][]float32) (*proto.Tensor, error) {
+	cols := len(batch[0])
+	data := make([]byte, 4*cols*len(batch))
+	off := 0
+	for i, row := range batch {
+		if len(row) != cols {
+			return nil, fmt.Errorf("batch row %d has %d features, expected %d", i, len(row), cols)
+		}
+		for _, v := range row {
+			binary.LittleEndian.PutUint32(data[off:], math.Float32bits(v))
+			off += 4
+		}
+	}
+	return &proto.Tensor{Shape: []int32{int32(len(batch)), int32(cols)}, Data: data}, nil
+}
+
+// unpackTensor decodes a [n, cols] tensor into n rows sharing one buffer
+func unpackTensor(t *proto.Tensor, n int) ([][]float32, error) {
+	if len(t.Shape) != 2 || int(t.Shape[0]) != n || t.Shape[1] < 0 ||
+		len(t.Data) != 4*n*int(t.Shape[1]) {
+		return nil, fmt.Errorf("tensor of shape %v and %d bytes does not fit a batch of %d",
+			t.Shape, len(t.Data), n)
+	}
+	cols := int(t.Shape[1])
+
+	flat := make([]float32, n*cols)
+	for i := range flat {
+		flat[i] = math.Float32frombits(binary.LittleEndian.Uint32(t.Data[4*i:]))
+	}
+	rows := make([][]float32, n)
+	for i := range rows {
+		rows[i] = flat[i*cols : (i+1)*cols : (i+1)*cols]
+	}
+	return rows, nil
+}
+
+// argmax returns the index of the largest value
+func argmax(values []float32) int32 {
+	best := 0
+	for i, v := range values {
+		if v > values[best] {
+			best = i
+		}
+	}
+	return int32(best)
+}
+
+// unpackEvaluateResponse converts a fused response for n positions. An empty
+// policy (the service has no policy model) leaves Probabilities nil.
+func unpackEvaluateResponse(resp *proto.EvaluateResponse, n int) ([]*NeuralResponse, error) {
+	if resp.Error != "" {
+		return nil, fmt.Errorf("evaluation failed: %s", resp.Error)
+	}
+	if len(resp.Values) != n {
+		return nil, fmt.Errorf("batch of %d returned %d values", n, len(resp.Values))
+	}
+
+	var policy [][]float32
+	if resp.Policy != nil && len(resp.Policy.Data) > 0 {
+		var err error
+		if policy, err = unpackTensor(resp.Policy, n); err != nil {
+			return nil, fmt.Errorf("policy %v", err)
+		}
+	}
+
+	results := make([]*NeuralResponse, n)
+	for i := range results {
+		result := &NeuralResponse{Value: resp.Values[i]}
+		if policy != nil {
+			result.Probabilities = policy[i]
+			result.BestMove = argmax(policy[i])
+		}
+		results[i] = result
+	}
+	return results, nil
+}
+
+// EvaluateBatch runs the policy and value models on a batch in a single
+// EvaluateBatch call
+func (c *NeuralClient) EvaluateBatch(ctx context.Context, batch [][]float32) ([]*NeuralResponse, error) {
+	if len(batch) == 0 {
+		return []*NeuralResponse{}, nil
+	}
+
+	features, err := packTensor(batch)
+	if err != nil {
+		return nil, err
+	}
+
+	c.beginCall(len(batch))
+	start := time.Now()
+
+	resp, err := c.client.EvaluateBatch(ctx, &proto.EvaluateRequest{Features: features})
+	c.endCall(start, err)
+	if err != nil {
+		return nil, fmt.Errorf("batch evaluation failed: %v", err)
+	}
+
+	return unpackEvaluateResponse(resp, len(batch))
+}
+
+// pendingEvaluation is a batch sent on an EvaluateStream awaiting its response
+type pendingEvaluation struct {
+	size  int
+	start time.Time
+	done  chan evaluationResult
+}
+
+type evaluationResult struct {
+	outputs []*NeuralResponse
+	err     error
+}
+
+// EvaluateStream keeps one EvaluateStream call open and matches responses to
+// batches by request ID, so any number of batches can be in flight on it at
+// once. It is safe for concurrent use and implements BatchPredictor, which
+// lets a BatchDispatcher with MaxInFlight > 1 pipeline batches over it.
+type EvaluateStream struct {
+	client *NeuralClient
+	stream proto.NeuralService_EvaluateStreamClient
+	cancel context.CancelFunc
+
+	sendMu sync.Mutex // Serialises Send, which is not safe for concurrent use
+
+	mu      sync.Mutex
+	nextID  uint64
+	pending map[uint64]*pendingEvaluation
+	err     error // Set once the stream has failed or been closed
+
+	recvDone chan struct{}
+}
+
+// OpenEvaluateStream starts an EvaluateStream call. The stream lives until
+// ctx is cancelled or Close is called; closing it leaves the client open.
+func (c *NeuralClient) OpenEvaluateStream(ctx context.Context) (*EvaluateStream, error) {
+	ctx, cancel := context.WithCancel(ctx)
+	stream, err := c.client.EvaluateStream(ctx)
+	if err != nil {
+		cancel()
+		return nil, fmt.Errorf("failed to open evaluate stream: %v", err)
+	}
+
+	s := &EvaluateStream{
+		client:   c,
+		stream:   stream,
+		cancel:   cancel,
+		pending:  make(map[uint64]*pendingEvaluation),
+		recvDone: make(chan struct{}),
+	}
+	go s.receive()
+	return s, nil
+}
+
+// PredictBatch sends a batch on the stream and waits for its response
+func (s *EvaluateStream) PredictBatch(ctx context.Context, batch [][]float32) ([]*NeuralResponse, error) {
+	if len(batch) == 0 {
+		return []*NeuralResponse{}, nil
+	}
+
+	features, err := packTensor(batch)
+	if err != nil {
+		return nil, err
+	}
+
+	p := &pendingEvaluation{size: len(batch), start: time.Now(), done: make(chan evaluationResult, 1)}
+	s.mu.Lock()
+	if s.err != nil {
+		err := s.err
+		s.mu.Unlock()
+		return nil, err
+	}
+	s.nextID++
+	id := s.nextID
+	s.pending[id] = p
+	s.mu.Unlock()
+
+	s.sendMu.Lock()
+	err = s.stream.Send(&proto.EvaluateRequest{Features: features, RequestId: id})
+	s.sendMu.Unlock()
+	if err != nil {
+		s.forget(id)
+		return nil, fmt.Errorf("stream evaluation failed: %v", err)
+	}
+
+	select {
+	case r := <-p.done:
+		return r.outputs, r.err
+	case <-ctx.Done():
+		s.forget(id)
+		return nil, ctx.Err()
+	}
+}
+
+// forget drops a pending batch whose caller has stopped waiting for it
+func (s *EvaluateStream) forget(id uint64) {
+	s.mu.Lock()
+	delete(s.pending, id)
+	s.mu.Unlock()
+}
+
+// receive delivers responses until the stream ends, then fails whatever is
+// still pending
+func (s *EvaluateStream) receive() {
+	defer close(s.recvDone)
+
+	for {
+		resp, err := s.stream.Recv()
+		if err != nil {
+			if err == io.EOF {
+				err = ErrStreamClosed
+			} else {
+				err = fmt.Errorf("stream evaluation failed: %v", err)
+			}
+			s.fail(err)
+			return
+		}
+
+		s.mu.Lock()
+		p, ok := s.pending[resp.RequestId]
+		delete(s.pending, resp.RequestId)
+		s.mu.Unlock()
+		if !ok {
+			continue
+		}
+
+		s.client.beginCall(p.size)
+		s.client.endCall(p.start, nil)
+
+		outputs, err := unpackEvaluateResponse(resp, p.size)
+		p.done <- evaluationResult{outputs, err}
+	}
+}
+
+// fail ends the stream with err and fails every pending batch
+func (s *EvaluateStream) fail(err error) {
+	s.mu.Lock()
+	if s.err == nil {
+		s.err = err
+	}
+	pending := s.pending
+	s.pending = make(map[uint64]*pendingEvaluation)
+	s.mu.Unlock()
+
+	for _, p := range pending {
+		p.done <- evaluationResult{nil, err}
+	}
+}
+
+// Close ends the stream once the service has answered every batch already
+// sent. Batches sent after Close fail with ErrStreamClosed.
+func (s *EvaluateStream) Close() error {
+	s.mu.Lock()
+	if s.err == nil {
+		s.err = ErrStreamClosed
+	}
+	s.mu.Unlock()
+
+	s.sendMu.Lock()
+	err := s.stream.CloseSend()
+	s.sendMu.Unlock()
+
+	<-s.recvDone
+	s.cancel()
+	return err
+}
+
+// streamBackend is a shared dispatcher's fused backend; closing it also
+// closes the client it was opened on
+type streamBackend struct {
+	*EvaluateStream
+}
+
+func (b streamBackend) Close() error {
+	err := b.EvaluateStream.Close()
+	if cerr := b.client.Close(); err == nil {
+		err = cerr
+	}
+	return err
+}
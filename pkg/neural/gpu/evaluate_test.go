@@ -0,0 +1,268 @@
+package gpu
+
+import (
+	"context"
+	"errors"
+	"fmt"
+	"io"
+	"strings"
+	"sync"
+	"sync/atomic"
+	"testing"
+	"time"
+
+	"github.com/zachbeta/neural_rps/pkg/neural/proto"
+)
+
+// streamServer answers EvaluateStream batches out of order: each request is
+// answered from its own goroutine, later requests sooner. The policy for a
+// row is the row doubled and its value the row's sum, so a response matched
+// to the wrong batch or row is easy to spot. A batch whose first feature is
+// negative fails.
+type streamServer struct {
+	benchServer
+
+	requests    atomic.Int64
+	inFlight    atomic.Int64
+	maxInFlight atomic.Int64
+}
+
+func (s *streamServer) EvaluateStream(stream proto.NeuralService_EvaluateStreamServer) error {
+	var wg sync.WaitGroup
+	defer wg.Wait()
+	var sendMu sync.Mutex
+
+	for {
+		req, err := stream.Recv()
+		if err == io.EOF {
+			return nil
+		}
+		if err != nil {
+			return err
+		}
+		s.requests.Add(1)
+
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			n := s.inFlight.Add(1)
+			for peak := s.maxInFlight.Load(); n > peak; peak = s.maxInFlight.Load() {
+				if s.maxInFlight.CompareAndSwap(peak, n) {
+					break
+				}
+			}
+			time.Sleep(time.Duration(8-req.RequestId%8) * time.Millisecond)
+
+			resp := streamAnswer(req)
+			sendMu.Lock()
+			stream.Send(resp)
+			sendMu.Unlock()
+			s.inFlight.Add(-1)
+		}()
+	}
+}
+
+func streamAnswer(req *proto.EvaluateRequest) *proto.EvaluateResponse {
+	resp := &proto.EvaluateResponse{RequestId: req.RequestId}
+	rows, err := unpackTensor(req.Features, int(req.Features.Shape[0]))
+	if err != nil {
+		resp.Error = err.Error()
+		return resp
+	}
+	if rows[0][0] < 0 {
+		resp.Error = "negative input"
+		return resp
+	}
+
+	policy := make([][]float32, len(rows))
+	resp.Values = make([]float32, len(rows))
+	for i, row := range rows {
+		policy[i] = make([]float32, len(row))
+		for j, v := range row {
+			policy[i][j] = 2 * v
+			resp.Values[i] += v
+		}
+	}
+	if resp.Policy, err = packTensor(policy); err != nil {
+		resp.Error = err.Error()
+	}
+	return resp
+}
+
+// streamBatch returns batch i, whose rows are distinct from every other
+// batch's
+func streamBatch(i int) [][]float32 {
+	batch := make([][]float32, 1+i%5)
+	for r := range batch {
+		batch[r] = make([]float32, benchInputSize)
+		for j := range batch[r] {
+			batch[r][j] = float32(i*1000 + r*100 + j%7)
+		}
+	}
+	return batch
+}
+
+// checkStreamResponse compares a response with streamServer's answer for row
+func checkStreamResponse(resp *NeuralResponse, row []float32) error {
+	var sum float32
+	for _, v := range row {
+		sum += v
+	}
+	if resp == nil || resp.Value != sum || len(resp.Probabilities) != len(row) {
+		return fmt.Errorf("expected value %g and %d probabilities, got %+v", sum, len(row), resp)
+	}
+	for j, v := range row {
+		if resp.Probabilities[j] != 2*v {
+			return fmt.Errorf("probability %d is %g, expected %g", j, resp.Probabilities[j], 2*v)
+		}
+	}
+	if resp.BestMove != argmax(resp.Probabilities) {
+		return fmt.Errorf("best move %d, expected %d", resp.BestMove, argmax(resp.Probabilities))
+	}
+	return nil
+}
+
+func openTestStream(t *testing.T, srv *streamServer) (*NeuralClient, *EvaluateStream) {
+	client, err := NewNeuralClient(serveNeural(t, srv), FusedModelType)
+	if err != nil {
+		t.Fatal(err)
+	}
+	stream, err := client.OpenEvaluateStream(context.Background())
+	if err != nil {
+		client.Close()
+		t.Fatal(err)
+	}
+	return client, stream
+}
+
+func TestEvaluateStreamMatchesResponses(t *testing.T) {
+	srv := &streamServer{}
+	client, stream := openTestStream(t, srv)
+	defer client.Close()
+
+	const batches = 24
+	var wg sync.WaitGroup
+	for i := 0; i < batches; i++ {
+		wg.Add(1)
+		go func(i int) {
+			defer wg.Done()
+			batch := streamBatch(i)
+			outputs, err := stream.PredictBatch(context.Background(), batch)
+			if err != nil {
+				t.Errorf("Batch %d failed: %v", i, err)
+				return
+			}
+			if len(outputs) != len(batch) {
+				t.Errorf("Batch %d of %d returned %d results", i, len(batch), len(outputs))
+				return
+			}
+			for r, row := range batch {
+				if err := checkStreamResponse(outputs[r], row); err != nil {
+					t.Errorf("Batch %d row %d: %v", i, r, err)
+				}
+			}
+		}(i)
+	}
+	wg.Wait()
+
+	if srv.maxInFlight.Load() < 2 {
+		t.Errorf("Expected batches to be in flight together, at most %d were", srv.maxInFlight.Load())
+	}
+
+	if err := stream.Close(); err != nil {
+		t.Fatal(err)
+	}
+	if _, err := stream.PredictBatch(context.Background(), streamBatch(0)); !errors.Is(err, ErrStreamClosed) {
+		t.Errorf("Expected ErrStreamClosed after Close, got %v", err)
+	}
+}
+
+func TestEvaluateStreamBatchError(t *testing.T) {
+	client, stream := openTestStream(t, &streamServer{})
+	defer client.Close()
+	defer stream.Close()
+
+	failing := streamBatch(3)
+	failing[0][0] = -1
+	if _, err := stream.PredictBatch(context.Background(), failing); err == nil || !strings.Contains(err.Error(), "negative input") {
+		t.Fatalf("Expected the service's error, got %v", err)
+	}
+
+	// A failed batch leaves the stream usable
+	batch := streamBatch(4)
+	outputs, err := stream.PredictBatch(context.Background(), batch)
+	if err != nil {
+		t.Fatal(err)
+	}
+	for r, row := range batch {
+		if err := checkStreamResponse(outputs[r], row); err != nil {
+			t.Errorf("Row %d: %v", r, err)
+		}
+	}
+}
+
+func TestEvaluateStreamCancelledBatch(t *testing.T) {
+	client, stream := openTestStream(t, &streamServer{})
+	defer client.Close()
+	defer stream.Close()
+
+	ctx, cancel := context.WithTimeout(context.Background(), time.Millisecond)
+	defer cancel()
+	if _, err := stream.PredictBatch(ctx, streamBatch(1)); !errors.Is(err, context.DeadlineExceeded) {
+		t.Fatalf("Expected context.DeadlineExceeded, got %v", err)
+	}
+
+	// Its late response is dropped rather than delivered to the next batch
+	batch := streamBatch(2)
+	outputs, err := stream.PredictBatch(context.Background(), batch)
+	if err != nil {
+		t.Fatal(err)
+	}
+	for r, row := range batch {
+		if err := checkStreamResponse(outputs[r], row); err != nil {
+			t.Errorf("Row %d: %v", r, err)
+		}
+	}
+}
+
+// TestDispatcherOverEvaluateStream runs a fused shared-style dispatcher over
+// a stream, with several batches pipelined on it at once
+func TestDispatcherOverEvaluateStream(t *testing.T) {
+	srv := &streamServer{}
+	_, stream := openTestStream(t, srv)
+	d := NewBatchDispatcher(streamBackend{stream}, DispatcherConfig{MaxBatchSize: 8, MaxInFlight: 4})
+
+	const requests = 96
+	var wg sync.WaitGroup
+	for i := 0; i < requests; i++ {
+		wg.Add(1)
+		go func(i int) {
+			defer wg.Done()
+			row := streamBatch(5 * i)[0]
+			resp, err := d.Predict(context.Background(), row)
+			if err != nil {
+				t.Errorf("Request %d failed: %v", i, err)
+				return
+			}
+			if err := checkStreamResponse(resp, row); err != nil {
+				t.Errorf("Request %d: %v", i, err)
+			}
+		}(i)
+	}
+	wg.Wait()
+
+	if got := srv.requests.Load(); got >= requests {
+		t.Errorf("Expected requests to share batches, the service saw %d for %d requests", got, requests)
+	}
+	if srv.maxInFlight.Load() < 2 {
+		t.Errorf("Expected batches pipelined on the stream, at most %d were in flight", srv.maxInFlight.Load())
+	}
+
+	// Closing the dispatcher closes the stream and the client under it
+	if err := d.Close(); err != nil {
+		t.Fatal(err)
+	}
+	if _, err := stream.PredictBatch(context.Background(), streamBatch(0)); !errors.Is(err, ErrStreamClosed) {
+		t.Errorf("Expected ErrStreamClosed once the dispatcher is closed, got %v", err)
+	}
+}
@@ -0,0 +1,80 @@
+package gpu
+
+import (
+	"context"
+
+	"github.com/zachbeta/neural_rps/pkg/common"
+)
+
+// float32BatchNetwork is implemented by networks that can run a batch
+// without a float64 round trip, such as onnx.Network
+type float32BatchNetwork interface {
+	ForwardBatchFloat32(inputs [][]float32) ([][]float32, error)
+}
+
+// LocalPredictor runs a common.BatchedNeuralNetwork in-process behind a
+// BatchDispatcher, so GPUBatchedMCTS can use it in place of the neural
+// service. Each response carries the network's outputs as Probabilities and
+// the first output as Value, which suits both policy and value models.
+type LocalPredictor struct {
+	network common.BatchedNeuralNetwork
+}
+
+// NewLocalPredictor wraps network. Closing the predictor closes the network.
+func NewLocalPredictor(network common.BatchedNeuralNetwork) *LocalPredictor {
+	return &LocalPredictor{network: network}
+}
+
+// PredictBatch runs the network on a batch
+func (p *LocalPredictor) PredictBatch(ctx context.Context, batch [][]float32) ([]*NeuralResponse, error) {
+	if err := ctx.Err(); err != nil {
+		return nil, err
+	}
+
+	var outputs [][]float32
+	if fast, ok := p.network.(float32BatchNetwork); ok {
+		var err error
+		if outputs, err = fast.ForwardBatchFloat32(batch); err != nil {
+			return nil, err
+		}
+	} else {
+		inputs := make([][]float64, len(batch))
+		for i, features := range batch {
+			inputs[i] = make([]float64, len(features))
+			for j, v := range features {
+				inputs[i][j] = float64(v)
+			}
+		}
+		outputs64, err := p.network.ForwardBatch(inputs)
+		if err != nil {
+			return nil, err
+		}
+		outputs = make([][]float32, len(outputs64))
+		for i, output := range outputs64 {
+			outputs[i] = make([]float32, len(output))
+			for j, v := range output {
+				outputs[i][j] = float32(v)
+			}
+		}
+	}
+
+	results := make([]*NeuralResponse, len(outputs))
+	for i, output := range outputs {
+		result := &NeuralResponse{Probabilities: output}
+		if len(output) > 0 {
+			result.Value = output[0]
+		}
+		for j, v := range output {
+			if v > output[result.BestMove] {
+				result.BestMove = int32(j)
+			}
+		}
+		results[i] = result
+	}
+	return results, nil
+}
+
+// Close closes the wrapped network
+func (p *LocalPredictor) Close() error {
+	return p.network.Close()
+}
@@ -0,0 +1,17 @@
+package gpu
+
+import (
+	"github.com/zachbeta/neural_rps/pkg/metrics"
+)
+
+// Latency distributions summed over every client and dispatcher in the
+// process, exported by metrics.WritePrometheus. The per-instance averages are
+// in NetworkStats and DispatcherStats.
+var (
+	rpcSeconds = metrics.NewDurationHistogram("neural_client_rpc_seconds",
+		"Time per successful call to the neural service")
+	dispatchQueueWaitSeconds = metrics.NewDurationHistogram("neural_dispatcher_queue_wait_seconds",
+		"Time a request waits in a BatchDispatcher before its batch is sent")
+	dispatchBatchSeconds = metrics.NewDurationHistogram("neural_dispatcher_batch_seconds",
+		"Time per BatchDispatcher batch, from send to response")
+)
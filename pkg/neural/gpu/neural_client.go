@@ -3,7 +3,7 @@ package gpu
 import (
 	"context"
 	"fmt"
-	"sync"
+	"sync/atomic"
 	"time"
 
 	"google.golang.org/grpc"
@@ -24,6 +24,7 @@ type NetworkStats struct {
 	TotalCalls     int
 	TotalPositions int
 	AvgLatencyUs   float64
+	Errors         int // Calls that failed
 }
 
 // NeuralClient is a client for the neural service gRPC API
@@ -33,12 +34,13 @@ type NeuralClient struct {
 	modelType  string
 	inputSize  int
 	outputSize int
+	packed     bool // Service accepts packed BatchPredict tensors
 
-	// Performance metrics
-	totalTime      time.Duration
-	totalCalls     int
-	totalPositions int
-	mu             sync.Mutex
+	// Performance metrics, updated atomically so calls never contend on them
+	totalTime      atomic.Int64 // Nanoseconds
+	totalCalls     atomic.Int64
+	totalPositions atomic.Int64
+	totalErrors    atomic.Int64
 }
 
 // NewNeuralClient creates a new client for the neural service
@@ -65,26 +67,19 @@ func NewNeuralClient(addr string, modelType string) (*NeuralClient, error) {
 	}
 
 	return &NeuralClient{
-		conn:           conn,
-		client:         client,
-		modelType:      modelType,
-		inputSize:      int(info.InputSize),
-		outputSize:     int(info.OutputSize),
-		totalTime:      0,
-		totalCalls:     0,
-		totalPositions: 0,
+		conn:       conn,
+		client:     client,
+		modelType:  modelType,
+		inputSize:  int(info.InputSize),
+		outputSize: int(info.OutputSize),
+		packed:     info.PackedTensors,
 	}, nil
 }
 
 // Predict runs inference on a single input
 func (c *NeuralClient) Predict(ctx context.Context, features []float32) ([]float32, float32, error) {
-	start := time.Time{}
-	c.mu.Lock()
-	c.totalCalls++
-	c.totalPositions++
-	c.mu.Unlock()
-
-	start = time.Now()
+	c.beginCall(1)
+	start := time.Now()
 
 	// Create request
 	req := &proto.PredictRequest{
@@ -94,30 +89,26 @@ func (c *NeuralClient) Predict(ctx context.Context, features []float32) ([]float
 
 	// Make gRPC call
 	resp, err := c.client.Predict(ctx, req)
+	c.endCall(start, err)
 	if err != nil {
 		return nil, 0, fmt.Errorf("prediction failed: %v", err)
 	}
 
-	c.mu.Lock()
-	c.totalTime += time.Since(start)
-	c.mu.Unlock()
-
 	return resp.Probabilities, resp.Value, nil
 }
 
-// PredictBatch runs inference on a batch of inputs
+// PredictBatch runs inference on a batch of inputs. If the service supports
+// it, the batch is sent as one packed tensor rather than a message per row.
 func (c *NeuralClient) PredictBatch(ctx context.Context, batch [][]float32) ([]*NeuralResponse, error) {
 	if len(batch) == 0 {
 		return []*NeuralResponse{}, nil
 	}
+	if c.packed {
+		return c.predictBatchPacked(ctx, batch)
+	}
 
-	start := time.Time{}
-	c.mu.Lock()
-	c.totalCalls++
-	c.totalPositions += len(batch)
-	c.mu.Unlock()
-
-	start = time.Now()
+	c.beginCall(len(batch))
+	start := time.Now()
 
 	// Create batch request
 	req := &proto.BatchPredictRequest{
@@ -134,14 +125,11 @@ func (c *NeuralClient) PredictBatch(ctx context.Context, batch [][]float32) ([]*
 
 	// Make gRPC call
 	resp, err := c.client.BatchPredict(ctx, req)
+	c.endCall(start, err)
 	if err != nil {
 		return nil, fmt.Errorf("batch prediction failed: %v", err)
 	}
 
-	c.mu.Lock()
-	c.totalTime += time.Since(start)
-	c.mu.Unlock()
-
 	// Convert gRPC response to our domain model
 	results := make([]*NeuralResponse, len(resp.Outputs))
 	for i, output := range resp.Outputs {
@@ -155,6 +143,48 @@ func (c *NeuralClient) PredictBatch(ctx context.Context, batch [][]float32) ([]*
 	return results, nil
 }
 
+// predictBatchPacked is PredictBatch with packed input and output tensors
+func (c *NeuralClient) predictBatchPacked(ctx context.Context, batch [][]float32) ([]*NeuralResponse, error) {
+	inputs, err := packTensor(batch)
+	if err != nil {
+		return nil, err
+	}
+
+	c.beginCall(len(batch))
+	start := time.Now()
+
+	resp, err := c.client.BatchPredict(ctx, &proto.BatchPredictRequest{
+		ModelType:    c.modelType,
+		PackedInputs: inputs,
+	})
+	c.endCall(start, err)
+	if err != nil {
+		return nil, fmt.Errorf("batch prediction failed: %v", err)
+	}
+
+	if resp.PackedOutputs == nil {
+		return nil, fmt.Errorf("batch prediction returned no packed outputs")
+	}
+	rows, err := unpackTensor(resp.PackedOutputs, len(batch))
+	if err != nil {
+		return nil, fmt.Errorf("batch prediction outputs: %v", err)
+	}
+
+	// Policy rows are probabilities; a value model's single output is its value
+	results := make([]*NeuralResponse, len(rows))
+	for i, row := range rows {
+		result := &NeuralResponse{}
+		if c.modelType == "policy" {
+			result.Probabilities = row
+			result.BestMove = argmax(row)
+		} else if len(row) > 0 {
+			result.Value = row[0]
+		}
+		results[i] = result
+	}
+	return results, nil
+}
+
 // GetInputSize returns the neural network input size
 func (c *NeuralClient) GetInputSize() int {
 	return c.inputSize
@@ -167,19 +197,36 @@ func (c *NeuralClient) GetOutputSize() int {
 
 // GetStats returns performance statistics for the neural network
 func (c *NeuralClient) GetStats() NetworkStats {
-	c.mu.Lock()
-	defer c.mu.Unlock()
+	calls := c.totalCalls.Load()
 
 	var avgLatency float64
-	if c.totalCalls > 0 {
-		avgLatency = float64(c.totalTime.Microseconds()) / float64(c.totalCalls)
+	if calls > 0 {
+		avgLatency = float64(c.totalTime.Load()) / 1e3 / float64(calls)
 	}
 
 	return NetworkStats{
-		TotalCalls:     c.totalCalls,
-		TotalPositions: c.totalPositions,
+		TotalCalls:     int(calls),
+		TotalPositions: int(c.totalPositions.Load()),
 		AvgLatencyUs:   avgLatency,
+		Errors:         int(c.totalErrors.Load()),
+	}
+}
+
+// beginCall counts a call of n positions
+func (c *NeuralClient) beginCall(n int) {
+	c.totalCalls.Add(1)
+	c.totalPositions.Add(int64(n))
+}
+
+// endCall records the latency of a call begun at start, or its failure
+func (c *NeuralClient) endCall(start time.Time, err error) {
+	if err != nil {
+		c.totalErrors.Add(1)
+		return
 	}
+	elapsed := time.Since(start)
+	c.totalTime.Add(int64(elapsed))
+	rpcSeconds.ObserveDuration(elapsed)
 }
 
 // Close closes the connection to the neural service
@@ -0,0 +1,112 @@
+package gpu
+
+import (
+	"context"
+	"fmt"
+	"net"
+	"testing"
+
+	"google.golang.org/grpc"
+
+	"github.com/zachbeta/neural_rps/pkg/neural/proto"
+)
+
+const (
+	benchInputSize  = 81
+	benchOutputSize = 9
+)
+
+// benchServer is a stand-in neural service answering every position with a
+// uniform policy, so benchmarks time the client and the transport, not a model
+type benchServer struct {
+	proto.UnimplementedNeuralServiceServer
+	packed bool
+}
+
+func (s *benchServer) GetModelInfo(ctx context.Context, req *proto.ModelInfoRequest) (*proto.ModelInfoResponse, error) {
+	return &proto.ModelInfoResponse{
+		InputSize:     benchInputSize,
+		OutputSize:    benchOutputSize,
+		Device:        "cpu",
+		PackedTensors: s.packed,
+	}, nil
+}
+
+func (s *benchServer) BatchPredict(ctx context.Context, req *proto.BatchPredictRequest) (*proto.BatchPredictResponse, error) {
+	uniform := make([]float32, benchOutputSize)
+	for i := range uniform {
+		uniform[i] = 1.0 / benchOutputSize
+	}
+
+	if req.PackedInputs != nil {
+		n := int(req.PackedInputs.Shape[0])
+		rows := make([][]float32, n)
+		for i := range rows {
+			rows[i] = uniform
+		}
+		outputs, err := packTensor(rows)
+		if err != nil {
+			return nil, err
+		}
+		return &proto.BatchPredictResponse{PackedOutputs: outputs}, nil
+	}
+
+	outputs := make([]*proto.PredictResponse, len(req.Inputs))
+	for i := range outputs {
+		outputs[i] = &proto.PredictResponse{Probabilities: uniform}
+	}
+	return &proto.BatchPredictResponse{Outputs: outputs}, nil
+}
+
+// startBenchServer serves a benchServer on a loopback port for the rest of b
+func startBenchServer(b *testing.B, packed bool) string {
+	return serveNeural(b, &benchServer{packed: packed})
+}
+
+// serveNeural serves srv on a loopback port for the rest of tb
+func serveNeural(tb testing.TB, srv proto.NeuralServiceServer) string {
+	lis, err := net.Listen("tcp", "127.0.0.1:0")
+	if err != nil {
+		tb.Fatalf("Failed to listen: %v", err)
+	}
+	server := grpc.NewServer()
+	proto.RegisterNeuralServiceServer(server, srv)
+	go server.Serve(lis)
+	tb.Cleanup(server.Stop)
+	return lis.Addr().String()
+}
+
+// BenchmarkNeuralClientPredictBatch times PredictBatch round trips over
+// loopback, with per-row messages and with packed tensors
+func BenchmarkNeuralClientPredictBatch(b *testing.B) {
+	for _, packed := range []bool{false, true} {
+		addr := startBenchServer(b, packed)
+		client, err := NewNeuralClient(addr, "policy")
+		if err != nil {
+			b.Fatal(err)
+		}
+		b.Cleanup(func() { client.Close() })
+
+		for _, size := range []int{1, 16, 64} {
+			batch := make([][]float32, size)
+			for i := range batch {
+				batch[i] = make([]float32, benchInputSize)
+				batch[i][i%benchInputSize] = 1
+			}
+
+			b.Run(fmt.Sprintf("packed=%t/batch=%d", packed, size), func(b *testing.B) {
+				ctx := context.Background()
+				b.ReportAllocs()
+				b.ResetTimer()
+				for i := 0; i < b.N; i++ {
+					if _, err := client.PredictBatch(ctx, batch); err != nil {
+						b.Fatal(err)
+					}
+				}
+				if s := b.Elapsed().Seconds(); s > 0 {
+					b.ReportMetric(float64(b.N*size)/s, "positions/sec")
+				}
+			})
+		}
+	}
+}
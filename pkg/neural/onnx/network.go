@@ -0,0 +1,474 @@
+// Package onnx runs ONNX models in-process with ONNX Runtime, as an
+// alternative to the Python gRPC neural service.
+package onnx
+
+import (
+	"errors"
+	"fmt"
+	"os"
+	"runtime"
+	"strconv"
+	"sync"
+	"time"
+
+	ort "github.com/yalue/onnxruntime_go"
+
+	"github.com/zachbeta/neural_rps/pkg/common"
+)
+
+// Provider selects the ONNX Runtime execution provider a session runs on
+type Provider string
+
+const (
+	ProviderCPU      Provider = "cpu"
+	ProviderCUDA     Provider = "cuda"
+	ProviderTensorRT Provider = "tensorrt"
+	ProviderCoreML   Provider = "coreml"
+)
+
+// ErrClosed is returned for inference on a Network after Close
+var ErrClosed = errors.New("onnx network closed")
+
+// LibraryPathEnv names the environment variable consulted for the ONNX
+// Runtime shared library when Config.SharedLibraryPath is empty
+const LibraryPathEnv = "ONNXRUNTIME_LIB"
+
+// Config describes a model and how to run it
+type Config struct {
+	ModelPath string
+
+	// SharedLibraryPath is the ONNX Runtime shared library. If empty,
+	// $ONNXRUNTIME_LIB is used, then the platform's default library name.
+	SharedLibraryPath string
+
+	Provider Provider // Defaults to ProviderCPU
+	DeviceID int      // GPU for ProviderCUDA and ProviderTensorRT
+
+	// Tensor names; default to "input" and "output", as exported by
+	// python/train_from_go_examples.py
+	InputName  string
+	OutputName string
+
+	// MaxBatchSize is the capacity of the preallocated tensors. Larger
+	// batches are run in chunks. Defaults to 256.
+	MaxBatchSize int
+
+	IntraOpThreads int // 0 lets ONNX Runtime decide
+}
+
+// DefaultConfig returns a CPU configuration for the model at modelPath
+func DefaultConfig(modelPath string) Config {
+	return Config{
+		ModelPath:    modelPath,
+		Provider:     ProviderCPU,
+		InputName:    "input",
+		OutputName:   "output",
+		MaxBatchSize: 256,
+	}
+}
+
+// defaultLibraryPath is the name the ONNX Runtime library is installed under
+func defaultLibraryPath() string {
+	switch runtime.GOOS {
+	case "darwin":
+		return "libonnxruntime.dylib"
+	case "windows":
+		return "onnxruntime.dll"
+	default:
+		return "libonnxruntime.so"
+	}
+}
+
+var (
+	envMu      sync.Mutex
+	envRefs    int
+	envLibrary string
+)
+
+// acquireEnvironment initializes the process-wide ONNX Runtime environment on
+// first use. Every network shares it, so they must agree on the library.
+func acquireEnvironment(libraryPath string) error {
+	if libraryPath == "" {
+		libraryPath = os.Getenv(LibraryPathEnv)
+	}
+	if libraryPath == "" {
+		libraryPath = defaultLibraryPath()
+	}
+
+	envMu.Lock()
+	defer envMu.Unlock()
+
+	if envRefs > 0 {
+		if libraryPath != envLibrary {
+			return fmt.Errorf("ONNX Runtime already initialized from %s, cannot load %s", envLibrary, libraryPath)
+		}
+		envRefs++
+		return nil
+	}
+
+	ort.SetSharedLibraryPath(libraryPath)
+	if err := ort.InitializeEnvironment(); err != nil {
+		return fmt.Errorf("failed to initialize ONNX Runtime from %s: %v", libraryPath, err)
+	}
+	envLibrary = libraryPath
+	envRefs = 1
+	return nil
+}
+
+// releaseEnvironment destroys the environment once the last network is closed
+func releaseEnvironment() error {
+	envMu.Lock()
+	defer envMu.Unlock()
+
+	envRefs--
+	if envRefs > 0 {
+		return nil
+	}
+	return ort.DestroyEnvironment()
+}
+
+// newSessionOptions builds session options for the configured provider
+func newSessionOptions(config Config) (*ort.SessionOptions, error) {
+	options, err := ort.NewSessionOptions()
+	if err != nil {
+		return nil, err
+	}
+	if config.IntraOpThreads > 0 {
+		if err := options.SetIntraOpNumThreads(config.IntraOpThreads); err != nil {
+			options.Destroy()
+			return nil, err
+		}
+	}
+
+	switch config.Provider {
+	case "", ProviderCPU:
+	case ProviderCUDA:
+		cudaOptions, err := ort.NewCUDAProviderOptions()
+		if err == nil {
+			err = cudaOptions.Update(map[string]string{"device_id": strconv.Itoa(config.DeviceID)})
+			if err == nil {
+				err = options.AppendExecutionProviderCUDA(cudaOptions)
+			}
+			cudaOptions.Destroy()
+		}
+		if err != nil {
+			options.Destroy()
+			return nil, fmt.Errorf("failed to enable CUDA provider: %v", err)
+		}
+	case ProviderTensorRT:
+		trtOptions, err := ort.NewTensorRTProviderOptions()
+		if err == nil {
+			err = trtOptions.Update(map[string]string{"device_id": strconv.Itoa(config.DeviceID)})
+			if err == nil {
+				err = options.AppendExecutionProviderTensorRT(trtOptions)
+			}
+			trtOptions.Destroy()
+		}
+		if err != nil {
+			options.Destroy()
+			return nil, fmt.Errorf("failed to enable TensorRT provider: %v", err)
+		}
+	case ProviderCoreML:
+		if err := options.AppendExecutionProviderCoreML(0); err != nil {
+			options.Destroy()
+			return nil, fmt.Errorf("failed to enable CoreML provider: %v", err)
+		}
+	default:
+		options.Destroy()
+		return nil, fmt.Errorf("unknown execution provider %q", config.Provider)
+	}
+	return options, nil
+}
+
+// batchTensors is an input/output tensor pair for one batch size. Every pair
+// views the same preallocated buffers.
+type batchTensors struct {
+	input  *ort.Tensor[float32]
+	output *ort.Tensor[float32]
+}
+
+// Network runs an ONNX model with a [batch, inputs] input and a
+// [batch, outputs] output. It implements common.BatchedNeuralNetwork and is
+// safe for concurrent use; calls are serialised because they share the
+// preallocated tensors, so use one Network per thread of inference.
+type Network struct {
+	session    *ort.DynamicAdvancedSession
+	inputSize  int
+	outputSize int
+	maxBatch   int
+
+	mu      sync.Mutex
+	inputs  []float32 // maxBatch x inputSize
+	outputs []float32 // maxBatch x outputSize
+	tensors map[int]batchTensors
+
+	// Performance metrics
+	totalTime      time.Duration
+	totalCalls     int
+	totalPositions int
+}
+
+// Ensure Network implements common.BatchedNeuralNetwork
+var _ common.BatchedNeuralNetwork = (*Network)(nil)
+
+// NewNetwork loads a model
+func NewNetwork(config Config) (*Network, error) {
+	defaults := DefaultConfig(config.ModelPath)
+	if config.InputName == "" {
+		config.InputName = defaults.InputName
+	}
+	if config.OutputName == "" {
+		config.OutputName = defaults.OutputName
+	}
+	if config.MaxBatchSize < 1 {
+		config.MaxBatchSize = defaults.MaxBatchSize
+	}
+
+	if err := acquireEnvironment(config.SharedLibraryPath); err != nil {
+		return nil, err
+	}
+
+	network, err := newNetwork(config)
+	if err != nil {
+		releaseEnvironment()
+		return nil, err
+	}
+	return network, nil
+}
+
+func newNetwork(config Config) (*Network, error) {
+	inputsInfo, outputsInfo, err := ort.GetInputOutputInfo(config.ModelPath)
+	if err != nil {
+		return nil, fmt.Errorf("failed to read ONNX model %s: %v", config.ModelPath, err)
+	}
+	inputSize, err := featureSize(inputsInfo, config.InputName)
+	if err != nil {
+		return nil, fmt.Errorf("ONNX model %s: %v", config.ModelPath, err)
+	}
+	outputSize, err := featureSize(outputsInfo, config.OutputName)
+	if err != nil {
+		return nil, fmt.Errorf("ONNX model %s: %v", config.ModelPath, err)
+	}
+
+	options, err := newSessionOptions(config)
+	if err != nil {
+		return nil, err
+	}
+	defer options.Destroy()
+
+	session, err := ort.NewDynamicAdvancedSession(config.ModelPath,
+		[]string{config.InputName}, []string{config.OutputName}, options)
+	if err != nil {
+		return nil, fmt.Errorf("failed to create ONNX session for %s: %v", config.ModelPath, err)
+	}
+
+	return &Network{
+		session:    session,
+		inputSize:  inputSize,
+		outputSize: outputSize,
+		maxBatch:   config.MaxBatchSize,
+		inputs:     make([]float32, config.MaxBatchSize*inputSize),
+		outputs:    make([]float32, config.MaxBatchSize*outputSize),
+		tensors:    make(map[int]batchTensors),
+	}, nil
+}
+
+// featureSize returns the last dimension of the named tensor, which must be
+// [batch, features]
+func featureSize(infos []ort.InputOutputInfo, name string) (int, error) {
+	for _, info := range infos {
+		if info.Name != name {
+			continue
+		}
+		dims := info.Dimensions
+		if len(dims) != 2 || dims[1] <= 0 {
+			return 0, fmt.Errorf("tensor %q has shape %v, expected [batch, features]", name, dims)
+		}
+		return int(dims[1]), nil
+	}
+	return 0, fmt.Errorf("no tensor named %q", name)
+}
+
+// tensorsFor returns the tensors for a batch of n rows, creating them the
+// first time that size is seen. Must be called with mu held.
+func (n *Network) tensorsFor(rows int) (batchTensors, error) {
+	if t, ok := n.tensors[rows]; ok {
+		return t, nil
+	}
+
+	input, err := ort.NewTensor(ort.NewShape(int64(rows), int64(n.inputSize)), n.inputs[:rows*n.inputSize])
+	if err != nil {
+		return batchTensors{}, err
+	}
+	output, err := ort.NewTensor(ort.NewShape(int64(rows), int64(n.outputSize)), n.outputs[:rows*n.outputSize])
+	if err != nil {
+		input.Destroy()
+		return batchTensors{}, err
+	}
+
+	t := batchTensors{input: input, output: output}
+	n.tensors[rows] = t
+	return t, nil
+}
+
+// ForwardBatchFloat32 runs the model on a batch without converting to
+// float64. The returned rows share one freshly allocated buffer.
+func (n *Network) ForwardBatchFloat32(inputs [][]float32) ([][]float32, error) {
+	results := make([][]float32, len(inputs))
+	flat := make([]float32, len(inputs)*n.outputSize)
+
+	n.mu.Lock()
+	defer n.mu.Unlock()
+	if n.session == nil {
+		return nil, ErrClosed
+	}
+	start := time.Now()
+
+	for chunk := 0; chunk < len(inputs); chunk += n.maxBatch {
+		rows := min(len(inputs)-chunk, n.maxBatch)
+
+		for i := 0; i < rows; i++ {
+			row := inputs[chunk+i]
+			if len(row) != n.inputSize {
+				return nil, errors.New("input size mismatch")
+			}
+			copy(n.inputs[i*n.inputSize:], row)
+		}
+
+		if err := n.run(rows); err != nil {
+			return nil, err
+		}
+
+		out := flat[chunk*n.outputSize : (chunk+rows)*n.outputSize]
+		copy(out, n.outputs[:rows*n.outputSize])
+		for i := 0; i < rows; i++ {
+			results[chunk+i] = out[i*n.outputSize : (i+1)*n.outputSize : (i+1)*n.outputSize]
+		}
+	}
+
+	n.totalTime += time.Since(start)
+	n.totalCalls++
+	n.totalPositions += len(inputs)
+	return results, nil
+}
+
+// run evaluates the first rows rows of the input buffer. Must be called with
+// mu held.
+func (n *Network) run(rows int) error {
+	t, err := n.tensorsFor(rows)
+	if err != nil {
+		return fmt.Errorf("failed to create ONNX tensors: %v", err)
+	}
+	if err := n.session.Run([]ort.Value{t.input}, []ort.Value{t.output}); err != nil {
+		return fmt.Errorf("ONNX inference failed: %v", err)
+	}
+	return nil
+}
+
+// Forward runs the model on a single input
+func (n *Network) Forward(input []float64) ([]float64, error) {
+	outputs, err := n.ForwardBatch([][]float64{input})
+	if err != nil {
+		return nil, err
+	}
+	return outputs[0], nil
+}
+
+// ForwardBatch runs the model on a batch of inputs
+func (n *Network) ForwardBatch(inputs [][]float64) ([][]float64, error) {
+	inputs32 := make([][]float32, len(inputs))
+	flat := make([]float32, len(inputs)*n.inputSize)
+	for i, input := range inputs {
+		if len(input) != n.inputSize {
+			return nil, errors.New("input size mismatch")
+		}
+		row := flat[i*n.inputSize : (i+1)*n.inputSize]
+		for j, v := range input {
+			row[j] = float32(v)
+		}
+		inputs32[i] = row
+	}
+
+	outputs32, err := n.ForwardBatchFloat32(inputs32)
+	if err != nil {
+		return nil, err
+	}
+
+	outputs := make([][]float64, len(outputs32))
+	flatOut := make([]float64, len(outputs32)*n.outputSize)
+	for i, output := range outputs32 {
+		row := flatOut[i*n.outputSize : (i+1)*n.outputSize : (i+1)*n.outputSize]
+		for j, v := range output {
+			row[j] = float64(v)
+		}
+		outputs[i] = row
+	}
+	return outputs, nil
+}
+
+// PredictBatch returns the index of the highest output for each input
+func (n *Network) PredictBatch(inputs [][]float64) ([]int, error) {
+	outputs, err := n.ForwardBatch(inputs)
+	if err != nil {
+		return nil, err
+	}
+
+	predictions := make([]int, len(outputs))
+	for i, output := range outputs {
+		for j, v := range output {
+			if v > output[predictions[i]] {
+				predictions[i] = j
+			}
+		}
+	}
+	return predictions, nil
+}
+
+// GetInputSize returns the model's input size
+func (n *Network) GetInputSize() int {
+	return n.inputSize
+}
+
+// GetOutputSize returns the model's output size
+func (n *Network) GetOutputSize() int {
+	return n.outputSize
+}
+
+// GetStats returns performance statistics for the network
+func (n *Network) GetStats() common.NetworkStats {
+	n.mu.Lock()
+	defer n.mu.Unlock()
+
+	stats := common.NetworkStats{
+		TotalCalls:     n.totalCalls,
+		TotalBatchSize: n.totalPositions,
+	}
+	if n.totalCalls > 0 {
+		stats.AvgLatencyUs = float64(n.totalTime.Microseconds()) / float64(n.totalCalls)
+		stats.AvgBatchSize = float64(n.totalPositions) / float64(n.totalCalls)
+	}
+	return stats
+}
+
+// Close releases the session and its tensors. Inference after Close fails
+// with ErrClosed.
+func (n *Network) Close() error {
+	n.mu.Lock()
+	defer n.mu.Unlock()
+
+	if n.session == nil {
+		return nil
+	}
+	for _, t := range n.tensors {
+		t.input.Destroy()
+		t.output.Destroy()
+	}
+	n.tensors = nil
+	err := n.session.Destroy()
+	n.session = nil
+
+	if envErr := releaseEnvironment(); err == nil {
+		err = envErr
+	}
+	return err
+}
@@ -0,0 +1,105 @@
+package onnx
+
+import (
+	"errors"
+	"math"
+	"math/rand"
+	"os"
+	"testing"
+)
+
+// fixtureModel is the small policy network exported by
+// python/train_from_go_examples.py
+const fixtureModel = "../../../python/output/pytorch_policy_h64.onnx"
+
+// openFixture loads fixtureModel, skipping the test when ONNX Runtime or the
+// model is not available
+func openFixture(t *testing.T, maxBatch int) *Network {
+	t.Helper()
+	if os.Getenv(LibraryPathEnv) == "" {
+		t.Skipf("Set %s to the ONNX Runtime shared library to run", LibraryPathEnv)
+	}
+	if _, err := os.Stat(fixtureModel); err != nil {
+		t.Skipf("Fixture model not available: %v", err)
+	}
+
+	config := DefaultConfig(fixtureModel)
+	config.MaxBatchSize = maxBatch
+	network, err := NewNetwork(config)
+	if err != nil {
+		t.Fatal(err)
+	}
+	return network
+}
+
+func randomInputs(rng *rand.Rand, n, size int) [][]float64 {
+	inputs := make([][]float64, n)
+	for i := range inputs {
+		inputs[i] = make([]float64, size)
+		for j := range inputs[i] {
+			inputs[i][j] = rng.Float64()
+		}
+	}
+	return inputs
+}
+
+func TestNetworkForward(t *testing.T) {
+	// A batch limit below the batch size makes ForwardBatch run in chunks
+	network := openFixture(t, 2)
+	defer network.Close()
+
+	if network.GetInputSize() <= 0 || network.GetOutputSize() <= 0 {
+		t.Fatalf("Expected the model's sizes, got %d inputs and %d outputs", network.GetInputSize(), network.GetOutputSize())
+	}
+
+	inputs := randomInputs(rand.New(rand.NewSource(1)), 5, network.GetInputSize())
+	outputs, err := network.ForwardBatch(inputs)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if len(outputs) != len(inputs) {
+		t.Fatalf("Expected %d outputs, got %d", len(inputs), len(outputs))
+	}
+	for i, input := range inputs {
+		want, err := network.Forward(input)
+		if err != nil {
+			t.Fatal(err)
+		}
+		if len(want) != network.GetOutputSize() {
+			t.Fatalf("Expected %d outputs, got %d", network.GetOutputSize(), len(want))
+		}
+		for j := range want {
+			if math.Abs(outputs[i][j]-want[j]) > 1e-5 {
+				t.Fatalf("Input %d output %d: batch gives %g, Forward %g", i, j, outputs[i][j], want[j])
+			}
+		}
+	}
+
+	if _, err := network.Forward(make([]float64, network.GetInputSize()+1)); err == nil {
+		t.Error("Expected an error for an input of the wrong size")
+	}
+	if stats := network.GetStats(); stats.TotalCalls != 1+len(inputs) {
+		t.Errorf("Expected %d calls, got %d", 1+len(inputs), stats.TotalCalls)
+	}
+}
+
+func TestNetworkClose(t *testing.T) {
+	network := openFixture(t, 4)
+	input := make([]float64, network.GetInputSize())
+	if _, err := network.Forward(input); err != nil {
+		t.Fatal(err)
+	}
+
+	if err := network.Close(); err != nil {
+		t.Fatal(err)
+	}
+	if _, err := network.Forward(input); !errors.Is(err, ErrClosed) {
+		t.Errorf("Expected ErrClosed after Close, got %v", err)
+	}
+	if _, err := network.ForwardBatchFloat32([][]float32{make([]float32, network.GetInputSize())}); !errors.Is(err, ErrClosed) {
+		t.Errorf("Expected ErrClosed from ForwardBatchFloat32 after Close, got %v", err)
+	}
+	if err := network.Close(); err != nil {
+		t.Errorf("Expected a second Close to do nothing, got %v", err)
+	}
+}
@@ -19,9 +19,11 @@ import (
 const _ = grpc.SupportPackageIsVersion7
 
 const (
-	NeuralService_Predict_FullMethodName      = "/neural.NeuralService/Predict"
-	NeuralService_BatchPredict_FullMethodName = "/neural.NeuralService/BatchPredict"
-	NeuralService_GetModelInfo_FullMethodName = "/neural.NeuralService/GetModelInfo"
+	NeuralService_Predict_FullMethodName        = "/neural.NeuralService/Predict"
+	NeuralService_BatchPredict_FullMethodName   = "/neural.NeuralService/BatchPredict"
+	NeuralService_GetModelInfo_FullMethodName   = "/neural.NeuralService/GetModelInfo"
+	NeuralService_EvaluateBatch_FullMethodName  = "/neural.NeuralService/EvaluateBatch"
+	NeuralService_EvaluateStream_FullMethodName = "/neural.NeuralService/EvaluateStream"
 )
 
 // NeuralServiceClient is the client API for NeuralService service.
@@ -34,6 +36,12 @@ type NeuralServiceClient interface {
 	BatchPredict(ctx context.Context, in *BatchPredictRequest, opts ...grpc.CallOption) (*BatchPredictResponse, error)
 	// GetModelInfo returns information about the loaded model
 	GetModelInfo(ctx context.Context, in *ModelInfoRequest, opts ...grpc.CallOption) (*ModelInfoResponse, error)
+	// EvaluateBatch runs the policy and value models on a batch in one call
+	EvaluateBatch(ctx context.Context, in *EvaluateRequest, opts ...grpc.CallOption) (*EvaluateResponse, error)
+	// EvaluateStream is EvaluateBatch over a bidirectional stream, so a client
+	// can keep several batches in flight on one call. Responses carry the
+	// request_id of the request they answer and may arrive in any order.
+	EvaluateStream(ctx context.Context, opts ...grpc.CallOption) (NeuralService_EvaluateStreamClient, error)
 }
 
 type neuralServiceClient struct {
@@ -71,6 +79,46 @@ func (c *neuralServiceClient) GetModelInfo(ctx context.Context, in *ModelInfoReq
 	return out, nil
 }
 
+func (c *neuralServiceClient) EvaluateBatch(ctx context.Context, in *EvaluateRequest, opts ...grpc.CallOption) (*EvaluateResponse, error) {
+	out := new(EvaluateResponse)
+	err := c.cc.Invoke(ctx, NeuralService_EvaluateBatch_FullMethodName, in, out, opts...)
+	if err != nil {
+		return nil, err
+	}
+	return out, nil
+}
+
+func (c *neuralServiceClient) EvaluateStream(ctx context.Context, opts ...grpc.CallOption) (NeuralService_EvaluateStreamClient, error) {
+	stream, err := c.cc.NewStream(ctx, &NeuralService_ServiceDesc.Streams[0], NeuralService_EvaluateStream_FullMethodName, opts...)
+	if err != nil {
+		return nil, err
+	}
+	x := &neuralServiceEvaluateStreamClient{stream}
+	return x, nil
+}
+
+type NeuralService_EvaluateStreamClient interface {
+	Send(*EvaluateRequest) error
+	Recv() (*EvaluateResponse, error)
+	grpc.ClientStream
+}
+
+type neuralServiceEvaluateStreamClient struct {
+	grpc.ClientStream
+}
+
+func (x *neuralServiceEvaluateStreamClient) Send(m *EvaluateRequest) error {
+	return x.ClientStream.SendMsg(m)
+}
+
+func (x *neuralServiceEvaluateStreamClient) Recv() (*EvaluateResponse, error) {
+	m := new(EvaluateResponse)
+	if err := x.ClientStream.RecvMsg(m); err != nil {
+		return nil, err
+	}
+	return m, nil
+}
+
 // NeuralServiceServer is the server API for NeuralService service.
 // All implementations must embed UnimplementedNeuralServiceServer
 // for forward compatibility
@@ -81,6 +129,12 @@ type NeuralServiceServer interface {
 	BatchPredict(context.Context, *BatchPredictRequest) (*BatchPredictResponse, error)
 	// GetModelInfo returns information about the loaded model
 	GetModelInfo(context.Context, *ModelInfoRequest) (*ModelInfoResponse, error)
+	// EvaluateBatch runs the policy and value models on a batch in one call
+	EvaluateBatch(context.Context, *EvaluateRequest) (*EvaluateResponse, error)
+	// EvaluateStream is EvaluateBatch over a bidirectional stream, so a client
+	// can keep several batches in flight on one call. Responses carry the
+	// request_id of the request they answer and may arrive in any order.
+	EvaluateStream(NeuralService_EvaluateStreamServer) error
 	mustEmbedUnimplementedNeuralServiceServer()
 }
 
@@ -97,6 +151,12 @@ func (UnimplementedNeuralServiceServer) BatchPredict(context.Context, *BatchPred
 func (UnimplementedNeuralServiceServer) GetModelInfo(context.Context, *ModelInfoRequest) (*ModelInfoResponse, error) {
 	return nil, status.Errorf(codes.Unimplemented, "method GetModelInfo not implemented")
 }
+func (UnimplementedNeuralServiceServer) EvaluateBatch(context.Context, *EvaluateRequest) (*EvaluateResponse, error) {
+	return nil, status.Errorf(codes.Unimplemented, "method EvaluateBatch not implemented")
+}
+func (UnimplementedNeuralServiceServer) EvaluateStream(NeuralService_EvaluateStreamServer) error {
+	return status.Errorf(codes.Unimplemented, "method EvaluateStream not implemented")
+}
 func (UnimplementedNeuralServiceServer) mustEmbedUnimplementedNeuralServiceServer() {}
 
 // UnsafeNeuralServiceServer may be embedded to opt out of forward compatibility for this service.
@@ -164,6 +224,50 @@ func _NeuralService_GetModelInfo_Handler(srv interface{}, ctx context.Context, d
 	return interceptor(ctx, in, info, handler)
 }
 
+func _NeuralService_EvaluateBatch_Handler(srv interface{}, ctx context.Context, dec func(interface{}) error, interceptor grpc.UnaryServerInterceptor) (interface{}, error) {
+	in := new(EvaluateRequest)
+	if err := dec(in); err != nil {
+		return nil, err
+	}
+	if interceptor == nil {
+		return srv.(NeuralServiceServer).EvaluateBatch(ctx, in)
+	}
+	info := &grpc.UnaryServerInfo{
+		Server:     srv,
+		FullMethod: NeuralService_EvaluateBatch_FullMethodName,
+	}
+	handler := func(ctx context.Context, req interface{}) (interface{}, error) {
+		return srv.(NeuralServiceServer).EvaluateBatch(ctx, req.(*EvaluateRequest))
+	}
+	return interceptor(ctx, in, info, handler)
+}
+
+func _NeuralService_EvaluateStream_Handler(srv interface{}, stream grpc.ServerStream) error {
+	return srv.(NeuralServiceServer).EvaluateStream(&neuralServiceEvaluateStreamServer{stream})
+}
+
+type NeuralService_EvaluateStreamServer interface {
+	Send(*EvaluateResponse) error
+	Recv() (*EvaluateRequest, error)
+	grpc.ServerStream
+}
+
+type neuralServiceEvaluateStreamServer struct {
+	grpc.ServerStream
+}
+
+func (x *neuralServiceEvaluateStreamServer) Send(m *EvaluateResponse) error {
+	return x.ServerStream.SendMsg(m)
+}
+
+func (x *neuralServiceEvaluateStreamServer) Recv() (*EvaluateRequest, error) {
+	m := new(EvaluateRequest)
+	if err := x.ServerStream.RecvMsg(m); err != nil {
+		return nil, err
+	}
+	return m, nil
+}
+
 // NeuralService_ServiceDesc is the grpc.ServiceDesc for NeuralService service.
 // It's only intended for direct use with grpc.RegisterService,
 // and not to be introspected or modified (even as a copy)
@@ -183,7 +287,18 @@ var NeuralService_ServiceDesc = grpc.ServiceDesc{
 			MethodName: "GetModelInfo",
 			Handler:    _NeuralService_GetModelInfo_Handler,
 		},
+		{
+			MethodName: "EvaluateBatch",
+			Handler:    _NeuralService_EvaluateBatch_Handler,
+		},
+	},
+	Streams: []grpc.StreamDesc{
+		{
+			StreamName:    "EvaluateStream",
+			Handler:       _NeuralService_EvaluateStream_Handler,
+			ServerStreams: true,
+			ClientStreams: true,
+		},
 	},
-	Streams:  []grpc.StreamDesc{},
 	Metadata: "proto/neural_service.proto",
 }
@@ -14,7 +14,7 @@ _sym_db = _symbol_database.Default()
 
 
 
-DESCRIPTOR = _descriptor_pool.Default().AddSerializedFile(b'\n\x1aproto/neural_service.proto\x12\x06neural\"6\n\x0ePredictRequest\x12\x10\n\x08\x66\x65\x61tures\x18\x01 \x03(\x02\x12\x12\n\nmodel_type\x18\x02 \x01(\t\"J\n\x0fPredictResponse\x12\x15\n\rprobabilities\x18\x01 \x03(\x02\x12\r\n\x05value\x18\x02 \x01(\x02\x12\x11\n\tbest_move\x18\x03 \x01(\x05\"P\n\x13\x42\x61tchPredictRequest\x12%\n\x06inputs\x18\x01 \x03(\x0b\x32\x15.neural.InputFeatures\x12\x12\n\nmodel_type\x18\x02 \x01(\t\"!\n\rInputFeatures\x12\x10\n\x08\x66\x65\x61tures\x18\x01 \x03(\x02\"@\n\x14\x42\x61tchPredictResponse\x12(\n\x07outputs\x18\x01 \x03(\x0b\x32\x17.neural.PredictResponse\"&\n\x10ModelInfoRequest\x12\x12\n\nmodel_type\x18\x01 \x01(\t\"t\n\x11ModelInfoResponse\x12\x12\n\ninput_size\x18\x01 \x01(\x05\x12\x13\n\x0bhidden_size\x18\x02 \x01(\x05\x12\x13\n\x0boutput_size\x18\x03 \x01(\x05\x12\x0e\n\x06\x64\x65vice\x18\x04 \x01(\t\x12\x11\n\tframework\x18\x05 \x01(\t2\xe1\x01\n\rNeuralService\x12<\n\x07Predict\x12\x16.neural.PredictRequest\x1a\x17.neural.PredictResponse\"\x00\x12K\n\x0c\x42\x61tchPredict\x12\x1b.neural.BatchPredictRequest\x1a\x1c.neural.BatchPredictResponse\"\x00\x12\x45\n\x0cGetModelInfo\x12\x18.neural.ModelInfoRequest\x1a\x19.neural.ModelInfoResponse\"\x00\x42\x31Z/github.com/zachbeta/neural_rps/pkg/neural/protob\x06proto3')
+DESCRIPTOR = _descriptor_pool.Default().AddSerializedFile(b'\n\x1aproto/neural_service.proto\x12\x06neural\"6\n\x0ePredictRequest\x12\x10\n\x08\x66\x65\x61tures\x18\x01 \x03(\x02\x12\x12\n\nmodel_type\x18\x02 \x01(\t\"J\n\x0fPredictResponse\x12\x15\n\rprobabilities\x18\x01 \x03(\x02\x12\r\n\x05value\x18\x02 \x01(\x02\x12\x11\n\tbest_move\x18\x03 \x01(\x05\"w\n\x13\x42\x61tchPredictRequest\x12%\n\x06inputs\x18\x01 \x03(\x0b\x32\x15.neural.InputFeatures\x12\x12\n\nmodel_type\x18\x02 \x01(\t\x12%\n\rpacked_inputs\x18\x03 \x01(\x0b\x32\x0e.neural.Tensor\"!\n\rInputFeatures\x12\x10\n\x08\x66\x65\x61tures\x18\x01 \x03(\x02\"h\n\x14\x42\x61tchPredictResponse\x12(\n\x07outputs\x18\x01 \x03(\x0b\x32\x17.neural.PredictResponse\x12&\n\x0epacked_outputs\x18\x02 \x01(\x0b\x32\x0e.neural.Tensor\"&\n\x10ModelInfoRequest\x12\x12\n\nmodel_type\x18\x01 \x01(\t\"\x8c\x01\n\x11ModelInfoResponse\x12\x12\n\ninput_size\x18\x01 \x01(\x05\x12\x13\n\x0bhidden_size\x18\x02 \x01(\x05\x12\x13\n\x0boutput_size\x18\x03 \x01(\x05\x12\x0e\n\x06\x64\x65vice\x18\x04 \x01(\t\x12\x11\n\tframework\x18\x05 \x01(\t\x12\x16\n\x0epacked_tensors\x18\x06 \x01(\x08\"%\n\x06Tensor\x12\r\n\x05shape\x18\x01 \x03(\x05\x12\x0c\n\x04\x64\x61ta\x18\x02 \x01(\x0c\"G\n\x0f\x45valuateRequest\x12 \n\x08\x66\x65\x61tures\x18\x01 \x01(\x0b\x32\x0e.neural.Tensor\x12\x12\n\nrequest_id\x18\x02 \x01(\x04\"e\n\x10\x45valuateResponse\x12\x1e\n\x06policy\x18\x01 \x01(\x0b\x32\x0e.neural.Tensor\x12\x0e\n\x06values\x18\x02 \x03(\x02\x12\x12\n\nrequest_id\x18\x03 \x01(\x04\x12\r\n\x05\x65rror\x18\x04 \x01(\t2\xf2\x02\n\rNeuralService\x12<\n\x07Predict\x12\x16.neural.PredictRequest\x1a\x17.neural.PredictResponse\"\x00\x12K\n\x0c\x42\x61tchPredict\x12\x1b.neural.BatchPredictRequest\x1a\x1c.neural.BatchPredictResponse\"\x00\x12\x45\n\x0cGetModelInfo\x12\x18.neural.ModelInfoRequest\x1a\x19.neural.ModelInfoResponse\"\x00\x12\x44\n\rEvaluateBatch\x12\x17.neural.EvaluateRequest\x1a\x18.neural.EvaluateResponse\"\x00\x12I\n\x0e\x45valuateStream\x12\x17.neural.EvaluateRequest\x1a\x18.neural.EvaluateResponse\"\x00(\x01\x30\x01\x42\x31Z/github.com/zachbeta/neural_rps/pkg/neural/protob\x06proto3')
 
 _globals = globals()
 _builder.BuildMessageAndEnumDescriptors(DESCRIPTOR, _globals)
@@ -27,15 +27,21 @@ if _descriptor._USE_C_DESCRIPTORS == False:
   _globals['_PREDICTRESPONSE']._serialized_start=94
   _globals['_PREDICTRESPONSE']._serialized_end=168
   _globals['_BATCHPREDICTREQUEST']._serialized_start=170
-  _globals['_BATCHPREDICTREQUEST']._serialized_end=250
-  _globals['_INPUTFEATURES']._serialized_start=252
-  _globals['_INPUTFEATURES']._serialized_end=285
-  _globals['_BATCHPREDICTRESPONSE']._serialized_start=287
-  _globals['_BATCHPREDICTRESPONSE']._serialized_end=351
-  _globals['_MODELINFOREQUEST']._serialized_start=353
-  _globals['_MODELINFOREQUEST']._serialized_end=391
-  _globals['_MODELINFORESPONSE']._serialized_start=393
-  _globals['_MODELINFORESPONSE']._serialized_end=509
-  _globals['_NEURALSERVICE']._serialized_start=512
-  _globals['_NEURALSERVICE']._serialized_end=737
+  _globals['_BATCHPREDICTREQUEST']._serialized_end=289
+  _globals['_INPUTFEATURES']._serialized_start=291
+  _globals['_INPUTFEATURES']._serialized_end=324
+  _globals['_BATCHPREDICTRESPONSE']._serialized_start=326
+  _globals['_BATCHPREDICTRESPONSE']._serialized_end=430
+  _globals['_MODELINFOREQUEST']._serialized_start=432
+  _globals['_MODELINFOREQUEST']._serialized_end=470
+  _globals['_MODELINFORESPONSE']._serialized_start=473
+  _globals['_MODELINFORESPONSE']._serialized_end=613
+  _globals['_TENSOR']._serialized_start=615
+  _globals['_TENSOR']._serialized_end=652
+  _globals['_EVALUATEREQUEST']._serialized_start=654
+  _globals['_EVALUATEREQUEST']._serialized_end=725
+  _globals['_EVALUATERESPONSE']._serialized_start=727
+  _globals['_EVALUATERESPONSE']._serialized_end=828
+  _globals['_NEURALSERVICE']._serialized_start=831
+  _globals['_NEURALSERVICE']._serialized_end=1201
 # @@protoc_insertion_point(module_scope)
@@ -30,6 +30,16 @@ class NeuralServiceStub(object):
                 request_serializer=proto_dot_neural__service__pb2.ModelInfoRequest.SerializeToString,
                 response_deserializer=proto_dot_neural__service__pb2.ModelInfoResponse.FromString,
                 )
+        self.EvaluateBatch = channel.unary_unary(
+                '/neural.NeuralService/EvaluateBatch',
+                request_serializer=proto_dot_neural__service__pb2.EvaluateRequest.SerializeToString,
+                response_deserializer=proto_dot_neural__service__pb2.EvaluateResponse.FromString,
+                )
+        self.EvaluateStream = channel.stream_stream(
+                '/neural.NeuralService/EvaluateStream',
+                request_serializer=proto_dot_neural__service__pb2.EvaluateRequest.SerializeToString,
+                response_deserializer=proto_dot_neural__service__pb2.EvaluateResponse.FromString,
+                )
 
 
 class NeuralServiceServicer(object):
@@ -57,6 +67,22 @@ class NeuralServiceServicer(object):
         context.set_details('Method not implemented!')
         raise NotImplementedError('Method not implemented!')
 
+    def EvaluateBatch(self, request, context):
+        """EvaluateBatch runs the policy and value models on a batch in one call
+        """
+        context.set_code(grpc.StatusCode.UNIMPLEMENTED)
+        context.set_details('Method not implemented!')
+        raise NotImplementedError('Method not implemented!')
+
+    def EvaluateStream(self, request_iterator, context):
+        """EvaluateStream is EvaluateBatch over a bidirectional stream, so a client
+        can keep several batches in flight on one call. Responses carry the
+        request_id of the request they answer and may arrive in any order.
+        """
+        context.set_code(grpc.StatusCode.UNIMPLEMENTED)
+        context.set_details('Method not implemented!')
+        raise NotImplementedError('Method not implemented!')
+
 
 def add_NeuralServiceServicer_to_server(servicer, server):
     rpc_method_handlers = {
@@ -75,6 +101,16 @@ def add_NeuralServiceServicer_to_server(servicer, server):
                     request_deserializer=proto_dot_neural__service__pb2.ModelInfoRequest.FromString,
                     response_serializer=proto_dot_neural__service__pb2.ModelInfoResponse.SerializeToString,
             ),
+            'EvaluateBatch': grpc.unary_unary_rpc_method_handler(
+                    servicer.EvaluateBatch,
+                    request_deserializer=proto_dot_neural__service__pb2.EvaluateRequest.FromString,
+                    response_serializer=proto_dot_neural__service__pb2.EvaluateResponse.SerializeToString,
+            ),
+            'EvaluateStream': grpc.stream_stream_rpc_method_handler(
+                    servicer.EvaluateStream,
+                    request_deserializer=proto_dot_neural__service__pb2.EvaluateRequest.FromString,
+                    response_serializer=proto_dot_neural__service__pb2.EvaluateResponse.SerializeToString,
+            ),
     }
     generic_handler = grpc.method_handlers_generic_handler(
             'neural.NeuralService', rpc_method_handlers)
@@ -136,3 +172,37 @@ class NeuralService(object):
             proto_dot_neural__service__pb2.ModelInfoResponse.FromString,
             options, channel_credentials,
             insecure, call_credentials, compression, wait_for_ready, timeout, metadata)
+
+    @staticmethod
+    def EvaluateBatch(request,
+            target,
+            options=(),
+            channel_credentials=None,
+            call_credentials=None,
+            insecure=False,
+            compression=None,
+            wait_for_ready=None,
+            timeout=None,
+            metadata=None):
+        return grpc.experimental.unary_unary(request, target, '/neural.NeuralService/EvaluateBatch',
+            proto_dot_neural__service__pb2.EvaluateRequest.SerializeToString,
+            proto_dot_neural__service__pb2.EvaluateResponse.FromString,
+            options, channel_credentials,
+            insecure, call_credentials, compression, wait_for_ready, timeout, metadata)
+
+    @staticmethod
+    def EvaluateStream(request_iterator,
+            target,
+            options=(),
+            channel_credentials=None,
+            call_credentials=None,
+            insecure=False,
+            compression=None,
+            wait_for_ready=None,
+            timeout=None,
+            metadata=None):
+        return grpc.experimental.stream_stream(request_iterator, target, '/neural.NeuralService/EvaluateStream',
+            proto_dot_neural__service__pb2.EvaluateRequest.SerializeToString,
+            proto_dot_neural__service__pb2.EvaluateResponse.FromString,
+            options, channel_credentials,
+            insecure, call_credentials, compression, wait_for_ready, timeout, metadata)
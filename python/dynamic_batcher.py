@@ -0,0 +1,202 @@
+"""Server-side dynamic batching over a pool of ONNX Runtime sessions.
+
+Each RPC handler submits its rows and waits on a future. One worker thread
+per session takes the oldest request, keeps collecting whatever else arrives
+within a short window (up to a row limit), runs the session once on the
+concatenated batch, and hands every caller back its own slice. Many clients
+sending small requests therefore share large session runs.
+"""
+import collections
+import logging
+import os
+import queue
+import threading
+import time
+from concurrent.futures import Future
+
+import numpy as np
+import onnxruntime as ort
+
+logger = logging.getLogger(__name__)
+
+# Recent per-request latencies kept for the percentile report
+LATENCY_WINDOW = 4096
+
+
+def default_session_count(providers):
+    """One session per GPU when a GPU provider is in use, otherwise one per four cores"""
+    if any(p in ('CUDAExecutionProvider', 'TensorrtExecutionProvider') for p in providers):
+        devices = os.environ.get('CUDA_VISIBLE_DEVICES')
+        return max(1, len([d for d in devices.split(',') if d.strip()])) if devices else 1
+    return max(1, (os.cpu_count() or 1) // 4)
+
+
+def create_session_pool(model_path, providers, sessions, intra_op_threads=0):
+    """Load model_path into `sessions` InferenceSessions that split the cores
+    between them. A GPU pool places session i on device i."""
+    if intra_op_threads <= 0:
+        intra_op_threads = max(1, (os.cpu_count() or 1) // sessions)
+
+    pool = []
+    gpu = any(p in ('CUDAExecutionProvider', 'TensorrtExecutionProvider') for p in providers)
+    for i in range(sessions):
+        options = ort.SessionOptions()
+        options.intra_op_num_threads = intra_op_threads
+        options.inter_op_num_threads = 1
+        options.execution_mode = ort.ExecutionMode.ORT_SEQUENTIAL
+        options.graph_optimization_level = ort.GraphOptimizationLevel.ORT_ENABLE_ALL
+
+        session_providers = providers
+        if gpu:
+            session_providers = [(p, {'device_id': i}) if p != 'CPUExecutionProvider' else p
+                                 for p in providers]
+        pool.append(ort.InferenceSession(model_path, sess_options=options, providers=session_providers))
+
+    logger.info(f"Loaded {sessions} session(s) of {model_path} with {intra_op_threads} intra-op thread(s) each")
+    return pool
+
+
+class _Request:
+    __slots__ = ('rows', 'future', 'enqueued')
+
+    def __init__(self, rows):
+        self.rows = rows
+        self.future = Future()
+        self.enqueued = time.perf_counter()
+
+
+class DynamicBatcher:
+    """Coalesces concurrent submissions into batched runs of one output of a
+    session pool. submit and run are safe to call from any thread."""
+
+    def __init__(self, sessions, output_name, max_batch_size=256, window_ms=2.0, name="model"):
+        if not sessions:
+            raise ValueError("DynamicBatcher needs at least one session")
+        self.name = name
+        self.input_name = sessions[0].get_inputs()[0].name
+        self.output_name = output_name
+        self.max_batch_size = max_batch_size
+        self.window = window_ms / 1000.0
+
+        self._queue = queue.Queue()
+        self._stats_lock = threading.Lock()
+        self._reset_stats()
+
+        self._workers = []
+        for i, session in enumerate(sessions):
+            worker = threading.Thread(target=self._work, args=(session,),
+                                      name=f"{name}-batcher-{i}", daemon=True)
+            worker.start()
+            self._workers.append(worker)
+
+    def _reset_stats(self):
+        self.runs = 0
+        self.rows = 0
+        self.requests = 0
+        self.peak_queue_depth = 0
+        self.batch_sizes = collections.Counter()
+        self.latencies = collections.deque(maxlen=LATENCY_WINDOW)
+
+    def submit(self, rows):
+        """Queue a [n, features] float32 array; the future resolves to its [n, outputs] result"""
+        request = _Request(rows)
+        self._queue.put(request)
+        depth = self._queue.qsize()
+        with self._stats_lock:
+            self.peak_queue_depth = max(self.peak_queue_depth, depth)
+        return request.future
+
+    def run(self, rows):
+        """Submit rows and wait for the result"""
+        return self.submit(rows).result()
+
+    def close(self):
+        """Stop the workers once the requests already queued have run"""
+        for _ in self._workers:
+            self._queue.put(None)
+        for worker in self._workers:
+            worker.join()
+
+    def _collect(self, first):
+        """Gather requests behind first until the window closes or the batch is full.
+        Returns the batch and a request that did not fit, if any."""
+        batch = [first]
+        size = len(first.rows)
+        deadline = time.perf_counter() + self.window
+        while size < self.max_batch_size:
+            remaining = deadline - time.perf_counter()
+            if remaining <= 0:
+                break
+            try:
+                request = self._queue.get(timeout=remaining)
+            except queue.Empty:
+                break
+            if request is None:
+                # Leave the stop marker for after this batch
+                self._queue.put(None)
+                break
+            if size + len(request.rows) > self.max_batch_size:
+                return batch, request
+            batch.append(request)
+            size += len(request.rows)
+        return batch, None
+
+    def _work(self, session):
+        carry = None
+        while True:
+            first = carry if carry is not None else self._queue.get()
+            if first is None:
+                return
+            batch, carry = self._collect(first)
+
+            rows = batch[0].rows if len(batch) == 1 else np.concatenate([r.rows for r in batch])
+            try:
+                outputs = session.run([self.output_name], {self.input_name: rows})[0]
+                outputs = outputs.reshape(len(rows), -1)
+            except Exception as e:
+                logger.error(f"{self.name} batch of {len(rows)} failed: {e}")
+                for request in batch:
+                    request.future.set_exception(e)
+                continue
+
+            done = time.perf_counter()
+            offset = 0
+            for request in batch:
+                n = len(request.rows)
+                request.future.set_result(outputs[offset:offset + n])
+                offset += n
+
+            with self._stats_lock:
+                self.runs += 1
+                self.rows += len(rows)
+                self.requests += len(batch)
+                self.batch_sizes[len(rows)] += 1
+                self.latencies.extend(done - r.enqueued for r in batch)
+
+    def stats(self, reset=False):
+        """Return a snapshot of queue depth, batch sizes and request latency
+        percentiles (in milliseconds) over the recent window"""
+        with self._stats_lock:
+            latencies = np.sort(np.fromiter(self.latencies, dtype=np.float64)) * 1000.0
+            snapshot = {
+                'queue_depth': self._queue.qsize(),
+                'peak_queue_depth': self.peak_queue_depth,
+                'runs': self.runs,
+                'requests': self.requests,
+                'rows': self.rows,
+                'avg_batch_size': self.rows / self.runs if self.runs else 0.0,
+                'max_batch_size': max(self.batch_sizes) if self.batch_sizes else 0,
+            }
+            for p in (50, 90, 99):
+                snapshot[f'latency_p{p}_ms'] = float(np.percentile(latencies, p)) if len(latencies) else 0.0
+            if reset:
+                self._reset_stats()
+        return snapshot
+
+    def log_stats(self, reset=False):
+        s = self.stats(reset)
+        logger.info(f"{self.name} batcher: {s['runs']} runs, {s['requests']} requests, "
+                    f"avg batch {s['avg_batch_size']:.1f} (max {s['max_batch_size']}), "
+                    f"queue depth {s['queue_depth']} (peak {s['peak_queue_depth']}), "
+                    f"latency p50 {s['latency_p50_ms']:.2f} ms, p90 {s['latency_p90_ms']:.2f} ms, "
+                    f"p99 {s['latency_p99_ms']:.2f} ms")
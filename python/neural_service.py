@@ -14,6 +14,7 @@ from concurrent import futures
 sys.path.append(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
 import proto.neural_service_pb2 as neural_pb2
 import proto.neural_service_pb2_grpc as neural_pb2_grpc
+from packed_tensors import pack_tensor, unpack_tensor
 
 # Configure logging
 logging.basicConfig(
@@ -188,6 +189,9 @@ class NeuralServicer(neural_pb2_grpc.NeuralServiceServicer):
     
     def BatchPredict(self, request, context):
         """Handle batch prediction request"""
+        if request.HasField('packed_inputs'):
+            return self._batch_predict_packed(request, context)
+
         start_time = time.time()
         batch_size = len(request.inputs)
         self.total_requests += 1
@@ -202,8 +206,8 @@ class NeuralServicer(neural_pb2_grpc.NeuralServiceServicer):
         # Select appropriate network
         network = self.policy_net if request.model_type == "policy" else self.value_net
         
-        # Prepare batch features
-        batch_features = [list(input_features.features) for input_features in request.inputs]
+        # Prepare batch features; numpy reads each repeated field directly
+        batch_features = np.array([input_features.features for input_features in request.inputs], dtype=np.float32)
         
         # Run batch prediction
         batch_results = network.batch_predict(batch_features)
@@ -227,6 +231,29 @@ class NeuralServicer(neural_pb2_grpc.NeuralServiceServicer):
         
         return response
     
+    def _batch_predict_packed(self, request, context):
+        """Handle a batch sent as one packed tensor: the input is viewed
+        without copying, run once, and the raw outputs returned packed"""
+        start_time = time.time()
+        network = self.policy_net if request.model_type == "policy" else self.value_net
+
+        try:
+            input_array = unpack_tensor(request.packed_inputs, network.input_size)
+        except ValueError as e:
+            context.set_code(grpc.StatusCode.INVALID_ARGUMENT)
+            context.set_details(str(e))
+            return neural_pb2.BatchPredictResponse()
+
+        self.total_requests += 1
+        self.total_batch_size += input_array.shape[0]
+
+        results = network.model.predict(input_array, verbose=0)
+        self.inference_time += time.time() - start_time
+
+        response = neural_pb2.BatchPredictResponse()
+        pack_tensor(results.reshape(input_array.shape[0], -1), response.packed_outputs)
+        return response
+
     def GetModelInfo(self, request, context):
         """Provide information about the loaded model"""
         # Select appropriate network
@@ -239,6 +266,7 @@ class NeuralServicer(neural_pb2_grpc.NeuralServiceServicer):
         response.output_size = network.output_size
         response.device = "metal" if (is_apple_silicon and physical_devices) else network.device
         response.framework = "tensorflow"
+        response.packed_tensors = True
         
         return response
     
@@ -5,6 +5,7 @@ import time
 import argparse
 import logging
 import platform
+import threading
 import numpy as np
 import onnxruntime as ort
 import grpc
@@ -14,6 +15,8 @@ from concurrent import futures
 sys.path.append(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
 import proto.neural_service_pb2 as neural_pb2
 import proto.neural_service_pb2_grpc as neural_pb2_grpc
+from packed_tensors import pack_tensor, unpack_tensor
+from dynamic_batcher import DynamicBatcher, create_session_pool, default_session_count
 
 # Configure logging
 logging.basicConfig(
@@ -26,13 +29,22 @@ logger = logging.getLogger(__name__)
 parser = argparse.ArgumentParser(description="ONNX Neural Service")
 parser.add_argument("--port", type=int, default=50053, help="Port for the gRPC service")
 parser.add_argument("--model_path", type=str, default="python/output/rps_value1.onnx", help="Path to the ONNX model file")
+parser.add_argument("--policy_model_path", type=str, default=None, help="Path to an ONNX policy model for EvaluateBatch and EvaluateStream")
+parser.add_argument("--sessions", type=int, default=0, help="ONNX sessions per model (0 = one per GPU, or one per four cores)")
+parser.add_argument("--intra_op_threads", type=int, default=0, help="Intra-op threads per session (0 = split the cores between sessions)")
+parser.add_argument("--batch_window_ms", type=float, default=2.0, help="How long a batch waits for concurrent requests to join it")
+parser.add_argument("--max_batch_size", type=int, default=256, help="Largest batch the dynamic batcher assembles")
+parser.add_argument("--max_workers", type=int, default=64, help="gRPC handler threads, which bounds how many requests can be coalesced")
+parser.add_argument("--stats_interval", type=float, default=60.0, help="Seconds between batcher stats log lines (0 disables)")
 args = parser.parse_args()
 
 class NeuralServicer(neural_pb2_grpc.NeuralServiceServicer):
     """gRPC servicer implementation for neural network inference using ONNX Runtime"""
     
-    def __init__(self, model_path):
-        """Initialize service with an ONNX model"""
+    def __init__(self, model_path, policy_model_path=None, sessions=0, intra_op_threads=0,
+                 batch_window_ms=2.0, max_batch_size=256):
+        """Initialize service with an ONNX value model and, optionally, a policy model.
+        Each model is loaded into a session pool behind a dynamic batcher."""
         logger.info(f"ONNX model path received: {model_path}")
         logger.info(f"Attempting to load ONNX model: {model_path}")
         
@@ -42,7 +54,11 @@ class NeuralServicer(neural_pb2_grpc.NeuralServiceServicer):
             providers = [
                 'CPUExecutionProvider'
             ]
-            self.ort_session = ort.InferenceSession(model_path, providers=providers)
+            if sessions <= 0:
+                sessions = default_session_count(providers)
+            value_pool = create_session_pool(model_path, providers, sessions, intra_op_threads)
+            # The first session answers metadata queries
+            self.ort_session = value_pool[0]
             logger.info(f"Successfully loaded ONNX model from {model_path}")
             logger.info(f"ONNX session providers: {self.ort_session.get_providers()}")
 
@@ -77,11 +93,40 @@ class NeuralServicer(neural_pb2_grpc.NeuralServiceServicer):
                         f"Output: '{self.output_name}' (Shape: {outputs_meta[0].shape}), "
                         f"Inferred Feature Size: {self.model_input_feature_size}")
 
+            self.value_batcher = DynamicBatcher(value_pool, self.output_name, max_batch_size=max_batch_size,
+                                                window_ms=batch_window_ms, name="value")
+
         except Exception as e:
             logger.error(f"Failed to load ONNX model or configure session from '{model_path}': {e}")
             # Propagate exception to prevent service from starting with a bad model
             raise
 
+        # The policy model is only used by the fused Evaluate RPCs. Without one,
+        # they return an empty policy and clients fall back to uniform priors.
+        self.policy_session = None
+        self.policy_batcher = None
+        if policy_model_path:
+            try:
+                policy_pool = create_session_pool(policy_model_path, providers, sessions, intra_op_threads)
+                self.policy_session = policy_pool[0]
+                policy_inputs = self.policy_session.get_inputs()
+                policy_outputs = self.policy_session.get_outputs()
+                if not policy_inputs or not policy_outputs:
+                    raise ValueError("ONNX policy model has no inputs or outputs.")
+                if policy_inputs[0].shape[-1] != self.model_input_feature_size:
+                    raise ValueError(f"Policy model feature size {policy_inputs[0].shape[-1]} does not match "
+                                     f"value model feature size {self.model_input_feature_size}")
+                self.policy_input_name = policy_inputs[0].name
+                self.policy_output_name = policy_outputs[0].name
+                self.policy_batcher = DynamicBatcher(policy_pool, self.policy_output_name,
+                                                     max_batch_size=max_batch_size,
+                                                     window_ms=batch_window_ms, name="policy")
+                logger.info(f"Loaded ONNX policy model from {policy_model_path}. "
+                            f"Output: '{self.policy_output_name}' (Shape: {policy_outputs[0].shape})")
+            except Exception as e:
+                logger.error(f"Failed to load ONNX policy model from '{policy_model_path}': {e}")
+                raise
+
         # Performance metrics
         self.total_requests = 0
         self.total_batch_size = 0
@@ -116,18 +161,10 @@ class NeuralServicer(neural_pb2_grpc.NeuralServiceServicer):
             # Convert features to NumPy array, reshape, and ensure correct type
             input_data = np.array(list(request.features), dtype=np.float32).reshape(1, self.model_input_feature_size)
             
-            # Prepare input dictionary for ONNX Runtime
-            inputs_dict = {self.input_name: input_data}
-            
-            logger.debug(f"Predict: Available session providers for inference: {self.ort_session.get_providers()}")
-            # Run inference
-            # The result is a list of NumPy arrays, one for each requested output name.
-            # Since we request one output (self.output_name), results will have one element.
-            onnx_results = self.ort_session.run([self.output_name], inputs_dict)
-            
-            # Extract the scalar value. For rps_value1.onnx, output shape is [1,1]
-            # onnx_results[0] is a np.array like [[-0.12345]]
-            value = float(onnx_results[0][0][0])
+            # Run inference through the batcher, which coalesces this row with
+            # concurrent requests. The result is this request's [1, outputs] slice.
+            # For rps_value1.onnx the slice is a np.array like [[-0.12345]]
+            value = float(self.value_batcher.run(input_data)[0][0])
 
             # Create response
             response = neural_pb2.PredictResponse()
@@ -147,6 +184,9 @@ class NeuralServicer(neural_pb2_grpc.NeuralServiceServicer):
     
     def BatchPredict(self, request, context):
         """Handle batch prediction request"""
+        if request.HasField('packed_inputs'):
+            return self._batch_predict_packed(request, context)
+
         start_time = time.time()
         batch_size = len(request.inputs)
         self.total_requests += 1 # Count as one gRPC request
@@ -164,7 +204,9 @@ class NeuralServicer(neural_pb2_grpc.NeuralServiceServicer):
             context.set_details("Empty batch provided")
             return neural_pb2.BatchPredictResponse()
         
-        batch_features_list = []
+        # Fill one preallocated array row by row; numpy reads each repeated
+        # field directly instead of going through an intermediate list
+        input_data = np.empty((batch_size, self.model_input_feature_size), dtype=np.float32)
         for i, inp in enumerate(request.inputs):
             if len(inp.features) != self.model_input_feature_size:
                 error_msg = f"Incorrect number of features for item {i} in batch. Expected {self.model_input_feature_size}, got {len(inp.features)}."
@@ -172,31 +214,19 @@ class NeuralServicer(neural_pb2_grpc.NeuralServiceServicer):
                 context.set_code(grpc.StatusCode.INVALID_ARGUMENT)
                 context.set_details(error_msg)
                 return neural_pb2.BatchPredictResponse()
-            batch_features_list.append(list(inp.features))
+            input_data[i] = inp.features
 
         try:
-            # Convert list of feature lists to NumPy array, reshape, and ensure correct type
-            input_data = np.array(batch_features_list, dtype=np.float32).reshape(batch_size, self.model_input_feature_size)
             
-            # Prepare input dictionary for ONNX Runtime
-            inputs_dict = {self.input_name: input_data}
-            
-            logger.debug(f"BatchPredict: Available session providers for inference: {self.ort_session.get_providers()}")
-            # Run inference
-            # The result is a list of NumPy arrays, one for each requested output name.
-            onnx_results = self.ort_session.run([self.output_name], inputs_dict)
-            
-            # onnx_results[0] is a np.array like [[val1], [val2], ..., [val_batch_size]]
-            # Each val is typically a list/array itself, e.g., [0.123] for a scalar output model
-            batch_output_values = onnx_results[0]
+            # Run inference through the batcher, which may merge this batch with
+            # concurrent requests. The result is a np.array like [[val1], [val2], ..., [val_batch_size]]
+            batch_output_values = self.value_batcher.run(input_data)
 
             response = neural_pb2.BatchPredictResponse()
-            for i in range(batch_size):
-                individual_output = neural_pb2.PredictResponse()
-                # Assuming the model outputs one scalar per input item in the batch
-                individual_output.value = float(batch_output_values[i][0])
-                # individual_output.best_move and .probabilities not set for value net
-                response.outputs.append(individual_output)
+            # Assuming the model outputs one scalar per input item in the batch;
+            # best_move and probabilities are not set for a value net
+            for value in batch_output_values[:, 0].tolist():
+                response.outputs.add(value=value)
 
         except Exception as e:
             logger.error(f"Error during ONNX BatchPredict inference: {e}")
@@ -208,10 +238,97 @@ class NeuralServicer(neural_pb2_grpc.NeuralServiceServicer):
         self.inference_time += time.time() - start_time
         return response
     
+    def _batch_predict_packed(self, request, context):
+        """Handle a batch sent as one packed tensor: the input is viewed
+        without copying, run once, and the outputs returned packed"""
+        start_time = time.time()
+
+        try:
+            input_data = unpack_tensor(request.packed_inputs, self.model_input_feature_size)
+        except ValueError as e:
+            logger.error(f"Invalid packed BatchPredict request: {e}")
+            context.set_code(grpc.StatusCode.INVALID_ARGUMENT)
+            context.set_details(str(e))
+            return neural_pb2.BatchPredictResponse()
+
+        batch_size = input_data.shape[0]
+        self.total_requests += 1
+        self.total_batch_size += batch_size
+
+        try:
+            outputs = self.value_batcher.run(input_data)
+            response = neural_pb2.BatchPredictResponse()
+            pack_tensor(outputs, response.packed_outputs)
+        except Exception as e:
+            logger.error(f"Error during ONNX packed BatchPredict inference: {e}")
+            context.set_code(grpc.StatusCode.INTERNAL)
+            context.set_details(f"Error during ONNX batch inference: {e}")
+            return neural_pb2.BatchPredictResponse()
+
+        self.inference_time += time.time() - start_time
+        return response
+
+    def _evaluate(self, request):
+        """Run both models on a packed feature tensor and build an EvaluateResponse.
+        Errors are reported in the response so one bad batch does not end a stream."""
+        response = neural_pb2.EvaluateResponse(request_id=request.request_id)
+
+        try:
+            input_data = unpack_tensor(request.features, self.model_input_feature_size)
+        except ValueError as e:
+            response.error = str(e)
+            return response
+
+        batch_size = input_data.shape[0]
+        self.total_requests += 1
+        self.total_batch_size += batch_size
+
+        try:
+            # Queue both models before waiting so they run concurrently
+            values = self.value_batcher.submit(input_data)
+            policy = self.policy_batcher.submit(input_data) if self.policy_batcher is not None else None
+
+            response.values.extend(values.result()[:, 0].tolist())
+            if policy is not None:
+                pack_tensor(policy.result(), response.policy)
+            else:
+                response.policy.shape.extend([batch_size, 0])
+        except Exception as e:
+            logger.error(f"Error during ONNX Evaluate inference: {e}")
+            return neural_pb2.EvaluateResponse(request_id=request.request_id,
+                                               error=f"Error during ONNX inference: {e}")
+
+        return response
+
+    def EvaluateBatch(self, request, context):
+        """Handle fused policy and value request for a batch"""
+        start_time = time.time()
+        response = self._evaluate(request)
+        if response.error:
+            logger.error(response.error)
+            context.set_code(grpc.StatusCode.INVALID_ARGUMENT)
+            context.set_details(response.error)
+            return neural_pb2.EvaluateResponse()
+
+        self.inference_time += time.time() - start_time
+        return response
+
+    def EvaluateStream(self, request_iterator, context):
+        """Handle a stream of fused requests, answering each in arrival order"""
+        for request in request_iterator:
+            start_time = time.time()
+            response = self._evaluate(request)
+            if response.error:
+                logger.error(f"EvaluateStream request {request.request_id}: {response.error}")
+            else:
+                self.inference_time += time.time() - start_time
+            yield response
+
     def GetModelInfo(self, request, context):
         """Provide information about the loaded ONNX model"""
         response = neural_pb2.ModelInfoResponse()
         response.framework = "onnxruntime"
+        response.packed_tensors = True
         response.hidden_size = -1 # Typically not well-defined for a generic ONNX model graph
 
         if hasattr(self, 'ort_session') and self.ort_session is not None:
@@ -280,36 +397,52 @@ class NeuralServicer(neural_pb2_grpc.NeuralServiceServicer):
             logger.info(f"Service uptime: {elapsed:.2f} s")
         else:
             logger.info("No requests processed.")
+        self.value_batcher.log_stats()
+        if self.policy_batcher is not None:
+            self.policy_batcher.log_stats()
+
+    def close(self):
+        """Stop the batchers after the requests they have queued"""
+        self.value_batcher.close()
+        if self.policy_batcher is not None:
+            self.policy_batcher.close()
 
-def serve(port, model_path, max_workers=10):
+def serve(port, model_path, policy_model_path=None, max_workers=64, sessions=0, intra_op_threads=0,
+          batch_window_ms=2.0, max_batch_size=256, stats_interval=60.0):
     """Start the gRPC server"""
+    # Handlers mostly wait on the batcher, so there can be many more of them
+    # than sessions; each concurrent handler is a request that can be coalesced
     server = grpc.server(futures.ThreadPoolExecutor(max_workers=max_workers))
-    neural_pb2_grpc.add_NeuralServiceServicer_to_server(
-        NeuralServicer(model_path=model_path), server # Pass model_path
-    )
+    servicer = NeuralServicer(model_path=model_path, policy_model_path=policy_model_path,
+                              sessions=sessions, intra_op_threads=intra_op_threads,
+                              batch_window_ms=batch_window_ms, max_batch_size=max_batch_size)
+    neural_pb2_grpc.add_NeuralServiceServicer_to_server(servicer, server)
     server.add_insecure_port(f'[::]:{port}')
     server.start()
     logger.info(f"Server started on port {port} with ONNX model: {model_path}")
-    
+
+    stopping = threading.Event()
+    if stats_interval > 0:
+        def report():
+            while not stopping.wait(stats_interval):
+                servicer.value_batcher.log_stats(reset=True)
+                if servicer.policy_batcher is not None:
+                    servicer.policy_batcher.log_stats(reset=True)
+        threading.Thread(target=report, name="batcher-stats", daemon=True).start()
+
     try:
         while True:
             time.sleep(60 * 60 * 24)  # Keep server alive
     except KeyboardInterrupt:
         logger.info("Server stopping...")
-        # Create an instance of NeuralServicer to call print_stats
-        # This is a bit of a hack; stats ideally would be managed by the server instance or a separate class.
-        # For simplicity, we re-fetch model_path if needed or use the global args.
-        temp_servicer_for_stats = NeuralServicer(model_path=args.model_path) 
-        temp_servicer_for_stats.total_requests = server.total_requests if hasattr(server, 'total_requests') else 0 # This won't work as server doesn't own these
-        temp_servicer_for_stats.total_batch_size = server.total_batch_size if hasattr(server, 'total_batch_size') else 0
-        temp_servicer_for_stats.inference_time = server.inference_time if hasattr(server, 'inference_time') else 0
-        # A better way for stats on shutdown would be to have NeuralServicer instance accessible
-        # or pass a stats object to it.
-        # For now, the stats printed on shutdown will be from a new instance, so likely zero.
-        # The running stats are printed by the servicer instance tied to the server, but not easily on shutdown here.
-        logger.warning("Stats on shutdown might be inaccurate due to instance scoping. Check periodic logs if enabled.")
+        stopping.set()
         server.stop(0)
+        servicer.print_stats()
+        servicer.close()
         logger.info("Server stopped.")
 
 if __name__ == '__main__':
-    serve(args.port, args.model_path) 
\ No newline at end of file
+    serve(args.port, args.model_path, args.policy_model_path, max_workers=args.max_workers,
+          sessions=args.sessions, intra_op_threads=args.intra_op_threads,
+          batch_window_ms=args.batch_window_ms, max_batch_size=args.max_batch_size,
+          stats_interval=args.stats_interval)
@@ -0,0 +1,36 @@
+"""Conversion between numpy arrays and the packed Tensor message.
+
+A Tensor carries its shape and one contiguous little-endian float32 buffer,
+so a whole batch crosses the wire, and into numpy, without a Python loop or
+a copy per row.
+"""
+import numpy as np
+
+FLOAT32_LE = np.dtype('<f4')
+
+
+def unpack_tensor(tensor, feature_size=None):
+    """View a Tensor's data as a read-only array of its shape without copying.
+
+    Raises ValueError if the data does not match the shape, or if the tensor
+    is not [batch, feature_size] when feature_size is given.
+    """
+    shape = tuple(tensor.shape)
+    if feature_size is not None and (len(shape) != 2 or shape[0] == 0 or shape[1] != feature_size):
+        raise ValueError(f"Expected a tensor of shape [batch, {feature_size}], got {list(shape)}")
+
+    count = int(np.prod(shape)) if shape else 0
+    if len(tensor.data) != count * FLOAT32_LE.itemsize:
+        raise ValueError(f"Tensor data holds {len(tensor.data)} bytes, "
+                         f"expected {count * FLOAT32_LE.itemsize} for shape {list(shape)}")
+    return np.frombuffer(tensor.data, dtype=FLOAT32_LE).reshape(shape)
+
+
+def pack_tensor(array, tensor):
+    """Fill a Tensor message from an array, converting it to contiguous
+    little-endian float32 first if it is not already."""
+    array = np.ascontiguousarray(array, dtype=FLOAT32_LE)
+    del tensor.shape[:]
+    tensor.shape.extend(array.shape)
+    tensor.data = array.tobytes()
+    return tensor
@@ -76,6 +76,12 @@ func (a *AlphaGoAgent) GetMove(state *game.RPSGame) (game.RPSMove, error) {
 	return *bestNode.Move, nil
 }
 
+// Fork returns an agent with its own search engine over the same networks,
+// so games played at once do not share a tree (see tournament.Forker)
+func (a *AlphaGoAgent) Fork() Agent {
+	return NewAlphaGoAgent(a.name, a.policyNetwork, a.valueNetwork)
+}
+
 func (a *AlphaGoAgent) Name() string {
 	return a.name
 }
@@ -2,20 +2,67 @@ package main
 
 import (
 	"encoding/json"
+	"errors"
+	"flag"
 	"fmt"
 	"log"
 	"net/http"
+	"runtime"
+	"sort"
+	"strconv"
 	"sync"
 	"time"
 
 	"github.com/gorilla/mux"
 	"github.com/zachbeta/neural_rps/alphago_demo/pkg/game"
+	"github.com/zachbeta/neural_rps/alphago_demo/pkg/metrics"
+	"github.com/zachbeta/neural_rps/alphago_demo/pkg/tournament"
+	neuralmetrics "github.com/zachbeta/neural_rps/pkg/metrics"
 )
 
-// Agent interface that all agents must implement
-type Agent interface {
-	GetMove(state *game.RPSGame) (game.RPSMove, error)
-	Name() string
+// Agent interface that all agents must implement. Agents that keep search
+// state should also implement tournament.Forker, so tournament workers get
+// their own instances.
+type Agent = tournament.Agent
+
+// Errors returned by RunGame and SubmitGame
+var (
+	ErrGameNotFound = errors.New("game not found")
+	ErrGameStarted  = errors.New("game already started")
+	ErrServerBusy   = errors.New("server busy: game queue is full")
+)
+
+// Server metrics, exported on /metrics
+var (
+	queueDepth = metrics.NewGauge("game_server_queue_depth",
+		"Submitted games waiting for a worker")
+	queueWaitSeconds = metrics.NewDurationHistogram("game_server_queue_wait_seconds",
+		"Time a submitted game waits for a worker")
+	gameSeconds = metrics.NewDurationHistogram("game_server_game_seconds",
+		"Time to play a game, from its first move to its last")
+	gamesCompletedTotal = metrics.NewCounter("game_server_games_completed_total",
+		"Games played to completion")
+	gamesFailedTotal = metrics.NewCounter("game_server_games_failed_total",
+		"Games ended by an agent error")
+	gamesRefusedTotal = metrics.NewCounter("game_server_games_refused_total",
+		"Games refused because the queue was full")
+)
+
+// matchState is how far a match has got
+type matchState int
+
+const (
+	matchCreated matchState = iota
+	matchQueued
+	matchRunning
+	matchCompleted
+	matchFailed
+)
+
+var matchStateNames = [...]string{"created", "queued", "running", "completed", "failed"}
+
+func (st matchState) String() string {
+	return matchStateNames[st]
 }
 
 // Game structure to track a match between two agents
@@ -27,6 +74,196 @@ type GameMatch struct {
 	Winner       game.RPSPlayer
 	Completed    bool
 	mutex        sync.Mutex
+
+	// Guarded by mutex. Only the goroutine playing the match modifies Game,
+	// and it does so under mutex, so it may read Game without it.
+	state   matchState
+	err     error
+	events  []GameEvent
+	changed chan struct{} // Closed and replaced whenever an event is added
+	status  []byte        // Encoded GameStatus, nil until the next status request
+
+	queuedAt time.Time // Set by SubmitGame before the match is queued
+}
+
+// GameEvent is one step of a match as streamed by /api/games/{id}/events:
+// a move, then "completed" or "error" as the last event
+type GameEvent struct {
+	Seq    int        `json:"seq"` // 1 for the match's first event
+	Type   string     `json:"type"`
+	Move   *MoveEvent `json:"move,omitempty"`
+	Winner string     `json:"winner,omitempty"`
+	Error  string     `json:"error,omitempty"`
+}
+
+// MoveEvent describes a move in a GameEvent
+type MoveEvent struct {
+	Agent     string `json:"agent"`
+	Player    int    `json:"player"`
+	Card      string `json:"card"`
+	CardIndex int    `json:"card_index"`
+	Position  int    `json:"position"`
+	Round     int    `json:"round"`
+}
+
+var cardNames = [...]string{game.Rock: "rock", game.Paper: "paper", game.Scissors: "scissors"}
+
+// GameStatus is the body of /api/games/{id}
+type GameStatus struct {
+	ID          string `json:"id"`
+	Player1     string `json:"player1"`
+	Player2     string `json:"player2"`
+	State       string `json:"state"`
+	CurrentTurn string `json:"current_turn,omitempty"`
+	IsCompleted bool   `json:"is_completed"`
+	Winner      string `json:"winner,omitempty"`
+	Error       string `json:"error,omitempty"`
+	Moves       int    `json:"moves"`
+	BoardState  string `json:"board_state"`
+}
+
+func newGameMatch(id string, gameInstance *game.RPSGame, player1, player2 Agent) *GameMatch {
+	return &GameMatch{
+		ID:           id,
+		Game:         gameInstance,
+		Player1Agent: player1,
+		Player2Agent: player2,
+		changed:      make(chan struct{}),
+	}
+}
+
+// claim moves a created match to state, returning false if it has already
+// been claimed
+func (m *GameMatch) claim(state matchState) bool {
+	m.mutex.Lock()
+	defer m.mutex.Unlock()
+	if m.state != matchCreated {
+		return false
+	}
+	m.state = state
+	m.status = nil
+	return true
+}
+
+// publish records event and wakes its subscribers; the caller holds mutex
+func (m *GameMatch) publish(event GameEvent) {
+	event.Seq = len(m.events) + 1
+	m.events = append(m.events, event)
+	m.status = nil
+	close(m.changed)
+	m.changed = make(chan struct{})
+}
+
+// finished reports whether the match completed or failed; the caller holds
+// mutex
+func (m *GameMatch) finished() bool {
+	return m.state == matchCompleted || m.state == matchFailed
+}
+
+// eventsSince returns the events after the first seq, and a channel that is
+// closed when another is added unless the match has finished
+func (m *GameMatch) eventsSince(seq int) (events []GameEvent, changed <-chan struct{}, finished bool) {
+	m.mutex.Lock()
+	defer m.mutex.Unlock()
+	seq = min(max(seq, 0), len(m.events))
+	return m.events[seq:len(m.events):len(m.events)], m.changed, m.finished()
+}
+
+// wait blocks until the match has finished
+func (m *GameMatch) wait() (*game.RPSGame, error) {
+	for {
+		m.mutex.Lock()
+		finished, changed := m.finished(), m.changed
+		m.mutex.Unlock()
+		if finished {
+			return m.Game, m.err
+		}
+		<-changed
+	}
+}
+
+// encodedStatus returns the match's GameStatus as JSON, encoding it only
+// after the match has changed, and its version for conditional requests
+func (m *GameMatch) encodedStatus() (body []byte, version int) {
+	m.mutex.Lock()
+	defer m.mutex.Unlock()
+	if m.status == nil {
+		m.status, _ = json.Marshal(m.statusLocked())
+	}
+	// The state changes twice without an event: when queued and when started
+	return m.status, len(m.events)*len(matchStateNames) + int(m.state)
+}
+
+func (m *GameMatch) statusLocked() GameStatus {
+	status := GameStatus{
+		ID:          m.ID,
+		Player1:     m.Player1Agent.Name(),
+		Player2:     m.Player2Agent.Name(),
+		State:       m.state.String(),
+		IsCompleted: m.Completed,
+		Moves:       len(m.Game.MoveHistory),
+		BoardState:  m.Game.String(),
+	}
+	if m.err != nil {
+		status.Error = m.err.Error()
+	}
+
+	if !m.Completed {
+		if m.Game.CurrentPlayer == game.Player1 {
+			status.CurrentTurn = m.Player1Agent.Name()
+		} else {
+			status.CurrentTurn = m.Player2Agent.Name()
+		}
+	} else {
+		status.Winner = m.winnerName()
+	}
+	return status
+}
+
+func (m *GameMatch) winnerName() string {
+	switch m.Winner {
+	case game.Player1:
+		return m.Player1Agent.Name()
+	case game.Player2:
+		return m.Player2Agent.Name()
+	}
+	return "Draw"
+}
+
+// agentPool keeps idle instances of one registered agent for the game
+// workers, so each game gets an instance of its own and the instances'
+// search engines and caches carry over from game to game. Instances are
+// Forks of the registered agent; agents that do not implement
+// tournament.Forker are shared, as in tournaments.
+type agentPool struct {
+	agent Agent
+	mutex sync.Mutex
+	idle  []Agent
+}
+
+func (p *agentPool) get() Agent {
+	forker, ok := p.agent.(tournament.Forker)
+	if !ok {
+		return p.agent
+	}
+
+	p.mutex.Lock()
+	defer p.mutex.Unlock()
+	if n := len(p.idle); n > 0 {
+		agent := p.idle[n-1]
+		p.idle = p.idle[:n-1]
+		return agent
+	}
+	return forker.Fork()
+}
+
+func (p *agentPool) put(agent Agent) {
+	if agent == p.agent {
+		return
+	}
+	p.mutex.Lock()
+	defer p.mutex.Unlock()
+	p.idle = append(p.idle, agent)
 }
 
 // Server to manage games and connections
@@ -38,6 +275,17 @@ type GameServer struct {
 	DeckSize   int
 	HandSize   int
 	MaxRounds  int
+
+	// Workers is the number of games SubmitGame plays at once (0 uses
+	// GOMAXPROCS), and QueueSize the number of submitted games that may wait
+	// for a worker before SubmitGame refuses more. Both are read when the
+	// first game is submitted.
+	Workers   int
+	QueueSize int
+
+	pools      map[string]*agentPool // By agent name, guarded by mutex
+	queue      chan *GameMatch
+	startQueue sync.Once
 }
 
 // Tournament structure to track competition results
@@ -57,6 +305,8 @@ func NewGameServer() *GameServer {
 		DeckSize:   21,
 		HandSize:   5,
 		MaxRounds:  10,
+		QueueSize:  64,
+		pools:      make(map[string]*agentPool),
 	}
 }
 
@@ -74,6 +324,7 @@ func (s *GameServer) RegisterAgent(agent Agent) {
 	s.mutex.Lock()
 	defer s.mutex.Unlock()
 	s.Agents[agent.Name()] = agent
+	s.pools[agent.Name()] = &agentPool{agent: agent}
 	log.Printf("Agent registered: %s", agent.Name())
 }
 
@@ -81,7 +332,11 @@ func (s *GameServer) RegisterAgent(agent Agent) {
 func (s *GameServer) CreateGame(player1AgentName, player2AgentName string) (string, error) {
 	s.mutex.Lock()
 	defer s.mutex.Unlock()
+	return s.createGameLocked(player1AgentName, player2AgentName)
+}
 
+// createGameLocked creates a game; the caller holds s.mutex
+func (s *GameServer) createGameLocked(player1AgentName, player2AgentName string) (string, error) {
 	player1Agent, ok := s.Agents[player1AgentName]
 	if !ok {
 		return "", fmt.Errorf("agent not found: %s", player1AgentName)
@@ -95,51 +350,138 @@ func (s *GameServer) CreateGame(player1AgentName, player2AgentName string) (stri
 	gameID := fmt.Sprintf("%s_vs_%s_%d", player1AgentName, player2AgentName, time.Now().UnixNano())
 	gameInstance := game.NewRPSGame(s.DeckSize, s.HandSize, s.MaxRounds)
 
-	match := &GameMatch{
-		ID:           gameID,
-		Game:         gameInstance,
-		Player1Agent: player1Agent,
-		Player2Agent: player2Agent,
-		Completed:    false,
-	}
-
+	match := newGameMatch(gameID, gameInstance, player1Agent, player2Agent)
 	s.Games[gameID] = match
 	log.Printf("Game created: %s vs %s (ID: %s)", player1AgentName, player2AgentName, gameID)
 	return gameID, nil
 }
 
-// Run a single game to completion
+// Run a single game to completion with pooled agent instances. If the game
+// is already queued or running, RunGame waits for it to finish instead.
 func (s *GameServer) RunGame(gameID string) (*game.RPSGame, error) {
+	match, err := s.getGame(gameID)
+	if err != nil {
+		return nil, err
+	}
+	if !match.claim(matchRunning) {
+		return match.wait()
+	}
+	return s.playPooled(match)
+}
+
+// SubmitGame queues a game for the worker pool and returns without waiting
+// for it; follow its progress on /api/games/{id}/events. It returns
+// ErrServerBusy if QueueSize games are already waiting.
+func (s *GameServer) SubmitGame(gameID string) error {
+	match, err := s.getGame(gameID)
+	if err != nil {
+		return err
+	}
+	s.startQueue.Do(s.startWorkers)
+
+	if !match.claim(matchQueued) {
+		return ErrGameStarted
+	}
+	match.queuedAt = time.Now()
+	select {
+	case s.queue <- match:
+		queueDepth.Add(1)
+		return nil
+	default:
+		match.mutex.Lock()
+		match.state = matchCreated
+		match.status = nil
+		match.mutex.Unlock()
+		gamesRefusedTotal.Inc()
+		return ErrServerBusy
+	}
+}
+
+func (s *GameServer) getGame(gameID string) (*GameMatch, error) {
+	s.mutex.Lock()
+	defer s.mutex.Unlock()
 	match, ok := s.Games[gameID]
 	if !ok {
-		return nil, fmt.Errorf("game not found: %s", gameID)
+		return nil, fmt.Errorf("%w: %s", ErrGameNotFound, gameID)
 	}
+	return match, nil
+}
 
-	match.mutex.Lock()
-	defer match.mutex.Unlock()
-
-	if match.Completed {
-		return match.Game, nil
+// startWorkers starts the goroutines that play submitted games
+func (s *GameServer) startWorkers() {
+	workers := s.Workers
+	if workers <= 0 {
+		workers = runtime.GOMAXPROCS(0)
 	}
+	s.queue = make(chan *GameMatch, s.QueueSize)
+	for i := 0; i < workers; i++ {
+		go func() {
+			for match := range s.queue {
+				queueDepth.Add(-1)
+				queueWaitSeconds.Since(match.queuedAt)
+				if _, err := s.playPooled(match); err != nil {
+					log.Printf("Error running game %s: %v", match.ID, err)
+				}
+			}
+		}()
+	}
+}
+
+// playPooled plays a claimed match with agent instances from the pools
+func (s *GameServer) playPooled(match *GameMatch) (*game.RPSGame, error) {
+	s.mutex.Lock()
+	pool1, pool2 := s.pools[match.Player1Agent.Name()], s.pools[match.Player2Agent.Name()]
+	s.mutex.Unlock()
+
+	player1, player2 := pool1.get(), pool2.get()
+	defer pool1.put(player1)
+	defer pool2.put(player2)
+	return s.playMatch(match, player1, player2)
+}
+
+// playMatch plays match to completion with the given agent instances, which
+// stand in for match.Player1Agent and match.Player2Agent. The caller has
+// claimed match. Each move is published to the match's subscribers as it is
+// made; agents think without the match locked, so status requests are
+// answered meanwhile.
+func (s *GameServer) playMatch(match *GameMatch, player1, player2 Agent) (*game.RPSGame, error) {
+	match.mutex.Lock()
+	match.state = matchRunning
+	match.status = nil
+	match.mutex.Unlock()
+	start := time.Now()
 
 	// Run the game loop
 	for !match.Game.IsGameOver() {
 		var currentAgent Agent
 		if match.Game.CurrentPlayer == game.Player1 {
-			currentAgent = match.Player1Agent
+			currentAgent = player1
 		} else {
-			currentAgent = match.Player2Agent
+			currentAgent = player2
 		}
 
 		move, err := currentAgent.GetMove(match.Game.Copy())
 		if err != nil {
-			return nil, fmt.Errorf("agent %s failed to make a move: %v", currentAgent.Name(), err)
+			return nil, s.failMatch(match, fmt.Errorf("agent %s failed to make a move: %v", currentAgent.Name(), err))
 		}
 
+		match.mutex.Lock()
 		move.Player = match.Game.CurrentPlayer
+		round := match.Game.Round
 		err = match.Game.MakeMove(move)
+		if err == nil {
+			match.publish(GameEvent{Type: "move", Move: &MoveEvent{
+				Agent:     currentAgent.Name(),
+				Player:    int(move.Player),
+				Card:      cardNames[match.Game.Board[move.Position].Type],
+				CardIndex: move.CardIndex,
+				Position:  move.Position,
+				Round:     round,
+			}})
+		}
+		match.mutex.Unlock()
 		if err != nil {
-			return nil, fmt.Errorf("invalid move from agent %s: %v", currentAgent.Name(), err)
+			return nil, s.failMatch(match, fmt.Errorf("invalid move from agent %s: %v", currentAgent.Name(), err))
 		}
 
 		log.Printf("Game %s: %s made move - Card: %d, Position: %d",
@@ -147,25 +489,33 @@ func (s *GameServer) RunGame(gameID string) (*game.RPSGame, error) {
 	}
 
 	// Determine winner
-	winner := match.Game.GetWinner()
-	match.Winner = winner
+	match.mutex.Lock()
+	match.Winner = match.Game.GetWinner()
 	match.Completed = true
+	match.state = matchCompleted
+	winnerName := match.winnerName()
+	match.publish(GameEvent{Type: "completed", Winner: winnerName})
+	match.mutex.Unlock()
+	gameSeconds.Since(start)
+	gamesCompletedTotal.Inc()
 
 	// Log the result
-	var winnerName string
-	switch winner {
-	case game.Player1:
-		winnerName = match.Player1Agent.Name()
-	case game.Player2:
-		winnerName = match.Player2Agent.Name()
-	default:
-		winnerName = "Draw"
-	}
 	log.Printf("Game %s completed. Winner: %s", match.ID, winnerName)
 
 	return match.Game, nil
 }
 
+// failMatch ends match with err, which it returns
+func (s *GameServer) failMatch(match *GameMatch, err error) error {
+	match.mutex.Lock()
+	defer match.mutex.Unlock()
+	match.state = matchFailed
+	match.err = err
+	match.publish(GameEvent{Type: "error", Error: err.Error()})
+	gamesFailedTotal.Inc()
+	return err
+}
+
 // Start a tournament between all registered agents
 func (s *GameServer) StartTournament() error {
 	s.mutex.Lock()
@@ -191,8 +541,9 @@ func (s *GameServer) StartTournament() error {
 				continue // Skip self-matches
 			}
 
-			// Create matches where each agent plays as Player1 and Player2
-			gameID, err := s.CreateGame(agents[i].Name(), agents[j].Name())
+			// Create matches where each agent plays as Player1 and Player2.
+			// s.mutex is already held.
+			gameID, err := s.createGameLocked(agents[i].Name(), agents[j].Name())
 			if err != nil {
 				return err
 			}
@@ -208,7 +559,9 @@ func (s *GameServer) StartTournament() error {
 	return nil
 }
 
-// Run all tournament matches
+// Run all tournament matches on the shared tournament scheduler. Matches
+// are played concurrently, each worker with its own agent instances, and
+// scores are applied in a fixed order.
 func (s *GameServer) runTournament() {
 	s.Tournament.mutex.Lock()
 	matchIDs := make([]string, 0, len(s.Tournament.Matches))
@@ -216,34 +569,67 @@ func (s *GameServer) runTournament() {
 		matchIDs = append(matchIDs, id)
 	}
 	s.Tournament.mutex.Unlock()
+	sort.Strings(matchIDs)
 
-	for _, id := range matchIDs {
-		_, err := s.RunGame(id)
-		if err != nil {
-			log.Printf("Error running tournament game %s: %v", id, err)
-			continue
-		}
+	next := 0
+	stats := tournament.Run(tournament.Config{
+		Next: func() (*tournament.Matchup, bool) {
+			if next == len(matchIDs) {
+				return nil, false
+			}
+			s.Tournament.mutex.Lock()
+			match := s.Tournament.Matches[matchIDs[next]]
+			s.Tournament.mutex.Unlock()
+			next++
+			return &tournament.Matchup{
+				First:  match.Player1Agent,
+				Second: match.Player2Agent,
+				Games:  1, // Each match is one game with its own board
+				Data:   match,
+			}, true
+		},
+
+		Play: func(m *tournament.Matchup, g int, player1, player2 tournament.Agent) tournament.Outcome {
+			match := m.Data.(*GameMatch)
+			play := func() (*game.RPSGame, error) { return s.playMatch(match, player1, player2) }
+			if !match.claim(matchRunning) {
+				play = match.wait // Submitted on its own meanwhile
+			}
+			if _, err := play(); err != nil {
+				log.Printf("Error running tournament game %s: %v", match.ID, err)
+				return tournament.Unscored
+			}
+			switch match.Winner {
+			case game.Player1:
+				return tournament.FirstWins
+			case game.Player2:
+				return tournament.SecondWins
+			}
+			return tournament.Draw
+		},
 
 		// Update tournament results
-		s.Tournament.mutex.Lock()
-		match := s.Tournament.Matches[id]
-		if match.Winner == game.Player1 {
-			s.Tournament.Results[match.Player1Agent.Name()] += 3 // 3 points for a win
-		} else if match.Winner == game.Player2 {
-			s.Tournament.Results[match.Player2Agent.Name()] += 3 // 3 points for a win
-		} else {
-			// Draw
-			s.Tournament.Results[match.Player1Agent.Name()] += 1 // 1 point for a draw
-			s.Tournament.Results[match.Player2Agent.Name()] += 1 // 1 point for a draw
-		}
-		s.Tournament.mutex.Unlock()
-	}
+		OnResult: func(m *tournament.Matchup, g int, outcome tournament.Outcome) {
+			s.Tournament.mutex.Lock()
+			defer s.Tournament.mutex.Unlock()
+			match := m.Data.(*GameMatch)
+			switch outcome {
+			case tournament.FirstWins:
+				s.Tournament.Results[match.Player1Agent.Name()] += 3 // 3 points for a win
+			case tournament.SecondWins:
+				s.Tournament.Results[match.Player2Agent.Name()] += 3 // 3 points for a win
+			case tournament.Draw:
+				s.Tournament.Results[match.Player1Agent.Name()] += 1 // 1 point for a draw
+				s.Tournament.Results[match.Player2Agent.Name()] += 1 // 1 point for a draw
+			}
+		},
+	})
 
 	// Mark tournament as completed
 	s.Tournament.mutex.Lock()
 	s.Tournament.InProgress = false
 	s.Tournament.mutex.Unlock()
-	log.Println("Tournament completed!")
+	log.Printf("Tournament completed! %d games in %s", stats.Games, stats.Elapsed.Round(time.Millisecond))
 }
 
 // Get tournament results
@@ -284,58 +670,61 @@ func (s *GameServer) handleGetGames(w http.ResponseWriter, r *http.Request) {
 	json.NewEncoder(w).Encode(gameIDs)
 }
 
+// handleGetGameStatus serves the match's status, encoded once per change
+// and tagged so that pollers can revalidate without a new body
 func (s *GameServer) handleGetGameStatus(w http.ResponseWriter, r *http.Request) {
-	vars := mux.Vars(r)
-	gameID := vars["id"]
-
-	s.mutex.Lock()
-	match, ok := s.Games[gameID]
-	s.mutex.Unlock()
-
-	if !ok {
+	match, err := s.getGame(mux.Vars(r)["id"])
+	if err != nil {
 		http.Error(w, "Game not found", http.StatusNotFound)
 		return
 	}
 
-	match.mutex.Lock()
-	defer match.mutex.Unlock()
-
-	type GameStatus struct {
-		ID          string `json:"id"`
-		Player1     string `json:"player1"`
-		Player2     string `json:"player2"`
-		CurrentTurn string `json:"current_turn,omitempty"`
-		IsCompleted bool   `json:"is_completed"`
-		Winner      string `json:"winner,omitempty"`
-		BoardState  string `json:"board_state"`
+	body, version := match.encodedStatus()
+	etag := `"` + strconv.Itoa(version) + `"`
+	w.Header().Set("ETag", etag)
+	if r.Header.Get("If-None-Match") == etag {
+		w.WriteHeader(http.StatusNotModified)
+		return
 	}
+	w.Header().Set("Content-Type", "application/json")
+	w.Write(append(body, '\n'))
+}
 
-	status := GameStatus{
-		ID:          match.ID,
-		Player1:     match.Player1Agent.Name(),
-		Player2:     match.Player2Agent.Name(),
-		IsCompleted: match.Completed,
-		BoardState:  match.Game.String(),
+// handleGameEvents streams the match's events as server-sent events until
+// its last one, starting after Last-Event-ID when a client reconnects
+func (s *GameServer) handleGameEvents(w http.ResponseWriter, r *http.Request) {
+	match, err := s.getGame(mux.Vars(r)["id"])
+	if err != nil {
+		http.Error(w, "Game not found", http.StatusNotFound)
+		return
+	}
+	flusher, ok := w.(http.Flusher)
+	if !ok {
+		http.Error(w, "Streaming unsupported", http.StatusInternalServerError)
+		return
 	}
 
-	if !match.Completed {
-		if match.Game.CurrentPlayer == game.Player1 {
-			status.CurrentTurn = match.Player1Agent.Name()
-		} else {
-			status.CurrentTurn = match.Player2Agent.Name()
+	w.Header().Set("Content-Type", "text/event-stream")
+	w.Header().Set("Cache-Control", "no-cache")
+	seq, _ := strconv.Atoi(r.Header.Get("Last-Event-ID"))
+	for {
+		events, changed, finished := match.eventsSince(seq)
+		for _, event := range events {
+			data, _ := json.Marshal(event)
+			fmt.Fprintf(w, "id: %d\nevent: %s\ndata: %s\n\n", event.Seq, event.Type, data)
+			seq = event.Seq
 		}
-	} else {
-		switch match.Winner {
-		case game.Player1:
-			status.Winner = match.Player1Agent.Name()
-		case game.Player2:
-			status.Winner = match.Player2Agent.Name()
-		default:
-			status.Winner = "Draw"
+		flusher.Flush()
+		if finished {
+			return
 		}
-	}
 
-	json.NewEncoder(w).Encode(status)
+		select {
+		case <-changed:
+		case <-r.Context().Done():
+			return
+		}
+	}
 }
 
 func (s *GameServer) handleCreateGame(w http.ResponseWriter, r *http.Request) {
@@ -360,17 +749,35 @@ func (s *GameServer) handleCreateGame(w http.ResponseWriter, r *http.Request) {
 	json.NewEncoder(w).Encode(map[string]string{"id": gameID})
 }
 
+// handleRunGame queues the game for the worker pool, refusing it with 503
+// when the queue is full
 func (s *GameServer) handleRunGame(w http.ResponseWriter, r *http.Request) {
-	vars := mux.Vars(r)
-	gameID := vars["id"]
+	gameID := mux.Vars(r)["id"]
 
-	_, err := s.RunGame(gameID)
-	if err != nil {
+	err := s.SubmitGame(gameID)
+	switch {
+	case errors.Is(err, ErrGameNotFound):
+		http.Error(w, err.Error(), http.StatusNotFound)
+		return
+	case errors.Is(err, ErrGameStarted):
+		http.Error(w, err.Error(), http.StatusConflict)
+		return
+	case errors.Is(err, ErrServerBusy):
+		w.Header().Set("Retry-After", "1")
+		http.Error(w, err.Error(), http.StatusServiceUnavailable)
+		return
+	case err != nil:
 		http.Error(w, err.Error(), http.StatusInternalServerError)
 		return
 	}
 
-	http.Redirect(w, r, "/api/games/"+gameID, http.StatusSeeOther)
+	w.Header().Set("Location", "/api/games/"+gameID)
+	w.WriteHeader(http.StatusAccepted)
+	json.NewEncoder(w).Encode(map[string]string{
+		"id":     gameID,
+		"status": "/api/games/" + gameID,
+		"events": "/api/games/" + gameID + "/events",
+	})
 }
 
 func (s *GameServer) handleStartTournament(w http.ResponseWriter, r *http.Request) {
@@ -390,9 +797,11 @@ func (s *GameServer) handleGetTournamentStatus(w http.ResponseWriter, r *http.Re
 
 	completedMatches := 0
 	for _, match := range s.Tournament.Matches {
+		match.mutex.Lock()
 		if match.Completed {
 			completedMatches++
 		}
+		match.mutex.Unlock()
 	}
 
 	results := make(map[string]int)
@@ -409,8 +818,26 @@ func (s *GameServer) handleGetTournamentStatus(w http.ResponseWriter, r *http.Re
 	})
 }
 
+// handleMetrics serves the demo engines' metrics and the neural clients'
+// latency histograms in one Prometheus scrape
+func handleMetrics(w http.ResponseWriter, r *http.Request) {
+	w.Header().Set("Content-Type", "text/plain; version=0.0.4; charset=utf-8")
+	if err := metrics.Default.WritePrometheus(w); err != nil {
+		return
+	}
+	neuralmetrics.WritePrometheus(w)
+}
+
 func main() {
+	addr := flag.String("addr", ":8080", "Address to listen on")
+	workers := flag.Int("workers", 0, "Games played at once (0 uses GOMAXPROCS)")
+	queueSize := flag.Int("queue", 64, "Games that may wait for a worker before new ones are refused")
+	pprof := flag.Bool("pprof", false, "Serve net/http/pprof profiles and runtime traces under /debug/pprof/")
+	flag.Parse()
+
 	server := NewGameServer()
+	server.Workers = *workers
+	server.QueueSize = *queueSize
 	router := mux.NewRouter()
 
 	// API routes
@@ -418,10 +845,15 @@ func main() {
 	router.HandleFunc("/api/games", server.handleGetGames).Methods("GET")
 	router.HandleFunc("/api/games", server.handleCreateGame).Methods("POST")
 	router.HandleFunc("/api/games/{id}", server.handleGetGameStatus).Methods("GET")
+	router.HandleFunc("/api/games/{id}/events", server.handleGameEvents).Methods("GET")
 	router.HandleFunc("/api/games/{id}/run", server.handleRunGame).Methods("POST")
 	router.HandleFunc("/api/tournament/start", server.handleStartTournament).Methods("POST")
 	router.HandleFunc("/api/tournament/status", server.handleGetTournamentStatus).Methods("GET")
+	router.HandleFunc("/metrics", handleMetrics).Methods("GET")
+	if *pprof {
+		router.PathPrefix("/debug/pprof/").Handler(metrics.DebugHandler())
+	}
 
-	log.Println("Starting game server on :8080")
-	log.Fatal(http.ListenAndServe(":8080", router))
+	log.Printf("Starting game server on %s", *addr)
+	log.Fatal(http.ListenAndServe(*addr, router))
 }
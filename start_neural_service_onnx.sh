@@ -10,6 +10,8 @@ cd "$SCRIPT_DIR"
 # Parse command line arguments
 PORT=50053 # Default port for ONNX service
 MODEL_PATH_ARG="python/output/rps_h256_value.model.onnx" # Default ONNX model path (H256)
+SESSIONS=0 # ONNX sessions per model (0 = auto)
+BATCH_WINDOW_MS=2 # Dynamic batching window
 SHUTDOWN=false
 
 while [[ $# -gt 0 ]]; do
@@ -22,13 +24,21 @@ while [[ $# -gt 0 ]]; do
             MODEL_PATH_ARG="${1#*=}"
             shift
             ;;
+        --sessions=*)
+            SESSIONS="${1#*=}"
+            shift
+            ;;
+        --batch-window-ms=*)
+            BATCH_WINDOW_MS="${1#*=}"
+            shift
+            ;;
         --shutdown)
             SHUTDOWN=true
             shift
             ;;
         *)
             echo "Unknown option: $1"
-            echo "Usage: $0 [--port=PORT] [--model-path=PATH_TO_ONNX_MODEL] [--shutdown]"
+            echo "Usage: $0 [--port=PORT] [--model-path=PATH_TO_ONNX_MODEL] [--sessions=N] [--batch-window-ms=MS] [--shutdown]"
             exit 1
             ;;
     esac
@@ -93,7 +103,8 @@ fi
 
 # Start service in the background and save PID
 # Ensure the python script itself is executable or called with python interpreter
-python -u python/neural_service_onnx.py --port "$PORT" --model_path "$MODEL_PATH_ARG" &
+python -u python/neural_service_onnx.py --port "$PORT" --model_path "$MODEL_PATH_ARG" \
+    --sessions "$SESSIONS" --batch_window_ms "$BATCH_WINDOW_MS" &
 SERVICE_PID=$!
 echo $SERVICE_PID > "$PID_FILE"
 echo "ONNX Neural service started with PID $SERVICE_PID"